@@ -0,0 +1,294 @@
+#ifndef CONTAINER_MONOTONIC_ARENA_H_INCLUDED
+#define CONTAINER_MONOTONIC_ARENA_H_INCLUDED
+
+#include <cstddef>
+#include "ContainerException.h"
+#include "private/TypeTraits.h"
+#include "Assertion/Assertion.h"
+
+namespace Container {
+
+/*!
+ * @brief Upstream memory pool of MonotonicArena that can not allocate any memory
+ */
+class NullUpstreamPool {
+public:
+	void* allocate(std::size_t)
+	{
+		return 0;
+	}
+	void deallocate(void*)
+	{
+	}
+};
+
+/*!
+ * @brief Monotonic memory arena using pre-allocated buffer
+ * @tparam UpstreamPool Type of the upstream memory pool that has `void* allocate(std::size_t)` and `void deallocate(void*)`, e.g. OSWrapper::VariableMemoryPool
+ *
+ * MonotonicArena hands out aligned memory from the pre-allocated buffer by moving the offset forward.
+ * The memory is not released one by one. rewind() releases all the memory allocated after mark() at once,
+ * and release() releases all the memory.
+ * The memory can be used as the buffers of PreallocatedVector and PreallocatedDeque.
+ *
+ * If the buffer has no space, MonotonicArena allocates an upstream block from the upstream memory pool
+ * and continues to allocate from the upstream block. The upstream blocks are returned to the upstream memory pool by rewind() and release().
+ *
+ * If there is no space and the upstream memory pool can not allocate the upstream block, allocate() throws the exception derived from std::exception.
+ * But if CPPELIB_NO_EXCEPTIONS macro is defined, aborted instead of the exception.
+ *
+ * @note MonotonicArena does not call the destructors of the objects constructed in the memory.
+ */
+template <typename UpstreamPool = NullUpstreamPool>
+class MonotonicArena {
+public:
+	typedef std::size_t size_type;
+
+	/*!
+	 * @brief Position of the arena returned by mark()
+	 *
+	 * The default Marker is the beginning of the arena.
+	 */
+	class Marker {
+	public:
+		Marker() : m_block(0), m_offset(0U) {}
+	private:
+		friend class MonotonicArena;
+		Marker(void* block, size_type offset) : m_block(block), m_offset(offset) {}
+		void* m_block;
+		size_type m_offset;
+	};
+
+private:
+	union MaxAlign {
+		long double m_ld;
+		double m_d;
+		long m_l;
+		void* m_p;
+		void (*m_f)();
+	};
+
+public:
+	/*!
+	 * @brief Default alignment of allocate()
+	 */
+	static const size_type DEFAULT_ALIGNMENT = AlignmentOf<MaxAlign>::value;
+
+private:
+	// Header at the beginning of each upstream block
+	struct Block {
+		Block* m_prev;
+		size_type m_size;
+	};
+	static const size_type BLOCK_HEADER_SIZE = ((sizeof(Block) + (DEFAULT_ALIGNMENT - 1U)) / DEFAULT_ALIGNMENT) * DEFAULT_ALIGNMENT;
+
+	char* m_buf;
+	size_type m_buf_size;
+	UpstreamPool* m_upstream;
+	size_type m_upstream_block_size;
+	Block* m_block;
+	char* m_cur;
+	size_type m_cur_size;
+	size_type m_offset;
+
+	class BadAlloc : public Container::BadAlloc {
+	public:
+		BadAlloc() : Container::BadAlloc() {}
+		const char* what() const CPPELIB_CONTAINER_NOEXCEPT
+		{
+			return "MonotonicArena::BadAlloc";
+		}
+	};
+
+	MonotonicArena(const MonotonicArena& x);
+	MonotonicArena& operator=(const MonotonicArena& x);
+
+public:
+	/*!
+	 * @brief Default constructor
+	 * @attention If you use default constructor, you need to call init() before other method call.
+	 */
+	MonotonicArena()
+	: m_buf(0), m_buf_size(0U), m_upstream(0), m_upstream_block_size(0U)
+	, m_block(0), m_cur(0), m_cur_size(0U), m_offset(0U)
+	{
+	}
+
+	/*!
+	 * @brief Constructor
+	 * @param preallocated_buffer Pre-allocated buffer by caller
+	 * @param buffer_size Number of bytes of preallocated_buffer
+	 * @param upstream Upstream memory pool. If null pointer, MonotonicArena uses only preallocated_buffer.
+	 * @param upstream_block_size Number of bytes of an upstream block. If an allocation needs more bytes, the upstream block is as large as it needs.
+	 */
+	MonotonicArena(void* preallocated_buffer, size_type buffer_size, UpstreamPool* upstream = 0, size_type upstream_block_size = 0U)
+	: m_buf(static_cast<char*>(preallocated_buffer)), m_buf_size(buffer_size), m_upstream(upstream), m_upstream_block_size(upstream_block_size)
+	, m_block(0), m_cur(m_buf), m_cur_size(buffer_size), m_offset(0U)
+	{
+	}
+
+	/*!
+	 * @brief Destructor
+	 *
+	 * Destructor calls release().
+	 */
+	~MonotonicArena()
+	{
+		release();
+	}
+
+	/*!
+	 * @brief Initialize
+	 * @param preallocated_buffer Pre-allocated buffer by caller
+	 * @param buffer_size Number of bytes of preallocated_buffer
+	 * @param upstream Upstream memory pool. If null pointer, MonotonicArena uses only preallocated_buffer.
+	 * @param upstream_block_size Number of bytes of an upstream block. If an allocation needs more bytes, the upstream block is as large as it needs.
+	 * @attention If you use default constructor, you need to call init() before other method call.
+	 * @note Pre-allocated buffer can be set only one time.
+	 */
+	void init(void* preallocated_buffer, size_type buffer_size, UpstreamPool* upstream = 0, size_type upstream_block_size = 0U)
+	{
+		if (m_buf != 0) {
+			return;
+		}
+		m_buf = static_cast<char*>(preallocated_buffer);
+		m_buf_size = buffer_size;
+		m_upstream = upstream;
+		m_upstream_block_size = upstream_block_size;
+		m_cur = m_buf;
+		m_cur_size = buffer_size;
+		m_offset = 0U;
+	}
+
+	/*!
+	 * @brief Allocate a memory from this arena
+	 * @param size Number of bytes of allocation
+	 * @param alignment Alignment of the memory. It must be a power of two.
+	 * @return Pointer of allocated memory
+	 */
+	void* allocate(size_type size, size_type alignment = DEFAULT_ALIGNMENT)
+	{
+		CHECK_ASSERT((alignment != 0U) && ((alignment & (alignment - 1U)) == 0U));
+		void* p = allocate_from_current(size, alignment);
+		if (p != 0) {
+			return p;
+		}
+		if (!add_upstream_block(size, alignment)) {
+			CPPELIB_CONTAINER_THROW(BadAlloc());
+			return 0;
+		}
+		return allocate_from_current(size, alignment);
+	}
+
+	/*!
+	 * @brief Allocate a memory for n objects of type T
+	 * @tparam T Type of the objects
+	 * @param n Number of the objects
+	 * @return Pointer of allocated memory aligned on the boundary of type T
+	 * @note The objects are not constructed.
+	 */
+	template <typename T>
+	T* allocate_array(size_type n)
+	{
+		if (n > static_cast<size_type>(-1) / sizeof(T)) {
+			CPPELIB_CONTAINER_THROW(BadAlloc());
+			return 0;
+		}
+		return static_cast<T*>(allocate(n * sizeof(T), AlignmentOf<T>::value));
+	}
+
+	/*!
+	 * @brief Get the current position of this arena
+	 * @return Marker that rewind() takes
+	 */
+	Marker mark() const
+	{
+		return Marker(m_block, m_offset);
+	}
+
+	/*!
+	 * @brief Release all the memory allocated after mark() returned the marker
+	 * @param marker Marker returned by mark() of this arena
+	 * @attention The marker must not be older than the position of this arena rewound before.
+	 */
+	void rewind(const Marker& marker)
+	{
+		while (m_block != marker.m_block) {
+			CHECK_ASSERT(m_block != 0);
+			Block* prev = m_block->m_prev;
+			m_upstream->deallocate(m_block);
+			m_block = prev;
+		}
+		if (m_block == 0) {
+			m_cur = m_buf;
+			m_cur_size = m_buf_size;
+		} else {
+			m_cur = reinterpret_cast<char*>(m_block) + BLOCK_HEADER_SIZE;
+			m_cur_size = m_block->m_size;
+		}
+		m_offset = marker.m_offset;
+	}
+
+	/*!
+	 * @brief Release all the memory and return all the upstream blocks to the upstream memory pool
+	 * @note Same as rewind(Marker())
+	 */
+	void release()
+	{
+		rewind(Marker());
+	}
+
+	/*!
+	 * @brief Get the number of bytes that can be allocated without a new upstream block
+	 * @return Number of bytes remaining in the current buffer or upstream block
+	 * @note The padding for the alignment is also taken from the remaining bytes.
+	 */
+	size_type remaining_size() const
+	{
+		return m_cur_size - m_offset;
+	}
+
+private:
+	void* allocate_from_current(size_type size, size_type alignment)
+	{
+		const size_type addr = reinterpret_cast<size_type>(m_cur) + m_offset;
+		const size_type padding = (alignment - (addr & (alignment - 1U))) & (alignment - 1U);
+		const size_type rest = m_cur_size - m_offset;
+		if ((padding > rest) || (size > rest - padding)) {
+			return 0;
+		}
+		void* p = m_cur + m_offset + padding;
+		m_offset += padding + size;
+		return p;
+	}
+
+	bool add_upstream_block(size_type size, size_type alignment)
+	{
+		if (m_upstream == 0) {
+			return false;
+		}
+		if (size > static_cast<size_type>(-1) - alignment - BLOCK_HEADER_SIZE) {
+			return false;
+		}
+		size_type block_size = size + alignment;
+		if (block_size < m_upstream_block_size) {
+			block_size = m_upstream_block_size;
+		}
+		void* mem = m_upstream->allocate(BLOCK_HEADER_SIZE + block_size);
+		if (mem == 0) {
+			return false;
+		}
+		Block* b = static_cast<Block*>(mem);
+		b->m_prev = m_block;
+		b->m_size = block_size;
+		m_block = b;
+		m_cur = static_cast<char*>(mem) + BLOCK_HEADER_SIZE;
+		m_cur_size = block_size;
+		m_offset = 0U;
+		return true;
+	}
+};
+
+}
+
+#endif // CONTAINER_MONOTONIC_ARENA_H_INCLUDED
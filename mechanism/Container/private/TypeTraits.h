@@ -1,6 +1,8 @@
 #ifndef CONTAINER_TYPE_TRAITS_H_INCLUDED
 #define CONTAINER_TYPE_TRAITS_H_INCLUDED
 
+#include <cstddef>
+
 namespace Container {
 
 struct TrueType {};
@@ -56,6 +58,14 @@ template <> struct IsInteger<unsigned long long> {
 };
 #endif
 
+template <typename T> struct AlignmentOf {
+	struct Helper {
+		char m_c;
+		T m_t;
+	};
+	static const std::size_t value = sizeof(Helper) - sizeof(T);
+};
+
 }
 
 #endif // CONTAINER_TYPE_TRAITS_H_INCLUDED
@@ -0,0 +1,67 @@
+#ifndef OS_WRAPPER_DEADLINE_H_INCLUDED
+#define OS_WRAPPER_DEADLINE_H_INCLUDED
+
+#if (__cplusplus >= 201103L)
+
+#include <chrono>
+#include <climits>
+#include "Timeout.h"
+
+namespace OSWrapper {
+
+/*!
+ * @brief Class of the end time of a Timeout
+ *
+ * A method that waits in a loop passes getRemaining() to each wait,
+ * so the total time of the waits does not exceed the Timeout given by the caller.
+ *
+ * @note This class is available only in C++11 or later.
+ */
+class Deadline {
+public:
+	/*!
+	 * @brief Constructor of Deadline
+	 * @param tmout The limited time from now
+	 */
+	explicit Deadline(Timeout tmout)
+	: m_tmout(tmout), m_end()
+	{
+		if ((tmout != Timeout::FOREVER) && (tmout != Timeout::POLLING)) {
+			m_end = std::chrono::steady_clock::now()
+				+ std::chrono::milliseconds(tmout.getWholeMillis()) + std::chrono::nanoseconds(tmout.getSubMillisNanos());
+		}
+	}
+
+	/*!
+	 * @brief Get the time left until the end time
+	 * @return Timeout::FOREVER or Timeout::POLLING if the Timeout is so, Timeout::POLLING if the end time has passed, else the time left
+	 */
+	Timeout getRemaining() const
+	{
+		if ((m_tmout == Timeout::FOREVER) || (m_tmout == Timeout::POLLING)) {
+			return m_tmout;
+		}
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now >= m_end) {
+			return Timeout::POLLING;
+		}
+		const long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(m_end - now).count();
+		if (nanos > LONG_MAX) {
+			return Timeout(static_cast<long>((nanos + 999999LL) / 1000000LL));
+		}
+		return Timeout::fromNanos(static_cast<long>(nanos));
+	}
+
+private:
+	const Timeout m_tmout;
+	std::chrono::steady_clock::time_point m_end;
+
+	Deadline(const Deadline&);
+	Deadline& operator=(const Deadline&);
+};
+
+}
+
+#endif // (__cplusplus >= 201103L)
+
+#endif // OS_WRAPPER_DEADLINE_H_INCLUDED
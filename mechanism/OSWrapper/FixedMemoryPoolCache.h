@@ -0,0 +1,319 @@
+#ifndef OS_WRAPPER_FIXED_MEMORY_POOL_CACHE_H_INCLUDED
+#define OS_WRAPPER_FIXED_MEMORY_POOL_CACHE_H_INCLUDED
+
+#include <cstddef>
+#include "FixedMemoryPool.h"
+#include "Mutex.h"
+#include "Thread.h"
+#include "Timeout.h"
+#include "OSWrapperError.h"
+
+namespace OSWrapper {
+
+/*!
+ * @brief Class template of FixedMemoryPool that caches the free blocks of another FixedMemoryPool for each thread
+ * @tparam Capacity Max number of blocks kept by one cache
+ * @tparam NumCaches Number of the caches
+ *
+ * FixedMemoryPoolCache is a decorator of a shared FixedMemoryPool, so it can be passed to any code that uses a FixedMemoryPool.
+ * Each thread uses the cache selected by its Thread object, and the cache keeps the free blocks in a small stack,
+ * so most of allocations and deallocations do not access the shared FixedMemoryPool.
+ * When the stack is empty, half of Capacity blocks are allocated from the FixedMemoryPool at once.
+ * When the stack is full, half of Capacity blocks are returned to the FixedMemoryPool at once.
+ * Each cache has its own Mutex, and the threads share a cache only if they select the same one.
+ *
+ * The blocks kept by the caches are available for all the threads.
+ * If the FixedMemoryPool has no free blocks, an allocation returns the blocks of all the caches to the FixedMemoryPool before it waits,
+ * and the blocks deallocated while it waits are returned to the FixedMemoryPool directly.
+ * getNumberOfAvailableBlocks() counts the blocks kept by the caches.
+ *
+ * The threads not created by Thread::create() and the non thread context use the FixedMemoryPool directly.
+ * If the Mutex of a cache can't be created, the threads that select the cache use the FixedMemoryPool directly.
+ *
+ * @note FixedMemoryPoolCache is not created by FixedMemoryPool::create(). Don't pass it to FixedMemoryPool::destroy().
+ * @note FixedMemoryPoolCache can't be copied.
+ */
+template <std::size_t Capacity, std::size_t NumCaches = 8U>
+class FixedMemoryPoolCache : public FixedMemoryPool {
+public:
+	/*!
+	 * @brief Constructor of FixedMemoryPoolCache
+	 * @param pool Shared FixedMemoryPool
+	 */
+	explicit FixedMemoryPoolCache(FixedMemoryPool* pool)
+	: m_pool(pool)
+	{
+		for (std::size_t i = 0U; i < NumCaches; ++i) {
+			m_caches[i].m_mtx = Mutex::createNonRecursive();
+			m_caches[i].m_numBlocks = 0U;
+			m_caches[i].m_numWaiters = 0U;
+		}
+	}
+
+	/*!
+	 * @brief Destructor of FixedMemoryPoolCache
+	 *
+	 * Destructor calls flush().
+	 */
+	virtual ~FixedMemoryPoolCache()
+	{
+		flush();
+		for (std::size_t i = 0U; i < NumCaches; ++i) {
+			Mutex::destroy(m_caches[i].m_mtx);
+		}
+	}
+
+	/*!
+	 * @brief Allocate a block without blocking
+	 * @return If a free block exists in the cache or the FixedMemoryPool then returns a pointer of allocated block, else returns null pointer
+	 */
+	virtual void* allocate()
+	{
+		void* p = 0;
+		(void) tryAllocateMemory(&p);
+		return p;
+	}
+
+	/*!
+	 * @brief Release the allocated block to the cache of the current thread
+	 * @param p Pointer of the block allocated by this object or the FixedMemoryPool
+	 *
+	 * @note If p is null pointer, do nothing.
+	 * @note A block allocated by another thread can be released to the cache.
+	 */
+	virtual void deallocate(void* p)
+	{
+		if (p == 0) {
+			return;
+		}
+		Cache* c = getCache();
+		if (c == 0) {
+			m_pool->deallocate(p);
+			return;
+		}
+		LockGuard lock(c->m_mtx);
+		if (c->m_numWaiters != 0U) {
+			m_pool->deallocate(p);
+			return;
+		}
+		if (c->m_numBlocks == Capacity) {
+			spill(c);
+		}
+		c->m_blocks[c->m_numBlocks] = p;
+		++c->m_numBlocks;
+	}
+
+	/*!
+	 * @brief Get the block size
+	 * @return Number of bytes of one fixed-size memory block
+	 */
+	virtual std::size_t getBlockSize() const
+	{
+		return m_pool->getBlockSize();
+	}
+
+	/*!
+	 * @brief Block the current thread until a memory block is allocated
+	 * @param[out] memory Pointer of pointer that stores the allocated memory
+	 * @retval OK Success. A memory is allocated
+	 * @retval InvalidParameter \p memory is null pointer
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedAllocateMemory(memory, Timeout::FOREVER)
+	 */
+	virtual Error allocateMemory(void** memory)
+	{
+		return timedAllocateMemory(memory, Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Allocate a memory block without blocking
+	 * @param[out] memory Pointer of pointer that stores the allocated memory
+	 * @retval OK Success. A memory is allocated
+	 * @retval TimedOut Failed because no free blocks in the caches and the FixedMemoryPool
+	 * @retval InvalidParameter \p memory is null pointer
+	 *
+	 * @note Same as timedAllocateMemory(memory, Timeout::POLLING)
+	 */
+	virtual Error tryAllocateMemory(void** memory)
+	{
+		return timedAllocateMemory(memory, Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Block the current thread until a memory block is allocated but only within the limited time
+	 * @param[out] memory Pointer of pointer that stores the allocated memory
+	 * @param tmout The limited time
+	 * @retval OK Success. A memory is allocated
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval InvalidParameter \p memory is null pointer
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * If the cache of the current thread is empty, the blocks are allocated from the FixedMemoryPool without blocking.
+	 * Only if the FixedMemoryPool has no free blocks, this method returns the blocks of all the caches to the FixedMemoryPool,
+	 * and then waits for a block of the FixedMemoryPool within \p tmout.
+	 */
+	virtual Error timedAllocateMemory(void** memory, Timeout tmout)
+	{
+		if (memory == 0) {
+			return InvalidParameter;
+		}
+		Cache* c = getCache();
+		if (c != 0) {
+			LockGuard lock(c->m_mtx);
+			// While another thread waits, the blocks of the FixedMemoryPool are not kept by the cache
+			if ((c->m_numBlocks == 0U) && (c->m_numWaiters == 0U)) {
+				refill(c);
+			}
+			if (c->m_numBlocks > 0U) {
+				--c->m_numBlocks;
+				*memory = c->m_blocks[c->m_numBlocks];
+				return OK;
+			}
+		}
+		if (m_pool->tryAllocateMemory(memory) == OK) {
+			return OK;
+		}
+
+		// The waiter count of every cache makes the deallocations during the wait return the blocks to the FixedMemoryPool
+		for (std::size_t i = 0U; i < NumCaches; ++i) {
+			if (m_caches[i].m_mtx != 0) {
+				LockGuard lock(m_caches[i].m_mtx);
+				flushCache(&m_caches[i]);
+				++m_caches[i].m_numWaiters;
+			}
+		}
+		const Error err = m_pool->timedAllocateMemory(memory, tmout);
+		for (std::size_t i = 0U; i < NumCaches; ++i) {
+			if (m_caches[i].m_mtx != 0) {
+				LockGuard lock(m_caches[i].m_mtx);
+				--m_caches[i].m_numWaiters;
+			}
+		}
+		return err;
+	}
+
+	/*!
+	 * @brief Get the number of available blocks
+	 * @return Number of available blocks of the FixedMemoryPool and the blocks kept by the caches
+	 */
+	virtual std::size_t getNumberOfAvailableBlocks() const
+	{
+		return m_pool->getNumberOfAvailableBlocks() + getNumberOfCachedBlocks();
+	}
+
+	/*!
+	 * @brief Get the max number of blocks
+	 * @return Max number of blocks of the FixedMemoryPool
+	 */
+	virtual std::size_t getMaxNumberOfBlocks() const
+	{
+		return m_pool->getMaxNumberOfBlocks();
+	}
+
+	/*!
+	 * @brief Return all the blocks in the caches to the FixedMemoryPool
+	 */
+	void flush()
+	{
+		for (std::size_t i = 0U; i < NumCaches; ++i) {
+			if (m_caches[i].m_mtx != 0) {
+				LockGuard lock(m_caches[i].m_mtx);
+				flushCache(&m_caches[i]);
+			}
+		}
+	}
+
+	/*!
+	 * @brief Get the number of the blocks in the caches
+	 * @return Number of the blocks in the caches
+	 */
+	std::size_t getNumberOfCachedBlocks() const
+	{
+		std::size_t num = 0U;
+		for (std::size_t i = 0U; i < NumCaches; ++i) {
+			if (m_caches[i].m_mtx != 0) {
+				LockGuard lock(m_caches[i].m_mtx);
+				num += m_caches[i].m_numBlocks;
+			}
+		}
+		return num;
+	}
+
+	/*!
+	 * @brief Get the shared FixedMemoryPool
+	 * @return Pointer of the FixedMemoryPool
+	 */
+	FixedMemoryPool* getFixedMemoryPool() const
+	{
+		return m_pool;
+	}
+
+private:
+	static const std::size_t BATCH_SIZE = (Capacity + 1U) / 2U;
+
+	struct Cache {
+		Mutex* m_mtx;
+		std::size_t m_numBlocks;
+		std::size_t m_numWaiters;
+		void* m_blocks[Capacity];
+	};
+
+	FixedMemoryPool* m_pool;
+	Cache m_caches[NumCaches];
+
+	Cache* getCache()
+	{
+		const Thread* t = Thread::getCurrentThread();
+		if (t == 0) {
+			return 0;
+		}
+		// Thread objects are aligned, so the low bits of the address are dropped
+		std::size_t h = reinterpret_cast<std::size_t>(t) / sizeof(void*);
+		h ^= h >> 8;
+		Cache* c = &m_caches[h % NumCaches];
+		if (c->m_mtx == 0) {
+			return 0;
+		}
+		return c;
+	}
+
+	void refill(Cache* c)
+	{
+		while (c->m_numBlocks < BATCH_SIZE) {
+			void* p = 0;
+			if (m_pool->tryAllocateMemory(&p) != OK) {
+				break;
+			}
+			c->m_blocks[c->m_numBlocks] = p;
+			++c->m_numBlocks;
+		}
+	}
+
+	// Return the blocks at the bottom of the stack, which were used least recently
+	void spill(Cache* c)
+	{
+		for (std::size_t i = 0U; i < BATCH_SIZE; ++i) {
+			m_pool->deallocate(c->m_blocks[i]);
+		}
+		for (std::size_t i = BATCH_SIZE; i < c->m_numBlocks; ++i) {
+			c->m_blocks[i - BATCH_SIZE] = c->m_blocks[i];
+		}
+		c->m_numBlocks -= BATCH_SIZE;
+	}
+
+	void flushCache(Cache* c)
+	{
+		while (c->m_numBlocks > 0U) {
+			--c->m_numBlocks;
+			m_pool->deallocate(c->m_blocks[c->m_numBlocks]);
+		}
+	}
+
+	FixedMemoryPoolCache(const FixedMemoryPoolCache&);
+	FixedMemoryPoolCache& operator=(const FixedMemoryPoolCache&);
+};
+
+}
+
+#endif // OS_WRAPPER_FIXED_MEMORY_POOL_CACHE_H_INCLUDED
@@ -0,0 +1,415 @@
+#ifndef OS_WRAPPER_FUTURE_H_INCLUDED
+#define OS_WRAPPER_FUTURE_H_INCLUDED
+
+#include <cstddef>
+#include "OSWrapperError.h"
+#include "Runnable.h"
+#include "Thread.h"
+#include "Timeout.h"
+#include "ThreadPool.h"
+
+namespace OSWrapper {
+
+template <typename T>
+class Callable;
+template <typename T, typename U>
+class Continuation;
+class FutureBase;
+template <typename T>
+class Future;
+
+template <typename T>
+Error async(ThreadPool* pool, Callable<T>* task, Future<T>* future, int priority = Thread::INHERIT_PRIORITY);
+template <typename T, typename U>
+Error then(ThreadPool* pool, Future<T>* antecedent, Continuation<T, U>* continuation, Future<U>* future, int priority = Thread::INHERIT_PRIORITY);
+template <typename U>
+Error whenAll(ThreadPool* pool, FutureBase* const* inputs, std::size_t numInputs, Callable<U>* task, Future<U>* future, int priority = Thread::INHERIT_PRIORITY);
+template <typename U>
+Error whenAny(ThreadPool* pool, FutureBase* const* inputs, std::size_t numInputs, Callable<U>* task, Future<U>* future, int priority = Thread::INHERIT_PRIORITY);
+
+/*!
+ * @brief Abstract class template of a task that returns a result
+ * @tparam T Type of the result
+ *
+ * Implement call() in the derived class and start the object by async(), then(), whenAll() or whenAny().
+ * The result is stored in this object, so the object must live until the Future has been released.
+ */
+template <typename T>
+class Callable : public Runnable {
+public:
+	Callable() : m_result(), m_hasResult(false) {}
+
+	/*!
+	 * @brief Destructor of Callable
+	 */
+	virtual ~Callable() {}
+
+	/*!
+	 * @brief Call call() and store the result
+	 *
+	 * If call() throws an exception, the result is not stored and the exception is propagated.
+	 */
+	void run()
+	{
+		m_hasResult = false;
+		if (!canCall()) {
+			return;
+		}
+		m_result = call();
+		m_hasResult = true;
+	}
+
+	/*!
+	 * @brief Return true if the result has been stored
+	 */
+	bool hasResult() const
+	{
+		return m_hasResult;
+	}
+
+	/*!
+	 * @brief Get the stored result
+	 * @pre hasResult() == true
+	 */
+	const T& getResult() const
+	{
+		return m_result;
+	}
+
+protected:
+	/*!
+	 * @brief Compute the result
+	 * @return The result
+	 */
+	virtual T call() = 0;
+
+	/*!
+	 * @brief Return false if call() can not be called
+	 *
+	 * The default implementation returns true.
+	 */
+	virtual bool canCall() const
+	{
+		return true;
+	}
+
+private:
+	T m_result;
+	bool m_hasResult;
+};
+
+/*!
+ * @brief Abstract class template of a task that receives the result of another Callable
+ * @tparam T Type of the result of the antecedent Callable
+ * @tparam U Type of the result
+ *
+ * Implement continueWith() in the derived class and start the object by then().
+ * If the antecedent has no result (it threw an exception or it was discarded), continueWith() is not called and this object has no result either.
+ */
+template <typename T, typename U>
+class Continuation : public Callable<U> {
+public:
+	Continuation() : Callable<U>(), m_antecedent(0) {}
+
+	/*!
+	 * @brief Destructor of Continuation
+	 */
+	virtual ~Continuation() {}
+
+protected:
+	/*!
+	 * @brief Compute the result from the result of the antecedent
+	 * @param input The result of the antecedent
+	 * @return The result
+	 */
+	virtual U continueWith(const T& input) = 0;
+
+private:
+	template <typename A, typename B>
+	friend Error then(ThreadPool* pool, Future<A>* antecedent, Continuation<A, B>* continuation, Future<B>* future, int priority);
+
+	const Callable<T>* m_antecedent;
+
+	U call()
+	{
+		return continueWith(m_antecedent->getResult());
+	}
+
+	bool canCall() const
+	{
+		return (m_antecedent != 0) && m_antecedent->hasResult();
+	}
+};
+
+/*!
+ * @brief Class of the state of an asynchronous task that does not depend on the type of the result
+ *
+ * FutureBase is used by whenAll() and whenAny() to refer Futures of different types.
+ * FutureBase can't be copied.
+ */
+class FutureBase {
+public:
+	/*!
+	 * @brief Max number of inputs of whenAll() and whenAny()
+	 */
+	static const std::size_t MAX_INPUTS = 16U;
+
+	FutureBase() : m_waiter() {}
+
+	/*!
+	 * @brief Block the current thread until the asynchronous task finished
+	 * @retval OK Success. The asynchronous task has finished
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval OtherError The asynchronous task was discarded by ThreadPool::OverflowPolicy DISCARD_OLDEST
+	 *
+	 * @note Same as ThreadPool::WaitGuard::wait()
+	 */
+	Error wait()
+	{
+		return m_waiter.wait();
+	}
+
+	/*!
+	 * @brief Query without blocking whether the asynchronous task finished
+	 *
+	 * @note Same as ThreadPool::WaitGuard::tryWait()
+	 */
+	Error tryWait()
+	{
+		return m_waiter.tryWait();
+	}
+
+	/*!
+	 * @brief Block the current thread until the asynchronous task finished but only within the limited time
+	 * @param tmout The limited time
+	 *
+	 * @note Same as ThreadPool::WaitGuard::timedWait()
+	 */
+	Error timedWait(Timeout tmout)
+	{
+		return m_waiter.timedWait(tmout);
+	}
+
+	/*!
+	 * @brief Return true if the asynchronous task has been started and this Future has not been released
+	 */
+	bool isValid() const
+	{
+		return m_waiter.isValid();
+	}
+
+	/*!
+	 * @brief Wait for the asynchronous task and turn this Future to invalid
+	 *
+	 * @note The destructor calls this method.
+	 */
+	void release()
+	{
+		m_waiter.release();
+	}
+
+protected:
+	~FutureBase() {}
+
+private:
+	template <typename T>
+	friend Error async(ThreadPool* pool, Callable<T>* task, Future<T>* future, int priority);
+	template <typename T, typename U>
+	friend Error then(ThreadPool* pool, Future<T>* antecedent, Continuation<T, U>* continuation, Future<U>* future, int priority);
+	template <typename U>
+	friend Error whenAll(ThreadPool* pool, FutureBase* const* inputs, std::size_t numInputs, Callable<U>* task, Future<U>* future, int priority);
+	template <typename U>
+	friend Error whenAny(ThreadPool* pool, FutureBase* const* inputs, std::size_t numInputs, Callable<U>* task, Future<U>* future, int priority);
+
+	ThreadPool::WaitGuard m_waiter;
+
+	FutureBase(const FutureBase&);
+	FutureBase& operator=(const FutureBase&);
+};
+
+/*!
+ * @brief Class template of the result of an asynchronous task
+ * @tparam T Type of the result
+ *
+ * Future becomes valid by async(), then(), whenAll() or whenAny().
+ * The destructor waits for the asynchronous task finished like ThreadPool::WaitGuard.
+ */
+template <typename T>
+class Future : public FutureBase {
+public:
+	Future() : FutureBase(), m_task(0) {}
+
+	/*!
+	 * @brief Wait for the asynchronous task and get the result
+	 * @param[out] value Pointer of the variable that receives the result
+	 * @retval OK Success. The result has been set to \p value
+	 * @retval InvalidParameter \p value is null pointer, or no task has been started with this Future
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval OtherError The asynchronous task has no result. It threw an exception, it was discarded, or its antecedent had no result
+	 */
+	Error get(T* value)
+	{
+		if ((value == 0) || (m_task == 0)) {
+			return InvalidParameter;
+		}
+		const Error err = wait();
+		if (err != OK) {
+			return err;
+		}
+		if (!m_task->hasResult()) {
+			return OtherError;
+		}
+		*value = m_task->getResult();
+		return OK;
+	}
+
+private:
+	template <typename A>
+	friend Error async(ThreadPool* pool, Callable<A>* task, Future<A>* future, int priority);
+	template <typename A, typename B>
+	friend Error then(ThreadPool* pool, Future<A>* antecedent, Continuation<A, B>* continuation, Future<B>* future, int priority);
+	template <typename B>
+	friend Error whenAll(ThreadPool* pool, FutureBase* const* inputs, std::size_t numInputs, Callable<B>* task, Future<B>* future, int priority);
+	template <typename B>
+	friend Error whenAny(ThreadPool* pool, FutureBase* const* inputs, std::size_t numInputs, Callable<B>* task, Future<B>* future, int priority);
+
+	const Callable<T>* m_task;
+};
+
+/*!
+ * @brief Start \p task on \p pool
+ * @tparam T Type of the result
+ * @param pool ThreadPool that runs \p task
+ * @param task Callable object
+ * @param[out] future Future that receives the result. It must be invalid.
+ * @param priority Priority of the task. See ThreadPool::start()
+ * @retval OK Success
+ * @retval InvalidParameter \p pool, \p task or \p future is null pointer, or \p future is valid
+ * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+ *
+ * @note Same as ThreadPool::start(). If the OverflowPolicy of \p pool is CALLER_RUNS and the queue is full, \p task runs by the current thread and \p future stays invalid, but get() returns the result.
+ */
+template <typename T>
+Error async(ThreadPool* pool, Callable<T>* task, Future<T>* future, int priority)
+{
+	if ((pool == 0) || (task == 0) || (future == 0) || future->isValid()) {
+		return InvalidParameter;
+	}
+	future->m_task = task;
+	const Error err = pool->start(task, &future->m_waiter, priority);
+	if (err != OK) {
+		future->m_task = 0;
+	}
+	return err;
+}
+
+/*!
+ * @brief Start \p continuation on \p pool after the task of \p antecedent finished
+ * @tparam T Type of the result of \p antecedent
+ * @tparam U Type of the result of \p continuation
+ * @param pool ThreadPool that runs \p continuation. It must be the ThreadPool of \p antecedent.
+ * @param antecedent Future of the antecedent task started by async(), then(), whenAll() or whenAny(). At most one following task can be registered to a running task.
+ * @param continuation Continuation object that receives the result of \p antecedent
+ * @param[out] future Future that receives the result of \p continuation. It must be invalid.
+ * @param priority Priority of the task. See ThreadPool::start()
+ * @retval OK Success
+ * @retval InvalidParameter A pointer is null, \p future is valid, no task has been started with \p antecedent, or \p antecedent already has a following task
+ * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+ *
+ * @note \p antecedent must not be released until \p continuation finished, because \p continuation reads the result of the antecedent task.
+ * @note See ThreadPool::startAfterAll()
+ */
+template <typename T, typename U>
+Error then(ThreadPool* pool, Future<T>* antecedent, Continuation<T, U>* continuation, Future<U>* future, int priority)
+{
+	if ((pool == 0) || (antecedent == 0) || (continuation == 0) || (future == 0) || future->isValid() ||
+			(antecedent->m_task == 0)) {
+		return InvalidParameter;
+	}
+	continuation->m_antecedent = antecedent->m_task;
+	future->m_task = continuation;
+	ThreadPool::WaitGuard* waiter = &antecedent->m_waiter;
+	const Error err = pool->startAfterAll(&waiter, 1U, continuation, &future->m_waiter, priority);
+	if (err != OK) {
+		future->m_task = 0;
+	}
+	return err;
+}
+
+/*!
+ * @brief Start \p task on \p pool after all the tasks of \p inputs finished
+ * @tparam U Type of the result of \p task
+ * @param pool ThreadPool that runs \p task. It must be the ThreadPool of \p inputs.
+ * @param inputs Array of pointers of FutureBase. An invalid element is regarded as finished.
+ * @param numInputs Number of elements of \p inputs
+ * @param task Callable object. It can read the results of \p inputs.
+ * @param[out] future Future that receives the result of \p task. It must be invalid.
+ * @param priority Priority of the task. See ThreadPool::start()
+ * @retval OK Success
+ * @retval InvalidParameter A pointer is null, \p numInputs is zero or more than FutureBase::MAX_INPUTS, \p future is valid, or an element of \p inputs already has a following task
+ * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+ *
+ * @note See ThreadPool::startAfterAll()
+ */
+template <typename U>
+Error whenAll(ThreadPool* pool, FutureBase* const* inputs, std::size_t numInputs, Callable<U>* task, Future<U>* future, int priority)
+{
+	if ((pool == 0) || (inputs == 0) || (numInputs == 0U) || (numInputs > FutureBase::MAX_INPUTS) ||
+			(task == 0) || (future == 0) || future->isValid()) {
+		return InvalidParameter;
+	}
+	ThreadPool::WaitGuard* waiters[FutureBase::MAX_INPUTS];
+	for (std::size_t i = 0U; i < numInputs; ++i) {
+		if (inputs[i] == 0) {
+			return InvalidParameter;
+		}
+		waiters[i] = &inputs[i]->m_waiter;
+	}
+	future->m_task = task;
+	const Error err = pool->startAfterAll(waiters, numInputs, task, &future->m_waiter, priority);
+	if (err != OK) {
+		future->m_task = 0;
+	}
+	return err;
+}
+
+/*!
+ * @brief Start \p task on \p pool after any of the tasks of \p inputs finished
+ * @tparam U Type of the result of \p task
+ * @param pool ThreadPool that runs \p task. It must be the ThreadPool of \p inputs.
+ * @param inputs Array of pointers of FutureBase. An invalid element is regarded as finished.
+ * @param numInputs Number of elements of \p inputs
+ * @param task Callable object. It can find the finished input by FutureBase::tryWait().
+ * @param[out] future Future that receives the result of \p task. It must be invalid.
+ * @param priority Priority of the task. See ThreadPool::start()
+ * @retval OK Success
+ * @retval InvalidParameter A pointer is null, \p numInputs is zero or more than FutureBase::MAX_INPUTS, \p future is valid, or an element of \p inputs already has a following task
+ * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+ *
+ * @note See ThreadPool::startAfterAny()
+ */
+template <typename U>
+Error whenAny(ThreadPool* pool, FutureBase* const* inputs, std::size_t numInputs, Callable<U>* task, Future<U>* future, int priority)
+{
+	if ((pool == 0) || (inputs == 0) || (numInputs == 0U) || (numInputs > FutureBase::MAX_INPUTS) ||
+			(task == 0) || (future == 0) || future->isValid()) {
+		return InvalidParameter;
+	}
+	ThreadPool::WaitGuard* waiters[FutureBase::MAX_INPUTS];
+	for (std::size_t i = 0U; i < numInputs; ++i) {
+		if (inputs[i] == 0) {
+			return InvalidParameter;
+		}
+		waiters[i] = &inputs[i]->m_waiter;
+	}
+	future->m_task = task;
+	const Error err = pool->startAfterAny(waiters, numInputs, task, &future->m_waiter, priority);
+	if (err != OK) {
+		future->m_task = 0;
+	}
+	return err;
+}
+
+}
+
+#endif // OS_WRAPPER_FUTURE_H_INCLUDED
@@ -0,0 +1,540 @@
+#ifndef OS_WRAPPER_MPMC_MESSAGE_QUEUE_H_INCLUDED
+#define OS_WRAPPER_MPMC_MESSAGE_QUEUE_H_INCLUDED
+
+#if (__cplusplus >= 201103L)
+
+#include <cstddef>
+#include <new>
+#include <atomic>
+#include <type_traits>
+#include "Timeout.h"
+#include "Deadline.h"
+#include "OSWrapperError.h"
+#include "EventFlag.h"
+#include "FixedMemoryPool.h"
+#include "Assertion/Assertion.h"
+
+namespace OSWrapper {
+
+/*!
+ * @brief Class template of multi-producer/multi-consumer message queue
+ * @tparam T Type of element
+ *
+ * MPMCMessageQueue has the same interface as MessageQueue, but the senders and the receivers do not serialize on Mutex.
+ * Each slot of the ring buffer has a sequence number, and a sender or a receiver claims a slot by an atomic compare-and-swap of the position.
+ * The EventFlag is used only when a sender finds this queue full or a receiver finds this queue empty.
+ *
+ * The receive methods move the message out of this queue if the move assignment of T does not throw an exception.
+ * If the assignment to the variable of the receiver throws an exception, the message is kept in this queue and is received next.
+ *
+ * @note The max queue size is rounded up to a power of 2 (not less than 2).
+ * @note This class template is available only in C++11 or later.
+ */
+template <typename T>
+class MPMCMessageQueue {
+public:
+	/*!
+	 * @brief Create a MPMCMessageQueue object
+	 * @param maxSize Max queue size. It is rounded up to a power of 2
+	 * @return If this method succeeds then returns a pointer of MPMCMessageQueue object, else returns null pointer
+	 */
+	static MPMCMessageQueue* create(std::size_t maxSize)
+	{
+		const std::size_t alignedMQSize =
+			(sizeof(MPMCMessageQueue) + (sizeof(double) - 1U)) & ~(sizeof(double) - 1U);
+		const std::size_t capacity = roundUpCapacity(maxSize);
+		if (capacity == 0U) {
+			return 0;
+		}
+		const std::size_t poolBufSize = alignedMQSize + (sizeof(Cell) * capacity);
+
+		FixedMemoryPool* pool = FixedMemoryPool::create(poolBufSize,
+				FixedMemoryPool::getRequiredMemorySize(poolBufSize, 1U));
+		if (pool == 0) {
+			return 0;
+		}
+
+		void* p = pool->allocate();
+		if (p == 0) {
+			FixedMemoryPool::destroy(pool);
+			return 0;
+		}
+
+		MPMCMessageQueue* m = new(p) MPMCMessageQueue(pool,
+				reinterpret_cast<Cell*>(static_cast<unsigned char*>(p) + alignedMQSize), capacity);
+		if (!m->createOSObjects()) {
+			destroy(m);
+			return 0;
+		}
+		return m;
+	}
+
+	/*!
+	 * @brief Destroy a MPMCMessageQueue object
+	 * @param m Pointer of MPMCMessageQueue object created by MPMCMessageQueue<T>::create()
+	 *
+	 * @note If m is null pointer, do nothing.
+	 */
+	static void destroy(MPMCMessageQueue* m)
+	{
+		if (m == 0) {
+			return;
+		}
+		FixedMemoryPool* pool = m->m_pool;
+		m->~MPMCMessageQueue();
+		pool->deallocate(m);
+		FixedMemoryPool::destroy(pool);
+	}
+
+	/*!
+	 * @brief Send the message
+	 *
+	 * This method enqueues the message into this queue.
+	 * If this queue is full, block the current thread until to be dequeued by receive methods.
+	 *
+	 * @param msg Message to send
+	 * @retval OK Success. The message was sent
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedSend(msg, Timeout::FOREVER)
+	 */
+	Error send(const T& msg)
+	{
+		return timedSend(msg, Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Send the message without blocking
+	 *
+	 * This method enqueues the message into this queue.
+	 * If this queue is full, returns TimedOut immediately.
+	 *
+	 * @param msg Message to send
+	 * @retval OK Success. The message was sent
+	 * @retval TimedOut This queue is full
+	 *
+	 * @note Same as timedSend(msg, Timeout::POLLING)
+	 */
+	Error trySend(const T& msg)
+	{
+		return timedSend(msg, Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Send the message within the limited time
+	 *
+	 * This method enqueues the message into this queue.
+	 * If this queue is full, block the current thread until to be dequeued by receive methods but only within the limited time.
+	 *
+	 * @param msg Message to send
+	 * @param tmout The limited time
+	 * @retval OK Success. The message was sent
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to send the message without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until has sent the message.
+	 * @note If the copy of the message throws an exception, the slot claimed is counted by getSize() until a receiver skips it.
+	 */
+	Error timedSend(const T& msg, Timeout tmout)
+	{
+		std::size_t pos = 0U;
+		Cell* cell = claimSendCell(&pos);
+		if (cell == 0) {
+			const Error err = waitWhileFull(&cell, &pos, tmout);
+			if (err != OK) {
+				return err;
+			}
+		}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			new(cell->m_data) T(msg);
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (const Assertion::Failure&) {
+			publishSendCell(cell, pos, false);
+			throw;
+		}
+		catch (...) {
+			publishSendCell(cell, pos, false);
+			return OtherError;
+		}
+#endif
+		publishSendCell(cell, pos, true);
+		return OK;
+	}
+
+	/*!
+	 * @brief Receive the message
+	 *
+	 * This method dequeues the message from this queue.
+	 * If this queue is empty, block the current thread until to be enqueued by send methods.
+	 *
+	 * @param msg Pointer of variable that stores the message received. If null pointer, not accessed
+	 * @retval OK Success. The message was received
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedReceive(msg, Timeout::FOREVER)
+	 */
+	Error receive(T* msg)
+	{
+		return timedReceive(msg, Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Receive the message without blocking
+	 *
+	 * This method dequeues the message from this queue.
+	 * If this queue is empty, returns TimedOut immediately.
+	 *
+	 * @param msg Pointer of variable that stores the message received. If null pointer, not accessed
+	 * @retval OK Success. The message was received
+	 * @retval TimedOut This queue is empty
+	 *
+	 * @note Same as timedReceive(msg, Timeout::POLLING)
+	 */
+	Error tryReceive(T* msg)
+	{
+		return timedReceive(msg, Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Receive the message within the limited time
+	 *
+	 * This method dequeues the message from this queue.
+	 * If this queue is empty, block the current thread until to be enqueued by send methods but only within the limited time.
+	 *
+	 * @param msg Pointer of variable that stores the message received. If null pointer, not accessed
+	 * @param tmout The limited time
+	 * @retval OK Success. The message was received
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to receive the message without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until has received the message.
+	 */
+	Error timedReceive(T* msg, Timeout tmout)
+	{
+		std::size_t pos = 0U;
+		Cell* cell = claimReceiveCell(&pos);
+		if (cell == 0) {
+			const Error err = waitWhileEmpty(&cell, &pos, tmout);
+			if (err != OK) {
+				return err;
+			}
+		}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			if (msg != 0) {
+				*msg = moveIfNoexcept(*cell->get());
+			}
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (const Assertion::Failure&) {
+			returnReceiveCell(cell, pos);
+			throw;
+		}
+		catch (...) {
+			returnReceiveCell(cell, pos);
+			return OtherError;
+		}
+#endif
+		releaseReceiveCell(cell, pos);
+		return OK;
+	}
+
+	/*!
+	 * @brief Get the queue size
+	 * @return Queue size
+	 *
+	 * @note While other threads are sending or receiving, the value is a snapshot and may be already changed.
+	 */
+	std::size_t getSize() const
+	{
+		const std::size_t recvPos = m_recvPos.load();
+		const std::size_t sendPos = m_sendPos.load();
+		const std::size_t size = sendPos - recvPos + m_numReturned.load();
+		if (size > m_capacity) {
+			return m_capacity;
+		}
+		return size;
+	}
+
+	/*!
+	 * @brief Get the max queue size
+	 * @return Max queue size
+	 */
+	std::size_t getMaxSize() const
+	{
+		return m_capacity;
+	}
+
+private:
+	class Cell {
+	public:
+		std::atomic<std::size_t> m_seq;
+		bool m_valid;
+		// The cell is returned by the receiver whose assignment threw an exception. m_pos is its position.
+		std::atomic<bool> m_returned;
+		std::size_t m_pos;
+		alignas(T) unsigned char m_data[sizeof(T)];
+
+		explicit Cell(std::size_t seq) : m_seq(seq), m_valid(false), m_returned(false), m_pos(0U), m_data() {}
+		T* get() { return reinterpret_cast<T*>(m_data); }
+	};
+
+	// Same as the one of MessageQueue. A move-only type is moved even if its move assignment may throw.
+	typedef typename std::conditional<
+		!std::is_nothrow_move_assignable<T>::value && std::is_copy_assignable<T>::value,
+		const T&, T&&>::type MoveAssignRef;
+	static MoveAssignRef moveIfNoexcept(T& x) { return static_cast<MoveAssignRef>(x); }
+
+	// The senders share m_sendPos and the receivers share m_recvPos.
+	// They are placed on different cache lines not to bounce between the senders and the receivers.
+	static const std::size_t CACHE_LINE_SIZE = 64U;
+
+	std::atomic<std::size_t> m_sendPos;
+	std::atomic<std::size_t> m_sendersWaiting;
+	unsigned char m_padding1[CACHE_LINE_SIZE];
+	std::atomic<std::size_t> m_recvPos;
+	std::atomic<std::size_t> m_receiversWaiting;
+	std::atomic<std::size_t> m_numReturned;
+	unsigned char m_padding2[CACHE_LINE_SIZE];
+
+	const std::size_t m_capacity;
+	Cell* const m_cells;
+
+	FixedMemoryPool* m_pool;
+	EventFlag* m_event;
+
+	static const EventFlag::Pattern EV_NOT_EMPTY;
+	static const EventFlag::Pattern EV_NOT_FULL;
+
+	MPMCMessageQueue(FixedMemoryPool* pool, Cell* cells, std::size_t capacity)
+	: m_sendPos(0U), m_sendersWaiting(0U), m_padding1()
+	, m_recvPos(0U), m_receiversWaiting(0U), m_numReturned(0U), m_padding2()
+	, m_capacity(capacity), m_cells(cells), m_pool(pool), m_event(0)
+	{
+		for (std::size_t i = 0U; i < m_capacity; i++) {
+			new(&m_cells[i]) Cell(i);
+		}
+	}
+
+	~MPMCMessageQueue()
+	{
+		const std::size_t sendPos = m_sendPos.load();
+		for (std::size_t pos = m_recvPos.load(); pos != sendPos; pos++) {
+			Cell* cell = &m_cells[pos & (m_capacity - 1U)];
+			if (cell->m_valid) {
+				cell->get()->~T();
+			}
+		}
+		for (std::size_t i = 0U; i < m_capacity; i++) {
+			if (m_cells[i].m_returned.load()) {
+				m_cells[i].get()->~T();
+			}
+		}
+		for (std::size_t i = 0U; i < m_capacity; i++) {
+			m_cells[i].~Cell();
+		}
+		EventFlag::destroy(m_event);
+	}
+
+	bool createOSObjects()
+	{
+		m_event = EventFlag::create(false);
+		if (m_event == 0) {
+			return false;
+		}
+		return true;
+	}
+
+	static std::size_t roundUpCapacity(std::size_t maxSize)
+	{
+		std::size_t capacity = 2U;
+		while (capacity < maxSize) {
+			capacity <<= 1;
+			if (capacity == 0U) {
+				break;
+			}
+		}
+		return capacity;
+	}
+
+	// A cell whose sequence number equals the position is free for the sender of that position,
+	// and a cell whose sequence number equals the position + 1 is filled for the receiver of that position.
+	Cell* claimSendCell(std::size_t* pos)
+	{
+		std::size_t p = m_sendPos.load(std::memory_order_relaxed);
+		while (true) {
+			Cell* cell = &m_cells[p & (m_capacity - 1U)];
+			const std::size_t seq = cell->m_seq.load(std::memory_order_acquire);
+			const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - p);
+			if (diff == 0) {
+				if (m_sendPos.compare_exchange_weak(p, p + 1U, std::memory_order_relaxed)) {
+					*pos = p;
+					return cell;
+				}
+			} else if (diff < 0) {
+				return 0;
+			} else {
+				p = m_sendPos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void publishSendCell(Cell* cell, std::size_t pos, bool valid)
+	{
+		cell->m_valid = valid;
+		cell->m_seq.store(pos + 1U, std::memory_order_release);
+		notify(m_receiversWaiting, EV_NOT_EMPTY);
+	}
+
+	// A cell left by the sender whose copy threw an exception is released and skipped.
+	// The returned cells hold the oldest messages, so they are claimed first.
+	Cell* claimReceiveCell(std::size_t* pos)
+	{
+		if (m_numReturned.load(std::memory_order_acquire) != 0U) {
+			Cell* cell = claimReturnedCell(pos);
+			if (cell != 0) {
+				return cell;
+			}
+		}
+		std::size_t p = m_recvPos.load(std::memory_order_relaxed);
+		while (true) {
+			Cell* cell = &m_cells[p & (m_capacity - 1U)];
+			const std::size_t seq = cell->m_seq.load(std::memory_order_acquire);
+			const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (p + 1U));
+			if (diff == 0) {
+				if (m_recvPos.compare_exchange_weak(p, p + 1U, std::memory_order_relaxed)) {
+					if (cell->m_valid) {
+						*pos = p;
+						return cell;
+					}
+					releaseReceiveCell(cell, p);
+					p = m_recvPos.load(std::memory_order_relaxed);
+				}
+			} else if (diff < 0) {
+				return 0;
+			} else {
+				p = m_recvPos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	Cell* claimReturnedCell(std::size_t* pos)
+	{
+		for (std::size_t i = 0U; i < m_capacity; i++) {
+			Cell* cell = &m_cells[i];
+			bool returned = true;
+			if (cell->m_returned.load(std::memory_order_relaxed)
+					&& cell->m_returned.compare_exchange_strong(returned, false, std::memory_order_acquire)) {
+				m_numReturned.fetch_sub(1U);
+				*pos = cell->m_pos;
+				return cell;
+			}
+		}
+		return 0;
+	}
+
+	// The sequence number of the returned cell is not changed, so the senders do not reuse it until it is received.
+	// m_numReturned is incremented first not to be decremented below zero by the receiver that claims the cell.
+	void returnReceiveCell(Cell* cell, std::size_t pos)
+	{
+		cell->m_pos = pos;
+		m_numReturned.fetch_add(1U);
+		cell->m_returned.store(true, std::memory_order_release);
+		notify(m_receiversWaiting, EV_NOT_EMPTY);
+	}
+
+	void releaseReceiveCell(Cell* cell, std::size_t pos)
+	{
+		if (cell->m_valid) {
+			cell->get()->~T();
+			cell->m_valid = false;
+		}
+		cell->m_seq.store(pos + m_capacity, std::memory_order_release);
+		notify(m_sendersWaiting, EV_NOT_FULL);
+	}
+
+	// The waiting counter is incremented before a waiter claims a cell again,
+	// and the other side publishes a cell before loading the waiting counter (both are separated by a full fence).
+	// So either the waiter claims the cell or the other side sees the counter and sets the EventFlag.
+	void notify(const std::atomic<std::size_t>& waiting, EventFlag::Pattern pattern)
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiting.load(std::memory_order_relaxed) != 0U) {
+			m_event->set(pattern);
+		}
+	}
+
+	// The reset by a waiter may clear the notification for another waiter.
+	// So the waiter which has claimed a cell sets the EventFlag again if another waiter exists.
+	// A waiter may lose the cell to another thread after it is woken up, so each wait takes only the time left of tmout.
+	Error waitWhileFull(Cell** cell, std::size_t* pos, Timeout tmout)
+	{
+		const Deadline deadline(tmout);
+		Error err = OK;
+		m_sendersWaiting.fetch_add(1U);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while (true) {
+			m_event->reset(EV_NOT_FULL);
+			*cell = claimSendCell(pos);
+			if (*cell != 0) {
+				if (m_sendersWaiting.load() > 1U) {
+					m_event->set(EV_NOT_FULL);
+				}
+				break;
+			}
+			err = m_event->timedWait(EV_NOT_FULL, EventFlag::OR, 0, deadline.getRemaining());
+			if (err != OK) {
+				break;
+			}
+		}
+		m_sendersWaiting.fetch_sub(1U);
+		return err;
+	}
+
+	Error waitWhileEmpty(Cell** cell, std::size_t* pos, Timeout tmout)
+	{
+		const Deadline deadline(tmout);
+		Error err = OK;
+		m_receiversWaiting.fetch_add(1U);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while (true) {
+			m_event->reset(EV_NOT_EMPTY);
+			*cell = claimReceiveCell(pos);
+			if (*cell != 0) {
+				if (m_receiversWaiting.load() > 1U) {
+					m_event->set(EV_NOT_EMPTY);
+				}
+				break;
+			}
+			err = m_event->timedWait(EV_NOT_EMPTY, EventFlag::OR, 0, deadline.getRemaining());
+			if (err != OK) {
+				break;
+			}
+		}
+		m_receiversWaiting.fetch_sub(1U);
+		return err;
+	}
+
+	MPMCMessageQueue(const MPMCMessageQueue&);
+	MPMCMessageQueue& operator=(const MPMCMessageQueue&);
+};
+
+template <typename T>
+const EventFlag::Pattern MPMCMessageQueue<T>::EV_NOT_EMPTY = 0x0001U;
+
+template <typename T>
+const EventFlag::Pattern MPMCMessageQueue<T>::EV_NOT_FULL = 0x0002U;
+
+}
+
+#endif // (__cplusplus >= 201103L)
+
+#endif // OS_WRAPPER_MPMC_MESSAGE_QUEUE_H_INCLUDED
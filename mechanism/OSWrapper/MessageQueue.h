@@ -3,11 +3,16 @@
 
 #include <cstddef>
 #include <new>
+#if (__cplusplus >= 201103L)
+#include <utility>
+#include <type_traits>
+#endif
 #include "Timeout.h"
 #include "OSWrapperError.h"
 #include "Mutex.h"
 #include "EventFlag.h"
 #include "FixedMemoryPool.h"
+#include "Thread.h"
 #include "Assertion/Assertion.h"
 
 namespace OSWrapper {
@@ -17,6 +22,10 @@ namespace OSWrapper {
  * @tparam T Type of element
  *
  * @note All the methods are thread-safe.
+ * @note In C++11 or later, the messages can be sent by move or constructed in place by emplace methods,
+ *       and the receive methods move the message out of this queue if the move assignment of T does not throw an exception.
+ * @note While a thread has reserved a slot by reserve methods, the send methods called by the thread return OtherError.
+ *       While a thread holds a message got by peek methods, the receive methods called by the thread return OtherError.
  */
 template <typename T>
 class MessageQueue {
@@ -116,13 +125,14 @@ public:
 	 * @retval OK Success. The message was sent
 	 * @retval TimedOut The limited time was elapsed
 	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval OtherError The current thread has reserved a slot by reserve methods
 	 *
 	 * @note If tmout is Timeout::POLLING then this method tries to send the message without blocking.
 	 * @note If tmout is Timeout::FOREVER then this method waits forever until has sent the message.
 	 */
 	Error timedSend(const T& msg, Timeout tmout)
 	{
-		Error err = m_mtxSend->timedLock(tmout);
+		Error err = lockSend(tmout);
 		if (err != OK) {
 			return err;
 		}
@@ -152,6 +162,127 @@ public:
 		return err;
 	}
 
+#if (__cplusplus >= 201103L)
+	/*!
+	 * @brief Send the message by move
+	 * @param msg Message to send
+	 * @retval OK Success. The message was sent
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedSend(std::move(msg), Timeout::FOREVER)
+	 */
+	Error send(T&& msg)
+	{
+		return timedSend(std::move(msg), Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Send the message by move without blocking
+	 * @param msg Message to send
+	 * @retval OK Success. The message was sent
+	 * @retval TimedOut This queue is full
+	 *
+	 * @note Same as timedSend(std::move(msg), Timeout::POLLING)
+	 */
+	Error trySend(T&& msg)
+	{
+		return timedSend(std::move(msg), Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Send the message by move within the limited time
+	 * @param msg Message to send
+	 * @param tmout The limited time
+	 * @retval OK Success. The message was sent
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedEmplaceSend(tmout, std::move(msg))
+	 * @note If this method fails, msg is not moved.
+	 */
+	Error timedSend(T&& msg, Timeout tmout)
+	{
+		return timedEmplaceSend(tmout, std::move(msg));
+	}
+
+	/*!
+	 * @brief Send the message constructed in place
+	 * @param args Arguments passed to the constructor of T
+	 * @retval OK Success. The message was sent
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedEmplaceSend(Timeout::FOREVER, args...)
+	 */
+	template <typename... Args>
+	Error emplaceSend(Args&&... args)
+	{
+		return timedEmplaceSend(Timeout::FOREVER, std::forward<Args>(args)...);
+	}
+
+	/*!
+	 * @brief Send the message constructed in place without blocking
+	 * @param args Arguments passed to the constructor of T
+	 * @retval OK Success. The message was sent
+	 * @retval TimedOut This queue is full
+	 *
+	 * @note Same as timedEmplaceSend(Timeout::POLLING, args...)
+	 */
+	template <typename... Args>
+	Error tryEmplaceSend(Args&&... args)
+	{
+		return timedEmplaceSend(Timeout::POLLING, std::forward<Args>(args)...);
+	}
+
+	/*!
+	 * @brief Send the message constructed in place within the limited time
+	 *
+	 * This method constructs the message from args directly in this queue.
+	 * If this queue is full, block the current thread until to be dequeued by receive methods but only within the limited time.
+	 *
+	 * @param tmout The limited time
+	 * @param args Arguments passed to the constructor of T
+	 * @retval OK Success. The message was sent
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval OtherError The current thread has reserved a slot by reserve methods
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to send the message without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until has sent the message.
+	 */
+	template <typename... Args>
+	Error timedEmplaceSend(Timeout tmout, Args&&... args)
+	{
+		Error err = lockSend(tmout);
+		if (err != OK) {
+			return err;
+		}
+		LockGuard lock(m_mtxSend, LockGuard::ADOPT_LOCK);
+
+		if (isFull()) {
+			err = m_event->timedWait(EV_NOT_FULL, EventFlag::OR, 0, tmout);
+			if (err != OK) {
+				return err;
+			}
+		}
+
+		err = OK;
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			emplace(std::forward<Args>(args)...);
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (const Assertion::Failure&) {
+			throw;
+		}
+		catch (...) {
+			err = OtherError;
+		}
+#endif
+		return err;
+	}
+#endif
+
 	/*!
 	 * @brief Receive the message
 	 *
@@ -197,13 +328,14 @@ public:
 	 * @retval OK Success. The message was received
 	 * @retval TimedOut The limited time was elapsed
 	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval OtherError The current thread holds a message got by peek methods
 	 *
 	 * @note If tmout is Timeout::POLLING then this method tries to receive the message without blocking.
 	 * @note If tmout is Timeout::FOREVER then this method waits forever until has received the message.
 	 */
 	Error timedReceive(T* msg, Timeout tmout)
 	{
-		Error err = m_mtxRecv->timedLock(tmout);
+		Error err = lockRecv(tmout);
 		if (err != OK) {
 			return err;
 		}
@@ -233,6 +365,356 @@ public:
 		return err;
 	}
 
+	/*!
+	 * @brief Send several messages at once
+	 *
+	 * This method enqueues up to n messages into this queue under one lock acquisition.
+	 * If this queue is full, block the current thread until to be dequeued by receive methods.
+	 * After that, enqueues as many messages as this queue can store at that time.
+	 *
+	 * @param msgs Pointer of array of messages to send
+	 * @param n Number of elements of msgs
+	 * @param[out] numSent Pointer of variable that stores the number of messages sent. If null pointer, not accessed
+	 * @retval OK Success. At least one message was sent
+	 * @retval InvalidParameter msgs is null pointer or n is zero
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedSendN(msgs, n, numSent, Timeout::FOREVER)
+	 */
+	Error sendN(const T* msgs, std::size_t n, std::size_t* numSent)
+	{
+		return timedSendN(msgs, n, numSent, Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Send several messages at once without blocking
+	 *
+	 * This method enqueues up to n messages into this queue under one lock acquisition.
+	 * If this queue is full, returns TimedOut immediately.
+	 *
+	 * @param msgs Pointer of array of messages to send
+	 * @param n Number of elements of msgs
+	 * @param[out] numSent Pointer of variable that stores the number of messages sent. If null pointer, not accessed
+	 * @retval OK Success. At least one message was sent
+	 * @retval TimedOut This queue is full
+	 * @retval InvalidParameter msgs is null pointer or n is zero
+	 *
+	 * @note Same as timedSendN(msgs, n, numSent, Timeout::POLLING)
+	 */
+	Error trySendN(const T* msgs, std::size_t n, std::size_t* numSent)
+	{
+		return timedSendN(msgs, n, numSent, Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Send several messages at once within the limited time
+	 *
+	 * This method enqueues up to n messages into this queue under one lock acquisition.
+	 * If this queue is full, block the current thread until to be dequeued by receive methods but only within the limited time.
+	 * After that, enqueues as many messages as this queue can store at that time.
+	 * The receivers are notified only once for all the messages sent.
+	 *
+	 * @param msgs Pointer of array of messages to send
+	 * @param n Number of elements of msgs
+	 * @param[out] numSent Pointer of variable that stores the number of messages sent. If null pointer, not accessed
+	 * @param tmout The limited time
+	 * @retval OK Success. At least one message was sent
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval InvalidParameter msgs is null pointer or n is zero
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval OtherError The current thread has reserved a slot by reserve methods
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to send the messages without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until has sent at least one message.
+	 * @note If the copy of a message throws an exception, the messages before it have been sent and numSent stores the number of them.
+	 */
+	Error timedSendN(const T* msgs, std::size_t n, std::size_t* numSent, Timeout tmout)
+	{
+		std::size_t sent = 0U;
+		const Error err = doTimedSendN(msgs, n, &sent, tmout);
+		if (numSent != 0) {
+			*numSent = sent;
+		}
+		return err;
+	}
+
+	/*!
+	 * @brief Receive several messages at once
+	 *
+	 * This method dequeues up to n messages from this queue under one lock acquisition.
+	 * If this queue is empty, block the current thread until to be enqueued by send methods.
+	 * After that, dequeues all the messages in this queue at that time but n messages at most.
+	 *
+	 * @param msgs Pointer of array that stores the messages received
+	 * @param n Number of elements of msgs
+	 * @param[out] numReceived Pointer of variable that stores the number of messages received. If null pointer, not accessed
+	 * @retval OK Success. At least one message was received
+	 * @retval InvalidParameter msgs is null pointer or n is zero
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedReceiveN(msgs, n, numReceived, Timeout::FOREVER)
+	 */
+	Error receiveN(T* msgs, std::size_t n, std::size_t* numReceived)
+	{
+		return timedReceiveN(msgs, n, numReceived, Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Receive several messages at once without blocking
+	 *
+	 * This method dequeues up to n messages from this queue under one lock acquisition.
+	 * If this queue is empty, returns TimedOut immediately.
+	 *
+	 * @param msgs Pointer of array that stores the messages received
+	 * @param n Number of elements of msgs
+	 * @param[out] numReceived Pointer of variable that stores the number of messages received. If null pointer, not accessed
+	 * @retval OK Success. At least one message was received
+	 * @retval TimedOut This queue is empty
+	 * @retval InvalidParameter msgs is null pointer or n is zero
+	 *
+	 * @note Same as timedReceiveN(msgs, n, numReceived, Timeout::POLLING)
+	 */
+	Error tryReceiveN(T* msgs, std::size_t n, std::size_t* numReceived)
+	{
+		return timedReceiveN(msgs, n, numReceived, Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Receive several messages at once within the limited time
+	 *
+	 * This method dequeues up to n messages from this queue under one lock acquisition.
+	 * If this queue is empty, block the current thread until to be enqueued by send methods but only within the limited time.
+	 * After that, dequeues all the messages in this queue at that time but n messages at most.
+	 * The senders are notified only once for all the messages received.
+	 *
+	 * @param msgs Pointer of array that stores the messages received
+	 * @param n Number of elements of msgs
+	 * @param[out] numReceived Pointer of variable that stores the number of messages received. If null pointer, not accessed
+	 * @param tmout The limited time
+	 * @retval OK Success. At least one message was received
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval InvalidParameter msgs is null pointer or n is zero
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval OtherError The current thread holds a message got by peek methods
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to receive the messages without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until has received at least one message.
+	 * @note If the copy of a message throws an exception, the messages before it have been received and numReceived stores the number of them.
+	 */
+	Error timedReceiveN(T* msgs, std::size_t n, std::size_t* numReceived, Timeout tmout)
+	{
+		std::size_t received = 0U;
+		const Error err = doTimedReceiveN(msgs, n, &received, tmout);
+		if (numReceived != 0) {
+			*numReceived = received;
+		}
+		return err;
+	}
+
+	/*!
+	 * @brief Reserve a slot to construct the message in place
+	 *
+	 * This method reserves the slot at the back of this queue and stores its address to *slot.
+	 * The caller constructs the message there by placement new, then calls commitSend().
+	 * So the message is not copied into this queue.
+	 * If this queue is full, block the current thread until to be dequeued by receive methods.
+	 *
+	 * @param[out] slot Pointer of variable that stores the address of uninitialized memory for one message of T
+	 * @retval OK Success. The slot was reserved
+	 * @retval InvalidParameter slot is null pointer
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedReserveSend(slot, Timeout::FOREVER)
+	 */
+	Error reserveSend(T** slot)
+	{
+		return timedReserveSend(slot, Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Reserve a slot to construct the message in place without blocking
+	 *
+	 * This method reserves the slot at the back of this queue and stores its address to *slot.
+	 * If this queue is full, returns TimedOut immediately.
+	 *
+	 * @param[out] slot Pointer of variable that stores the address of uninitialized memory for one message of T
+	 * @retval OK Success. The slot was reserved
+	 * @retval TimedOut This queue is full
+	 * @retval InvalidParameter slot is null pointer
+	 *
+	 * @note Same as timedReserveSend(slot, Timeout::POLLING)
+	 */
+	Error tryReserveSend(T** slot)
+	{
+		return timedReserveSend(slot, Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Reserve a slot to construct the message in place within the limited time
+	 *
+	 * This method reserves the slot at the back of this queue and stores its address to *slot.
+	 * The caller constructs the message there by placement new, then calls commitSend().
+	 * If the construction fails, the caller calls cancelSend() instead.
+	 * If this queue is full, block the current thread until to be dequeued by receive methods but only within the limited time.
+	 *
+	 * @param[out] slot Pointer of variable that stores the address of uninitialized memory for one message of T
+	 * @param tmout The limited time
+	 * @retval OK Success. The slot was reserved
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval InvalidParameter slot is null pointer
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval OtherError The current thread has reserved a slot by reserve methods
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to reserve the slot without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until has reserved the slot.
+	 * @attention While the slot is reserved, the other senders are blocked.
+	 *            The send methods called by the current thread return OtherError until it calls commitSend() or cancelSend().
+	 */
+	Error timedReserveSend(T** slot, Timeout tmout)
+	{
+		if (slot == 0) {
+			return InvalidParameter;
+		}
+		Error err = lockSend(tmout);
+		if (err != OK) {
+			return err;
+		}
+
+		if (isFull()) {
+			err = m_event->timedWait(EV_NOT_FULL, EventFlag::OR, 0, tmout);
+			if (err != OK) {
+				m_mtxSend->unlock();
+				return err;
+			}
+		}
+
+		*slot = reserve();
+		return OK;
+	}
+
+	/*!
+	 * @brief Send the message constructed in the slot reserved by reserve methods
+	 * @retval OK Success. The message was sent
+	 * @retval NotLocked No slot is reserved, or the slot was reserved by another thread
+	 */
+	Error commitSend()
+	{
+		if (!commit(true)) {
+			return NotLocked;
+		}
+		m_mtxSend->unlock();
+		return OK;
+	}
+
+	/*!
+	 * @brief Release the slot reserved by reserve methods without sending
+	 * @retval OK Success. The slot was released
+	 * @retval NotLocked No slot is reserved, or the slot was reserved by another thread
+	 *
+	 * @note The message must not be constructed in the slot, or must be destroyed by the caller before this method is called.
+	 */
+	Error cancelSend()
+	{
+		if (!commit(false)) {
+			return NotLocked;
+		}
+		m_mtxSend->unlock();
+		return OK;
+	}
+
+	/*!
+	 * @brief Get the message at the front of this queue without copying it
+	 *
+	 * This method stores the address of the message at the front of this queue to *msg.
+	 * The message stays in this queue until releaseReceive() is called, so the caller can process it in place.
+	 * If this queue is empty, block the current thread until to be enqueued by send methods.
+	 *
+	 * @param[out] msg Pointer of variable that stores the address of the message
+	 * @retval OK Success. The message is available
+	 * @retval InvalidParameter msg is null pointer
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedPeekReceive(msg, Timeout::FOREVER)
+	 */
+	Error peekReceive(T** msg)
+	{
+		return timedPeekReceive(msg, Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Get the message at the front of this queue without copying it and without blocking
+	 *
+	 * This method stores the address of the message at the front of this queue to *msg.
+	 * If this queue is empty, returns TimedOut immediately.
+	 *
+	 * @param[out] msg Pointer of variable that stores the address of the message
+	 * @retval OK Success. The message is available
+	 * @retval TimedOut This queue is empty
+	 * @retval InvalidParameter msg is null pointer
+	 *
+	 * @note Same as timedPeekReceive(msg, Timeout::POLLING)
+	 */
+	Error tryPeekReceive(T** msg)
+	{
+		return timedPeekReceive(msg, Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Get the message at the front of this queue without copying it within the limited time
+	 *
+	 * This method stores the address of the message at the front of this queue to *msg.
+	 * The message stays in this queue until releaseReceive() is called, so the caller can process it in place.
+	 * If this queue is empty, block the current thread until to be enqueued by send methods but only within the limited time.
+	 *
+	 * @param[out] msg Pointer of variable that stores the address of the message
+	 * @param tmout The limited time
+	 * @retval OK Success. The message is available
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval InvalidParameter msg is null pointer
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval OtherError The current thread holds a message got by peek methods
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to get the message without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until the message is available.
+	 * @attention While the message is held, the other receivers are blocked.
+	 *            The receive methods called by the current thread return OtherError until it calls releaseReceive().
+	 */
+	Error timedPeekReceive(T** msg, Timeout tmout)
+	{
+		if (msg == 0) {
+			return InvalidParameter;
+		}
+		Error err = lockRecv(tmout);
+		if (err != OK) {
+			return err;
+		}
+
+		if (isEmpty()) {
+			err = m_event->timedWait(EV_NOT_EMPTY, EventFlag::OR, 0, tmout);
+			if (err != OK) {
+				m_mtxRecv->unlock();
+				return err;
+			}
+		}
+
+		*msg = peek();
+		return OK;
+	}
+
+	/*!
+	 * @brief Destroy the message got by peek methods and dequeue it
+	 * @retval OK Success. The message was dequeued
+	 * @retval NotLocked No message is held, or the message is held by another thread
+	 */
+	Error releaseReceive()
+	{
+		if (!release()) {
+			return NotLocked;
+		}
+		m_mtxRecv->unlock();
+		return OK;
+	}
+
 	/*!
 	 * @brief Get the queue size
 	 * @return Queue size
@@ -272,6 +754,15 @@ private:
 		void construct(T* p, const T& val) { new(p) T(val); }
 		void destroy(T* p) { p->~T(); }
 
+#if (__cplusplus >= 201103L)
+		// Like std::move_if_noexcept() but for the assignment.
+		// A move-only type is moved even if its move assignment may throw.
+		typedef typename std::conditional<
+			!std::is_nothrow_move_assignable<T>::value && std::is_copy_assignable<T>::value,
+			const T&, T&&>::type MoveAssignRef;
+		static MoveAssignRef moveIfNoexcept(T& x) { return static_cast<MoveAssignRef>(x); }
+#endif
+
 		RingBuf(const RingBuf&);
 		RingBuf& operator=(const RingBuf&);
 	public:
@@ -311,8 +802,41 @@ private:
 		void pop(T* data)
 		{
 			if (data != 0) {
+#if (__cplusplus >= 201103L)
+				*data = moveIfNoexcept(m_buf[m_begin]);
+#else
 				*data = m_buf[m_begin];
+#endif
 			}
+			popFront();
+		}
+
+#if (__cplusplus >= 201103L)
+		template <typename... Args>
+		void emplace(Args&&... args)
+		{
+			new(&m_buf[m_end]) T(std::forward<Args>(args)...);
+			m_end = next_idx(m_end);
+		}
+#endif
+
+		void* back()
+		{
+			return &m_buf[m_end];
+		}
+
+		void pushBack()
+		{
+			m_end = next_idx(m_end);
+		}
+
+		T* front()
+		{
+			return &m_buf[m_begin];
+		}
+
+		void popFront()
+		{
 			destroy(&m_buf[m_begin]);
 			m_begin = next_idx(m_begin);
 		}
@@ -320,17 +844,41 @@ private:
 	};
 	RingBuf m_rb;
 
+	class NotifyGuard {
+	private:
+		EventFlag* m_event;
+		EventFlag::Pattern m_pattern;
+		const std::size_t* m_count;
+
+		NotifyGuard(const NotifyGuard&);
+		NotifyGuard& operator=(const NotifyGuard&);
+	public:
+		NotifyGuard(EventFlag* event, EventFlag::Pattern pattern, const std::size_t* count)
+		: m_event(event), m_pattern(pattern), m_count(count) {}
+		~NotifyGuard()
+		{
+			if (*m_count != 0U) {
+				m_event->set(m_pattern);
+			}
+		}
+	};
+
 	FixedMemoryPool* m_pool;
 	Mutex* m_mtxRB;
 	Mutex* m_mtxSend;
 	Mutex* m_mtxRecv;
 	EventFlag* m_event;
+	bool m_sendReserved;
+	bool m_recvPeeked;
+	Thread* m_sendOwner;
+	Thread* m_recvOwner;
 
 	static const EventFlag::Pattern EV_NOT_EMPTY;
 	static const EventFlag::Pattern EV_NOT_FULL;
 
 	MessageQueue(FixedMemoryPool* pool, T* rbBuffer, std::size_t rbBufSize)
 	: m_rb(rbBuffer, rbBufSize), m_pool(pool), m_mtxRB(0), m_mtxSend(0), m_mtxRecv(0), m_event(0)
+	, m_sendReserved(false), m_recvPeeked(false), m_sendOwner(0), m_recvOwner(0)
 	{
 	}
 
@@ -344,7 +892,7 @@ private:
 
 	bool createOSObjects()
 	{
-		m_mtxRB = Mutex::create();
+		m_mtxRB = Mutex::createNonRecursive();
 		if (m_mtxRB == 0) {
 			return false;
 		}
@@ -397,6 +945,203 @@ private:
 		m_event->set(EV_NOT_FULL);
 	}
 
+#if (__cplusplus >= 201103L)
+	template <typename... Args>
+	void emplace(Args&&... args)
+	{
+		LockGuard lock(m_mtxRB);
+		m_rb.emplace(std::forward<Args>(args)...);
+		m_event->set(EV_NOT_EMPTY);
+	}
+#endif
+
+	// m_mtxSend is recursive, so the thread that has reserved a slot can lock it again.
+	// The send methods fail for that thread instead of writing to the reserved slot.
+	Error lockSend(Timeout tmout)
+	{
+		const Error err = m_mtxSend->timedLock(tmout);
+		if (err != OK) {
+			return err;
+		}
+		if (isSendReserved()) {
+			m_mtxSend->unlock();
+			return OtherError;
+		}
+		return OK;
+	}
+
+	Error lockRecv(Timeout tmout)
+	{
+		const Error err = m_mtxRecv->timedLock(tmout);
+		if (err != OK) {
+			return err;
+		}
+		if (isRecvPeeked()) {
+			m_mtxRecv->unlock();
+			return OtherError;
+		}
+		return OK;
+	}
+
+	bool isSendReserved() const
+	{
+		LockGuard lock(m_mtxRB);
+		return m_sendReserved;
+	}
+
+	bool isRecvPeeked() const
+	{
+		LockGuard lock(m_mtxRB);
+		return m_recvPeeked;
+	}
+
+	// The reserved slot is not counted by getSize() until it is committed,
+	// so the receivers do not access it while the sender constructs the message.
+	T* reserve()
+	{
+		Thread* owner = Thread::getCurrentThread();
+		LockGuard lock(m_mtxRB);
+		m_sendReserved = true;
+		m_sendOwner = owner;
+		return static_cast<T*>(m_rb.back());
+	}
+
+	// Only the thread that reserved the slot locks m_mtxSend, so the other threads must not unlock it
+	bool commit(bool send)
+	{
+		Thread* current = Thread::getCurrentThread();
+		LockGuard lock(m_mtxRB);
+		if (!m_sendReserved || (m_sendOwner != current)) {
+			return false;
+		}
+		m_sendReserved = false;
+		m_sendOwner = 0;
+		if (send) {
+			m_rb.pushBack();
+			m_event->set(EV_NOT_EMPTY);
+		}
+		return true;
+	}
+
+	T* peek()
+	{
+		Thread* owner = Thread::getCurrentThread();
+		LockGuard lock(m_mtxRB);
+		m_recvPeeked = true;
+		m_recvOwner = owner;
+		return m_rb.front();
+	}
+
+	bool release()
+	{
+		Thread* current = Thread::getCurrentThread();
+		LockGuard lock(m_mtxRB);
+		if (!m_recvPeeked || (m_recvOwner != current)) {
+			return false;
+		}
+		m_recvPeeked = false;
+		m_recvOwner = 0;
+		m_rb.popFront();
+		m_event->set(EV_NOT_FULL);
+		return true;
+	}
+
+	Error doTimedSendN(const T* msgs, std::size_t n, std::size_t* numSent, Timeout tmout)
+	{
+		if ((msgs == 0) || (n == 0U)) {
+			return InvalidParameter;
+		}
+		Error err = lockSend(tmout);
+		if (err != OK) {
+			return err;
+		}
+		LockGuard lock(m_mtxSend, LockGuard::ADOPT_LOCK);
+
+		if (isFull()) {
+			err = m_event->timedWait(EV_NOT_FULL, EventFlag::OR, 0, tmout);
+			if (err != OK) {
+				return err;
+			}
+		}
+
+		err = OK;
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			pushN(msgs, n, numSent);
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (const Assertion::Failure&) {
+			throw;
+		}
+		catch (...) {
+			err = OtherError;
+		}
+#endif
+		return err;
+	}
+
+	Error doTimedReceiveN(T* msgs, std::size_t n, std::size_t* numReceived, Timeout tmout)
+	{
+		if ((msgs == 0) || (n == 0U)) {
+			return InvalidParameter;
+		}
+		Error err = lockRecv(tmout);
+		if (err != OK) {
+			return err;
+		}
+		LockGuard lock(m_mtxRecv, LockGuard::ADOPT_LOCK);
+
+		if (isEmpty()) {
+			err = m_event->timedWait(EV_NOT_EMPTY, EventFlag::OR, 0, tmout);
+			if (err != OK) {
+				return err;
+			}
+		}
+
+		err = OK;
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			popN(msgs, n, numReceived);
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (const Assertion::Failure&) {
+			throw;
+		}
+		catch (...) {
+			err = OtherError;
+		}
+#endif
+		return err;
+	}
+
+	// The messages are moved under one lock of m_mtxRB and the other side is notified only once.
+	// *count is updated for each message so that it is correct even if the copy of a message throws an exception.
+	void pushN(const T* msgs, std::size_t n, std::size_t* count)
+	{
+		LockGuard lock(m_mtxRB);
+		const std::size_t space = m_rb.getMaxSize() - m_rb.getSize();
+		const std::size_t num = (n < space) ? n : space;
+		const NotifyGuard notify(m_event, EV_NOT_EMPTY, count);
+		for (std::size_t i = 0U; i < num; i++) {
+			m_rb.push(msgs[i]);
+			(*count)++;
+		}
+	}
+
+	void popN(T* msgs, std::size_t n, std::size_t* count)
+	{
+		LockGuard lock(m_mtxRB);
+		const std::size_t size = m_rb.getSize();
+		const std::size_t num = (n < size) ? n : size;
+		const NotifyGuard notify(m_event, EV_NOT_FULL, count);
+		for (std::size_t i = 0U; i < num; i++) {
+			m_rb.pop(&msgs[i]);
+			(*count)++;
+		}
+	}
+
 	MessageQueue(const MessageQueue&);
 	MessageQueue& operator=(const MessageQueue&);
 };
@@ -23,6 +23,12 @@ Mutex* Mutex::create(int priorityCeiling)
 	return s_factory->create(priorityCeiling);
 }
 
+Mutex* Mutex::createNonRecursive()
+{
+	CHECK_ASSERT(s_factory);
+	return s_factory->createNonRecursive();
+}
+
 void Mutex::destroy(Mutex* m)
 {
 	if ((s_factory != 0) && (m != 0)) {
@@ -41,6 +41,17 @@ public:
 	 */
 	static Mutex* create(int priorityCeiling);
 
+	/*!
+	 * @brief Create a Mutex object that is not locked recursively
+	 * @return If this method succeeds then returns a pointer of Mutex object, else returns null pointer
+	 *
+	 * The mutex may be lighter than the mutex created by create().
+	 * The current thread must not lock the mutex again while it locks the mutex.
+	 *
+	 * @note If the platform does not have such a mutex, same as create().
+	 */
+	static Mutex* createNonRecursive();
+
 	/*!
 	 * @brief Destroy a Mutex object
 	 * @param m Pointer of Mutex object created by Mutex::create()
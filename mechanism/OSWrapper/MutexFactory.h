@@ -10,6 +10,10 @@ public:
 	virtual ~MutexFactory() {}
 	virtual Mutex* create() = 0;
 	virtual Mutex* create(int priorityCeiling) = 0;
+	virtual Mutex* createNonRecursive()
+	{
+		return create();
+	}
 	virtual void destroy(Mutex* m) = 0;
 };
 
@@ -16,6 +16,9 @@ void registerOneShotTimerFactory(OneShotTimerFactory* factory);
 
 /*!
  * @brief Abstract class that has functions of common RTOS's one-shot timer
+ *
+ * @note Depending on the platform, all the timers share one thread that calls Runnable::run() of the expired timers one by one
+ *       (e.g. StdCppOSWrapper and PosixOSWrapper). So Runnable::run() must not block, or the other timers are delayed.
  */
 class OneShotTimer {
 protected:
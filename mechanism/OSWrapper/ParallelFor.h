@@ -0,0 +1,351 @@
+#ifndef OS_WRAPPER_PARALLEL_FOR_H_INCLUDED
+#define OS_WRAPPER_PARALLEL_FOR_H_INCLUDED
+
+#include <cstddef>
+#include "OSWrapperError.h"
+#include "Runnable.h"
+#include "Mutex.h"
+#include "ThreadPool.h"
+
+namespace OSWrapper {
+
+/*!
+ * @brief Class template of an index range shared by the caller of parallelFor() or parallelReduce() and the tasks started on a ThreadPool
+ * @tparam Job Type that processes the chunks of the range
+ *
+ * The caller and the tasks take chunks from the front of the range until the range becomes empty.
+ * The size of a chunk is half of the remaining indices divided by the number of participants, and not less than the grain size.
+ * So the first chunks are large and the last chunks are small, and a participant that finishes early takes the rest of the work.
+ *
+ * Job must have the following members.
+ * - typedef Partial : Type of the partial result of a participant
+ * - Partial identity() const : The initial partial result
+ * - void runChunk(std::size_t begin, std::size_t end, Partial* partial) const : Process the indices [begin, end)
+ * - void join(const Partial& partial) : Merge the partial result. This is called with the Mutex locked.
+ *
+ * If a participant exits run() by an exception, its chunk and partial result are lost.
+ * The range records it, and execute() returns OtherError after all the participants have finished.
+ *
+ * @note This class template is used by parallelFor() and parallelReduce(). You don't have to use this directly.
+ */
+template <typename Job>
+class ParallelRange : public Runnable {
+public:
+	/*!
+	 * @brief Max number of tasks started on a ThreadPool by one call
+	 */
+	static const std::size_t MAX_HELPERS = 16U;
+
+	/*!
+	 * @brief Process the range by the current thread and the free threads of \p pool
+	 * @param pool ThreadPool that runs the tasks
+	 * @param begin The first index
+	 * @param end The index next to the last
+	 * @param grainSize Min number of indices in a chunk. If zero, 1 is used.
+	 * @param job Job object
+	 * @retval OK Success. All the indices have been processed
+	 * @retval InvalidParameter \p pool is null pointer
+	 * @retval OtherError A task started on \p pool exited by an exception. Some indices may not have been processed.
+	 */
+	static Error execute(ThreadPool* pool, std::size_t begin, std::size_t end, std::size_t grainSize, Job* job)
+	{
+		if (pool == 0) {
+			return InvalidParameter;
+		}
+		if (begin >= end) {
+			return OK;
+		}
+		if (grainSize == 0U) {
+			grainSize = 1U;
+		}
+
+		const std::size_t numChunks = (end - begin - 1U) / grainSize + 1U;
+		std::size_t numHelpers = pool->getMaxThreads();
+		if (numHelpers > numChunks - 1U) {
+			numHelpers = numChunks - 1U;
+		}
+		if (numHelpers > MAX_HELPERS) {
+			numHelpers = MAX_HELPERS;
+		}
+		Mutex* mtx = 0;
+		if (numHelpers > 0U) {
+			mtx = Mutex::create();
+			if (mtx == 0) {
+				// Process all the range by the current thread
+				numHelpers = 0U;
+			}
+		}
+
+		ParallelRange range(job, begin, end, grainSize, numHelpers + 1U, mtx);
+		{
+			// The destructors wait for the tasks finished even if an exception is thrown by the job
+			ThreadPool::WaitGuard waiters[MAX_HELPERS];
+			for (std::size_t i = 0U; i < numHelpers; i++) {
+				// The task is not queued behind the other tasks of the pool, and the queued tasks are not discarded
+				if (pool->tryStartOnIdleThread(&range, &waiters[i]) != OK) {
+					break;
+				}
+			}
+			range.run();
+		}
+		if (range.m_failed) {
+			return OtherError;
+		}
+		return OK;
+	}
+
+	/*!
+	 * @brief Take the chunks and process them until the range becomes empty
+	 *
+	 * This method is called concurrently by the caller and the tasks.
+	 */
+	void run()
+	{
+		FailureGuard guard(this);
+		typename Job::Partial partial = m_job->identity();
+		std::size_t chunkBegin = 0U;
+		std::size_t chunkEnd = 0U;
+		while (take(&chunkBegin, &chunkEnd)) {
+			m_job->runChunk(chunkBegin, chunkEnd, &partial);
+		}
+		if (m_mtx != 0) {
+			LockGuard lock(m_mtx);
+			m_job->join(partial);
+		} else {
+			m_job->join(partial);
+		}
+		guard.dismiss();
+	}
+
+private:
+	// Records the failure if run() is exited by an exception
+	class FailureGuard {
+	public:
+		explicit FailureGuard(ParallelRange* range) : m_range(range) {}
+		~FailureGuard()
+		{
+			if (m_range != 0) {
+				m_range->setFailed();
+			}
+		}
+		void dismiss() { m_range = 0; }
+	private:
+		ParallelRange* m_range;
+
+		FailureGuard(const FailureGuard&);
+		FailureGuard& operator=(const FailureGuard&);
+	};
+	friend class FailureGuard;
+
+	Job* m_job;
+	std::size_t m_next;
+	const std::size_t m_end;
+	const std::size_t m_grainSize;
+	const std::size_t m_numParticipants;
+	Mutex* m_mtx;
+	bool m_failed;
+
+	ParallelRange(Job* job, std::size_t begin, std::size_t end, std::size_t grainSize, std::size_t numParticipants, Mutex* mtx)
+	: m_job(job), m_next(begin), m_end(end), m_grainSize(grainSize), m_numParticipants(numParticipants), m_mtx(mtx), m_failed(false)
+	{
+	}
+
+	~ParallelRange()
+	{
+		Mutex::destroy(m_mtx);
+	}
+
+	void setFailed()
+	{
+		if (m_mtx != 0) {
+			LockGuard lock(m_mtx);
+			m_failed = true;
+		} else {
+			m_failed = true;
+		}
+	}
+
+	bool take(std::size_t* chunkBegin, std::size_t* chunkEnd)
+	{
+		if (m_mtx != 0) {
+			LockGuard lock(m_mtx);
+			return takeChunk(chunkBegin, chunkEnd);
+		}
+		return takeChunk(chunkBegin, chunkEnd);
+	}
+
+	bool takeChunk(std::size_t* chunkBegin, std::size_t* chunkEnd)
+	{
+		const std::size_t remaining = m_end - m_next;
+		if (remaining == 0U) {
+			return false;
+		}
+		std::size_t size = remaining;
+		if (m_numParticipants > 1U) {
+			size = remaining / (2U * m_numParticipants);
+			if (size < m_grainSize) {
+				size = m_grainSize;
+			}
+			if (size > remaining) {
+				size = remaining;
+			}
+		}
+		*chunkBegin = m_next;
+		m_next += size;
+		*chunkEnd = m_next;
+		return true;
+	}
+
+	ParallelRange(const ParallelRange&);
+	ParallelRange& operator=(const ParallelRange&);
+};
+
+/*!
+ * @brief Job of parallelFor()
+ * @tparam Body Type of function object
+ *
+ * @note This class template is used by parallelFor(). You don't have to use this directly.
+ */
+template <typename Body>
+class ParallelForJob {
+public:
+	typedef bool Partial;
+
+	explicit ParallelForJob(const Body& body) : m_body(body) {}
+
+	Partial identity() const
+	{
+		return false;
+	}
+
+	void runChunk(std::size_t begin, std::size_t end, Partial*) const
+	{
+		m_body(begin, end);
+	}
+
+	void join(const Partial&)
+	{
+	}
+
+private:
+	const Body& m_body;
+
+	ParallelForJob(const ParallelForJob&);
+	ParallelForJob& operator=(const ParallelForJob&);
+};
+
+/*!
+ * @brief Job of parallelReduce()
+ * @tparam T Type of the result
+ * @tparam Body Type of function object that processes a chunk
+ * @tparam Reduction Type of function object that merges two results
+ *
+ * @note This class template is used by parallelReduce(). You don't have to use this directly.
+ */
+template <typename T, typename Body, typename Reduction>
+class ParallelReduceJob {
+public:
+	typedef T Partial;
+
+	ParallelReduceJob(const T& identity, const Body& body, const Reduction& reduction)
+	: m_identity(identity), m_body(body), m_reduction(reduction), m_result(identity) {}
+
+	Partial identity() const
+	{
+		return m_identity;
+	}
+
+	void runChunk(std::size_t begin, std::size_t end, Partial* partial) const
+	{
+		*partial = m_body(begin, end, *partial);
+	}
+
+	void join(const Partial& partial)
+	{
+		m_result = m_reduction(m_result, partial);
+	}
+
+	const T& getResult() const
+	{
+		return m_result;
+	}
+
+private:
+	const T& m_identity;
+	const Body& m_body;
+	const Reduction& m_reduction;
+	T m_result;
+
+	ParallelReduceJob(const ParallelReduceJob&);
+	ParallelReduceJob& operator=(const ParallelReduceJob&);
+};
+
+/*!
+ * @brief Call \p body for the chunks of the index range [begin, end) in parallel
+ * @tparam Body Type of function object
+ * @param pool ThreadPool that runs the chunks in addition to the current thread
+ * @param begin The first index
+ * @param end The index next to the last
+ * @param grainSize Min number of indices in a chunk. If zero, 1 is used.
+ * @param body Function object that is called as body(chunkBegin, chunkEnd) with std::size_t arguments. It must be safe to call concurrently.
+ * @retval OK Success. All the indices have been processed
+ * @retval InvalidParameter \p pool is null pointer
+ * @retval OtherError \p body threw an exception in a task started on \p pool. Some indices may not have been processed.
+ *
+ * The current thread processes the chunks too, and returns after all the chunks have finished.
+ * Tasks are started only while the ThreadPool has free threads, so this method does not wait for a busy ThreadPool.
+ * The OverflowPolicy of the ThreadPool is not applied, so the queued tasks of the ThreadPool are not discarded.
+ * The chunk size adapts to the number of participants. See ParallelRange.
+ *
+ * @note If \p body throws an exception in the current thread, the exception is propagated after the started tasks finished.
+ * @note An exception thrown in a task is handled by the UncaughtExceptionHandler of \p pool, and then this method returns OtherError.
+ * @note Do not call this method from a task of \p pool if \p pool has a task queue (createQueued(), createPriorityQueued() or createWorkStealing()). All the threads may wait for the queued tasks.
+ */
+template <typename Body>
+Error parallelFor(ThreadPool* pool, std::size_t begin, std::size_t end, std::size_t grainSize, const Body& body)
+{
+	ParallelForJob<Body> job(body);
+	return ParallelRange<ParallelForJob<Body> >::execute(pool, begin, end, grainSize, &job);
+}
+
+/*!
+ * @brief Reduce the index range [begin, end) in parallel
+ * @tparam T Type of the result
+ * @tparam Body Type of function object that processes a chunk
+ * @tparam Reduction Type of function object that merges two results
+ * @param pool ThreadPool that runs the chunks in addition to the current thread
+ * @param begin The first index
+ * @param end The index next to the last
+ * @param grainSize Min number of indices in a chunk. If zero, 1 is used.
+ * @param identity Identity value of \p reduction
+ * @param body Function object that is called as body(chunkBegin, chunkEnd, partial) and returns \p partial merged with the result of the chunk. It must be safe to call concurrently.
+ * @param reduction Function object that is called as reduction(a, b) and returns the merged result of \p a and \p b. It must be associative and commutative.
+ * @param[out] result Pointer of the variable that receives the result. If [begin, end) is empty, \p identity is set.
+ * @retval OK Success. All the indices have been processed
+ * @retval InvalidParameter \p pool or \p result is null pointer
+ * @retval OtherError \p body or \p reduction threw an exception in a task started on \p pool. \p result is not set.
+ *
+ * Each participant merges the chunks it processed into its own partial result, starting from \p identity.
+ * Then the partial results are merged by \p reduction.
+ *
+ * @note The notes of parallelFor() apply to this method too.
+ */
+template <typename T, typename Body, typename Reduction>
+Error parallelReduce(ThreadPool* pool, std::size_t begin, std::size_t end, std::size_t grainSize,
+		const T& identity, const Body& body, const Reduction& reduction, T* result)
+{
+	if (result == 0) {
+		return InvalidParameter;
+	}
+	ParallelReduceJob<T, Body, Reduction> job(identity, body, reduction);
+	const Error err = ParallelRange<ParallelReduceJob<T, Body, Reduction> >::execute(pool, begin, end, grainSize, &job);
+	if (err != OK) {
+		return err;
+	}
+	*result = job.getResult();
+	return OK;
+}
+
+}
+
+#endif // OS_WRAPPER_PARALLEL_FOR_H_INCLUDED
@@ -81,6 +81,74 @@ void PeriodicTimer::timerMain()
 #endif
 }
 
+/*!
+ * @brief Notify the OverrunHandler of the missed periods
+ * @param missedPeriods Number of the missed periods
+ * @note Called in the concrete class derived from PeriodicTimer.
+ */
+void PeriodicTimer::reportOverrun(unsigned long missedPeriods)
+{
+	if ((m_overrunHandler == 0) || (missedPeriods == 0U)) {
+		return;
+	}
+#ifndef CPPELIB_NO_EXCEPTIONS
+	try {
+#endif
+		m_overrunHandler->handle(this, missedPeriods);
+#ifndef CPPELIB_NO_EXCEPTIONS
+	}
+	catch (...) {
+		// ignore exception
+	}
+#endif
+}
+
+Error PeriodicTimer::setScheduleMode(ScheduleMode mode, OverrunPolicy policy/*= SKIP*/)
+{
+	(void) mode;
+	(void) policy;
+	return OtherError;
+}
+
+void PeriodicTimer::setOverrunHandler(PeriodicTimer::OverrunHandler* handler)
+{
+	m_overrunHandler = handler;
+}
+
+PeriodicTimer::OverrunHandler* PeriodicTimer::getOverrunHandler() const
+{
+	return m_overrunHandler;
+}
+
+unsigned long PeriodicTimer::getPeriodInMicros() const
+{
+	return getPeriodInMillis() * 1000UL;
+}
+
+unsigned long PeriodicTimer::getNumberOfExpirations() const
+{
+	return 0UL;
+}
+
+unsigned long PeriodicTimer::getNumberOfOverruns() const
+{
+	return 0UL;
+}
+
+unsigned long PeriodicTimer::getMaxJitterInMicros() const
+{
+	return 0UL;
+}
+
+unsigned long PeriodicTimer::getAverageJitterInMicros() const
+{
+	return 0UL;
+}
+
+void PeriodicTimer::resetStatistics()
+{
+}
+
 PeriodicTimer* PeriodicTimer::create(Runnable* r, unsigned long periodInMillis, const char* name/*= ""*/)
 {
 	CHECK_ASSERT(s_factory);
@@ -93,6 +161,18 @@ PeriodicTimer* PeriodicTimer::create(Runnable* r, unsigned long periodInMillis,
 	return s_factory->create(r, periodInMillis, name);
 }
 
+PeriodicTimer* PeriodicTimer::createInMicros(Runnable* r, unsigned long periodInMicros, const char* name/*= ""*/)
+{
+	CHECK_ASSERT(s_factory);
+	if (r == 0) {
+		return 0;
+	}
+	if (periodInMicros == 0U) {
+		return 0;
+	}
+	return s_factory->createInMicros(r, periodInMicros, name);
+}
+
 void PeriodicTimer::destroy(PeriodicTimer* t)
 {
 	if ((s_factory != 0) && (t != 0)) {
@@ -1,6 +1,8 @@
 #ifndef OS_WRAPPER_PERIODIC_TIMER_H_INCLUDED
 #define OS_WRAPPER_PERIODIC_TIMER_H_INCLUDED
 
+#include "OSWrapperError.h"
+
 namespace OSWrapper {
 
 class Runnable;
@@ -16,14 +18,18 @@ void registerPeriodicTimerFactory(PeriodicTimerFactory* factory);
 
 /*!
  * @brief Abstract class that has functions of common RTOS's periodic timer
+ *
+ * @note Depending on the platform, all the timers share one thread that calls Runnable::run() of the expired timers one by one
+ *       (e.g. StdCppOSWrapper and PosixOSWrapper). So Runnable::run() must not block. A blocking run() delays all the other timers and causes their overruns.
  */
 class PeriodicTimer {
 protected:
 	explicit PeriodicTimer(Runnable* r)
-	: m_runnable(r), m_uncaughtExceptionHandler(0) {}
+	: m_runnable(r), m_uncaughtExceptionHandler(0), m_overrunHandler(0) {}
 	virtual ~PeriodicTimer() {}
 
 	void timerMain();
+	void reportOverrun(unsigned long missedPeriods);
 
 public:
 	/*!
@@ -44,6 +50,44 @@ public:
 		virtual void handle(PeriodicTimer* t, const char* msg) = 0;
 	};
 
+	/*!
+	 * @brief Interface for handling the overrun of the absolute schedule
+	 *
+	 * If the schedule mode is ABSOLUTE_SCHEDULE and the overrun policy is REPORT,
+	 * the class that implements this interface is notified of the missed periods.
+	 */
+	class OverrunHandler {
+	public:
+		virtual ~OverrunHandler() {}
+		/*!
+		 * @brief Handle the overrun of the PeriodicTimer
+		 * @param t Pointer of PeriodicTimer object that missed the periods
+		 * @param missedPeriods Number of the periods skipped since the previous Runnable::run()
+		 *
+		 * @note Called in the timer context just before Runnable::run().
+		 */
+		virtual void handle(PeriodicTimer* t, unsigned long missedPeriods) = 0;
+	};
+
+	/*!
+	 * @brief How the timer schedules the next period
+	 */
+	enum ScheduleMode {
+		RELATIVE_SCHEDULE, //!< The next period starts when Runnable::run() returns. The execution time of Runnable::run() accumulates as drift.
+		ABSOLUTE_SCHEDULE  //!< The periods are on the time grid of start() + N * period. The execution time of Runnable::run() does not drift the timer.
+	};
+
+	/*!
+	 * @brief What the timer does when the deadlines of the absolute schedule have already passed
+	 *
+	 * The deadlines pass if Runnable::run() takes longer than the period or the timer is delayed.
+	 */
+	enum OverrunPolicy {
+		SKIP,     //!< Skip the missed periods and continue from the next deadline on the time grid
+		CATCH_UP, //!< Call Runnable::run() for each missed period back to back
+		REPORT    //!< Same as SKIP, and call OverrunHandler with the number of the missed periods
+	};
+
 	/*!
 	 * @brief Set the default UncaughtExceptionHandler for all the PeriodicTimer
 	 * @param handler Pointer of UncaughtExceptionHandler object
@@ -67,6 +111,17 @@ public:
 	 */
 	static PeriodicTimer* create(Runnable* r, unsigned long periodInMillis, const char* name = "");
 
+	/*!
+	 * @brief Create a PeriodicTimer object with the period in microseconds
+	 * @param r Pointer of Runnable object
+	 * @param periodInMicros Timer period in microseconds
+	 * @param name Name of the object
+	 * @return If this method succeeds then returns a pointer of PeriodicTimer object, else returns null pointer
+	 * @note Created PeriodicTimer object is stopped. You need to call start() for the PeriodicTimer object.
+	 * @note If the concrete class does not support the period in microseconds, this method returns null pointer.
+	 */
+	static PeriodicTimer* createInMicros(Runnable* r, unsigned long periodInMicros, const char* name = "");
+
 	/*!
 	 * @brief Destroy a PeriodicTimer object
 	 * @param t Pointer of PeriodicTimer object created by PeriodicTimer::create()
@@ -103,9 +158,18 @@ public:
 	/*!
 	 * @brief Get the timer period (in milliseconds)
 	 * @return Timer period (in milliseconds)
+	 * @note If the timer is created by createInMicros(), the period is rounded up to milliseconds.
 	 */
 	virtual unsigned long getPeriodInMillis() const = 0;
 
+	/*!
+	 * @brief Get the timer period (in microseconds)
+	 * @return Timer period (in microseconds)
+	 *
+	 * @note If the concrete class does not implement this method, this method returns getPeriodInMillis() * 1000
+	 */
+	virtual unsigned long getPeriodInMicros() const;
+
 	/*!
 	 * @brief Set the object's name
 	 * @param name The object's name
@@ -133,9 +197,76 @@ public:
 	 */
 	UncaughtExceptionHandler* getUncaughtExceptionHandler() const;
 
+	/*!
+	 * @brief Set the schedule mode and the overrun policy of this PeriodicTimer
+	 * @param mode Schedule mode
+	 * @param policy Overrun policy. It is used only if mode is ABSOLUTE_SCHEDULE.
+	 * @retval OK Success
+	 * @retval InvalidParameter Parameter mode or policy is invalid
+	 * @retval OtherError Not implemented in concrete class
+	 *
+	 * @note The default schedule mode is RELATIVE_SCHEDULE.
+	 * @note If the timer is started, the new schedule mode is applied from the next period.
+	 */
+	virtual Error setScheduleMode(ScheduleMode mode, OverrunPolicy policy = SKIP);
+
+	/*!
+	 * @brief Set the OverrunHandler for this PeriodicTimer
+	 * @param handler Pointer of OverrunHandler object
+	 */
+	void setOverrunHandler(OverrunHandler* handler);
+
+	/*!
+	 * @brief Get the OverrunHandler for this PeriodicTimer
+	 * @return The OverrunHandler object
+	 */
+	OverrunHandler* getOverrunHandler() const;
+
+	/*!
+	 * @brief Get the number of the calls of Runnable::run() since the statistics was reset
+	 * @return Number of the calls of Runnable::run()
+	 *
+	 * @note If the concrete class does not implement this method, this method returns 0
+	 */
+	virtual unsigned long getNumberOfExpirations() const;
+
+	/*!
+	 * @brief Get the number of the deadlines that had passed before the timer scheduled them
+	 * @return Number of the overruns
+	 *
+	 * Only ABSOLUTE_SCHEDULE mode counts the overruns.
+	 *
+	 * @note If the concrete class does not implement this method, this method returns 0
+	 */
+	virtual unsigned long getNumberOfOverruns() const;
+
+	/*!
+	 * @brief Get the max jitter (in microseconds)
+	 * @return Max delay of the call of Runnable::run() from its scheduled time (in microseconds)
+	 *
+	 * @note If the concrete class does not implement this method, this method returns 0
+	 */
+	virtual unsigned long getMaxJitterInMicros() const;
+
+	/*!
+	 * @brief Get the average jitter (in microseconds)
+	 * @return Average delay of the call of Runnable::run() from its scheduled time (in microseconds)
+	 *
+	 * @note If the concrete class does not implement this method, this method returns 0
+	 */
+	virtual unsigned long getAverageJitterInMicros() const;
+
+	/*!
+	 * @brief Reset the number of the expirations, the number of the overruns and the jitter
+	 *
+	 * @note If the concrete class does not implement this method, do nothing
+	 */
+	virtual void resetStatistics();
+
 private:
 	Runnable* m_runnable;
 	UncaughtExceptionHandler* m_uncaughtExceptionHandler;
+	OverrunHandler* m_overrunHandler;
 	static UncaughtExceptionHandler* m_defaultUncaughtExceptionHandler;
 
 	void handleException(const char* msg);
@@ -11,6 +11,13 @@ public:
 	virtual ~PeriodicTimerFactory() {}
 	virtual PeriodicTimer* create(Runnable* r, unsigned long periodInMillis, const char* name) = 0;
 	virtual void destroy(PeriodicTimer* t) = 0;
+	virtual PeriodicTimer* createInMicros(Runnable* r, unsigned long periodInMicros, const char* name)
+	{
+		(void) r;
+		(void) periodInMicros;
+		(void) name;
+		return 0;
+	}
 };
 
 }
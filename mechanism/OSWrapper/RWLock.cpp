@@ -0,0 +1,79 @@
+#include "RWLock.h"
+#include "RWLockFactory.h"
+#include "Assertion/Assertion.h"
+
+namespace OSWrapper {
+
+static RWLockFactory* s_factory = 0;
+
+void registerRWLockFactory(RWLockFactory* factory)
+{
+	s_factory = factory;
+}
+
+RWLock* RWLock::create(bool writerPreference)
+{
+	CHECK_ASSERT(s_factory);
+	return s_factory->create(writerPreference);
+}
+
+void RWLock::destroy(RWLock* l)
+{
+	if ((s_factory != 0) && (l != 0)) {
+		s_factory->destroy(l);
+	}
+}
+
+
+ReadLockGuard::ReadLockGuard(RWLock* l)
+: m_lock(l), m_lockErr(OtherError)
+{
+	if (m_lock != 0) {
+		m_lockErr = m_lock->readLock();
+	}
+}
+
+const ReadLockGuard::AdoptLock ReadLockGuard::ADOPT_LOCK;
+
+ReadLockGuard::ReadLockGuard(RWLock* l, AdoptLock adoptLock)
+: m_lock(l), m_lockErr(OK)
+{
+	(void)adoptLock;
+}
+
+ReadLockGuard::~ReadLockGuard()
+{
+	if (m_lock != 0) {
+		if (m_lockErr == OK) {
+			m_lock->readUnlock();
+		}
+	}
+}
+
+
+WriteLockGuard::WriteLockGuard(RWLock* l)
+: m_lock(l), m_lockErr(OtherError)
+{
+	if (m_lock != 0) {
+		m_lockErr = m_lock->writeLock();
+	}
+}
+
+const WriteLockGuard::AdoptLock WriteLockGuard::ADOPT_LOCK;
+
+WriteLockGuard::WriteLockGuard(RWLock* l, AdoptLock adoptLock)
+: m_lock(l), m_lockErr(OK)
+{
+	(void)adoptLock;
+}
+
+WriteLockGuard::~WriteLockGuard()
+{
+	if (m_lock != 0) {
+		if (m_lockErr == OK) {
+			m_lock->writeUnlock();
+		}
+	}
+}
+
+}
@@ -0,0 +1,214 @@
+#ifndef OS_WRAPPER_RW_LOCK_H_INCLUDED
+#define OS_WRAPPER_RW_LOCK_H_INCLUDED
+
+#include "Timeout.h"
+#include "OSWrapperError.h"
+
+namespace OSWrapper {
+
+class RWLockFactory;
+
+/*!
+ * @brief Register the RWLockFactory
+ * @param factory Pointer of the object of the concrete class derived from RWLockFactory
+ *
+ * @note You need to call this function only one time when the application is initialized.
+ */
+void registerRWLockFactory(RWLockFactory* factory);
+
+/*!
+ * @brief Abstract class of reader-writer lock
+ *
+ * Many threads can lock this lock for reading at the same time,
+ * but only one thread can lock it for writing and then no thread can lock it for reading.
+ *
+ * The lock is not recursive.
+ * The current thread must not lock it again while it locks it for reading or writing.
+ */
+class RWLock {
+protected:
+	virtual ~RWLock() {}
+
+public:
+	/*!
+	 * @brief Create a RWLock object
+	 * @param writerPreference If true, a thread waiting to lock for writing blocks the new readers,
+	 *                         else the new readers can lock while the current readers lock
+	 * @return If this method succeeds then returns a pointer of RWLock object, else returns null pointer
+	 *
+	 * @note If writerPreference is false, the writers may starve while the readers lock one after another.
+	 */
+	static RWLock* create(bool writerPreference = false);
+
+	/*!
+	 * @brief Destroy a RWLock object
+	 * @param l Pointer of RWLock object created by RWLock::create()
+	 *
+	 * @note If l is null pointer, do nothing.
+	 */
+	static void destroy(RWLock* l);
+
+	/*!
+	 * @brief Block the current thread until locks this lock for reading
+	 * @retval OK Success. The current thread locked this lock for reading
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedReadLock(Timeout::FOREVER)
+	 */
+	virtual Error readLock() = 0;
+
+	/*!
+	 * @brief Try to lock this lock for reading without blocking
+	 * @retval OK Success. The current thread locked this lock for reading
+	 * @retval TimedOut Failed. Other thread locks this lock for writing
+	 *
+	 * @note Same as timedReadLock(Timeout::POLLING)
+	 */
+	virtual Error tryReadLock() = 0;
+
+	/*!
+	 * @brief Block the current thread until locks this lock for reading but only within the limited time
+	 * @param tmout The limited time
+	 * @retval OK Success. The current thread locked this lock for reading
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to lock this lock without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until locks this lock.
+	 */
+	virtual Error timedReadLock(Timeout tmout) = 0;
+
+	/*!
+	 * @brief Unlock this lock that the current thread locks for reading
+	 * @retval OK Success. The current thread unlocked this lock
+	 * @retval NotLocked No thread locks this lock for reading
+	 */
+	virtual Error readUnlock() = 0;
+
+	/*!
+	 * @brief Block the current thread until locks this lock for writing
+	 * @retval OK Success. The current thread locked this lock for writing
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedWriteLock(Timeout::FOREVER)
+	 */
+	virtual Error writeLock() = 0;
+
+	/*!
+	 * @brief Try to lock this lock for writing without blocking
+	 * @retval OK Success. The current thread locked this lock for writing
+	 * @retval TimedOut Failed. Other thread locks this lock for reading or writing
+	 *
+	 * @note Same as timedWriteLock(Timeout::POLLING)
+	 */
+	virtual Error tryWriteLock() = 0;
+
+	/*!
+	 * @brief Block the current thread until locks this lock for writing but only within the limited time
+	 * @param tmout The limited time
+	 * @retval OK Success. The current thread locked this lock for writing
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to lock this lock without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until locks this lock.
+	 */
+	virtual Error timedWriteLock(Timeout tmout) = 0;
+
+	/*!
+	 * @brief Unlock this lock that the current thread locks for writing
+	 * @retval OK Success. The current thread unlocked this lock
+	 * @retval NotLocked No thread locks this lock for writing
+	 */
+	virtual Error writeUnlock() = 0;
+
+};
+
+
+/*!
+ * @brief RAII wrapper of RWLock for reading
+ *
+ * A ReadLockGuard object is used as a local variable.
+ * While the ReadLockGuard object exists in the scope, the current thread is locking the RWLock for reading.
+ * When it goes out of the scope and the ReadLockGuard object ends its life, the RWLock is unlocked automatically.
+ */
+class ReadLockGuard {
+public:
+	struct AdoptLock {};
+	static const AdoptLock ADOPT_LOCK; //!< Used as argument of ReadLockGuard's constructor
+
+	/*!
+	 * @brief Constructor of ReadLockGuard with automatic locking
+	 * @param l RWLock object that the current thread has not locked
+	 *
+	 * This constructor calls readLock() for the RWLock object.
+	 */
+	explicit ReadLockGuard(RWLock* l);
+
+	/*!
+	 * @brief Constructor of ReadLockGuard using locked RWLock object
+	 * @param l RWLock object that the current thread has already locked for reading, for example by tryReadLock() or timedReadLock()
+	 * @param adoptLock Specify ReadLockGuard::ADOPT_LOCK
+	 */
+	ReadLockGuard(RWLock* l, AdoptLock adoptLock);
+
+	/*!
+	 * @brief Destructor of ReadLockGuard
+	 *
+	 * Destructor calls readUnlock() for the locked RWLock object.
+	 */
+	~ReadLockGuard();
+
+private:
+	RWLock* m_lock;
+	Error m_lockErr;
+
+	ReadLockGuard(const ReadLockGuard&);
+	ReadLockGuard& operator=(const ReadLockGuard&);
+};
+
+/*!
+ * @brief RAII wrapper of RWLock for writing
+ *
+ * A WriteLockGuard object is used as a local variable.
+ * While the WriteLockGuard object exists in the scope, the current thread is locking the RWLock for writing.
+ * When it goes out of the scope and the WriteLockGuard object ends its life, the RWLock is unlocked automatically.
+ */
+class WriteLockGuard {
+public:
+	struct AdoptLock {};
+	static const AdoptLock ADOPT_LOCK; //!< Used as argument of WriteLockGuard's constructor
+
+	/*!
+	 * @brief Constructor of WriteLockGuard with automatic locking
+	 * @param l RWLock object that the current thread has not locked
+	 *
+	 * This constructor calls writeLock() for the RWLock object.
+	 */
+	explicit WriteLockGuard(RWLock* l);
+
+	/*!
+	 * @brief Constructor of WriteLockGuard using locked RWLock object
+	 * @param l RWLock object that the current thread has already locked for writing, for example by tryWriteLock() or timedWriteLock()
+	 * @param adoptLock Specify WriteLockGuard::ADOPT_LOCK
+	 */
+	WriteLockGuard(RWLock* l, AdoptLock adoptLock);
+
+	/*!
+	 * @brief Destructor of WriteLockGuard
+	 *
+	 * Destructor calls writeUnlock() for the locked RWLock object.
+	 */
+	~WriteLockGuard();
+
+private:
+	RWLock* m_lock;
+	Error m_lockErr;
+
+	WriteLockGuard(const WriteLockGuard&);
+	WriteLockGuard& operator=(const WriteLockGuard&);
+};
+
+}
+
+#endif // OS_WRAPPER_RW_LOCK_H_INCLUDED
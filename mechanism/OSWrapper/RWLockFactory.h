@@ -0,0 +1,17 @@
+#ifndef OS_WRAPPER_RW_LOCK_FACTORY_H_INCLUDED
+#define OS_WRAPPER_RW_LOCK_FACTORY_H_INCLUDED
+
+namespace OSWrapper {
+
+class RWLock;
+
+class RWLockFactory {
+public:
+	virtual ~RWLockFactory() {}
+	virtual RWLock* create(bool writerPreference) = 0;
+	virtual void destroy(RWLock* l) = 0;
+};
+
+}
+
+#endif // OS_WRAPPER_RW_LOCK_FACTORY_H_INCLUDED
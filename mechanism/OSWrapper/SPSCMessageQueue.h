@@ -0,0 +1,382 @@
+#ifndef OS_WRAPPER_SPSC_MESSAGE_QUEUE_H_INCLUDED
+#define OS_WRAPPER_SPSC_MESSAGE_QUEUE_H_INCLUDED
+
+#if (__cplusplus >= 201103L)
+
+#include <cstddef>
+#include <new>
+#include <atomic>
+#include "Timeout.h"
+#include "Deadline.h"
+#include "OSWrapperError.h"
+#include "EventFlag.h"
+#include "FixedMemoryPool.h"
+#include "Assertion/Assertion.h"
+
+namespace OSWrapper {
+
+/*!
+ * @brief Class template of single-producer/single-consumer message queue
+ * @tparam T Type of element
+ *
+ * SPSCMessageQueue has the same interface as MessageQueue, but the ring buffer is indexed by atomic variables instead of being guarded by Mutex.
+ * The EventFlag is used only when the sender finds this queue full or the receiver finds this queue empty.
+ * So sending and receiving a message costs no lock while this queue is neither empty nor full.
+ *
+ * @attention Only one thread can call the send methods and only one thread can call the receive methods at the same time.
+ *            If several threads send or receive, use MessageQueue instead of this.
+ * @note This class template is available only in C++11 or later.
+ */
+template <typename T>
+class SPSCMessageQueue {
+public:
+	/*!
+	 * @brief Create a SPSCMessageQueue object
+	 * @param maxSize Max queue size
+	 * @return If this method succeeds then returns a pointer of SPSCMessageQueue object, else returns null pointer
+	 */
+	static SPSCMessageQueue* create(std::size_t maxSize)
+	{
+		const std::size_t alignedMQSize =
+			(sizeof(SPSCMessageQueue) + (sizeof(double) - 1U)) & ~(sizeof(double) - 1U);
+		const std::size_t bufSize = maxSize + 1U;
+		const std::size_t poolBufSize = alignedMQSize + (sizeof(T) * bufSize);
+
+		FixedMemoryPool* pool = FixedMemoryPool::create(poolBufSize,
+				FixedMemoryPool::getRequiredMemorySize(poolBufSize, 1U));
+		if (pool == 0) {
+			return 0;
+		}
+
+		void* p = pool->allocate();
+		if (p == 0) {
+			FixedMemoryPool::destroy(pool);
+			return 0;
+		}
+
+		SPSCMessageQueue* m = new(p) SPSCMessageQueue(pool,
+				reinterpret_cast<T*>(static_cast<unsigned char*>(p) + alignedMQSize), bufSize);
+		if (!m->createOSObjects()) {
+			destroy(m);
+			return 0;
+		}
+		return m;
+	}
+
+	/*!
+	 * @brief Destroy a SPSCMessageQueue object
+	 * @param m Pointer of SPSCMessageQueue object created by SPSCMessageQueue<T>::create()
+	 *
+	 * @note If m is null pointer, do nothing.
+	 */
+	static void destroy(SPSCMessageQueue* m)
+	{
+		if (m == 0) {
+			return;
+		}
+		FixedMemoryPool* pool = m->m_pool;
+		m->~SPSCMessageQueue();
+		pool->deallocate(m);
+		FixedMemoryPool::destroy(pool);
+	}
+
+	/*!
+	 * @brief Send the message
+	 *
+	 * This method enqueues the message into this queue.
+	 * If this queue is full, block the current thread until to be dequeued by receive methods.
+	 *
+	 * @param msg Message to send
+	 * @retval OK Success. The message was sent
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedSend(msg, Timeout::FOREVER)
+	 */
+	Error send(const T& msg)
+	{
+		return timedSend(msg, Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Send the message without blocking
+	 *
+	 * This method enqueues the message into this queue.
+	 * If this queue is full, returns TimedOut immediately.
+	 *
+	 * @param msg Message to send
+	 * @retval OK Success. The message was sent
+	 * @retval TimedOut This queue is full
+	 *
+	 * @note Same as timedSend(msg, Timeout::POLLING)
+	 */
+	Error trySend(const T& msg)
+	{
+		return timedSend(msg, Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Send the message within the limited time
+	 *
+	 * This method enqueues the message into this queue.
+	 * If this queue is full, block the current thread until to be dequeued by receive methods but only within the limited time.
+	 *
+	 * @param msg Message to send
+	 * @param tmout The limited time
+	 * @retval OK Success. The message was sent
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to send the message without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until has sent the message.
+	 */
+	Error timedSend(const T& msg, Timeout tmout)
+	{
+		const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		const Error err = waitWhileFull(tail, tmout);
+		if (err != OK) {
+			return err;
+		}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			new(&m_buf[tail]) T(msg);
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (const Assertion::Failure&) {
+			throw;
+		}
+		catch (...) {
+			return OtherError;
+		}
+#endif
+		m_tail.store(nextIndex(tail));
+		if (m_receiverWaiting.load()) {
+			m_event->set(EV_NOT_EMPTY);
+		}
+		return OK;
+	}
+
+	/*!
+	 * @brief Receive the message
+	 *
+	 * This method dequeues the message from this queue.
+	 * If this queue is empty, block the current thread until to be enqueued by send methods.
+	 *
+	 * @param msg Pointer of variable that stores the message received. If null pointer, not accessed
+	 * @retval OK Success. The message was received
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note Same as timedReceive(msg, Timeout::FOREVER)
+	 */
+	Error receive(T* msg)
+	{
+		return timedReceive(msg, Timeout::FOREVER);
+	}
+
+	/*!
+	 * @brief Receive the message without blocking
+	 *
+	 * This method dequeues the message from this queue.
+	 * If this queue is empty, returns TimedOut immediately.
+	 *
+	 * @param msg Pointer of variable that stores the message received. If null pointer, not accessed
+	 * @retval OK Success. The message was received
+	 * @retval TimedOut This queue is empty
+	 *
+	 * @note Same as timedReceive(msg, Timeout::POLLING)
+	 */
+	Error tryReceive(T* msg)
+	{
+		return timedReceive(msg, Timeout::POLLING);
+	}
+
+	/*!
+	 * @brief Receive the message within the limited time
+	 *
+	 * This method dequeues the message from this queue.
+	 * If this queue is empty, block the current thread until to be enqueued by send methods but only within the limited time.
+	 *
+	 * @param msg Pointer of variable that stores the message received. If null pointer, not accessed
+	 * @param tmout The limited time
+	 * @retval OK Success. The message was received
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to receive the message without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until has received the message.
+	 */
+	Error timedReceive(T* msg, Timeout tmout)
+	{
+		const std::size_t head = m_head.load(std::memory_order_relaxed);
+		const Error err = waitWhileEmpty(head, tmout);
+		if (err != OK) {
+			return err;
+		}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			if (msg != 0) {
+				*msg = m_buf[head];
+			}
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (const Assertion::Failure&) {
+			throw;
+		}
+		catch (...) {
+			return OtherError;
+		}
+#endif
+		m_buf[head].~T();
+		m_head.store(nextIndex(head));
+		if (m_senderWaiting.load()) {
+			m_event->set(EV_NOT_FULL);
+		}
+		return OK;
+	}
+
+	/*!
+	 * @brief Get the queue size
+	 * @return Queue size
+	 */
+	std::size_t getSize() const
+	{
+		const std::size_t head = m_head.load();
+		const std::size_t tail = m_tail.load();
+		if (head <= tail) {
+			return tail - head;
+		}
+		return m_bufSize - head + tail;
+	}
+
+	/*!
+	 * @brief Get the max queue size
+	 * @return Max queue size
+	 */
+	std::size_t getMaxSize() const
+	{
+		return m_bufSize - 1U;
+	}
+
+private:
+	// The receiver owns m_head and the sender owns m_tail.
+	// They are placed on different cache lines not to bounce between the two threads.
+	static const std::size_t CACHE_LINE_SIZE = 64U;
+
+	std::atomic<std::size_t> m_head;
+	std::atomic<bool> m_receiverWaiting;
+	unsigned char m_padding1[CACHE_LINE_SIZE];
+	std::atomic<std::size_t> m_tail;
+	std::atomic<bool> m_senderWaiting;
+	unsigned char m_padding2[CACHE_LINE_SIZE];
+
+	const std::size_t m_bufSize;
+	T* const m_buf;
+
+	FixedMemoryPool* m_pool;
+	EventFlag* m_event;
+
+	static const EventFlag::Pattern EV_NOT_EMPTY;
+	static const EventFlag::Pattern EV_NOT_FULL;
+
+	SPSCMessageQueue(FixedMemoryPool* pool, T* buf, std::size_t bufSize)
+	: m_head(0U), m_receiverWaiting(false), m_padding1()
+	, m_tail(0U), m_senderWaiting(false), m_padding2()
+	, m_bufSize(bufSize), m_buf(buf), m_pool(pool), m_event(0)
+	{
+	}
+
+	~SPSCMessageQueue()
+	{
+		std::size_t head = m_head.load();
+		const std::size_t tail = m_tail.load();
+		while (head != tail) {
+			m_buf[head].~T();
+			head = nextIndex(head);
+		}
+		EventFlag::destroy(m_event);
+	}
+
+	bool createOSObjects()
+	{
+		m_event = EventFlag::create(false);
+		if (m_event == 0) {
+			return false;
+		}
+		return true;
+	}
+
+	std::size_t nextIndex(std::size_t idx) const
+	{
+		if (idx + 1U < m_bufSize) {
+			return idx + 1U;
+		}
+		return idx + 1U - m_bufSize;
+	}
+
+	// The waiting flag is stored before the index of the other side is loaded again,
+	// and the other side stores its index before loading the waiting flag (both are sequentially consistent).
+	// So either this thread sees the updated index or the other side sees the waiting flag and sets the EventFlag.
+	// The wait may be woken up without the index updated, so each wait takes only the time left of tmout.
+	Error waitWhileFull(std::size_t tail, Timeout tmout)
+	{
+		const std::size_t next = nextIndex(tail);
+		if (next != m_head.load(std::memory_order_acquire)) {
+			return OK;
+		}
+		const Deadline deadline(tmout);
+		Error err = OK;
+		m_senderWaiting.store(true);
+		while (true) {
+			m_event->reset(EV_NOT_FULL);
+			if (next != m_head.load()) {
+				break;
+			}
+			err = m_event->timedWait(EV_NOT_FULL, EventFlag::OR, 0, deadline.getRemaining());
+			if (err != OK) {
+				break;
+			}
+		}
+		m_senderWaiting.store(false);
+		return err;
+	}
+
+	Error waitWhileEmpty(std::size_t head, Timeout tmout)
+	{
+		if (head != m_tail.load(std::memory_order_acquire)) {
+			return OK;
+		}
+		const Deadline deadline(tmout);
+		Error err = OK;
+		m_receiverWaiting.store(true);
+		while (true) {
+			m_event->reset(EV_NOT_EMPTY);
+			if (head != m_tail.load()) {
+				break;
+			}
+			err = m_event->timedWait(EV_NOT_EMPTY, EventFlag::OR, 0, deadline.getRemaining());
+			if (err != OK) {
+				break;
+			}
+		}
+		m_receiverWaiting.store(false);
+		return err;
+	}
+
+	SPSCMessageQueue(const SPSCMessageQueue&);
+	SPSCMessageQueue& operator=(const SPSCMessageQueue&);
+};
+
+template <typename T>
+const EventFlag::Pattern SPSCMessageQueue<T>::EV_NOT_EMPTY = 0x0001U;
+
+template <typename T>
+const EventFlag::Pattern SPSCMessageQueue<T>::EV_NOT_FULL = 0x0002U;
+
+}
+
+#endif // (__cplusplus >= 201103L)
+
+#endif // OS_WRAPPER_SPSC_MESSAGE_QUEUE_H_INCLUDED
@@ -0,0 +1,27 @@
+#include "Semaphore.h"
+#include "SemaphoreFactory.h"
+#include "Assertion/Assertion.h"
+
+namespace OSWrapper {
+
+static SemaphoreFactory* s_factory = 0;
+
+void registerSemaphoreFactory(SemaphoreFactory* factory)
+{
+	s_factory = factory;
+}
+
+Semaphore* Semaphore::create(std::size_t initialCount, std::size_t maxCount)
+{
+	CHECK_ASSERT(s_factory);
+	return s_factory->create(initialCount, maxCount);
+}
+
+void Semaphore::destroy(Semaphore* s)
+{
+	if ((s_factory != 0) && (s != 0)) {
+		s_factory->destroy(s);
+	}
+}
+
+}
@@ -0,0 +1,117 @@
+#ifndef OS_WRAPPER_SEMAPHORE_H_INCLUDED
+#define OS_WRAPPER_SEMAPHORE_H_INCLUDED
+
+#include <cstddef>
+#include "Timeout.h"
+#include "OSWrapperError.h"
+
+namespace OSWrapper {
+
+class SemaphoreFactory;
+
+/*!
+ * @brief Register the SemaphoreFactory
+ * @param factory Pointer of the object of the concrete class derived from SemaphoreFactory
+ *
+ * @note You need to call this function only one time when the application is initialized.
+ */
+void registerSemaphoreFactory(SemaphoreFactory* factory);
+
+/*!
+ * @brief Abstract class that has functions of common RTOS's counting semaphore
+ *
+ * The semaphore has the count of the permits from 0 to the maximum count.
+ * A thread acquires n permits at once. The permits are not owned by the thread,
+ * so any thread or non thread context can release them.
+ *
+ * @note The waiting threads are not guaranteed to acquire in the order of the waiting.
+ */
+class Semaphore {
+protected:
+	virtual ~Semaphore() {}
+
+public:
+	/*!
+	 * @brief Create a Semaphore object
+	 * @param initialCount Initial count of the permits
+	 * @param maxCount Maximum count of the permits
+	 * @return If this method succeeds then returns a pointer of Semaphore object, else returns null pointer
+	 *
+	 * @note If maxCount is 0, initialCount is greater than maxCount or maxCount is too large for the platform, this method fails.
+	 */
+	static Semaphore* create(std::size_t initialCount, std::size_t maxCount);
+
+	/*!
+	 * @brief Destroy a Semaphore object
+	 * @param s Pointer of Semaphore object created by Semaphore::create()
+	 *
+	 * @note If s is null pointer, do nothing.
+	 */
+	static void destroy(Semaphore* s);
+
+	/*!
+	 * @brief Block the current thread until acquires n permits
+	 * @param n Number of the permits
+	 * @retval OK Success. The count is decreased by n
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval InvalidParameter n is 0 or greater than the maximum count
+	 *
+	 * @note Same as timedAcquire(n, Timeout::FOREVER)
+	 */
+	virtual Error acquire(std::size_t n) = 0;
+
+	/*!
+	 * @brief Try to acquire n permits without blocking
+	 * @param n Number of the permits
+	 * @retval OK Success. The count is decreased by n
+	 * @retval TimedOut Failed. The count is less than n
+	 * @retval InvalidParameter n is 0 or greater than the maximum count
+	 *
+	 * @note Same as timedAcquire(n, Timeout::POLLING)
+	 */
+	virtual Error tryAcquire(std::size_t n) = 0;
+
+	/*!
+	 * @brief Block the current thread until acquires n permits but only within the limited time
+	 * @param n Number of the permits
+	 * @param tmout The limited time
+	 * @retval OK Success. The count is decreased by n
+	 * @retval TimedOut The limited time was elapsed
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 * @retval InvalidParameter n is 0 or greater than the maximum count
+	 *
+	 * The n permits are acquired at once, so no permit is acquired if this method fails.
+	 *
+	 * @note If tmout is Timeout::POLLING then this method tries to acquire without blocking.
+	 * @note If tmout is Timeout::FOREVER then this method waits forever until acquires.
+	 */
+	virtual Error timedAcquire(std::size_t n, Timeout tmout) = 0;
+
+	/*!
+	 * @brief Release n permits
+	 * @param n Number of the permits
+	 * @retval OK Success. The count is increased by n and the waiting threads that can acquire are woken up
+	 * @retval InvalidParameter n is 0
+	 * @retval OtherError The count would exceed the maximum count. No permit is released
+	 *
+	 * @note In non thread context, the platform that can't lock there (e.g. uITRON) signals the permits one by one.
+	 *       If n is greater than 1 and the count reaches the maximum count during it, some of the permits are released though OtherError is returned.
+	 */
+	virtual Error release(std::size_t n) = 0;
+
+	/*!
+	 * @brief Get the current count of the permits
+	 * @return The current count
+	 */
+	virtual std::size_t getCount() const = 0;
+
+	/*!
+	 * @brief Get the maximum count of the permits
+	 * @return The maximum count
+	 */
+	virtual std::size_t getMaxCount() const = 0;
+};
+
+}
+
+#endif // OS_WRAPPER_SEMAPHORE_H_INCLUDED
@@ -0,0 +1,19 @@
+#ifndef OS_WRAPPER_SEMAPHORE_FACTORY_H_INCLUDED
+#define OS_WRAPPER_SEMAPHORE_FACTORY_H_INCLUDED
+
+#include <cstddef>
+
+namespace OSWrapper {
+
+class Semaphore;
+
+class SemaphoreFactory {
+public:
+	virtual ~SemaphoreFactory() {}
+	virtual Semaphore* create(std::size_t initialCount, std::size_t maxCount) = 0;
+	virtual void destroy(Semaphore* s) = 0;
+};
+
+}
+
+#endif // OS_WRAPPER_SEMAPHORE_FACTORY_H_INCLUDED
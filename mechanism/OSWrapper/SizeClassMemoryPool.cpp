@@ -0,0 +1,250 @@
+#include "SizeClassMemoryPool.h"
+#include "FixedMemoryPool.h"
+#include <new>
+
+namespace OSWrapper {
+
+namespace {
+
+std::size_t alignSize(std::size_t size)
+{
+	return (size + (sizeof(double) - 1U)) & ~(sizeof(double) - 1U);
+}
+
+bool isValidParameter(std::size_t minBlockSize, const std::size_t numBlocks[], std::size_t numSizeClasses)
+{
+	if ((minBlockSize == 0U) || (numBlocks == 0)) {
+		return false;
+	}
+	if ((numSizeClasses == 0U) || (numSizeClasses > SizeClassMemoryPool::MAX_SIZE_CLASSES)) {
+		return false;
+	}
+	// The largest block size must not overflow
+	if (((minBlockSize << (numSizeClasses - 1U)) >> (numSizeClasses - 1U)) != minBlockSize) {
+		return false;
+	}
+	for (std::size_t i = 0U; i < numSizeClasses; ++i) {
+		if (numBlocks[i] == 0U) {
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+SizeClassMemoryPool::SizeClassMemoryPool(FixedMemoryPool* objPool)
+: m_sizeClasses()
+, m_numSizeClasses(0U)
+, m_largePool(0)
+, m_largeRequests()
+, m_objPool(objPool)
+{
+	for (std::size_t i = 0U; i < MAX_SIZE_CLASSES; ++i) {
+		m_sizeClasses[i].m_hits = 0UL;
+		m_sizeClasses[i].m_misses = 0UL;
+	}
+	m_largeRequests = 0UL;
+}
+
+SizeClassMemoryPool::~SizeClassMemoryPool()
+{
+}
+
+SizeClassMemoryPool* SizeClassMemoryPool::create(std::size_t minBlockSize, const std::size_t numBlocks[], std::size_t numSizeClasses,
+		std::size_t largeMemoryPoolSize/*= 0U*/, void* memoryPoolAddress/*= 0*/)
+{
+	if (!isValidParameter(minBlockSize, numBlocks, numSizeClasses)) {
+		return 0;
+	}
+
+	// If memoryPoolAddress is null pointer, the memory pool area follows the object in the same block
+	const std::size_t objSize = alignSize(sizeof(SizeClassMemoryPool));
+	std::size_t blockSize = objSize;
+	if (memoryPoolAddress == 0) {
+		blockSize += getRequiredMemorySize(minBlockSize, numBlocks, numSizeClasses, largeMemoryPoolSize);
+	}
+	FixedMemoryPool* objPool = FixedMemoryPool::create(blockSize, FixedMemoryPool::getRequiredMemorySize(blockSize, 1U));
+	if (objPool == 0) {
+		return 0;
+	}
+	void* p = 0;
+	if (objPool->tryAllocateMemory(&p) != OK) {
+		FixedMemoryPool::destroy(objPool);
+		return 0;
+	}
+	SizeClassMemoryPool* pool = new(p) SizeClassMemoryPool(objPool);
+
+	char* area = static_cast<char*>(memoryPoolAddress);
+	if (area == 0) {
+		area = static_cast<char*>(p) + objSize;
+	}
+	if (!pool->constructMembers(minBlockSize, numBlocks, numSizeClasses, largeMemoryPoolSize, area)) {
+		destroy(pool);
+		return 0;
+	}
+	return pool;
+}
+
+void SizeClassMemoryPool::destroy(SizeClassMemoryPool* p)
+{
+	if (p == 0) {
+		return;
+	}
+	FixedMemoryPool* objPool = p->m_objPool;
+	p->destructMembers();
+	p->~SizeClassMemoryPool();
+	objPool->deallocate(p);
+	FixedMemoryPool::destroy(objPool);
+}
+
+// Called by VariableMemoryPool::destroy(), because this object is not created by the VariableMemoryPoolFactory
+bool SizeClassMemoryPool::destroySelf()
+{
+	destroy(this);
+	return true;
+}
+
+std::size_t SizeClassMemoryPool::getRequiredMemorySize(std::size_t minBlockSize, const std::size_t numBlocks[], std::size_t numSizeClasses,
+		std::size_t largeMemoryPoolSize/*= 0U*/)
+{
+	if (!isValidParameter(minBlockSize, numBlocks, numSizeClasses)) {
+		return 0U;
+	}
+	std::size_t size = 0U;
+	for (std::size_t i = 0U; i < numSizeClasses; ++i) {
+		size += alignSize(FixedMemoryPool::getRequiredMemorySize(minBlockSize << i, numBlocks[i]));
+	}
+	return size + largeMemoryPoolSize;
+}
+
+bool SizeClassMemoryPool::constructMembers(std::size_t minBlockSize, const std::size_t numBlocks[], std::size_t numSizeClasses,
+		std::size_t largeMemoryPoolSize, char* memoryPoolAddress)
+{
+	char* area = memoryPoolAddress;
+	for (std::size_t i = 0U; i < numSizeClasses; ++i) {
+		SizeClass& sc = m_sizeClasses[i];
+		const std::size_t areaSize = FixedMemoryPool::getRequiredMemorySize(minBlockSize << i, numBlocks[i]);
+		sc.m_pool = FixedMemoryPool::create(minBlockSize << i, areaSize, area);
+		if (sc.m_pool == 0) {
+			return false;
+		}
+		sc.m_blockSize = minBlockSize << i;
+		sc.m_begin = area;
+		sc.m_end = area + areaSize;
+		m_numSizeClasses = i + 1U;
+		area += alignSize(areaSize);
+	}
+
+	if (largeMemoryPoolSize != 0U) {
+		m_largePool = VariableMemoryPool::create(largeMemoryPoolSize, area);
+		if (m_largePool == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void SizeClassMemoryPool::destructMembers()
+{
+	VariableMemoryPool::destroy(m_largePool);
+	for (std::size_t i = 0U; i < m_numSizeClasses; ++i) {
+		FixedMemoryPool::destroy(m_sizeClasses[i].m_pool);
+	}
+}
+
+void* SizeClassMemoryPool::allocate(std::size_t size)
+{
+	std::size_t i = 0U;
+	while ((i < m_numSizeClasses) && (m_sizeClasses[i].m_blockSize < size)) {
+		++i;
+	}
+	if (i < m_numSizeClasses) {
+		SizeClass& sc = m_sizeClasses[i];
+		void* p = 0;
+		if (sc.m_pool->tryAllocateMemory(&p) == OK) {
+			increment(sc.m_hits);
+			return p;
+		}
+		increment(sc.m_misses);
+	} else {
+		increment(m_largeRequests);
+	}
+
+	if (m_largePool == 0) {
+		return 0;
+	}
+	return m_largePool->allocate(size);
+}
+
+void SizeClassMemoryPool::deallocate(void* p)
+{
+	if (p == 0) {
+		return;
+	}
+	const char* cp = static_cast<const char*>(p);
+	for (std::size_t i = 0U; i < m_numSizeClasses; ++i) {
+		SizeClass& sc = m_sizeClasses[i];
+		if ((sc.m_begin <= cp) && (cp < sc.m_end)) {
+			sc.m_pool->deallocate(p);
+			return;
+		}
+	}
+	if (m_largePool != 0) {
+		m_largePool->deallocate(p);
+	}
+}
+
+std::size_t SizeClassMemoryPool::getNumberOfSizeClasses() const
+{
+	return m_numSizeClasses;
+}
+
+std::size_t SizeClassMemoryPool::getBlockSize(std::size_t sizeClass) const
+{
+	if (sizeClass >= m_numSizeClasses) {
+		return 0U;
+	}
+	return m_sizeClasses[sizeClass].m_blockSize;
+}
+
+unsigned long SizeClassMemoryPool::getNumberOfHits(std::size_t sizeClass) const
+{
+	if (sizeClass >= m_numSizeClasses) {
+		return 0UL;
+	}
+	return load(m_sizeClasses[sizeClass].m_hits);
+}
+
+unsigned long SizeClassMemoryPool::getNumberOfMisses(std::size_t sizeClass) const
+{
+	if (sizeClass >= m_numSizeClasses) {
+		return 0UL;
+	}
+	return load(m_sizeClasses[sizeClass].m_misses);
+}
+
+unsigned long SizeClassMemoryPool::getNumberOfLargeRequests() const
+{
+	return load(m_largeRequests);
+}
+
+void SizeClassMemoryPool::increment(Counter& counter)
+{
+#if (__cplusplus >= 201103L)
+	counter.fetch_add(1UL, std::memory_order_relaxed);
+#else
+	++counter;
+#endif
+}
+
+unsigned long SizeClassMemoryPool::load(const Counter& counter)
+{
+#if (__cplusplus >= 201103L)
+	return counter.load(std::memory_order_relaxed);
+#else
+	return counter;
+#endif
+}
+
+}
@@ -0,0 +1,160 @@
+#ifndef OS_WRAPPER_SIZE_CLASS_MEMORY_POOL_H_INCLUDED
+#define OS_WRAPPER_SIZE_CLASS_MEMORY_POOL_H_INCLUDED
+
+#include <cstddef>
+#include "VariableMemoryPool.h"
+#if (__cplusplus >= 201103L)
+#include <atomic>
+#endif
+
+namespace OSWrapper {
+
+class FixedMemoryPool;
+
+/*!
+ * @brief Class of VariableMemoryPool that allocates the memory from the FixedMemoryPools of the size classes
+ *
+ * SizeClassMemoryPool has FixedMemoryPools whose block sizes are minBlockSize, minBlockSize * 2, minBlockSize * 4, and so on.
+ * allocate() takes a block from the FixedMemoryPool of the smallest size class that can store the required size,
+ * so a small allocation costs the same as a FixedMemoryPool and the fragmentation is bounded by the size classes.
+ *
+ * If SizeClassMemoryPool has a large memory pool, it is a VariableMemoryPool used as the fallback.
+ * The required size larger than the largest size class, and the required size whose size class has no free blocks,
+ * are allocated from the large memory pool.
+ *
+ * The areas of all the FixedMemoryPools and the large memory pool are carved from one memory pool area.
+ *
+ * The number of hits and misses of each size class are counted.
+ * A hit is an allocation from the FixedMemoryPool of the size class, and a miss is a required size of the size class that the FixedMemoryPool failed to allocate.
+ *
+ * @note The counters are not atomic before C++11.
+ * @note A SizeClassMemoryPool object can be destroyed by either SizeClassMemoryPool::destroy() or VariableMemoryPool::destroy().
+ */
+class SizeClassMemoryPool : public VariableMemoryPool {
+public:
+	/*!
+	 * @brief Max number of the size classes
+	 */
+	static const std::size_t MAX_SIZE_CLASSES = 16U;
+
+	/*!
+	 * @brief Create a SizeClassMemoryPool object
+	 * @param minBlockSize Block size of the smallest size class. The block size of each size class is twice as large as the previous one.
+	 * @param numBlocks Array of the number of blocks of each size class
+	 * @param numSizeClasses Number of the size classes. It must be from 1 to MAX_SIZE_CLASSES.
+	 * @param largeMemoryPoolSize Number of bytes of the large memory pool. If zero then SizeClassMemoryPool has no large memory pool.
+	 * @param memoryPoolAddress Memory pool area of getRequiredMemorySize() bytes
+	 * @return If this method succeeds then returns a pointer of SizeClassMemoryPool object, else returns null pointer
+	 *
+	 * @note If memoryPoolAddress is null pointer, the memory pool area is allocated from a FixedMemoryPool.
+	 * @note All the elements of \p numBlocks must not be zero.
+	 */
+	static SizeClassMemoryPool* create(std::size_t minBlockSize, const std::size_t numBlocks[], std::size_t numSizeClasses,
+			std::size_t largeMemoryPoolSize = 0U, void* memoryPoolAddress = 0);
+
+	/*!
+	 * @brief Destroy a SizeClassMemoryPool object
+	 * @param p Pointer of SizeClassMemoryPool object created by SizeClassMemoryPool::create()
+	 *
+	 * @note If p is null pointer, do nothing.
+	 */
+	static void destroy(SizeClassMemoryPool* p);
+
+	/*!
+	 * @brief Get the required size of the memory pool area
+	 * @param minBlockSize Block size of the smallest size class
+	 * @param numBlocks Array of the number of blocks of each size class
+	 * @param numSizeClasses Number of the size classes
+	 * @param largeMemoryPoolSize Number of bytes of the large memory pool
+	 * @return Required size of the memory pool area passed to create()
+	 */
+	static std::size_t getRequiredMemorySize(std::size_t minBlockSize, const std::size_t numBlocks[], std::size_t numSizeClasses,
+			std::size_t largeMemoryPoolSize = 0U);
+
+	/*!
+	 * @brief Allocate a memory from this SizeClassMemoryPool
+	 * @param size Number of bytes of allocation
+	 * @return If a free block of the size class or a free area of the large memory pool exists then returns a pointer of allocated memory, else returns null pointer
+	 */
+	void* allocate(std::size_t size);
+
+	/*!
+	 * @brief Release the allocated memory
+	 * @param p Pointer of allocated memory
+	 *
+	 * @note If p is null pointer, do nothing.
+	 */
+	void deallocate(void* p);
+
+	/*!
+	 * @brief Get the number of the size classes
+	 * @return Number of the size classes
+	 */
+	std::size_t getNumberOfSizeClasses() const;
+
+	/*!
+	 * @brief Get the block size of the size class
+	 * @param sizeClass Index of the size class. 0 is the smallest size class.
+	 * @return Block size of the size class. If \p sizeClass is out of range then returns 0.
+	 */
+	std::size_t getBlockSize(std::size_t sizeClass) const;
+
+	/*!
+	 * @brief Get the number of allocations from the FixedMemoryPool of the size class
+	 * @param sizeClass Index of the size class
+	 * @return Number of hits. If \p sizeClass is out of range then returns 0.
+	 */
+	unsigned long getNumberOfHits(std::size_t sizeClass) const;
+
+	/*!
+	 * @brief Get the number of required sizes of the size class that the FixedMemoryPool failed to allocate
+	 * @param sizeClass Index of the size class
+	 * @return Number of misses. If \p sizeClass is out of range then returns 0.
+	 */
+	unsigned long getNumberOfMisses(std::size_t sizeClass) const;
+
+	/*!
+	 * @brief Get the number of required sizes larger than the largest size class
+	 * @return Number of the required sizes
+	 */
+	unsigned long getNumberOfLargeRequests() const;
+
+private:
+#if (__cplusplus >= 201103L)
+	typedef std::atomic<unsigned long> Counter;
+#else
+	typedef unsigned long Counter;
+#endif
+
+	struct SizeClass {
+		FixedMemoryPool* m_pool;
+		std::size_t m_blockSize;
+		const char* m_begin;
+		const char* m_end;
+		Counter m_hits;
+		Counter m_misses;
+	};
+
+	SizeClass m_sizeClasses[MAX_SIZE_CLASSES];
+	std::size_t m_numSizeClasses;
+	VariableMemoryPool* m_largePool;
+	Counter m_largeRequests;
+	FixedMemoryPool* m_objPool;
+
+	explicit SizeClassMemoryPool(FixedMemoryPool* objPool);
+	~SizeClassMemoryPool();
+	bool destroySelf();
+	bool constructMembers(std::size_t minBlockSize, const std::size_t numBlocks[], std::size_t numSizeClasses,
+			std::size_t largeMemoryPoolSize, char* memoryPoolAddress);
+	void destructMembers();
+
+	static void increment(Counter& counter);
+	static unsigned long load(const Counter& counter);
+
+	SizeClassMemoryPool(const SizeClassMemoryPool&);
+	SizeClassMemoryPool& operator=(const SizeClassMemoryPool&);
+};
+
+}
+
+#endif // OS_WRAPPER_SIZE_CLASS_MEMORY_POOL_H_INCLUDED
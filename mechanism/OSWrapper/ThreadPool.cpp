@@ -2,11 +2,718 @@
 #include "MessageQueue.h"
 #include "EventFlag.h"
 #include "FixedMemoryPool.h"
+#include "Mutex.h"
+#include "Assertion/Assertion.h"
+#include <exception>
+#include <algorithm>
+#if (__cplusplus >= 201103L)
+#include <atomic>
+#include "MPMCMessageQueue.h"
+#endif
 
 namespace OSWrapper {
 
+// Scheduler is the task queue of a ThreadPool created by createQueued() or createWorkStealing().
+// It owns the free task entries (TaskRunner objects) and the Runnable objects executed by the threads.
+// The threads keep running the workers until shutdown() is called and all the queued tasks are finished.
+class ThreadPool::Scheduler {
+public:
+	static void destroy(Scheduler* s)
+	{
+		if (s == 0) {
+			return;
+		}
+		FixedMemoryPool* pool = s->m_pool;
+		s->~Scheduler();
+		pool->deallocate(s);
+		FixedMemoryPool::destroy(pool);
+	}
+
+	virtual Runnable* getWorker(std::size_t index) = 0;
+	virtual void setWorkerThread(std::size_t index, Thread* t) = 0;
+	virtual Error timedAcquire(TaskRunner** runner, Timeout tmout) = 0;
+	virtual void release(TaskRunner* runner) = 0;
+	virtual void submit(TaskRunner* runner) = 0;
+	virtual void shutdown() = 0;
+
+	// Take the oldest task that has not started yet out of the queue
+	virtual bool discardOldest(TaskRunner** runner)
+	{
+		(void)runner;
+		return false;
+	}
+
+	// Return true if a worker waits for a task and no queued task is left for it
+	virtual bool hasIdleWorker() = 0;
+
+protected:
+	explicit Scheduler(FixedMemoryPool* pool) : m_pool(pool) {}
+	virtual ~Scheduler() {}
+
+	static std::size_t alignSize(std::size_t size)
+	{
+		return (size + (sizeof(double) - 1U)) & ~(sizeof(double) - 1U);
+	}
+
+	// Allocate one memory block that holds the scheduler object and its arrays
+	static void* allocateBlock(std::size_t size, FixedMemoryPool** pool)
+	{
+		*pool = FixedMemoryPool::create(size, FixedMemoryPool::getRequiredMemorySize(size, 1U));
+		if (*pool == 0) {
+			return 0;
+		}
+		void* p = (*pool)->allocate();
+		if (p == 0) {
+			FixedMemoryPool::destroy(*pool);
+			return 0;
+		}
+		return p;
+	}
+
+private:
+	FixedMemoryPool* m_pool;
+
+	Scheduler(const Scheduler&);
+	Scheduler& operator=(const Scheduler&);
+};
+
+// All the threads take the tasks from one MessageQueue in FIFO order.
+// A null pointer in the queue tells a worker to exit, so the tasks queued before shutdown() are finished.
+class ThreadPool::QueuedScheduler : public ThreadPool::Scheduler {
+public:
+	static QueuedScheduler* create(std::size_t numWorkers, std::size_t maxTasks)
+	{
+		const std::size_t objSize = alignSize(sizeof(QueuedScheduler));
+		FixedMemoryPool* pool = 0;
+		void* p = allocateBlock(objSize + sizeof(Worker) * numWorkers, &pool);
+		if (p == 0) {
+			return 0;
+		}
+
+		unsigned char* top = static_cast<unsigned char*>(p);
+		QueuedScheduler* s = new(p) QueuedScheduler(pool, reinterpret_cast<Worker*>(top + objSize), numWorkers);
+		if (!s->createOSObjects(maxTasks)) {
+			Scheduler::destroy(s);
+			return 0;
+		}
+		return s;
+	}
+
+	Runnable* getWorker(std::size_t index)
+	{
+		return &m_workers[index];
+	}
+
+	void setWorkerThread(std::size_t index, Thread* t)
+	{
+		m_workers[index].m_thread = t;
+	}
+
+	Error timedAcquire(TaskRunner** runner, Timeout tmout)
+	{
+		return m_freeRunners->timedReceive(runner, tmout);
+	}
+
+	void release(TaskRunner* runner)
+	{
+		m_freeRunners->send(runner);
+	}
+
+	// The queue has room for all the task entries and the stop requests, so this never blocks.
+	void submit(TaskRunner* runner)
+	{
+		m_taskQueue->send(runner);
+	}
+
+	void shutdown()
+	{
+		for (std::size_t i = 0U; i < m_numWorkers; i++) {
+			m_taskQueue->send(0);
+		}
+	}
+
+	bool discardOldest(TaskRunner** runner)
+	{
+		return (m_taskQueue->tryReceive(runner) == OK) && (*runner != 0);
+	}
+
+	// The messages in m_taskQueue will be taken by the idle workers
+	bool hasIdleWorker()
+	{
+		LockGuard lock(m_idleMutex);
+		return m_numIdle > m_taskQueue->getSize();
+	}
+
+protected:
+	class Worker : public Runnable {
+	public:
+		explicit Worker(QueuedScheduler* scheduler) : m_scheduler(scheduler), m_thread(0) {}
+
+		void run()
+		{
+			while (true) {
+				m_scheduler->countIdle(true);
+				TaskRunner* runner = m_scheduler->take();
+				m_scheduler->countIdle(false);
+				if (runner == 0) {
+					break;
+				}
+				runner->runOn(m_thread);
+			}
+		}
+
+		QueuedScheduler* m_scheduler;
+		Thread* m_thread;
+	};
+
+	Worker* const m_workers;
+	const std::size_t m_numWorkers;
+	TaskRunnerMQ* m_taskQueue;
+	TaskRunnerMQ* m_freeRunners;
+	Mutex* m_idleMutex;
+	std::size_t m_numIdle;
+
+	QueuedScheduler(FixedMemoryPool* pool, Worker* workers, std::size_t numWorkers)
+	: Scheduler(pool), m_workers(workers), m_numWorkers(numWorkers), m_taskQueue(0), m_freeRunners(0), m_idleMutex(0), m_numIdle(0U)
+	{
+		for (std::size_t i = 0U; i < m_numWorkers; i++) {
+			new(&m_workers[i]) Worker(this);
+		}
+	}
+
+	~QueuedScheduler()
+	{
+		for (std::size_t i = 0U; i < m_numWorkers; i++) {
+			m_workers[i].~Worker();
+		}
+		Mutex::destroy(m_idleMutex);
+		TaskRunnerMQ::destroy(m_freeRunners);
+		TaskRunnerMQ::destroy(m_taskQueue);
+	}
+
+	bool createOSObjects(std::size_t maxTasks)
+	{
+		m_taskQueue = TaskRunnerMQ::create(maxTasks + m_numWorkers);
+		if (m_taskQueue == 0) {
+			return false;
+		}
+		m_freeRunners = TaskRunnerMQ::create(maxTasks);
+		if (m_freeRunners == 0) {
+			return false;
+		}
+		m_idleMutex = Mutex::createNonRecursive();
+		if (m_idleMutex == 0) {
+			return false;
+		}
+		return true;
+	}
+
+	void countIdle(bool idle)
+	{
+		LockGuard lock(m_idleMutex);
+		if (idle) {
+			++m_numIdle;
+		} else {
+			--m_numIdle;
+		}
+	}
+
+	// Return the next task, or null pointer if the worker has to exit
+	virtual TaskRunner* take()
+	{
+		TaskRunner* runner = 0;
+		m_taskQueue->receive(&runner);
+		return runner;
+	}
+};
+
+// The tasks wait in a binary heap ordered by priority, and by the order of start() among the same priority.
+// m_taskQueue only wakes up the workers. It has one message for each task and for each stop request.
+// A worker may find the heap empty after a task was discarded, so it exits only if shutdown() has been called.
+class ThreadPool::PriorityScheduler : public ThreadPool::QueuedScheduler {
+public:
+	static PriorityScheduler* create(std::size_t numWorkers, std::size_t maxTasks)
+	{
+		const std::size_t objSize = alignSize(sizeof(PriorityScheduler));
+		const std::size_t workersSize = alignSize(sizeof(Worker) * numWorkers);
+		const std::size_t heapSize = sizeof(Entry) * maxTasks;
+		FixedMemoryPool* pool = 0;
+		void* p = allocateBlock(objSize + workersSize + heapSize, &pool);
+		if (p == 0) {
+			return 0;
+		}
+
+		unsigned char* top = static_cast<unsigned char*>(p);
+		PriorityScheduler* s = new(p) PriorityScheduler(pool, reinterpret_cast<Worker*>(top + objSize), numWorkers,
+				top + objSize + workersSize, heapSize);
+		if (!s->createOSObjects(maxTasks)) {
+			Scheduler::destroy(s);
+			return 0;
+		}
+		return s;
+	}
+
+	void submit(TaskRunner* runner)
+	{
+		{
+			LockGuard lock(m_mutex);
+			const Entry e = { runner, runner->getPriority(), m_sequence++ };
+			m_heap.push_back(e);
+			std::push_heap(m_heap.begin(), m_heap.end(), m_runsLater);
+		}
+		m_taskQueue->send(0);
+	}
+
+	void shutdown()
+	{
+		{
+			LockGuard lock(m_mutex);
+			m_shutdown = true;
+		}
+		QueuedScheduler::shutdown();
+	}
+
+	// The task of the lowest priority is discarded. Among the same priority, the oldest one is discarded.
+	bool discardOldest(TaskRunner** runner)
+	{
+		{
+			LockGuard lock(m_mutex);
+			if (m_heap.empty()) {
+				return false;
+			}
+			std::size_t victim = 0U;
+			for (std::size_t i = 1U; i < m_heap.size(); i++) {
+				if (m_runsLater.isLowerPriority(m_heap[i].priority, m_heap[victim].priority)
+						|| ((m_heap[i].priority == m_heap[victim].priority) && m_runsLater.isOlder(m_heap[i], m_heap[victim]))) {
+					victim = i;
+				}
+			}
+			*runner = m_heap[victim].runner;
+			m_heap[victim] = m_heap.back();
+			m_heap.pop_back();
+			std::make_heap(m_heap.begin(), m_heap.end(), m_runsLater);
+		}
+		// Remove the wakeup message of the task if no worker has received it yet
+		TaskRunner* msg = 0;
+		(void)m_taskQueue->tryReceive(&msg);
+		return true;
+	}
+
+private:
+	struct Entry {
+		TaskRunner* runner;
+		int priority;
+		unsigned long sequence;
+	};
+
+	// The comparator of the heap. The entry that runs first is on the top.
+	class RunsLater {
+	public:
+		RunsLater() : m_largerIsHigher(Thread::getLowestPriority() < Thread::getHighestPriority()) {}
+
+		bool operator()(const Entry& a, const Entry& b) const
+		{
+			if (a.priority != b.priority) {
+				return isLowerPriority(a.priority, b.priority);
+			}
+			return isOlder(b, a);
+		}
+
+		bool isLowerPriority(int a, int b) const
+		{
+			return m_largerIsHigher ? (a < b) : (a > b);
+		}
+
+		bool isOlder(const Entry& a, const Entry& b) const
+		{
+			return static_cast<long>(a.sequence - b.sequence) < 0;
+		}
+
+	private:
+		bool m_largerIsHigher;
+	};
+
+	Mutex* m_mutex;
+	Container::PreallocatedVector<Entry> m_heap;
+	RunsLater m_runsLater;
+	unsigned long m_sequence;
+	bool m_shutdown;
+
+	PriorityScheduler(FixedMemoryPool* pool, Worker* workers, std::size_t numWorkers, void* heapBuf, std::size_t heapSize)
+	: QueuedScheduler(pool, workers, numWorkers), m_mutex(0), m_heap(heapBuf, heapSize), m_runsLater(), m_sequence(0U), m_shutdown(false)
+	{
+	}
+
+	~PriorityScheduler()
+	{
+		Mutex::destroy(m_mutex);
+	}
+
+	bool createOSObjects(std::size_t maxTasks)
+	{
+		if (!QueuedScheduler::createOSObjects(maxTasks)) {
+			return false;
+		}
+		m_mutex = Mutex::create();
+		if (m_mutex == 0) {
+			return false;
+		}
+		return true;
+	}
+
+	TaskRunner* take()
+	{
+		while (true) {
+			TaskRunner* msg = 0;
+			m_taskQueue->receive(&msg);
+
+			LockGuard lock(m_mutex);
+			if (!m_heap.empty()) {
+				std::pop_heap(m_heap.begin(), m_heap.end(), m_runsLater);
+				TaskRunner* runner = m_heap.back().runner;
+				m_heap.pop_back();
+				return runner;
+			}
+			if (m_shutdown) {
+				return 0;
+			}
+		}
+	}
+};
+
+#if (__cplusplus >= 201103L)
+class ThreadPool::WorkStealingScheduler : public ThreadPool::Scheduler {
+public:
+	static WorkStealingScheduler* create(std::size_t numWorkers, std::size_t maxTasks)
+	{
+		std::size_t capacity = 2U;
+		while (capacity < maxTasks) {
+			capacity <<= 1;
+		}
+		const std::size_t objSize = alignSize(sizeof(WorkStealingScheduler));
+		const std::size_t workersSize = alignSize(sizeof(Worker) * numWorkers);
+		const std::size_t bufSize = sizeof(std::atomic<TaskRunner*>) * capacity * numWorkers;
+		FixedMemoryPool* pool = 0;
+		void* p = allocateBlock(objSize + workersSize + bufSize, &pool);
+		if (p == 0) {
+			return 0;
+		}
+
+		unsigned char* top = static_cast<unsigned char*>(p);
+		WorkStealingScheduler* s = new(p) WorkStealingScheduler(pool,
+				reinterpret_cast<Worker*>(top + objSize), numWorkers,
+				reinterpret_cast<std::atomic<TaskRunner*>*>(top + objSize + workersSize), capacity);
+		if (!s->createOSObjects(maxTasks)) {
+			Scheduler::destroy(s);
+			return 0;
+		}
+		return s;
+	}
+
+	Runnable* getWorker(std::size_t index)
+	{
+		return &m_workers[index];
+	}
+
+	void setWorkerThread(std::size_t index, Thread* t)
+	{
+		m_workers[index].m_thread = t;
+	}
+
+	Error timedAcquire(TaskRunner** runner, Timeout tmout)
+	{
+		return m_freeRunners->timedReceive(runner, tmout);
+	}
+
+	void release(TaskRunner* runner)
+	{
+		m_freeRunners->send(runner);
+	}
+
+	// A task started in a worker is pushed to the deque of the worker, so it is likely to run on the same cache.
+	void submit(TaskRunner* runner)
+	{
+		Worker* self = findCurrentWorker();
+		if ((self == 0) || !self->m_deque.push(runner)) {
+			m_sharedQueue->send(runner);
+		}
+		wakeOne();
+	}
+
+	// A sleeping worker has found no task. It stops being counted when it is woken up for a submitted task.
+	bool hasIdleWorker()
+	{
+		return m_numSleeping.load() > 0U;
+	}
+
+	void shutdown()
+	{
+		m_shutdown.store(true);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		for (std::size_t i = 0U; i < m_numWorkers; i++) {
+			wake(&m_workers[i]);
+		}
+	}
+
+private:
+	// Chase-Lev work-stealing deque with a fixed capacity.
+	// The owner worker pushes and pops at the bottom and the other workers steal at the top.
+	class Deque {
+	public:
+		Deque(std::atomic<TaskRunner*>* buf, std::size_t capacity)
+		: m_top(0), m_padding(), m_bottom(0), m_buf(buf), m_mask(static_cast<std::ptrdiff_t>(capacity) - 1)
+		{
+			for (std::size_t i = 0U; i < capacity; i++) {
+				new(&m_buf[i]) std::atomic<TaskRunner*>(0);
+			}
+		}
+
+		bool push(TaskRunner* runner)
+		{
+			const std::ptrdiff_t b = m_bottom.load(std::memory_order_relaxed);
+			const std::ptrdiff_t t = m_top.load(std::memory_order_acquire);
+			if (b - t > m_mask) {
+				return false;
+			}
+			m_buf[b & m_mask].store(runner, std::memory_order_relaxed);
+			m_bottom.store(b + 1, std::memory_order_release);
+			return true;
+		}
+
+		TaskRunner* pop()
+		{
+			const std::ptrdiff_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::ptrdiff_t t = m_top.load(std::memory_order_relaxed);
+			if (t > b) {
+				m_bottom.store(b + 1, std::memory_order_relaxed);
+				return 0;
+			}
+			TaskRunner* runner = m_buf[b & m_mask].load(std::memory_order_relaxed);
+			if (t == b) {
+				// The last task. Race with the thieves.
+				if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					runner = 0;
+				}
+				m_bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return runner;
+		}
+
+		// *aborted is set to true if another worker took the task at the same time.
+		TaskRunner* steal(bool* aborted)
+		{
+			std::ptrdiff_t t = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const std::ptrdiff_t b = m_bottom.load(std::memory_order_acquire);
+			if (t >= b) {
+				return 0;
+			}
+			TaskRunner* runner = m_buf[t & m_mask].load(std::memory_order_relaxed);
+			if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				*aborted = true;
+				return 0;
+			}
+			return runner;
+		}
+
+	private:
+		static const std::size_t CACHE_LINE_SIZE = 64U;
+
+		std::atomic<std::ptrdiff_t> m_top;
+		unsigned char m_padding[CACHE_LINE_SIZE];
+		std::atomic<std::ptrdiff_t> m_bottom;
+		std::atomic<TaskRunner*>* const m_buf;
+		const std::ptrdiff_t m_mask;
+
+		Deque(const Deque&);
+		Deque& operator=(const Deque&);
+	};
+
+	class Worker : public Runnable {
+	public:
+		Worker(WorkStealingScheduler* scheduler, unsigned int seed, std::atomic<TaskRunner*>* buf, std::size_t capacity)
+		: m_scheduler(scheduler), m_thread(0), m_ev(0), m_sleeping(false), m_random(seed), m_deque(buf, capacity) {}
+
+		void run()
+		{
+			m_scheduler->runWorker(this);
+		}
+
+		// xorshift
+		unsigned int nextRandom()
+		{
+			m_random ^= m_random << 13;
+			m_random ^= m_random >> 17;
+			m_random ^= m_random << 5;
+			return m_random;
+		}
+
+		WorkStealingScheduler* m_scheduler;
+		Thread* m_thread;
+		EventFlag* m_ev;
+		std::atomic<bool> m_sleeping;
+		unsigned int m_random;
+		Deque m_deque;
+	};
+
+	Worker* const m_workers;
+	const std::size_t m_numWorkers;
+	MPMCMessageQueue<TaskRunner*>* m_sharedQueue;
+	MPMCMessageQueue<TaskRunner*>* m_freeRunners;
+	std::atomic<std::size_t> m_numSleeping;
+	std::atomic<std::size_t> m_nextWake;
+	std::atomic<bool> m_shutdown;
+
+	WorkStealingScheduler(FixedMemoryPool* pool, Worker* workers, std::size_t numWorkers,
+			std::atomic<TaskRunner*>* buf, std::size_t capacity)
+	: Scheduler(pool), m_workers(workers), m_numWorkers(numWorkers)
+	, m_sharedQueue(0), m_freeRunners(0), m_numSleeping(0U), m_nextWake(0U), m_shutdown(false)
+	{
+		for (std::size_t i = 0U; i < m_numWorkers; i++) {
+			new(&m_workers[i]) Worker(this, static_cast<unsigned int>(i) * 2654435761U + 1U, &buf[capacity * i], capacity);
+		}
+	}
+
+	~WorkStealingScheduler()
+	{
+		for (std::size_t i = 0U; i < m_numWorkers; i++) {
+			EventFlag::destroy(m_workers[i].m_ev);
+			m_workers[i].~Worker();
+		}
+		MPMCMessageQueue<TaskRunner*>::destroy(m_freeRunners);
+		MPMCMessageQueue<TaskRunner*>::destroy(m_sharedQueue);
+	}
+
+	bool createOSObjects(std::size_t maxTasks)
+	{
+		m_sharedQueue = MPMCMessageQueue<TaskRunner*>::create(maxTasks);
+		if (m_sharedQueue == 0) {
+			return false;
+		}
+		m_freeRunners = MPMCMessageQueue<TaskRunner*>::create(maxTasks);
+		if (m_freeRunners == 0) {
+			return false;
+		}
+		for (std::size_t i = 0U; i < m_numWorkers; i++) {
+			m_workers[i].m_ev = EventFlag::create(true);
+			if (m_workers[i].m_ev == 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// The worker is found by its Thread instead of a thread local variable, because not all the RTOSes support it.
+	Worker* findCurrentWorker()
+	{
+		const Thread* t = Thread::getCurrentThread();
+		if (t == 0) {
+			return 0;
+		}
+		for (std::size_t i = 0U; i < m_numWorkers; i++) {
+			if (m_workers[i].m_thread == t) {
+				return &m_workers[i];
+			}
+		}
+		return 0;
+	}
+
+	TaskRunner* findTask(Worker* self)
+	{
+		TaskRunner* runner = self->m_deque.pop();
+		if (runner != 0) {
+			return runner;
+		}
+		if (m_sharedQueue->tryReceive(&runner) == OK) {
+			return runner;
+		}
+		return steal(self);
+	}
+
+	TaskRunner* steal(Worker* self)
+	{
+		bool aborted = true;
+		while (aborted) {
+			aborted = false;
+			const std::size_t start = self->nextRandom() % m_numWorkers;
+			for (std::size_t i = 0U; i < m_numWorkers; i++) {
+				Worker* victim = &m_workers[(start + i) % m_numWorkers];
+				if (victim == self) {
+					continue;
+				}
+				TaskRunner* runner = victim->m_deque.steal(&aborted);
+				if (runner != 0) {
+					return runner;
+				}
+			}
+		}
+		return 0;
+	}
+
+	// The worker publishes m_sleeping before it looks for a task again,
+	// and the submitter publishes the task before it looks at m_numSleeping (both are separated by a full fence).
+	// So either the worker finds the task or the submitter wakes the worker.
+	void runWorker(Worker* self)
+	{
+		while (true) {
+			TaskRunner* runner = findTask(self);
+			if (runner == 0) {
+				self->m_sleeping.store(true);
+				m_numSleeping.fetch_add(1U);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				runner = findTask(self);
+				if ((runner == 0) && !m_shutdown.load()) {
+					self->m_ev->waitAny();
+				}
+				if (self->m_sleeping.exchange(false)) {
+					m_numSleeping.fetch_sub(1U);
+				}
+				if ((runner == 0) && m_shutdown.load()) {
+					runner = findTask(self);
+					if (runner == 0) {
+						break;
+					}
+				}
+			}
+			if (runner != 0) {
+				runner->runOn(self->m_thread);
+			}
+		}
+	}
+
+	void wakeOne()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_numSleeping.load(std::memory_order_relaxed) == 0U) {
+			return;
+		}
+		const std::size_t start = m_nextWake.fetch_add(1U, std::memory_order_relaxed) % m_numWorkers;
+		for (std::size_t i = 0U; i < m_numWorkers; i++) {
+			if (wake(&m_workers[(start + i) % m_numWorkers])) {
+				return;
+			}
+		}
+	}
+
+	bool wake(Worker* w)
+	{
+		if (w->m_sleeping.load(std::memory_order_relaxed) && w->m_sleeping.exchange(false)) {
+			m_numSleeping.fetch_sub(1U);
+			w->m_ev->setAll();
+			return true;
+		}
+		return false;
+	}
+};
+#endif
+
 ThreadPool::ThreadPool(FixedMemoryPool* objPool, int defaultPriority, const char* threadName)
 : m_freeRunnerQueue(0)
+, m_scheduler(0)
+, m_overflowPolicy(BLOCK)
+, m_chainMutex(0)
 , m_threads()
 , m_threadMemory(0)
 , m_threadMemoryPool(0)
@@ -23,6 +730,76 @@ ThreadPool::~ThreadPool()
 }
 
 ThreadPool* ThreadPool::create(std::size_t maxThreads, std::size_t stackSize/*= 0U*/, int defaultPriority/*= Thread::getNormalPriority()*/, const char* threadName/*= ""*/)
+{
+	ThreadPool* tp = createObject(defaultPriority, threadName);
+	if (tp == 0) {
+		return 0;
+	}
+
+	if (!tp->constructMembers(maxThreads, stackSize)) {
+		destroyObject(tp);
+		return 0;
+	}
+	return tp;
+}
+
+ThreadPool* ThreadPool::createQueued(std::size_t maxThreads, std::size_t queueSize, OverflowPolicy policy/*= BLOCK*/, std::size_t stackSize/*= 0U*/, int defaultPriority/*= Thread::getNormalPriority()*/, const char* threadName/*= ""*/)
+{
+	return createWithQueue(false, maxThreads, queueSize, policy, stackSize, defaultPriority, threadName);
+}
+
+ThreadPool* ThreadPool::createPriorityQueued(std::size_t maxThreads, std::size_t queueSize, OverflowPolicy policy/*= BLOCK*/, std::size_t stackSize/*= 0U*/, int defaultPriority/*= Thread::getNormalPriority()*/, const char* threadName/*= ""*/)
+{
+	return createWithQueue(true, maxThreads, queueSize, policy, stackSize, defaultPriority, threadName);
+}
+
+ThreadPool* ThreadPool::createWithQueue(bool byPriority, std::size_t maxThreads, std::size_t queueSize, OverflowPolicy policy, std::size_t stackSize, int defaultPriority, const char* threadName)
+{
+	if (maxThreads == 0U) {
+		return 0;
+	}
+	ThreadPool* tp = createObject(defaultPriority, threadName);
+	if (tp == 0) {
+		return 0;
+	}
+	tp->m_overflowPolicy = policy;
+
+	const std::size_t maxTasks = maxThreads + queueSize;
+	if (byPriority) {
+		tp->m_scheduler = PriorityScheduler::create(maxThreads, maxTasks);
+	} else {
+		tp->m_scheduler = QueuedScheduler::create(maxThreads, maxTasks);
+	}
+	if ((tp->m_scheduler == 0) || !tp->constructQueuedMembers(maxThreads, maxTasks, stackSize)) {
+		Scheduler::destroy(tp->m_scheduler);
+		destroyObject(tp);
+		return 0;
+	}
+	return tp;
+}
+
+#if (__cplusplus >= 201103L)
+ThreadPool* ThreadPool::createWorkStealing(std::size_t maxThreads, std::size_t maxTasks, std::size_t stackSize/*= 0U*/, int defaultPriority/*= Thread::getNormalPriority()*/, const char* threadName/*= ""*/)
+{
+	if ((maxThreads == 0U) || (maxTasks == 0U)) {
+		return 0;
+	}
+	ThreadPool* tp = createObject(defaultPriority, threadName);
+	if (tp == 0) {
+		return 0;
+	}
+
+	tp->m_scheduler = WorkStealingScheduler::create(maxThreads, maxTasks);
+	if ((tp->m_scheduler == 0) || !tp->constructQueuedMembers(maxThreads, maxTasks, stackSize)) {
+		Scheduler::destroy(tp->m_scheduler);
+		destroyObject(tp);
+		return 0;
+	}
+	return tp;
+}
+#endif
+
+ThreadPool* ThreadPool::createObject(int defaultPriority, const char* threadName)
 {
 	const std::size_t objSize = sizeof(ThreadPool);
 	FixedMemoryPool* objPool = FixedMemoryPool::create(objSize,
@@ -38,15 +815,23 @@ ThreadPool* ThreadPool::create(std::size_t maxThreads, std::size_t stackSize/*=
 	}
 	ThreadPool* tp = new(p) ThreadPool(objPool, defaultPriority, threadName);
 
-	if (!tp->constructMembers(maxThreads, stackSize)) {
-		tp->~ThreadPool();
-		objPool->deallocate(tp);
-		FixedMemoryPool::destroy(objPool);
+	tp->m_chainMutex = Mutex::create();
+	if (tp->m_chainMutex == 0) {
+		destroyObject(tp);
 		return 0;
 	}
 	return tp;
 }
 
+void ThreadPool::destroyObject(ThreadPool* tp)
+{
+	FixedMemoryPool* objPool = tp->m_objPool;
+	Mutex::destroy(tp->m_chainMutex);
+	tp->~ThreadPool();
+	objPool->deallocate(tp);
+	FixedMemoryPool::destroy(objPool);
+}
+
 bool ThreadPool::constructMembers(std::size_t maxThreads, std::size_t stackSize)
 {
 	const std::size_t threadMemoryPoolSize = sizeof(Thread*) * maxThreads;
@@ -106,17 +891,75 @@ failed:
 	return false;
 }
 
+// The task entries are not bound to the threads.
+// All the threads start here and run the workers of the scheduler.
+bool ThreadPool::constructQueuedMembers(std::size_t maxThreads, std::size_t maxTasks, std::size_t stackSize)
+{
+	const std::size_t threadMemoryPoolSize = sizeof(Thread*) * maxThreads;
+
+	m_threadMemoryPool = FixedMemoryPool::create(threadMemoryPoolSize,
+			FixedMemoryPool::getRequiredMemorySize(threadMemoryPoolSize, 1U));
+	if (m_threadMemoryPool == 0) {
+		goto failed;
+	}
+	m_threadMemory = m_threadMemoryPool->allocate();
+	if (m_threadMemory == 0) {
+		goto failed;
+	}
+	m_threads.init(m_threadMemory, threadMemoryPoolSize);
+
+	m_runnerPool = FixedMemoryPool::create(sizeof(TaskRunner),
+			FixedMemoryPool::getRequiredMemorySize(sizeof(TaskRunner), maxTasks));
+	if (m_runnerPool == 0) {
+		goto failed;
+	}
+
+	for (std::size_t i = 0U; i < maxTasks; ++i) {
+		void* p = m_runnerPool->allocate();
+		if (p == 0) {
+			goto failed;
+		}
+
+		EventFlag* e = EventFlag::create(false);
+		if (e == 0) {
+			m_runnerPool->deallocate(p);
+			goto failed;
+		}
+
+		TaskRunner* runner = new(p) TaskRunner(e, this);
+		m_scheduler->release(runner);
+	}
+
+	for (std::size_t i = 0U; i < maxThreads; ++i) {
+		Thread* t = Thread::create(m_scheduler->getWorker(i), m_defaultPriority, stackSize, 0, m_threadName);
+		if (t == 0) {
+			goto failed;
+		}
+		m_scheduler->setWorkerThread(i, t);
+		m_threads.push_back(t);
+	}
+
+	for (std::size_t i = 0U; i < m_threads.size(); ++i) {
+		m_threads[i]->start();
+	}
+	return true;
+
+failed:
+	destroyMembers();
+	return false;
+}
+
 void ThreadPool::destroy(ThreadPool* p)
 {
 	if (p == 0) {
 		return;
 	}
-	FixedMemoryPool* objPool = p->m_objPool;
+	if (p->m_scheduler != 0) {
+		p->m_scheduler->shutdown();
+	}
 	p->waitThreads();
 	p->destroyMembers();
-	p->~ThreadPool();
-	objPool->deallocate(p);
-	FixedMemoryPool::destroy(objPool);
+	destroyObject(p);
 }
 
 void ThreadPool::waitThreads()
@@ -134,11 +977,13 @@ void ThreadPool::destroyMembers()
 	FixedMemoryPool::destroy(m_runnerPool);
 	FixedMemoryPool::destroy(m_threadMemoryPool);
 	TaskRunnerMQ::destroy(m_freeRunnerQueue);
+	Scheduler::destroy(m_scheduler);
+	m_scheduler = 0;
 }
 
 void ThreadPool::destroyRunners()
 {
-	if (m_freeRunnerQueue == 0) {
+	if ((m_freeRunnerQueue == 0) && (m_scheduler == 0)) {
 		return;
 	}
 	if (m_runnerPool == 0) {
@@ -146,13 +991,20 @@ void ThreadPool::destroyRunners()
 	}
 	while (true) {
 		TaskRunner* runner = 0;
-		Error err = m_freeRunnerQueue->tryReceive(&runner);
+		Error err;
+		if (m_scheduler != 0) {
+			err = m_scheduler->timedAcquire(&runner, Timeout::POLLING);
+		} else {
+			err = m_freeRunnerQueue->tryReceive(&runner);
+		}
 		if (err != OK) {
 			// empty
 			break;
 		}
 		EventFlag::destroy(runner->getEventFlag());
-		Thread::destroy(runner->getThread());
+		if (m_scheduler == 0) {
+			Thread::destroy(runner->getThread());
+		}
 		runner->~TaskRunner();
 		m_runnerPool->deallocate(runner);
 	}
@@ -166,6 +1018,12 @@ void ThreadPool::destroyThreads()
 	if (m_threadMemory == 0) {
 		return;
 	}
+	if (m_scheduler != 0) {
+		// The threads are not owned by the task entries
+		for (std::size_t i = 0U; i < m_threads.size(); ++i) {
+			Thread::destroy(m_threads[i]);
+		}
+	}
 	m_threadMemoryPool->deallocate(m_threadMemory);
 }
 
@@ -185,27 +1043,222 @@ Error ThreadPool::timedStart(Runnable* task, Timeout tmout, WaitGuard* waiter/*=
 		return InvalidParameter;
 	}
 	TaskRunner* runner = 0;
-	const Error recvErr = m_freeRunnerQueue->timedReceive(&runner, tmout);
+	const Error err = reserveRunner(&runner, tmout);
+	if (err != OK) {
+		if ((err == TimedOut) && (m_scheduler != 0) && (m_overflowPolicy == CALLER_RUNS)) {
+			task->run();
+			return OK;
+		}
+		return err;
+	}
+
+	runner->prepare(task, priority, (waiter != 0));
+	if (waiter != 0) {
+		waiter->m_runner = runner;
+	}
+	dispatch(runner);
+	return OK;
+}
+
+// Start the task only if a thread is idle now. The task is not queued behind the other tasks.
+// The OverflowPolicy is not applied, so no queued task is discarded, and the task does not run in the current thread.
+Error ThreadPool::tryStartOnIdleThread(Runnable* task, WaitGuard* waiter)
+{
+	if (task == 0) {
+		return InvalidParameter;
+	}
+	TaskRunner* runner = 0;
+	Error err = OK;
+	if (m_scheduler != 0) {
+		if (!m_scheduler->hasIdleWorker()) {
+			return TimedOut;
+		}
+		err = m_scheduler->timedAcquire(&runner, Timeout::POLLING);
+	} else {
+		err = reserveRunner(&runner, Timeout::POLLING);
+	}
+	if (err != OK) {
+		return err;
+	}
+
+	runner->prepare(task, Thread::INHERIT_PRIORITY, (waiter != 0));
+	if (waiter != 0) {
+		waiter->m_runner = runner;
+	}
+	dispatch(runner);
+	return OK;
+}
+
+Error ThreadPool::startAfterAll(WaitGuard* const* antecedents, std::size_t numAntecedents, Runnable* task, WaitGuard* waiter/*= 0*/, int priority/*= Thread::INHERIT_PRIORITY*/)
+{
+	return timedStartAfter(antecedents, numAntecedents, false, task, Timeout::FOREVER, waiter, priority);
+}
+
+Error ThreadPool::startAfterAny(WaitGuard* const* antecedents, std::size_t numAntecedents, Runnable* task, WaitGuard* waiter/*= 0*/, int priority/*= Thread::INHERIT_PRIORITY*/)
+{
+	return timedStartAfter(antecedents, numAntecedents, true, task, Timeout::FOREVER, waiter, priority);
+}
+
+Error ThreadPool::timedStartAfterAll(WaitGuard* const* antecedents, std::size_t numAntecedents, Runnable* task, Timeout tmout, WaitGuard* waiter/*= 0*/, int priority/*= Thread::INHERIT_PRIORITY*/)
+{
+	return timedStartAfter(antecedents, numAntecedents, false, task, tmout, waiter, priority);
+}
+
+Error ThreadPool::timedStartAfterAny(WaitGuard* const* antecedents, std::size_t numAntecedents, Runnable* task, Timeout tmout, WaitGuard* waiter/*= 0*/, int priority/*= Thread::INHERIT_PRIORITY*/)
+{
+	return timedStartAfter(antecedents, numAntecedents, true, task, tmout, waiter, priority);
+}
+
+// The task entry of the following task is reserved here, so the thread that finishes the last antecedent only dispatches it.
+// The links between the entries are protected by m_chainMutex.
+// An entry of startAfterAny() may be reused after it runs while the other antecedents still link to it,
+// so a link is valid only if the generation of the entry has not changed.
+Error ThreadPool::timedStartAfter(WaitGuard* const* antecedents, std::size_t numAntecedents, bool afterAny, Runnable* task, Timeout tmout, WaitGuard* waiter, int priority)
+{
+	if ((antecedents == 0) || (numAntecedents == 0U) || (task == 0)) {
+		return InvalidParameter;
+	}
+	for (std::size_t i = 0U; i < numAntecedents; ++i) {
+		if (antecedents[i] == 0) {
+			return InvalidParameter;
+		}
+	}
+	{
+		// Fail before waiting for a free task entry. Checked again below, because the antecedents may finish meanwhile.
+		LockGuard lock(m_chainMutex);
+		for (std::size_t i = 0U; i < numAntecedents; ++i) {
+			const TaskRunner* a = antecedents[i]->m_runner;
+			if ((a != 0) && !a->m_finished && a->hasFollowingTask()) {
+				return InvalidParameter;
+			}
+		}
+	}
+
+	TaskRunner* runner = 0;
+	const Error err = reserveRunner(&runner, tmout);
+	if (err != OK) {
+		return err;
+	}
+	runner->prepare(task, priority, (waiter != 0));
+
+	bool runsNow = false;
+	{
+		LockGuard lock(m_chainMutex);
+		std::size_t numPending = 0U;
+		for (std::size_t i = 0U; i < numAntecedents; ++i) {
+			TaskRunner* a = antecedents[i]->m_runner;
+			if ((a == 0) || a->m_finished) {
+				continue;
+			}
+			if (a->hasFollowingTask()) {
+				releaseRunner(runner);
+				return InvalidParameter;
+			}
+			++numPending;
+		}
+
+		if ((numPending == 0U) || (afterAny && (numPending < numAntecedents))) {
+			runsNow = true;
+		} else {
+			++runner->m_generation;
+			runner->m_numPending = afterAny ? 1U : numPending;
+			for (std::size_t i = 0U; i < numAntecedents; ++i) {
+				TaskRunner* a = antecedents[i]->m_runner;
+				a->m_next = runner;
+				a->m_nextGeneration = runner->m_generation;
+			}
+		}
+	}
+
+	if (waiter != 0) {
+		waiter->m_runner = runner;
+	}
+	if (runsNow) {
+		dispatch(runner);
+	}
+	return OK;
+}
+
+// Called when the task of runner has finished or has been discarded, before the waiter is notified
+void ThreadPool::finishChain(TaskRunner* runner)
+{
+	TaskRunner* next = 0;
+	{
+		LockGuard lock(m_chainMutex);
+		runner->m_finished = true;
+		if (runner->hasFollowingTask()) {
+			TaskRunner* n = runner->m_next;
+			--n->m_numPending;
+			if (n->m_numPending == 0U) {
+				next = n;
+			}
+		}
+		runner->m_next = 0;
+	}
+	if (next != 0) {
+		dispatch(next);
+	}
+}
+
+// Get a free task entry. The thread of the entry of create() must have finished the previous task.
+Error ThreadPool::reserveRunner(TaskRunner** runner, Timeout tmout)
+{
+	if (m_scheduler != 0) {
+		return acquireRunner(runner, tmout);
+	}
+
+	const Error recvErr = m_freeRunnerQueue->timedReceive(runner, tmout);
 	if (recvErr != OK) {
 		return recvErr;
 	}
 
-	Thread* t = runner->getThread();
+	Thread* t = (*runner)->getThread();
 	const Error waitErr = t->timedWait(tmout);
 	if (waitErr != OK) {
+		m_freeRunnerQueue->send(*runner);
 		return waitErr;
 	}
+	return OK;
+}
 
-	runner->startThread(task, priority, (waiter != 0));
+void ThreadPool::dispatch(TaskRunner* runner)
+{
+	if (m_scheduler != 0) {
+		m_scheduler->submit(runner);
+		return;
+	}
+	runner->startThread();
+}
 
-	if (waiter != 0) {
-		waiter->m_runner = runner;
+// Get a free task entry following the overflow policy
+Error ThreadPool::acquireRunner(TaskRunner** runner, Timeout tmout)
+{
+	switch (m_overflowPolicy) {
+	case REJECT:
+	case CALLER_RUNS:
+		return m_scheduler->timedAcquire(runner, Timeout::POLLING);
+	case DISCARD_OLDEST:
+		while (m_scheduler->timedAcquire(runner, Timeout::POLLING) != OK) {
+			TaskRunner* oldest = 0;
+			if (!m_scheduler->discardOldest(&oldest)) {
+				// All the entries are running or waiting for WaitGuard::release()
+				return m_scheduler->timedAcquire(runner, tmout);
+			}
+			oldest->discard();
+		}
+		return OK;
+	case BLOCK:
+	default:
+		return m_scheduler->timedAcquire(runner, tmout);
 	}
-	return OK;
 }
 
 void ThreadPool::releaseRunner(TaskRunner* runner)
 {
+	if (m_scheduler != 0) {
+		m_scheduler->release(runner);
+		return;
+	}
 	m_freeRunnerQueue->send(runner);
 }
 
@@ -227,13 +1280,26 @@ const char* ThreadPool::getThreadName() const
 	return m_threadName;
 }
 
+std::size_t ThreadPool::getMaxThreads() const
+{
+	return m_threads.size();
+}
+
 
 ThreadPool::TaskRunner::TaskRunner(EventFlag* ev, ThreadPool* tp)
 : m_task(0)
 , m_thread(0)
 , m_ev(ev)
 , m_needsWaiting(false)
+, m_changesPriority(true)
+, m_discarded(false)
+, m_priority(Thread::INHERIT_PRIORITY)
 , m_tp(tp)
+, m_finished(false)
+, m_next(0)
+, m_nextGeneration(0U)
+, m_generation(0U)
+, m_numPending(0U)
 {
 }
 
@@ -241,12 +1307,68 @@ ThreadPool::TaskRunner::~TaskRunner()
 {
 }
 
-void ThreadPool::TaskRunner::startThread(Runnable* task, int priority, bool needsWaiting)
+void ThreadPool::TaskRunner::startThread()
+{
+	m_thread->setPriority(m_priority);
+	m_thread->start();
+}
+
+void ThreadPool::TaskRunner::prepare(Runnable* task, int priority, bool needsWaiting)
 {
 	m_task = task;
 	m_needsWaiting = needsWaiting;
-	m_thread->setPriority(priority);
-	m_thread->start();
+	m_priority = priority;
+	// The thread of create() always returns to the default priority, because setPriority() is called even with Thread::INHERIT_PRIORITY.
+	m_changesPriority = (m_tp->m_scheduler == 0) || (priority != Thread::INHERIT_PRIORITY);
+	m_discarded = false;
+	m_finished = false;
+}
+
+// Called by the worker thread of the scheduler.
+// An exception thrown by the task is handled here not to stop the worker.
+void ThreadPool::TaskRunner::runOn(Thread* t)
+{
+	m_thread = t;
+	if (m_changesPriority) {
+		m_thread->setPriority(m_priority);
+	}
+#ifndef CPPELIB_NO_EXCEPTIONS
+	try {
+#endif
+		invoke();
+#ifndef CPPELIB_NO_EXCEPTIONS
+	}
+	catch (const std::exception& e) {
+		handleException(e.what());
+	}
+	catch (const Assertion::Failure& e) {
+		handleException(e.message());
+	}
+	catch (...) {
+		handleException("Unknown Exception");
+	}
+#endif
+	afterInvoke();
+}
+
+void ThreadPool::TaskRunner::handleException(const char* msg)
+{
+#ifndef CPPELIB_NO_EXCEPTIONS
+	try {
+		Thread::UncaughtExceptionHandler* handler = m_thread->getUncaughtExceptionHandler();
+		if (handler == 0) {
+			handler = Thread::getDefaultUncaughtExceptionHandler();
+		}
+		if (handler != 0) {
+			handler->handle(m_thread, msg);
+		}
+	}
+	catch (...) {
+		// ignore exception
+	}
+#else
+	(void)msg;
+#endif
 }
 
 void ThreadPool::TaskRunner::run()
@@ -274,11 +1396,15 @@ void ThreadPool::TaskRunner::invoke()
 
 void ThreadPool::TaskRunner::afterInvoke()
 {
-	m_thread->setPriority(m_tp->getDefaultPriority());
+	if (m_changesPriority) {
+		m_thread->setPriority(m_tp->getDefaultPriority());
+	}
 	if (m_needsWaiting) {
+		m_tp->finishChain(this);
 		notifyFinished();
 	} else {
-		release();
+		// EventFlag has not been set
+		m_tp->releaseRunner(this);
 	}
 }
 
@@ -287,6 +1413,18 @@ void ThreadPool::TaskRunner::notifyFinished()
 	m_ev->setAll();
 }
 
+// The task is not run. The waiter is woken up as if the task has finished.
+void ThreadPool::TaskRunner::discard()
+{
+	m_discarded = true;
+	if (m_needsWaiting) {
+		m_tp->finishChain(this);
+		notifyFinished();
+	} else {
+		m_tp->releaseRunner(this);
+	}
+}
+
 void ThreadPool::TaskRunner::release()
 {
 	m_ev->resetAll();
@@ -333,7 +1471,11 @@ Error ThreadPool::WaitGuard::timedWait(Timeout tmout)
 	if (m_runner == 0) {
 		return OK;
 	}
-	return m_runner->timedWait(tmout);
+	const Error err = m_runner->timedWait(tmout);
+	if ((err == OK) && m_runner->isDiscarded()) {
+		return OtherError;
+	}
+	return err;
 }
 
 bool ThreadPool::WaitGuard::isValid() const
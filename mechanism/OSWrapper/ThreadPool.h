@@ -9,8 +9,10 @@
 namespace OSWrapper {
 
 template <typename T> class MessageQueue;
+class Mutex;
 class EventFlag;
 class FixedMemoryPool;
+template <typename Job> class ParallelRange;
 
 /*!
  * @brief Class of thread pool pattern
@@ -26,9 +28,18 @@ class FixedMemoryPool;
  * If you choose not to use a WaitGuard when you call start(), you don't have to wait for the task finished.
  * But the destruction of the task object must be later than the task finished.
  * Otherwise the access violation may occur that the thread may access to the destroyed object.
+ *
+ * A ThreadPool created by create() starts a task only when one of its threads is free.
+ * A ThreadPool created by createQueued(), createPriorityQueued() or createWorkStealing() has a task queue instead.
+ * Its threads keep running and take tasks from the queue, so start() returns as soon as the task is queued.
+ *
+ * startAfterAll() and startAfterAny() start a task when other tasks have finished, without blocking any thread until then.
+ * Future.h provides the tasks that return a value on top of them.
  */
 class ThreadPool {
 private:
+	template <typename Job> friend class ParallelRange;
+
 	class TaskRunner : public Runnable {
 	public:
 		void release();
@@ -39,32 +50,59 @@ private:
 
 		TaskRunner(EventFlag* ev, ThreadPool* tp);
 		~TaskRunner();
-		void startThread(Runnable* task, int priority, bool needsWaiting);
+		void startThread();
+		void prepare(Runnable* task, int priority, bool needsWaiting);
+		void runOn(Thread* t);
 		void run();
 		void invoke();
 		void afterInvoke();
+		void handleException(const char* msg);
 		void notifyFinished();
+		void discard();
+		bool isDiscarded() const { return m_discarded; }
+		bool hasFollowingTask() const { return (m_next != 0) && (m_next->m_generation == m_nextGeneration) && (m_next->m_numPending > 0U); }
 		void setThread(Thread* t) { m_thread = t; }
 		Thread* getThread() const { return m_thread; }
 		EventFlag* getEventFlag() const { return m_ev; }
+		int getPriority() const { return m_changesPriority ? m_priority : m_tp->getDefaultPriority(); }
 
 		Runnable* m_task;
 		Thread* m_thread;
 		EventFlag* m_ev;
 		bool m_needsWaiting;
+		bool m_changesPriority;
+		bool m_discarded;
+		int m_priority;
 		ThreadPool* m_tp;
 
+		// Used with the Mutex of ThreadPool locked
+		bool m_finished;
+		TaskRunner* m_next;
+		unsigned int m_nextGeneration;
+		unsigned int m_generation;
+		std::size_t m_numPending;
+
 		TaskRunner(const TaskRunner&);
 		TaskRunner& operator=(const TaskRunner&);
 	};
 
 public:
+	/*!
+	 * @brief What start() does when the task queue of a ThreadPool created by createQueued() or createPriorityQueued() is full
+	 */
+	enum OverflowPolicy {
+		BLOCK,         //!< Wait for a free entry of the queue within the timeout of start()
+		REJECT,        //!< Return TimedOut immediately
+		CALLER_RUNS,   //!< Run the task in the thread that calls start() and return OK after the task finished
+		DISCARD_OLDEST //!< Discard the oldest task that has not started yet and queue the new task. With createPriorityQueued(), the oldest task of the lowest priority is discarded.
+	};
+
 	/*!
 	 * @brief Class to wait for the asynchronous task finished
 	 *
 	 * WaitGuard has a validity state, valid or invalid.
 	 * After constuction, the state is invalid.
-	 * The state becomes valid by ThreadPool::start(), ThreadPool::tryStart(), or ThreadPool::timedStart().
+	 * The state becomes valid by ThreadPool::start(), ThreadPool::tryStart(), ThreadPool::timedStart(), ThreadPool::startAfterAll(), or ThreadPool::startAfterAny().
 	 * If the state is valid, the thread that owns this WaitGuard must wait() until the started asynchronous task finished and must release() the WaitGuard.
 	 * After release(), the state becomes invalid.
 	 * 
@@ -119,6 +157,7 @@ public:
 		 * @retval OK Success. The asynchronous task has finished
 		 * @retval TimedOut The limited time was elapsed
 		 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+		 * @retval OtherError The asynchronous task was discarded by OverflowPolicy DISCARD_OLDEST and has not run
 		 *
 		 * @note If the state is invalid, this method returns OK immediately.
 		 * @note If \p tmout is Timeout::POLLING then this method queries the state without blocking.
@@ -151,6 +190,67 @@ public:
 	 */
 	static ThreadPool* create(std::size_t maxThreads, std::size_t stackSize = 0U, int defaultPriority = Thread::getNormalPriority(), const char* threadName = "");
 
+	/*!
+	 * @brief Create a ThreadPool object that has a bounded task queue
+	 *
+	 * start() puts a task into the queue and returns without waiting for a free thread.
+	 * The threads take the tasks from the queue in FIFO order.
+	 * If the queue is full, start() follows \p policy.
+	 *
+	 * @param maxThreads Number of threads that execute the tasks
+	 * @param queueSize Number of tasks that can wait in the queue in addition to the running tasks
+	 * @param policy What start() does when the queue is full
+	 * @param stackSize Stack size of threads. If zero then sets default stack size of RTOS.
+	 * @param defaultPriority Thread priority of the threads. If a task is started with a priority other than Thread::INHERIT_PRIORITY, the thread runs the task at that priority. With Thread::INHERIT_PRIORITY, the task runs at \p defaultPriority.
+	 * @param threadName Name of threads. Threads are named the same name.
+	 * @return If this method succeeds then returns a pointer of ThreadPool object, else returns null pointer
+	 *
+	 * @note A task whose WaitGuard has not been released yet keeps its entry of the queue, even if the task has been discarded by DISCARD_OLDEST. So DISCARD_OLDEST may discard more than one task to get a free entry.
+	 * @note With CALLER_RUNS, the WaitGuard stays invalid because the task has already finished when start() returns. An exception thrown by the task is propagated to the caller of start().
+	 */
+	static ThreadPool* createQueued(std::size_t maxThreads, std::size_t queueSize, OverflowPolicy policy = BLOCK, std::size_t stackSize = 0U, int defaultPriority = Thread::getNormalPriority(), const char* threadName = "");
+
+	/*!
+	 * @brief Create a ThreadPool object that has a bounded task queue ordered by priority
+	 *
+	 * Same as createQueued() except that a free thread takes the task of the highest priority from the queue.
+	 * The tasks of the same priority are taken in FIFO order.
+	 * The priority of a task is the \p priority parameter of start(). If it is Thread::INHERIT_PRIORITY, the priority is \p defaultPriority.
+	 *
+	 * @param maxThreads Number of threads that execute the tasks
+	 * @param queueSize Number of tasks that can wait in the queue in addition to the running tasks
+	 * @param policy What start() does when the queue is full
+	 * @param stackSize Stack size of threads. If zero then sets default stack size of RTOS.
+	 * @param defaultPriority Thread priority of the threads, and the priority of the task started with Thread::INHERIT_PRIORITY
+	 * @param threadName Name of threads. Threads are named the same name.
+	 * @return If this method succeeds then returns a pointer of ThreadPool object, else returns null pointer
+	 *
+	 * @note A running task is not preempted by a task of higher priority in the queue.
+	 */
+	static ThreadPool* createPriorityQueued(std::size_t maxThreads, std::size_t queueSize, OverflowPolicy policy = BLOCK, std::size_t stackSize = 0U, int defaultPriority = Thread::getNormalPriority(), const char* threadName = "");
+
+#if (__cplusplus >= 201103L)
+	/*!
+	 * @brief Create a ThreadPool object that schedules the tasks by work stealing
+	 *
+	 * Each thread has its own deque of tasks (Chase-Lev deque).
+	 * A task started in a thread of this ThreadPool is pushed to the deque of the thread, and the other tasks are pushed to a shared queue.
+	 * A thread takes a task from its own deque first, then from the shared queue, then steals one from the deque of another thread chosen at random.
+	 * start() does not wait for a free thread but only for a free entry of the task queue.
+	 *
+	 * @param maxThreads Number of threads that execute the tasks
+	 * @param maxTasks Number of tasks that can be queued or running at the same time
+	 * @param stackSize Stack size of threads. If zero then sets default stack size of RTOS.
+	 * @param defaultPriority Thread priority of the threads. If a task is started with a priority other than Thread::INHERIT_PRIORITY, the thread runs the task at that priority. With Thread::INHERIT_PRIORITY, the task runs at \p defaultPriority.
+	 * @param threadName Name of threads. Threads are named the same name.
+	 * @return If this method succeeds then returns a pointer of ThreadPool object, else returns null pointer
+	 *
+	 * @note This method is available only in C++11 or later.
+	 * @note If a task waits for another task of the same ThreadPool by WaitGuard, all the threads may wait and never finish.
+	 */
+	static ThreadPool* createWorkStealing(std::size_t maxThreads, std::size_t maxTasks, std::size_t stackSize = 0U, int defaultPriority = Thread::getNormalPriority(), const char* threadName = "");
+#endif
+
 	/*!
 	 * @brief Destroy a ThreadPool object
 	 *
@@ -204,9 +304,62 @@ public:
 	 *
 	 * @note If \p tmout is Timeout::POLLING then this method does not block.
 	 * @note If \p tmout is Timeout::FOREVER then this method waits forever until a free thread is allocated.
+	 * @note If this ThreadPool has a task queue, this method waits for a free entry of the queue instead of a free thread, and OK means the task has been queued.
+	 * @note If this ThreadPool was created by createQueued() or createPriorityQueued() with a policy other than BLOCK, \p tmout is not used.
 	 */
 	Error timedStart(Runnable* task, Timeout tmout, WaitGuard* waiter = 0, int priority = Thread::INHERIT_PRIORITY);
 
+	/*!
+	 * @brief Start an asynchronous task after all the other tasks have finished
+	 *
+	 * This method reserves a free thread (or a free entry of the task queue) for \p task and returns.
+	 * When the last task of \p antecedents finishes, the thread that ran it starts \p task without waiting.
+	 * If all the tasks have already finished, \p task is started by this method.
+	 *
+	 * @param antecedents Array of pointers of WaitGuard objects of the tasks to wait for. A WaitGuard that is invalid means the task has finished.
+	 * @param numAntecedents Number of elements of \p antecedents
+	 * @param task Asynchronous task
+	 * @param waiter Pointer of variable of WaitGuard object that state is invalid. If this method succeeds, the WaitGuard object becomes valid. If you don't want to wait for the task finished, specify null pointer or omit this.
+	 * @param priority Thread priority of the asynchronous task
+	 * @retval OK Success. \p task has been started or will be started
+	 * @retval InvalidParameter \p antecedents or \p task is null pointer, \p numAntecedents is zero, or one of \p antecedents already has a following task
+	 * @retval CalledByNonThread Called from non thread context (interrupt handler, timer, etc)
+	 *
+	 * @note A task can be followed by only one task started by startAfterAll() or startAfterAny().
+	 * @note The reserved thread of a ThreadPool created by create() is not used by other tasks until \p task finishes.
+	 * @note Same as timedStartAfterAll(antecedents, numAntecedents, task, Timeout::FOREVER, waiter, priority)
+	 */
+	Error startAfterAll(WaitGuard* const* antecedents, std::size_t numAntecedents, Runnable* task, WaitGuard* waiter = 0, int priority = Thread::INHERIT_PRIORITY);
+
+	/*!
+	 * @brief Start an asynchronous task after one of the other tasks has finished
+	 *
+	 * Same as startAfterAll() except that \p task is started when the first task of \p antecedents finishes.
+	 *
+	 * @note Same as timedStartAfterAny(antecedents, numAntecedents, task, Timeout::FOREVER, waiter, priority)
+	 */
+	Error startAfterAny(WaitGuard* const* antecedents, std::size_t numAntecedents, Runnable* task, WaitGuard* waiter = 0, int priority = Thread::INHERIT_PRIORITY);
+
+	/*!
+	 * @brief Start an asynchronous task after all the other tasks have finished, with Timeout to reserve a thread
+	 *
+	 * Same as startAfterAll() except that this method waits for a free thread (or a free entry of the task queue) only for \p tmout.
+	 *
+	 * @retval TimedOut The limited time was elapsed
+	 * @note The OverflowPolicy CALLER_RUNS works as REJECT for this method, because \p task can't run before \p antecedents.
+	 */
+	Error timedStartAfterAll(WaitGuard* const* antecedents, std::size_t numAntecedents, Runnable* task, Timeout tmout, WaitGuard* waiter = 0, int priority = Thread::INHERIT_PRIORITY);
+
+	/*!
+	 * @brief Start an asynchronous task after one of the other tasks has finished, with Timeout to reserve a thread
+	 *
+	 * Same as startAfterAny() except that this method waits for a free thread (or a free entry of the task queue) only for \p tmout.
+	 *
+	 * @retval TimedOut The limited time was elapsed
+	 * @note The OverflowPolicy CALLER_RUNS works as REJECT for this method, because \p task can't run before \p antecedents.
+	 */
+	Error timedStartAfterAny(WaitGuard* const* antecedents, std::size_t numAntecedents, Runnable* task, Timeout tmout, WaitGuard* waiter = 0, int priority = Thread::INHERIT_PRIORITY);
+
 	/*!
 	 * @brief Set the UncaughtExceptionHandler for this ThreadPool
 	 * @param handler Pointer of UncaughtExceptionHandler object
@@ -225,9 +378,25 @@ public:
 	 */
 	const char* getThreadName() const;
 
+	/*!
+	 * @brief Get the number of threads
+	 * @return The number of threads
+	 */
+	std::size_t getMaxThreads() const;
+
 private:
+	class Scheduler;
+	class QueuedScheduler;
+	class PriorityScheduler;
+#if (__cplusplus >= 201103L)
+	class WorkStealingScheduler;
+#endif
+
 	typedef MessageQueue<TaskRunner*> TaskRunnerMQ;
 	TaskRunnerMQ* m_freeRunnerQueue;
+	Scheduler* m_scheduler;
+	OverflowPolicy m_overflowPolicy;
+	Mutex* m_chainMutex;
 
 	typedef Container::PreallocatedVector<Thread*> ThreadVector;
 	ThreadVector m_threads;
@@ -241,12 +410,22 @@ private:
 	const int m_defaultPriority;
 	const char* m_threadName;
 
+	static ThreadPool* createObject(int defaultPriority, const char* threadName);
+	static void destroyObject(ThreadPool* tp);
+	static ThreadPool* createWithQueue(bool byPriority, std::size_t maxThreads, std::size_t queueSize, OverflowPolicy policy, std::size_t stackSize, int defaultPriority, const char* threadName);
 	bool constructMembers(std::size_t maxThreads, std::size_t stackSize);
+	bool constructQueuedMembers(std::size_t maxThreads, std::size_t maxTasks, std::size_t stackSize);
 	void destroyMembers();
 	void destroyRunners();
 	void destroyThreads();
 	void waitThreads();
 	void releaseRunner(TaskRunner* runner);
+	Error acquireRunner(TaskRunner** runner, Timeout tmout);
+	Error reserveRunner(TaskRunner** runner, Timeout tmout);
+	Error tryStartOnIdleThread(Runnable* task, WaitGuard* waiter);
+	void dispatch(TaskRunner* runner);
+	Error timedStartAfter(WaitGuard* const* antecedents, std::size_t numAntecedents, bool afterAny, Runnable* task, Timeout tmout, WaitGuard* waiter, int priority);
+	void finishChain(TaskRunner* runner);
 	int getDefaultPriority() const { return m_defaultPriority; }
 
 	ThreadPool(FixedMemoryPool* objPool, int defaultPriority, const char* threadName);
@@ -5,4 +5,20 @@ namespace OSWrapper {
 const Timeout Timeout::POLLING(0);
 const Timeout Timeout::FOREVER(-1);
 
+Timeout Timeout::fromMicros(long microseconds)
+{
+	if (microseconds < 0) {
+		return FOREVER;
+	}
+	return Timeout(microseconds / 1000, (microseconds % 1000) * 1000);
+}
+
+Timeout Timeout::fromNanos(long nanoseconds)
+{
+	if (nanoseconds < 0) {
+		return FOREVER;
+	}
+	return Timeout(nanoseconds / 1000000, nanoseconds % 1000000);
+}
+
 }
@@ -11,25 +11,55 @@ namespace OSWrapper {
 class Timeout {
 private:
 	long m_milliseconds;
+	long m_subMillisNanos;
 
+	Timeout(long milliseconds, long subMillisNanos) : m_milliseconds(milliseconds), m_subMillisNanos(subMillisNanos) {}
 	Timeout& operator=(const Timeout&);
 public:
 	/*!
 	 * @brief Constructor of Timeout
 	 * @param milliseconds Set timeout in milliseconds
 	 */
-	explicit Timeout(long milliseconds) : m_milliseconds(milliseconds) {}
+	explicit Timeout(long milliseconds) : m_milliseconds(milliseconds), m_subMillisNanos(0) {}
 
 	/*!
 	 * @brief Copy constructor of Timeout
 	 * @param tmout Copy source object
 	 */
-	Timeout(const Timeout& tmout) : m_milliseconds(tmout.m_milliseconds) {}
+	Timeout(const Timeout& tmout) : m_milliseconds(tmout.m_milliseconds), m_subMillisNanos(tmout.m_subMillisNanos) {}
+
+	/*!
+	 * @brief Create the Timeout in microseconds
+	 * @param microseconds Timeout in microseconds
+	 * @return Timeout object. If microseconds is negative, returns FOREVER.
+	 */
+	static Timeout fromMicros(long microseconds);
+
+	/*!
+	 * @brief Create the Timeout in nanoseconds
+	 * @param nanoseconds Timeout in nanoseconds
+	 * @return Timeout object. If nanoseconds is negative, returns FOREVER.
+	 */
+	static Timeout fromNanos(long nanoseconds);
 
 	/*!
 	 * @brief Implicit conversion from the Timeout object to integer value
+	 *
+	 * The value is in milliseconds. If the Timeout has a fraction of a millisecond, the value is rounded up.
+	 */
+	operator long() const { return (m_subMillisNanos != 0) ? (m_milliseconds + 1) : m_milliseconds; }
+
+	/*!
+	 * @brief Get the whole milliseconds of the Timeout
+	 * @return Timeout in milliseconds without the fraction of a millisecond
+	 */
+	long getWholeMillis() const { return m_milliseconds; }
+
+	/*!
+	 * @brief Get the fraction of a millisecond of the Timeout
+	 * @return Fraction of a millisecond in nanoseconds (0 to 999999)
 	 */
-	operator long() const { return m_milliseconds; }
+	long getSubMillisNanos() const { return m_subMillisNanos; }
 
 	/*!
 	 * @brief Constant value object for non-blocking
@@ -19,7 +19,13 @@ VariableMemoryPool* VariableMemoryPool::create(std::size_t memoryPoolSize, void*
 
 void VariableMemoryPool::destroy(VariableMemoryPool* p)
 {
-	if ((s_factory != 0) && (p != 0)) {
+	if (p == 0) {
+		return;
+	}
+	if (p->destroySelf()) {
+		return;
+	}
+	if (s_factory != 0) {
 		s_factory->destroy(p);
 	}
 }
@@ -22,6 +22,15 @@ class VariableMemoryPool {
 protected:
 	virtual ~VariableMemoryPool() {}
 
+	/*!
+	 * @brief Destroy this object if it is not created by the VariableMemoryPoolFactory
+	 * @retval true This object has been destroyed
+	 * @retval false This object is destroyed by the VariableMemoryPoolFactory
+	 *
+	 * @note Override this in the class that is created by its own create() method, so VariableMemoryPool::destroy() can destroy it too.
+	 */
+	virtual bool destroySelf() { return false; }
+
 public:
 	/*!
 	 * @brief Create a VariableMemoryPool object
@@ -35,7 +44,7 @@ public:
 
 	/*!
 	 * @brief Destroy a VariableMemoryPool object
-	 * @param p Pointer of VariableMemoryPool object created by VariableMemoryPool::create()
+	 * @param p Pointer of VariableMemoryPool object created by VariableMemoryPool::create() or by the create() method of a derived class such as SizeClassMemoryPool
 	 *
 	 * @note If p is null pointer, do nothing.
 	 */
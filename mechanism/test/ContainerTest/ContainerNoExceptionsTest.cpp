@@ -6,6 +6,7 @@
 #include "Container/FixedDeque.h"
 #include "Container/PreallocatedVector.h"
 #include "Container/PreallocatedDeque.h"
+#include "Container/MonotonicArena.h"
 #include <string>
 #include <csetjmp>
 #include <cstdio>
@@ -17,6 +18,7 @@ using Container::FixedVector;
 using Container::FixedDeque;
 using Container::PreallocatedVector;
 using Container::PreallocatedDeque;
+using Container::MonotonicArena;
 
 namespace {
 std::jmp_buf s_jmpBuf;
@@ -204,4 +206,29 @@ TEST(ContainerNoExceptionsTest, PreallocatedDeque_test)
 	}
 	FAIL("failed");
 }
+
+TEST(ContainerNoExceptionsTest, MonotonicArena_test)
+{
+	TestAssert testAssert;
+	Assertion::setHandler(&testAssert);
+
+	double buf[10];
+	MonotonicArena<> x(buf, sizeof buf);
+	if (setjmp(s_jmpBuf) == 0) {
+		x.allocate(sizeof buf, 1);
+	} else {
+		FAIL("failed");
+	}
+
+	mock().expectOneCall("handle").onObject(&testAssert);
+	if (setjmp(s_jmpBuf) == 0) {
+		x.allocate(1, 1);
+		FAIL("failed");
+	} else {
+		STRCMP_CONTAINS("BadAlloc", testAssert.m_msg.c_str());
+		return;
+	}
+	FAIL("failed");
+}
+
 #endif
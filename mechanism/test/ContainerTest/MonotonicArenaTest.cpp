@@ -0,0 +1,275 @@
+#include "Container/MonotonicArena.h"
+#include "Container/PreallocatedVector.h"
+#include <cstdlib>
+#include "CppUTest/TestHarness.h"
+
+namespace MonotonicArenaTest {
+
+using Container::MonotonicArena;
+using Container::PreallocatedVector;
+
+class TestUpstreamPool {
+public:
+	int m_numBlocks;
+	int m_count;
+	std::size_t m_lastSize;
+	TestUpstreamPool() : m_numBlocks(0), m_count(-1), m_lastSize(0) {}
+	void* allocate(std::size_t size)
+	{
+		if (m_count == 0) {
+			return 0;
+		}
+		m_count--;
+		m_numBlocks++;
+		m_lastSize = size;
+		return std::malloc(size);
+	}
+	void deallocate(void* p)
+	{
+		m_numBlocks--;
+		std::free(p);
+	}
+};
+
+TEST_GROUP(MonotonicArenaTest) {
+	static const std::size_t ALLOC_SIZE = 256;
+	long double alloc_buf[ALLOC_SIZE / sizeof(long double)];
+	TestUpstreamPool upstream;
+
+	bool isInBuffer(const void* p, std::size_t size)
+	{
+		const char* cp = static_cast<const char*>(p);
+		const char* buf = reinterpret_cast<const char*>(alloc_buf);
+		return (buf <= cp) && (cp + size <= buf + ALLOC_SIZE);
+	}
+	bool isAligned(const void* p, std::size_t alignment)
+	{
+		return (reinterpret_cast<std::size_t>(p) % alignment) == 0;
+	}
+};
+
+TEST(MonotonicArenaTest, allocate)
+{
+	MonotonicArena<> x(alloc_buf, ALLOC_SIZE);
+	LONGS_EQUAL(ALLOC_SIZE, x.remaining_size());
+
+	void* p = x.allocate(10);
+	POINTERS_EQUAL(alloc_buf, p);
+	void* q = x.allocate(10);
+	CHECK(isInBuffer(q, 10));
+	CHECK(static_cast<char*>(p) + 10 <= static_cast<char*>(q));
+	CHECK(isAligned(q, MonotonicArena<>::DEFAULT_ALIGNMENT));
+	CHECK(x.remaining_size() <= ALLOC_SIZE - 20);
+}
+
+TEST(MonotonicArenaTest, allocate_alignment)
+{
+	MonotonicArena<> x(alloc_buf, ALLOC_SIZE);
+	void* p = x.allocate(1, 1);
+	void* q = x.allocate(1, 1);
+	POINTERS_EQUAL(static_cast<char*>(p) + 1, q);
+
+	void* r = x.allocate(4, 32);
+	CHECK(isAligned(r, 32));
+	CHECK(isInBuffer(r, 4));
+}
+
+TEST(MonotonicArenaTest, allocate_array)
+{
+	MonotonicArena<> x(alloc_buf, ALLOC_SIZE);
+	x.allocate(1, 1);
+	int* p = x.allocate_array<int>(10);
+	CHECK(isAligned(p, sizeof(int)));
+	CHECK(isInBuffer(p, sizeof(int) * 10));
+	for (int i = 0; i < 10; i++) {
+		p[i] = i;
+	}
+	LONGS_EQUAL(9, p[9]);
+}
+
+TEST(MonotonicArenaTest, allocate_whole_buffer)
+{
+	MonotonicArena<> x(alloc_buf, ALLOC_SIZE);
+	void* p = x.allocate(ALLOC_SIZE);
+	POINTERS_EQUAL(alloc_buf, p);
+	LONGS_EQUAL(0, x.remaining_size());
+}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+TEST(MonotonicArenaTest, allocate_exception)
+{
+	MonotonicArena<> x(alloc_buf, ALLOC_SIZE);
+	x.allocate(ALLOC_SIZE - 8);
+	try {
+		x.allocate(9, 1);
+	}
+	catch (const std::exception& e) {
+		STRCMP_EQUAL("MonotonicArena::BadAlloc", e.what());
+		return;
+	}
+	FAIL("failed");
+}
+
+TEST(MonotonicArenaTest, allocate_array_exception)
+{
+	MonotonicArena<> x(alloc_buf, ALLOC_SIZE);
+	try {
+		x.allocate_array<int>(static_cast<std::size_t>(-1) / sizeof(int) + 1);
+	}
+	catch (const std::exception& e) {
+		STRCMP_EQUAL("MonotonicArena::BadAlloc", e.what());
+		return;
+	}
+	FAIL("failed");
+}
+
+TEST(MonotonicArenaTest, allocate_exception_upstream_failed)
+{
+	MonotonicArena<TestUpstreamPool> x(alloc_buf, ALLOC_SIZE, &upstream);
+	upstream.m_count = 0;
+	try {
+		x.allocate(ALLOC_SIZE + 1);
+	}
+	catch (const std::exception& e) {
+		STRCMP_EQUAL("MonotonicArena::BadAlloc", e.what());
+		return;
+	}
+	FAIL("failed");
+}
+#endif
+
+TEST(MonotonicArenaTest, init_only_one_time)
+{
+	MonotonicArena<> x;
+	x.init(alloc_buf, ALLOC_SIZE);
+	void* p = x.allocate(10);
+	POINTERS_EQUAL(alloc_buf, p);
+
+	double b[10];
+	x.init(b, sizeof b); // do nothing
+	x.release();
+	p = x.allocate(10);
+	POINTERS_EQUAL(alloc_buf, p);
+}
+
+TEST(MonotonicArenaTest, mark_rewind)
+{
+	MonotonicArena<> x(alloc_buf, ALLOC_SIZE);
+	x.allocate(10);
+	MonotonicArena<>::Marker m = x.mark();
+	const std::size_t remaining = x.remaining_size();
+
+	void* p = x.allocate(20);
+	x.allocate(30);
+	x.rewind(m);
+	LONGS_EQUAL(remaining, x.remaining_size());
+	void* q = x.allocate(20);
+	POINTERS_EQUAL(p, q);
+
+	// Rewind to the same marker again
+	x.rewind(m);
+	q = x.allocate(20);
+	POINTERS_EQUAL(p, q);
+}
+
+TEST(MonotonicArenaTest, release)
+{
+	MonotonicArena<> x(alloc_buf, ALLOC_SIZE);
+	x.allocate(100);
+	x.release();
+	LONGS_EQUAL(ALLOC_SIZE, x.remaining_size());
+	POINTERS_EQUAL(alloc_buf, x.allocate(10));
+
+	x.release();
+	x.rewind(MonotonicArena<>::Marker());
+	POINTERS_EQUAL(alloc_buf, x.allocate(10));
+}
+
+TEST(MonotonicArenaTest, upstream_block)
+{
+	MonotonicArena<TestUpstreamPool> x(alloc_buf, ALLOC_SIZE, &upstream, 1024);
+	x.allocate(ALLOC_SIZE - 8);
+	LONGS_EQUAL(0, upstream.m_numBlocks);
+
+	void* p = x.allocate(100);
+	CHECK(!isInBuffer(p, 100));
+	CHECK(isAligned(p, MonotonicArena<TestUpstreamPool>::DEFAULT_ALIGNMENT));
+	LONGS_EQUAL(1, upstream.m_numBlocks);
+	CHECK(upstream.m_lastSize >= 1024);
+
+	// The upstream block is used until it is full
+	x.allocate(800);
+	LONGS_EQUAL(1, upstream.m_numBlocks);
+	x.allocate(200);
+	LONGS_EQUAL(2, upstream.m_numBlocks);
+
+	// A larger allocation than the upstream block size
+	void* q = x.allocate(4000);
+	CHECK(q);
+	LONGS_EQUAL(3, upstream.m_numBlocks);
+	CHECK(upstream.m_lastSize >= 4000);
+
+	x.release();
+	LONGS_EQUAL(0, upstream.m_numBlocks);
+	POINTERS_EQUAL(alloc_buf, x.allocate(10));
+}
+
+TEST(MonotonicArenaTest, rewind_returns_upstream_blocks)
+{
+	MonotonicArena<TestUpstreamPool> x(alloc_buf, ALLOC_SIZE, &upstream, 1024);
+	x.allocate(ALLOC_SIZE);
+	x.allocate(100);
+	LONGS_EQUAL(1, upstream.m_numBlocks);
+
+	MonotonicArena<TestUpstreamPool>::Marker m = x.mark();
+	void* p = x.allocate(100);
+	x.allocate(2000);
+	x.allocate(2000);
+	LONGS_EQUAL(3, upstream.m_numBlocks);
+
+	x.rewind(m);
+	LONGS_EQUAL(1, upstream.m_numBlocks);
+	POINTERS_EQUAL(p, x.allocate(100));
+}
+
+TEST(MonotonicArenaTest, dtor_returns_upstream_blocks)
+{
+	{
+		MonotonicArena<TestUpstreamPool> x(alloc_buf, ALLOC_SIZE, &upstream);
+		x.allocate(ALLOC_SIZE + 1);
+		x.allocate(ALLOC_SIZE + 1);
+		LONGS_EQUAL(2, upstream.m_numBlocks);
+	}
+	LONGS_EQUAL(0, upstream.m_numBlocks);
+}
+
+TEST(MonotonicArenaTest, no_buffer_only_upstream)
+{
+	MonotonicArena<TestUpstreamPool> x(0, 0, &upstream, 512);
+	void* p = x.allocate(10);
+	CHECK(p);
+	LONGS_EQUAL(1, upstream.m_numBlocks);
+	x.release();
+	LONGS_EQUAL(0, upstream.m_numBlocks);
+}
+
+TEST(MonotonicArenaTest, buffer_of_PreallocatedVector)
+{
+	MonotonicArena<> x(alloc_buf, ALLOC_SIZE);
+	for (int frame = 0; frame < 3; frame++) {
+		MonotonicArena<>::Marker m = x.mark();
+		PreallocatedVector<int> v(x.allocate_array<int>(10), sizeof(int) * 10);
+		PreallocatedVector<double> w(x.allocate_array<double>(5), sizeof(double) * 5);
+		for (int i = 0; i < 10; i++) {
+			v.push_back(i + frame);
+		}
+		w.resize(5, 1.5);
+		LONGS_EQUAL(10, v.size());
+		LONGS_EQUAL(frame + 9, v.back());
+		DOUBLES_EQUAL(1.5, w.back(), 0.0);
+		x.rewind(m);
+	}
+	LONGS_EQUAL(ALLOC_SIZE, x.remaining_size());
+}
+
+} // namespace MonotonicArenaTest
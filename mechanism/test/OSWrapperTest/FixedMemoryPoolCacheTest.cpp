@@ -0,0 +1,439 @@
+#include "OSWrapper/FixedMemoryPool.h"
+#include "OSWrapper/FixedMemoryPoolCache.h"
+#include "OSWrapper/Thread.h"
+#include "OSWrapper/ThreadFactory.h"
+#include "OSWrapper/Mutex.h"
+#include "OSWrapper/MutexFactory.h"
+
+#include "CppUTest/TestHarness.h"
+
+namespace FixedMemoryPoolCacheTest {
+
+using OSWrapper::FixedMemoryPool;
+using OSWrapper::FixedMemoryPoolCache;
+using OSWrapper::Runnable;
+using OSWrapper::Thread;
+using OSWrapper::ThreadFactory;
+using OSWrapper::Mutex;
+using OSWrapper::MutexFactory;
+using OSWrapper::Timeout;
+
+class TestThread : public Thread {
+public:
+	TestThread() : Thread(0) {}
+	~TestThread() {}
+	void start() {}
+	OSWrapper::Error wait() { return OSWrapper::OK; }
+	OSWrapper::Error tryWait() { return OSWrapper::OK; }
+	OSWrapper::Error timedWait(Timeout) { return OSWrapper::OK; }
+	bool isFinished() const { return false; }
+	void setName(const char*) {}
+	const char* getName() const { return ""; }
+	void setPriority(int) {}
+	int getPriority() const { return 0; }
+	int getInitialPriority() const { return 0; }
+	std::size_t getStackSize() const { return 0; }
+	void* getNativeHandle() { return 0; }
+};
+
+class TestThreadFactory : public ThreadFactory {
+public:
+	Thread* m_currentThread;
+	TestThreadFactory() : m_currentThread(0) {}
+private:
+	Thread* create(Runnable*, int, std::size_t, void*, const char*)
+	{
+		return 0;
+	}
+	void destroy(Thread*)
+	{
+	}
+	void sleep(unsigned long)
+	{
+	}
+	void yield()
+	{
+	}
+	Thread* getCurrentThread()
+	{
+		return m_currentThread;
+	}
+	int getMaxPriority() const
+	{
+		return 10;
+	}
+	int getMinPriority() const
+	{
+		return 1;
+	}
+	int getHighestPriority() const
+	{
+		return 10;
+	}
+	int getLowestPriority() const
+	{
+		return 1;
+	}
+};
+
+class TestMutex : public Mutex {
+public:
+	TestMutex() {}
+	~TestMutex() {}
+	OSWrapper::Error lock()
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error tryLock()
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error timedLock(Timeout)
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error unlock()
+	{
+		return OSWrapper::OK;
+	}
+};
+
+class TestMutexFactory : public MutexFactory {
+public:
+	int m_count;
+	TestMutexFactory() : m_count(-1) {}
+	Mutex* create()
+	{
+		if (m_count == 0) {
+			return 0;
+		}
+		m_count--;
+		return new TestMutex();
+	}
+	Mutex* create(int)
+	{
+		return create();
+	}
+	void destroy(Mutex* m)
+	{
+		delete static_cast<TestMutex*>(m);
+	}
+};
+
+class FakeFixedMemoryPool : public FixedMemoryPool {
+public:
+	static const std::size_t MAX_BLOCKS = 10;
+	double m_buf[MAX_BLOCKS];
+	void* m_free[MAX_BLOCKS];
+	std::size_t m_numFree;
+	int m_numTryAllocate;
+	int m_numTimedAllocate;
+	int m_numDeallocate;
+	long m_lastTimeout;
+	void (*m_onTimedAllocate)();
+
+	FakeFixedMemoryPool()
+	: m_numFree(MAX_BLOCKS), m_numTryAllocate(0), m_numTimedAllocate(0), m_numDeallocate(0), m_lastTimeout(0), m_onTimedAllocate(0)
+	{
+		for (std::size_t i = 0; i < MAX_BLOCKS; i++) {
+			m_free[i] = &m_buf[i];
+		}
+	}
+	~FakeFixedMemoryPool() {}
+
+	void* allocate()
+	{
+		return 0;
+	}
+	void deallocate(void* p)
+	{
+		m_numDeallocate++;
+		m_free[m_numFree++] = p;
+	}
+	std::size_t getBlockSize() const
+	{
+		return sizeof(double);
+	}
+	OSWrapper::Error tryAllocateMemory(void** memory)
+	{
+		m_numTryAllocate++;
+		if (m_numFree == 0) {
+			return OSWrapper::TimedOut;
+		}
+		*memory = m_free[--m_numFree];
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error timedAllocateMemory(void** memory, Timeout tmout)
+	{
+		m_numTimedAllocate++;
+		m_lastTimeout = tmout;
+		if (m_onTimedAllocate != 0) {
+			// Another thread runs while this thread waits
+			m_onTimedAllocate();
+		}
+		if (m_numFree == 0) {
+			return OSWrapper::TimedOut;
+		}
+		*memory = m_free[--m_numFree];
+		return OSWrapper::OK;
+	}
+	std::size_t getNumberOfAvailableBlocks() const
+	{
+		return m_numFree;
+	}
+	std::size_t getMaxNumberOfBlocks() const
+	{
+		return MAX_BLOCKS;
+	}
+};
+
+static TestThreadFactory s_threadFactory;
+static TestThread s_thread;
+
+TEST_GROUP(FixedMemoryPoolCacheTest) {
+	FakeFixedMemoryPool pool;
+	TestMutexFactory mutexFactory;
+
+	void setup()
+	{
+		OSWrapper::registerThreadFactory(&s_threadFactory);
+		OSWrapper::registerMutexFactory(&mutexFactory);
+		s_threadFactory.m_currentThread = &s_thread;
+	}
+	void teardown()
+	{
+		s_threadFactory.m_currentThread = 0;
+	}
+};
+
+TEST(FixedMemoryPoolCacheTest, ctor)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	LONGS_EQUAL(0, cache.getNumberOfCachedBlocks());
+	POINTERS_EQUAL(&pool, cache.getFixedMemoryPool());
+	LONGS_EQUAL(sizeof(double), cache.getBlockSize());
+	LONGS_EQUAL(FakeFixedMemoryPool::MAX_BLOCKS, cache.getMaxNumberOfBlocks());
+	LONGS_EQUAL(0, pool.m_numTryAllocate);
+}
+
+TEST(FixedMemoryPoolCacheTest, allocate_refills_half_of_capacity)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	void* p = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&p));
+	CHECK(p);
+	LONGS_EQUAL(2, pool.m_numTryAllocate);
+	LONGS_EQUAL(1, cache.getNumberOfCachedBlocks());
+	LONGS_EQUAL(8, pool.getNumberOfAvailableBlocks());
+
+	// Allocated from the cache
+	void* q = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.tryAllocateMemory(&q));
+	CHECK(q);
+	CHECK(p != q);
+	LONGS_EQUAL(2, pool.m_numTryAllocate);
+	LONGS_EQUAL(0, cache.getNumberOfCachedBlocks());
+
+	cache.deallocate(p);
+	cache.deallocate(q);
+	LONGS_EQUAL(2, cache.getNumberOfCachedBlocks());
+	LONGS_EQUAL(0, pool.m_numDeallocate);
+}
+
+TEST(FixedMemoryPoolCacheTest, allocate_returns_last_deallocated_block)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	void* p = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&p));
+	cache.deallocate(p);
+	void* q = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&q));
+	POINTERS_EQUAL(p, q);
+	cache.deallocate(q);
+}
+
+TEST(FixedMemoryPoolCacheTest, deallocate_spills_half_of_capacity_when_full)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	void* p[5] = {0};
+	for (int i = 0; i < 5; i++) {
+		LONGS_EQUAL(OSWrapper::OK, pool.tryAllocateMemory(&p[i]));
+	}
+	for (int i = 0; i < 4; i++) {
+		cache.deallocate(p[i]);
+	}
+	LONGS_EQUAL(4, cache.getNumberOfCachedBlocks());
+	LONGS_EQUAL(0, pool.m_numDeallocate);
+
+	cache.deallocate(p[4]);
+	LONGS_EQUAL(3, cache.getNumberOfCachedBlocks());
+	LONGS_EQUAL(2, pool.m_numDeallocate);
+
+	// The blocks deallocated first have been returned to the pool
+	POINTERS_EQUAL(p[0], pool.m_free[pool.m_numFree - 2]);
+	POINTERS_EQUAL(p[1], pool.m_free[pool.m_numFree - 1]);
+
+	void* q = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&q));
+	POINTERS_EQUAL(p[4], q);
+	cache.deallocate(q);
+}
+
+TEST(FixedMemoryPoolCacheTest, deallocate_nullptr)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	cache.deallocate(0);
+	LONGS_EQUAL(0, cache.getNumberOfCachedBlocks());
+}
+
+TEST(FixedMemoryPoolCacheTest, allocate_waits_for_pool_when_exhausted)
+{
+	void* blocks[FakeFixedMemoryPool::MAX_BLOCKS];
+	for (std::size_t i = 0; i < FakeFixedMemoryPool::MAX_BLOCKS; i++) {
+		LONGS_EQUAL(OSWrapper::OK, pool.tryAllocateMemory(&blocks[i]));
+	}
+	FixedMemoryPoolCache<4> cache(&pool);
+	void* p = 0;
+	LONGS_EQUAL(OSWrapper::TimedOut, cache.timedAllocateMemory(&p, Timeout(100)));
+	LONGS_EQUAL(1, pool.m_numTimedAllocate);
+	LONGS_EQUAL(100, pool.m_lastTimeout);
+
+	LONGS_EQUAL(OSWrapper::TimedOut, cache.tryAllocateMemory(&p));
+	LONGS_EQUAL(2, pool.m_numTimedAllocate);
+	LONGS_EQUAL(static_cast<long>(Timeout::POLLING), pool.m_lastTimeout);
+
+	pool.deallocate(blocks[0]);
+	LONGS_EQUAL(OSWrapper::OK, cache.timedAllocateMemory(&p, Timeout(100)));
+	POINTERS_EQUAL(blocks[0], p);
+	cache.deallocate(p);
+}
+
+TEST(FixedMemoryPoolCacheTest, allocate_invalid_parameter)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	LONGS_EQUAL(OSWrapper::InvalidParameter, cache.allocateMemory(0));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, cache.tryAllocateMemory(0));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, cache.timedAllocateMemory(0, Timeout(100)));
+	LONGS_EQUAL(0, pool.m_numTryAllocate);
+}
+
+TEST(FixedMemoryPoolCacheTest, flush)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	void* p = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&p));
+	cache.deallocate(p);
+	LONGS_EQUAL(2, cache.getNumberOfCachedBlocks());
+	LONGS_EQUAL(8, pool.getNumberOfAvailableBlocks());
+
+	cache.flush();
+	LONGS_EQUAL(0, cache.getNumberOfCachedBlocks());
+	LONGS_EQUAL(10, pool.getNumberOfAvailableBlocks());
+}
+
+TEST(FixedMemoryPoolCacheTest, getNumberOfAvailableBlocks_counts_cached_blocks)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	void* p = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&p));
+	LONGS_EQUAL(1, cache.getNumberOfCachedBlocks());
+	LONGS_EQUAL(9, cache.getNumberOfAvailableBlocks());
+	cache.deallocate(p);
+	LONGS_EQUAL(10, cache.getNumberOfAvailableBlocks());
+	LONGS_EQUAL(8, pool.getNumberOfAvailableBlocks());
+}
+
+TEST(FixedMemoryPoolCacheTest, allocate_takes_back_blocks_of_other_caches)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	void* p = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&p));
+	void* blocks[FakeFixedMemoryPool::MAX_BLOCKS - 2];
+	for (std::size_t i = 0; i < FakeFixedMemoryPool::MAX_BLOCKS - 2; i++) {
+		LONGS_EQUAL(OSWrapper::OK, pool.tryAllocateMemory(&blocks[i]));
+	}
+	LONGS_EQUAL(1, cache.getNumberOfCachedBlocks());
+
+	// The thread not created by Thread::create() has no cache, and takes the block kept by the cache of s_thread
+	s_threadFactory.m_currentThread = 0;
+	void* q = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.tryAllocateMemory(&q));
+	CHECK(q);
+	LONGS_EQUAL(1, pool.m_numTimedAllocate);
+	LONGS_EQUAL(0, cache.getNumberOfCachedBlocks());
+	LONGS_EQUAL(0, cache.getNumberOfAvailableBlocks());
+
+	cache.deallocate(q);
+	LONGS_EQUAL(1, pool.getNumberOfAvailableBlocks());
+	LONGS_EQUAL(0, cache.getNumberOfCachedBlocks());
+	s_threadFactory.m_currentThread = &s_thread;
+	cache.deallocate(p);
+	for (std::size_t i = 0; i < FakeFixedMemoryPool::MAX_BLOCKS - 2; i++) {
+		pool.deallocate(blocks[i]);
+	}
+}
+
+static FixedMemoryPoolCache<4>* s_cache;
+static void* s_block;
+
+static void deallocateByThread()
+{
+	s_threadFactory.m_currentThread = &s_thread;
+	s_cache->deallocate(s_block);
+	s_threadFactory.m_currentThread = 0;
+}
+
+TEST(FixedMemoryPoolCacheTest, deallocate_while_waiting_returns_block_to_pool)
+{
+	FixedMemoryPoolCache<4> cache(&pool);
+	void* blocks[FakeFixedMemoryPool::MAX_BLOCKS];
+	for (std::size_t i = 0; i < FakeFixedMemoryPool::MAX_BLOCKS; i++) {
+		LONGS_EQUAL(OSWrapper::OK, pool.tryAllocateMemory(&blocks[i]));
+	}
+
+	// While the thread not created by Thread::create() waits, s_thread deallocates a block
+	s_cache = &cache;
+	s_block = blocks[0];
+	pool.m_onTimedAllocate = deallocateByThread;
+	s_threadFactory.m_currentThread = 0;
+	void* p = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&p));
+	POINTERS_EQUAL(blocks[0], p);
+	LONGS_EQUAL(0, cache.getNumberOfCachedBlocks());
+	pool.m_onTimedAllocate = 0;
+
+	// After the wait, the block is kept by the cache again
+	s_threadFactory.m_currentThread = &s_thread;
+	cache.deallocate(p);
+	LONGS_EQUAL(1, cache.getNumberOfCachedBlocks());
+	for (std::size_t i = 1; i < FakeFixedMemoryPool::MAX_BLOCKS; i++) {
+		pool.deallocate(blocks[i]);
+	}
+}
+
+TEST(FixedMemoryPoolCacheTest, mutex_create_failed)
+{
+	mutexFactory.m_count = 0;
+	FixedMemoryPoolCache<4> cache(&pool);
+	void* p = 0;
+	LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&p));
+	LONGS_EQUAL(1, pool.m_numTryAllocate);
+	LONGS_EQUAL(9, pool.getNumberOfAvailableBlocks());
+	cache.deallocate(p);
+	LONGS_EQUAL(0, cache.getNumberOfCachedBlocks());
+	LONGS_EQUAL(10, pool.getNumberOfAvailableBlocks());
+}
+
+TEST(FixedMemoryPoolCacheTest, dtor_flushes)
+{
+	{
+		FixedMemoryPoolCache<4> cache(&pool);
+		void* p = 0;
+		LONGS_EQUAL(OSWrapper::OK, cache.allocateMemory(&p));
+		cache.deallocate(p);
+		LONGS_EQUAL(8, pool.getNumberOfAvailableBlocks());
+	}
+	LONGS_EQUAL(10, pool.getNumberOfAvailableBlocks());
+}
+
+} // namespace FixedMemoryPoolCacheTest
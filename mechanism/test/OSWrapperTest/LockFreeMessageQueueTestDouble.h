@@ -0,0 +1,181 @@
+#ifndef LOCK_FREE_MESSAGE_QUEUE_TEST_DOUBLE_H_INCLUDED
+#define LOCK_FREE_MESSAGE_QUEUE_TEST_DOUBLE_H_INCLUDED
+
+#if (__cplusplus >= 201103L)
+#include "OSWrapper/EventFlag.h"
+#include "OSWrapper/EventFlagFactory.h"
+#include "OSWrapper/FixedMemoryPool.h"
+#include "OSWrapper/FixedMemoryPoolFactory.h"
+#include <vector>
+#include <chrono>
+#include <thread>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+#include "CppUTest/MemoryLeakDetectorMallocMacros.h"
+
+// The test doubles shared by SPSCMessageQueueTest and MPMCMessageQueueTest
+namespace LockFreeMessageQueueTestDouble {
+
+using OSWrapper::EventFlag;
+using OSWrapper::EventFlagFactory;
+using OSWrapper::FixedMemoryPool;
+using OSWrapper::FixedMemoryPoolFactory;
+using OSWrapper::Timeout;
+
+class TestEventFlag : public EventFlag {
+public:
+	std::vector<Timeout> m_timeouts;
+	int m_sleepMillis;
+	TestEventFlag() : m_timeouts(), m_sleepMillis(0) {}
+	OSWrapper::Error waitAny()
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error waitOne(std::size_t)
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error wait(Pattern, Mode, Pattern*)
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error tryWaitAny()
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error tryWaitOne(std::size_t)
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error tryWait(Pattern, Mode, Pattern*)
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error timedWaitAny(Timeout)
+	{
+		return OSWrapper::TimedOut;
+	}
+	OSWrapper::Error timedWaitOne(std::size_t, Timeout)
+	{
+		return OSWrapper::TimedOut;
+	}
+	OSWrapper::Error timedWait(Pattern bitPattern, Mode, Pattern*, Timeout tmout)
+	{
+		m_timeouts.push_back(tmout);
+		std::this_thread::sleep_for(std::chrono::milliseconds(m_sleepMillis));
+		return static_cast<OSWrapper::Error>(mock().actualCall("timedWait").withParameter("bitPattern", static_cast<unsigned int>(bitPattern)).onObject(this)
+			.returnIntValueOrDefault(OSWrapper::TimedOut));
+	}
+
+	OSWrapper::Error setAll()
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error setOne(std::size_t)
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error set(Pattern)
+	{
+		return OSWrapper::OK;
+	}
+
+	OSWrapper::Error resetAll()
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error resetOne(std::size_t)
+	{
+		return OSWrapper::OK;
+	}
+	OSWrapper::Error reset(Pattern)
+	{
+		return OSWrapper::OK;
+	}
+
+	Pattern getCurrentPattern() const
+	{
+		return 0;
+	}
+};
+
+class TestEventFlagFactory : public EventFlagFactory {
+public:
+	int m_count;
+	TestEventFlag* m_last;
+	TestEventFlagFactory() : m_count(-1), m_last(0) {}
+	EventFlag* create(bool)
+	{
+		if (m_count == 0) {
+			return 0;
+		}
+		m_count--;
+		m_last = new TestEventFlag();
+		return m_last;
+	}
+
+	void destroy(EventFlag* e)
+	{
+		delete static_cast<TestEventFlag*>(e);
+	}
+};
+
+class TestFixedMemoryPool : public FixedMemoryPool {
+private:
+	std::size_t m_blockSize;
+	int& m_count;
+public:
+	TestFixedMemoryPool(std::size_t blockSize, int& count)
+	: m_blockSize(blockSize), m_count(count) {}
+	~TestFixedMemoryPool() {}
+
+	void* allocate()
+	{
+		if (m_count == 0) {
+			return 0;
+		}
+		m_count--;
+		return malloc(m_blockSize);
+	}
+	void deallocate(void* p)
+	{
+		free(p);
+	}
+	std::size_t getBlockSize() const
+	{
+		return m_blockSize;
+	}
+};
+
+class TestFixedMemoryPoolFactory : public FixedMemoryPoolFactory {
+public:
+	int m_count;
+	int m_allocateCount;
+	TestFixedMemoryPoolFactory() : m_count(-1), m_allocateCount(-1) {}
+	FixedMemoryPool* create(std::size_t blockSize, std::size_t, void*)
+	{
+		if (m_count == 0) {
+			return 0;
+		}
+		m_count--;
+		FixedMemoryPool* p = new TestFixedMemoryPool(blockSize, m_allocateCount);
+		return p;
+	}
+
+	void destroy(FixedMemoryPool* p)
+	{
+		delete static_cast<TestFixedMemoryPool*>(p);
+	}
+
+	std::size_t getRequiredMemorySize(std::size_t blockSize, std::size_t numBlocks)
+	{
+		return blockSize * numBlocks;
+	}
+};
+
+} // namespace LockFreeMessageQueueTestDouble
+
+#endif // __cplusplus >= 201103L
+
+#endif // LOCK_FREE_MESSAGE_QUEUE_TEST_DOUBLE_H_INCLUDED
@@ -0,0 +1,231 @@
+#if (__cplusplus >= 201103L)
+#include "OSWrapper/MPMCMessageQueue.h"
+#include <string>
+#include <new>
+#include "LockFreeMessageQueueTestDouble.h"
+
+namespace MPMCMessageQueueTest {
+
+using OSWrapper::MPMCMessageQueue;
+using OSWrapper::Timeout;
+using LockFreeMessageQueueTestDouble::TestEventFlag;
+using LockFreeMessageQueueTestDouble::TestEventFlagFactory;
+using LockFreeMessageQueueTestDouble::TestFixedMemoryPoolFactory;
+
+TEST_GROUP(MPMCMessageQueueTest) {
+	TestEventFlagFactory testEventFlagFactory;
+	TestFixedMemoryPoolFactory testFixedMemoryPoolFactory;
+	typedef MPMCMessageQueue<int> IntMQ;
+	static const std::size_t SIZE = 4;
+
+	void setup()
+	{
+		OSWrapper::registerEventFlagFactory(&testEventFlagFactory);
+		OSWrapper::registerFixedMemoryPoolFactory(&testFixedMemoryPoolFactory);
+	}
+	void teardown()
+	{
+		mock().checkExpectations();
+		mock().clear();
+	}
+};
+
+TEST(MPMCMessageQueueTest, create_destroy)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(SIZE, mq->getMaxSize());
+	LONGS_EQUAL(0, mq->getSize());
+	IntMQ::destroy(mq);
+}
+
+TEST(MPMCMessageQueueTest, create_rounds_up_maxSize)
+{
+	const std::size_t maxSize[] = { 0, 1, 2, 3, 5, 8, 100 };
+	const std::size_t expected[] = { 2, 2, 2, 4, 8, 8, 128 };
+	for (std::size_t i = 0; i < sizeof maxSize / sizeof maxSize[0]; i++) {
+		IntMQ* mq = IntMQ::create(maxSize[i]);
+		CHECK(mq);
+		LONGS_EQUAL(expected[i], mq->getMaxSize());
+		IntMQ::destroy(mq);
+	}
+}
+
+TEST(MPMCMessageQueueTest, destroy_nullptr)
+{
+	IntMQ::destroy(0);
+}
+
+TEST(MPMCMessageQueueTest, create_failed_FixedMemoryPool)
+{
+	testFixedMemoryPoolFactory.m_count = 0;
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq == 0);
+
+	testFixedMemoryPoolFactory.m_count = 1;
+	testFixedMemoryPoolFactory.m_allocateCount = 0;
+	mq = IntMQ::create(SIZE);
+	CHECK(mq == 0);
+}
+
+TEST(MPMCMessageQueueTest, create_failed_EventFlag)
+{
+	testEventFlagFactory.m_count = 0;
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq == 0);
+}
+
+TEST(MPMCMessageQueueTest, send_receive_without_waiting)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	for (int n = 0; n < 3; n++) {
+		for (std::size_t i = 0; i < SIZE; i++) {
+			LONGS_EQUAL(OSWrapper::OK, mq->trySend(int(i) + n));
+			LONGS_EQUAL(i + 1, mq->getSize());
+		}
+		for (std::size_t i = 0; i < SIZE; i++) {
+			int data = -1;
+			LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(&data));
+			LONGS_EQUAL(int(i) + n, data);
+			LONGS_EQUAL(SIZE - i - 1, mq->getSize());
+		}
+	}
+	IntMQ::destroy(mq);
+}
+
+TEST(MPMCMessageQueueTest, trySend_full_waits_EventFlag)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	for (std::size_t i = 0; i < SIZE; i++) {
+		LONGS_EQUAL(OSWrapper::OK, mq->trySend(int(i)));
+	}
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0002U).onObject(testEventFlagFactory.m_last);
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->trySend(100));
+	LONGS_EQUAL(SIZE, mq->getSize());
+	IntMQ::destroy(mq);
+}
+
+TEST(MPMCMessageQueueTest, tryReceive_empty_waits_EventFlag)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0001U).onObject(testEventFlagFactory.m_last);
+	int data = -1;
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->tryReceive(&data));
+	LONGS_EQUAL(-1, data);
+	IntMQ::destroy(mq);
+}
+
+TEST(MPMCMessageQueueTest, timedSend_woken_up_while_full_waits_remaining_time)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	for (std::size_t i = 0; i < SIZE; i++) {
+		LONGS_EQUAL(OSWrapper::OK, mq->trySend(int(i)));
+	}
+	TestEventFlag* ev = testEventFlagFactory.m_last;
+	ev->m_sleepMillis = 20;
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0002U).onObject(ev).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0002U).onObject(ev);
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->timedSend(100, Timeout(1000)));
+	LONGS_EQUAL(2, ev->m_timeouts.size());
+	CHECK(ev->m_timeouts[0] <= 1000);
+	CHECK(ev->m_timeouts[1] <= 1000 - 20);
+	CHECK(ev->m_timeouts[1] > 0);
+	IntMQ::destroy(mq);
+}
+
+TEST(MPMCMessageQueueTest, receive_woken_up_while_empty_waits_FOREVER)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	TestEventFlag* ev = testEventFlagFactory.m_last;
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0001U).onObject(ev).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0001U).onObject(ev);
+	int data = -1;
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->receive(&data));
+	LONGS_EQUAL(2, ev->m_timeouts.size());
+	CHECK(ev->m_timeouts[0] == Timeout::FOREVER);
+	CHECK(ev->m_timeouts[1] == Timeout::FOREVER);
+	IntMQ::destroy(mq);
+}
+
+TEST(MPMCMessageQueueTest, destroy_with_remaining_msgs)
+{
+	MPMCMessageQueue<std::string>* mq = MPMCMessageQueue<std::string>::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend("remaining message which is allocated on the heap"));
+	LONGS_EQUAL(1, mq->getSize());
+	MPMCMessageQueue<std::string>::destroy(mq);
+}
+
+TEST(MPMCMessageQueueTest, receive_nullptr)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend(1));
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(0));
+	LONGS_EQUAL(0, mq->getSize());
+	IntMQ::destroy(mq);
+}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+class ThrowingAssignment {
+public:
+	static bool s_throws;
+	std::string m_str;
+	explicit ThrowingAssignment(const char* str = "") : m_str(str) {}
+	ThrowingAssignment(const ThrowingAssignment& x) : m_str(x.m_str) {}
+	ThrowingAssignment& operator=(const ThrowingAssignment& x)
+	{
+		if (s_throws) {
+			throw std::bad_alloc();
+		}
+		m_str = x.m_str;
+		return *this;
+	}
+};
+bool ThrowingAssignment::s_throws = false;
+
+TEST(MPMCMessageQueueTest, receive_keeps_message_if_assignment_throws)
+{
+	typedef MPMCMessageQueue<ThrowingAssignment> ThrowingMQ;
+	ThrowingMQ* mq = ThrowingMQ::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend(ThrowingAssignment("first message which is allocated on the heap")));
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend(ThrowingAssignment("second")));
+
+	ThrowingAssignment data;
+	ThrowingAssignment::s_throws = true;
+	LONGS_EQUAL(OSWrapper::OtherError, mq->tryReceive(&data));
+	LONGS_EQUAL(2, mq->getSize());
+	ThrowingAssignment::s_throws = false;
+
+	// The kept message is received before the others
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(&data));
+	STRCMP_EQUAL("first message which is allocated on the heap", data.m_str.c_str());
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(&data));
+	STRCMP_EQUAL("second", data.m_str.c_str());
+	LONGS_EQUAL(0, mq->getSize());
+	ThrowingMQ::destroy(mq);
+}
+
+TEST(MPMCMessageQueueTest, destroy_with_kept_message)
+{
+	typedef MPMCMessageQueue<ThrowingAssignment> ThrowingMQ;
+	ThrowingMQ* mq = ThrowingMQ::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend(ThrowingAssignment("kept message which is allocated on the heap")));
+	ThrowingAssignment data;
+	ThrowingAssignment::s_throws = true;
+	LONGS_EQUAL(OSWrapper::OtherError, mq->tryReceive(&data));
+	ThrowingAssignment::s_throws = false;
+	LONGS_EQUAL(1, mq->getSize());
+	ThrowingMQ::destroy(mq);
+}
+#endif
+
+} // namespace MPMCMessageQueueTest
+#endif
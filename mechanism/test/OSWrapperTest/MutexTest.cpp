@@ -88,6 +88,16 @@ TEST(MutexTest, create_destroy_priorityCeiling)
 	Mutex::destroy(mutex);
 }
 
+TEST(MutexTest, createNonRecursive_not_implemented)
+{
+	// The default createNonRecursive() of MutexFactory calls create()
+	Mutex* mutex = Mutex::createNonRecursive();
+	CHECK(mutex);
+	mock().expectOneCall("lock").onObject(mutex);
+	LONGS_EQUAL(OSWrapper::OK, mutex->lock());
+	Mutex::destroy(mutex);
+}
+
 TEST(MutexTest, destroy_nullptr)
 {
 	Mutex::destroy(0);
@@ -67,6 +67,11 @@ public:
 		return m_name;
 	}
 
+	void overrun(unsigned long missedPeriods)
+	{
+		reportOverrun(missedPeriods);
+	}
+
 };
 
 class TestPeriodicTimerFactory : public PeriodicTimerFactory {
@@ -161,6 +166,89 @@ TEST(PeriodicTimerTest, name)
 	PeriodicTimer::destroy(timer);
 }
 
+TEST(PeriodicTimerTest, createInMicros_not_implemented)
+{
+	TestRunnable testRun;
+	PeriodicTimer* timer = PeriodicTimer::createInMicros(&testRun, 500);
+	CHECK_FALSE(timer);
+}
+
+TEST(PeriodicTimerTest, createInMicros_failed_runnable_nullptr)
+{
+	PeriodicTimer* timer = PeriodicTimer::createInMicros(0, 500);
+	CHECK_FALSE(timer);
+}
+
+TEST(PeriodicTimerTest, createInMicros_failed_period_is_zero)
+{
+	TestRunnable testRun;
+	PeriodicTimer* timer = PeriodicTimer::createInMicros(&testRun, 0);
+	CHECK_FALSE(timer);
+}
+
+TEST(PeriodicTimerTest, getPeriodInMicros_not_implemented)
+{
+	TestRunnable testRun;
+	PeriodicTimer* timer = PeriodicTimer::create(&testRun, 100);
+	CHECK(timer);
+
+	LONGS_EQUAL(100000, timer->getPeriodInMicros());
+	PeriodicTimer::destroy(timer);
+}
+
+TEST(PeriodicTimerTest, setScheduleMode_not_implemented)
+{
+	TestRunnable testRun;
+	PeriodicTimer* timer = PeriodicTimer::create(&testRun, 100);
+	CHECK(timer);
+
+	LONGS_EQUAL(OSWrapper::OtherError, timer->setScheduleMode(PeriodicTimer::ABSOLUTE_SCHEDULE, PeriodicTimer::SKIP));
+	PeriodicTimer::destroy(timer);
+}
+
+TEST(PeriodicTimerTest, statistics_not_implemented)
+{
+	TestRunnable testRun;
+	PeriodicTimer* timer = PeriodicTimer::create(&testRun, 100);
+	CHECK(timer);
+
+	timer->resetStatistics();
+	LONGS_EQUAL(0, timer->getNumberOfExpirations());
+	LONGS_EQUAL(0, timer->getNumberOfOverruns());
+	LONGS_EQUAL(0, timer->getMaxJitterInMicros());
+	LONGS_EQUAL(0, timer->getAverageJitterInMicros());
+	PeriodicTimer::destroy(timer);
+}
+
+class TestOverrunHandler : public PeriodicTimer::OverrunHandler {
+public:
+	virtual void handle(PeriodicTimer* t, unsigned long missedPeriods)
+	{
+		mock().actualCall("handle").withParameter("t", t).withParameter("missedPeriods", missedPeriods).onObject(this);
+	}
+};
+
+TEST(PeriodicTimerTest, reportOverrun)
+{
+	TestRunnable testRun;
+	TestPeriodicTimer* timer = static_cast<TestPeriodicTimer*>(PeriodicTimer::create(&testRun, 100));
+	CHECK(timer);
+	POINTERS_EQUAL(0, timer->getOverrunHandler());
+
+	// No OverrunHandler
+	timer->overrun(1);
+
+	TestOverrunHandler handler;
+	timer->setOverrunHandler(&handler);
+	POINTERS_EQUAL(&handler, timer->getOverrunHandler());
+	mock().expectOneCall("handle").withParameter("t", static_cast<PeriodicTimer*>(timer)).withParameter("missedPeriods", 3UL).onObject(&handler);
+	timer->overrun(3);
+
+	// No missed periods
+	timer->overrun(0);
+	PeriodicTimer::destroy(timer);
+}
+
 #ifndef CPPELIB_NO_EXCEPTIONS
 class UnknownExceptionTestRunnable : public Runnable {
 public:
@@ -343,6 +431,26 @@ TEST(PeriodicTimerTest, ExceptionHandler_throws_exception)
 	timer->stop();
 	PeriodicTimer::destroy(timer);
 }
+
+class ThrowOverrunHandler : public PeriodicTimer::OverrunHandler {
+public:
+	virtual void handle(PeriodicTimer*, unsigned long)
+	{
+		throw 0;
+	}
+};
+
+TEST(PeriodicTimerTest, OverrunHandler_throws_exception)
+{
+	TestRunnable testRun;
+	TestPeriodicTimer* timer = static_cast<TestPeriodicTimer*>(PeriodicTimer::create(&testRun, 100));
+	CHECK(timer);
+
+	ThrowOverrunHandler handler;
+	timer->setOverrunHandler(&handler);
+	timer->overrun(1);
+	PeriodicTimer::destroy(timer);
+}
 #endif
 
 } // namespace PeriodicTimerTest
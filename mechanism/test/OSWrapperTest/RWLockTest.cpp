@@ -0,0 +1,297 @@
+#include "OSWrapper/RWLock.h"
+#include "OSWrapper/RWLockFactory.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+namespace RWLockTest {
+
+using OSWrapper::RWLock;
+using OSWrapper::RWLockFactory;
+using OSWrapper::Timeout;
+using OSWrapper::ReadLockGuard;
+using OSWrapper::WriteLockGuard;
+
+class TestRWLock : public RWLock {
+public:
+	bool m_writerPreference;
+
+	TestRWLock(bool writerPreference)
+	: m_writerPreference(writerPreference) {}
+	~TestRWLock() {}
+
+	OSWrapper::Error readLock()
+	{
+		return (OSWrapper::Error) mock().actualCall("readLock").onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error tryReadLock()
+	{
+		return (OSWrapper::Error) mock().actualCall("tryReadLock").onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error timedReadLock(Timeout tmout)
+	{
+		return (OSWrapper::Error) mock().actualCall("timedReadLock").withParameter("tmout", tmout)
+			.onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error readUnlock()
+	{
+		return (OSWrapper::Error) mock().actualCall("readUnlock").onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error writeLock()
+	{
+		return (OSWrapper::Error) mock().actualCall("writeLock").onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error tryWriteLock()
+	{
+		return (OSWrapper::Error) mock().actualCall("tryWriteLock").onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error timedWriteLock(Timeout tmout)
+	{
+		return (OSWrapper::Error) mock().actualCall("timedWriteLock").withParameter("tmout", tmout)
+			.onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error writeUnlock()
+	{
+		return (OSWrapper::Error) mock().actualCall("writeUnlock").onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+};
+
+class TestRWLockFactory : public RWLockFactory {
+public:
+	RWLock* create(bool writerPreference)
+	{
+		RWLock* l = new TestRWLock(writerPreference);
+		return l;
+	}
+
+	void destroy(RWLock* l)
+	{
+		delete static_cast<TestRWLock*>(l);
+	}
+};
+
+TEST_GROUP(RWLockTest) {
+	TestRWLockFactory testFactory;
+
+	void setup()
+	{
+		OSWrapper::registerRWLockFactory(&testFactory);
+	}
+	void teardown()
+	{
+		mock().checkExpectations();
+		mock().clear();
+	}
+};
+
+TEST(RWLockTest, create_destroy)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	CHECK_FALSE(static_cast<TestRWLock*>(rwlock)->m_writerPreference);
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, create_destroy_writerPreference)
+{
+	RWLock* rwlock = RWLock::create(true);
+	CHECK(rwlock);
+	CHECK_TRUE(static_cast<TestRWLock*>(rwlock)->m_writerPreference);
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, destroy_nullptr)
+{
+	RWLock::destroy(0);
+}
+
+TEST(RWLockTest, readLock_readUnlock)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("readLock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("readUnlock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+
+	OSWrapper::Error err = rwlock->readLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = rwlock->readUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, tryReadLock)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("tryReadLock").onObject(rwlock).andReturnValue(OSWrapper::TimedOut);
+
+	OSWrapper::Error err = rwlock->tryReadLock();
+	LONGS_EQUAL(OSWrapper::TimedOut, err);
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, timedReadLock)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("timedReadLock").onObject(rwlock).withParameter("tmout", Timeout(100)).andReturnValue(OSWrapper::TimedOut);
+
+	OSWrapper::Error err = rwlock->timedReadLock(Timeout(100));
+	LONGS_EQUAL(OSWrapper::TimedOut, err);
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, writeLock_writeUnlock)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("writeLock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("writeUnlock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+
+	OSWrapper::Error err = rwlock->writeLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = rwlock->writeUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, tryWriteLock)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("tryWriteLock").onObject(rwlock).andReturnValue(OSWrapper::TimedOut);
+
+	OSWrapper::Error err = rwlock->tryWriteLock();
+	LONGS_EQUAL(OSWrapper::TimedOut, err);
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, timedWriteLock)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("timedWriteLock").onObject(rwlock).withParameter("tmout", Timeout(100)).andReturnValue(OSWrapper::TimedOut);
+
+	OSWrapper::Error err = rwlock->timedWriteLock(Timeout(100));
+	LONGS_EQUAL(OSWrapper::TimedOut, err);
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, unlock_not_locked)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("readUnlock").onObject(rwlock).andReturnValue(OSWrapper::NotLocked);
+	mock().expectOneCall("writeUnlock").onObject(rwlock).andReturnValue(OSWrapper::NotLocked);
+
+	OSWrapper::Error err = rwlock->readUnlock();
+	LONGS_EQUAL(OSWrapper::NotLocked, err);
+	err = rwlock->writeUnlock();
+	LONGS_EQUAL(OSWrapper::NotLocked, err);
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, ReadLockGuard)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("readLock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("readUnlock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+
+	{
+		ReadLockGuard lock(rwlock);
+	}
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, ReadLockGuard_lock_failed)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("readLock").onObject(rwlock).andReturnValue(OSWrapper::OtherError);
+	mock().expectNoCall("readUnlock");
+
+	{
+		ReadLockGuard lock(rwlock);
+	}
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, ReadLockGuard_ADOPT_LOCK)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("tryReadLock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("readUnlock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+
+	{
+		OSWrapper::Error err = rwlock->tryReadLock();
+		LONGS_EQUAL(OSWrapper::OK, err);
+
+		ReadLockGuard lock(rwlock, ReadLockGuard::ADOPT_LOCK);
+	}
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, WriteLockGuard)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("writeLock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("writeUnlock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+
+	{
+		WriteLockGuard lock(rwlock);
+	}
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, WriteLockGuard_lock_failed)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("writeLock").onObject(rwlock).andReturnValue(OSWrapper::OtherError);
+	mock().expectNoCall("writeUnlock");
+
+	{
+		WriteLockGuard lock(rwlock);
+	}
+
+	RWLock::destroy(rwlock);
+}
+
+TEST(RWLockTest, WriteLockGuard_ADOPT_LOCK)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	mock().expectOneCall("timedWriteLock").onObject(rwlock).withParameter("tmout", Timeout(10)).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("writeUnlock").onObject(rwlock).andReturnValue(OSWrapper::OK);
+
+	{
+		OSWrapper::Error err = rwlock->timedWriteLock(Timeout(10));
+		LONGS_EQUAL(OSWrapper::OK, err);
+
+		WriteLockGuard lock(rwlock, WriteLockGuard::ADOPT_LOCK);
+	}
+
+	RWLock::destroy(rwlock);
+}
+
+} // namespace RWLockTest
@@ -0,0 +1,152 @@
+#if (__cplusplus >= 201103L)
+#include "OSWrapper/SPSCMessageQueue.h"
+#include "LockFreeMessageQueueTestDouble.h"
+
+namespace SPSCMessageQueueTest {
+
+using OSWrapper::SPSCMessageQueue;
+using OSWrapper::Timeout;
+using LockFreeMessageQueueTestDouble::TestEventFlag;
+using LockFreeMessageQueueTestDouble::TestEventFlagFactory;
+using LockFreeMessageQueueTestDouble::TestFixedMemoryPoolFactory;
+
+TEST_GROUP(SPSCMessageQueueTest) {
+	TestEventFlagFactory testEventFlagFactory;
+	TestFixedMemoryPoolFactory testFixedMemoryPoolFactory;
+	typedef SPSCMessageQueue<int> IntMQ;
+	static const std::size_t SIZE = 3;
+
+	void setup()
+	{
+		OSWrapper::registerEventFlagFactory(&testEventFlagFactory);
+		OSWrapper::registerFixedMemoryPoolFactory(&testFixedMemoryPoolFactory);
+	}
+	void teardown()
+	{
+		mock().checkExpectations();
+		mock().clear();
+	}
+};
+
+TEST(SPSCMessageQueueTest, create_destroy)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(SIZE, mq->getMaxSize());
+	LONGS_EQUAL(0, mq->getSize());
+	IntMQ::destroy(mq);
+}
+
+TEST(SPSCMessageQueueTest, destroy_nullptr)
+{
+	IntMQ::destroy(0);
+}
+
+TEST(SPSCMessageQueueTest, create_failed_FixedMemoryPool)
+{
+	testFixedMemoryPoolFactory.m_count = 0;
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq == 0);
+
+	testFixedMemoryPoolFactory.m_count = 1;
+	testFixedMemoryPoolFactory.m_allocateCount = 0;
+	mq = IntMQ::create(SIZE);
+	CHECK(mq == 0);
+}
+
+TEST(SPSCMessageQueueTest, create_failed_EventFlag)
+{
+	testEventFlagFactory.m_count = 0;
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq == 0);
+}
+
+TEST(SPSCMessageQueueTest, send_receive_without_waiting)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	for (int n = 0; n < 3; n++) {
+		for (std::size_t i = 0; i < SIZE; i++) {
+			LONGS_EQUAL(OSWrapper::OK, mq->trySend(int(i) + n));
+			LONGS_EQUAL(i + 1, mq->getSize());
+		}
+		for (std::size_t i = 0; i < SIZE; i++) {
+			int data = -1;
+			LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(&data));
+			LONGS_EQUAL(int(i) + n, data);
+			LONGS_EQUAL(SIZE - i - 1, mq->getSize());
+		}
+	}
+	IntMQ::destroy(mq);
+}
+
+TEST(SPSCMessageQueueTest, trySend_full_waits_EventFlag)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	for (std::size_t i = 0; i < SIZE; i++) {
+		LONGS_EQUAL(OSWrapper::OK, mq->trySend(int(i)));
+	}
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0002U).onObject(testEventFlagFactory.m_last);
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->trySend(100));
+	LONGS_EQUAL(SIZE, mq->getSize());
+	IntMQ::destroy(mq);
+}
+
+TEST(SPSCMessageQueueTest, tryReceive_empty_waits_EventFlag)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0001U).onObject(testEventFlagFactory.m_last);
+	int data = -1;
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->tryReceive(&data));
+	LONGS_EQUAL(-1, data);
+	IntMQ::destroy(mq);
+}
+
+TEST(SPSCMessageQueueTest, timedReceive_woken_up_while_empty_waits_remaining_time)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	TestEventFlag* ev = testEventFlagFactory.m_last;
+	ev->m_sleepMillis = 20;
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0001U).onObject(ev).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0001U).onObject(ev);
+	int data = -1;
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->timedReceive(&data, Timeout(1000)));
+	LONGS_EQUAL(2, ev->m_timeouts.size());
+	CHECK(ev->m_timeouts[0] <= 1000);
+	CHECK(ev->m_timeouts[1] <= 1000 - 20);
+	CHECK(ev->m_timeouts[1] > 0);
+	IntMQ::destroy(mq);
+}
+
+TEST(SPSCMessageQueueTest, timedSend_woken_up_while_full_waits_FOREVER)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	for (std::size_t i = 0; i < SIZE; i++) {
+		LONGS_EQUAL(OSWrapper::OK, mq->trySend(int(i)));
+	}
+	TestEventFlag* ev = testEventFlagFactory.m_last;
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0002U).onObject(ev).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("timedWait").withParameter("bitPattern", 0x0002U).onObject(ev);
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->send(100));
+	LONGS_EQUAL(2, ev->m_timeouts.size());
+	CHECK(ev->m_timeouts[0] == Timeout::FOREVER);
+	CHECK(ev->m_timeouts[1] == Timeout::FOREVER);
+	IntMQ::destroy(mq);
+}
+
+TEST(SPSCMessageQueueTest, receive_nullptr)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend(1));
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(0));
+	LONGS_EQUAL(0, mq->getSize());
+	IntMQ::destroy(mq);
+}
+
+} // namespace SPSCMessageQueueTest
+#endif
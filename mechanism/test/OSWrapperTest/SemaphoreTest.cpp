@@ -0,0 +1,142 @@
+#include "OSWrapper/Semaphore.h"
+#include "OSWrapper/SemaphoreFactory.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+namespace SemaphoreTest {
+
+using OSWrapper::Semaphore;
+using OSWrapper::SemaphoreFactory;
+using OSWrapper::Timeout;
+
+class TestSemaphore : public Semaphore {
+private:
+	std::size_t m_maxCount;
+public:
+	explicit TestSemaphore(std::size_t maxCount)
+	: m_maxCount(maxCount) {}
+	~TestSemaphore() {}
+
+	OSWrapper::Error acquire(std::size_t n)
+	{
+		return (OSWrapper::Error) mock().actualCall("acquire").withParameter("n", n)
+			.onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error tryAcquire(std::size_t n)
+	{
+		return (OSWrapper::Error) mock().actualCall("tryAcquire").withParameter("n", n)
+			.onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error timedAcquire(std::size_t n, Timeout tmout)
+	{
+		return (OSWrapper::Error) mock().actualCall("timedAcquire").withParameter("n", n).withParameter("tmout", tmout)
+			.onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	OSWrapper::Error release(std::size_t n)
+	{
+		return (OSWrapper::Error) mock().actualCall("release").withParameter("n", n)
+			.onObject(this).returnIntValueOrDefault(OSWrapper::OK);
+	}
+
+	std::size_t getCount() const
+	{
+		return mock().actualCall("getCount").onObject(this).returnUnsignedIntValueOrDefault(0);
+	}
+
+	std::size_t getMaxCount() const
+	{
+		return m_maxCount;
+	}
+};
+
+class TestSemaphoreFactory : public SemaphoreFactory {
+public:
+	Semaphore* create(std::size_t initialCount, std::size_t maxCount)
+	{
+		mock().actualCall("create").withParameter("initialCount", initialCount).withParameter("maxCount", maxCount);
+		Semaphore* s = new TestSemaphore(maxCount);
+		return s;
+	}
+
+	void destroy(Semaphore* s)
+	{
+		delete static_cast<TestSemaphore*>(s);
+	}
+};
+
+TEST_GROUP(SemaphoreTest) {
+	TestSemaphoreFactory testFactory;
+	Semaphore* sem;
+
+	void setup()
+	{
+		OSWrapper::registerSemaphoreFactory(&testFactory);
+		mock().expectOneCall("create").withParameter("initialCount", 0).withParameter("maxCount", 10);
+		sem = Semaphore::create(0, 10);
+		CHECK(sem);
+	}
+	void teardown()
+	{
+		Semaphore::destroy(sem);
+		mock().checkExpectations();
+		mock().clear();
+	}
+};
+
+TEST(SemaphoreTest, create_destroy)
+{
+	LONGS_EQUAL(10, sem->getMaxCount());
+}
+
+TEST(SemaphoreTest, destroy_nullptr)
+{
+	Semaphore::destroy(0);
+}
+
+TEST(SemaphoreTest, acquire)
+{
+	mock().expectOneCall("acquire").onObject(sem).withParameter("n", 3).andReturnValue(OSWrapper::OK);
+
+	OSWrapper::Error err = sem->acquire(3);
+	LONGS_EQUAL(OSWrapper::OK, err);
+}
+
+TEST(SemaphoreTest, tryAcquire)
+{
+	mock().expectOneCall("tryAcquire").onObject(sem).withParameter("n", 1).andReturnValue(OSWrapper::TimedOut);
+
+	OSWrapper::Error err = sem->tryAcquire(1);
+	LONGS_EQUAL(OSWrapper::TimedOut, err);
+}
+
+TEST(SemaphoreTest, timedAcquire)
+{
+	mock().expectOneCall("timedAcquire").onObject(sem).withParameter("n", 2).withParameter("tmout", Timeout(100))
+		.andReturnValue(OSWrapper::TimedOut);
+
+	OSWrapper::Error err = sem->timedAcquire(2, Timeout(100));
+	LONGS_EQUAL(OSWrapper::TimedOut, err);
+}
+
+TEST(SemaphoreTest, release)
+{
+	mock().expectOneCall("release").onObject(sem).withParameter("n", 5).andReturnValue(OSWrapper::OK);
+	mock().expectOneCall("getCount").onObject(sem).andReturnValue(5U);
+
+	OSWrapper::Error err = sem->release(5);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	LONGS_EQUAL(5, sem->getCount());
+}
+
+TEST(SemaphoreTest, release_over_maxCount)
+{
+	mock().expectOneCall("release").onObject(sem).withParameter("n", 11).andReturnValue(OSWrapper::OtherError);
+
+	OSWrapper::Error err = sem->release(11);
+	LONGS_EQUAL(OSWrapper::OtherError, err);
+}
+
+} // namespace SemaphoreTest
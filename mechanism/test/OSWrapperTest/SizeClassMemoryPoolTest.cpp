@@ -0,0 +1,366 @@
+#include "OSWrapper/FixedMemoryPool.h"
+#include "OSWrapper/FixedMemoryPoolFactory.h"
+#include "OSWrapper/VariableMemoryPool.h"
+#include "OSWrapper/VariableMemoryPoolFactory.h"
+#include "OSWrapper/SizeClassMemoryPool.h"
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+namespace SizeClassMemoryPoolTest {
+
+using OSWrapper::FixedMemoryPool;
+using OSWrapper::FixedMemoryPoolFactory;
+using OSWrapper::VariableMemoryPool;
+using OSWrapper::VariableMemoryPoolFactory;
+using OSWrapper::SizeClassMemoryPool;
+
+class TestFixedMemoryPool : public FixedMemoryPool {
+private:
+	std::size_t m_blockSize;
+	std::size_t m_maxBlocks;
+	double* m_buf;
+	char* m_area;
+	void** m_free;
+	std::size_t m_numFree;
+public:
+	TestFixedMemoryPool(std::size_t blockSize, std::size_t memoryPoolSize, void* memoryPoolAddress)
+	: m_blockSize(blockSize), m_maxBlocks(memoryPoolSize / blockSize), m_buf(0), m_area(static_cast<char*>(memoryPoolAddress))
+	, m_free(new void*[m_maxBlocks]), m_numFree(0)
+	{
+		if (m_area == 0) {
+			m_buf = new double[memoryPoolSize / sizeof(double) + 1];
+			m_area = reinterpret_cast<char*>(m_buf);
+		}
+		for (std::size_t i = m_maxBlocks; i > 0; i--) {
+			m_free[m_numFree++] = m_area + (i - 1) * m_blockSize;
+		}
+	}
+	~TestFixedMemoryPool()
+	{
+		delete[] m_free;
+		delete[] m_buf;
+	}
+
+	void* allocate()
+	{
+		void* p = 0;
+		tryAllocateMemory(&p);
+		return p;
+	}
+	void deallocate(void* p)
+	{
+		m_free[m_numFree++] = p;
+	}
+	std::size_t getBlockSize() const
+	{
+		return m_blockSize;
+	}
+	OSWrapper::Error tryAllocateMemory(void** memory)
+	{
+		if (m_numFree == 0) {
+			return OSWrapper::TimedOut;
+		}
+		*memory = m_free[--m_numFree];
+		return OSWrapper::OK;
+	}
+	std::size_t getNumberOfAvailableBlocks() const
+	{
+		return m_numFree;
+	}
+	std::size_t getMaxNumberOfBlocks() const
+	{
+		return m_maxBlocks;
+	}
+};
+
+class TestFixedMemoryPoolFactory : public FixedMemoryPoolFactory {
+public:
+	int m_count;
+	TestFixedMemoryPoolFactory() : m_count(-1) {}
+	FixedMemoryPool* create(std::size_t blockSize, std::size_t memoryPoolSize, void* memoryPoolAddress)
+	{
+		if (m_count == 0) {
+			return 0;
+		}
+		m_count--;
+		FixedMemoryPool* p = new TestFixedMemoryPool(blockSize, memoryPoolSize, memoryPoolAddress);
+		return p;
+	}
+
+	void destroy(FixedMemoryPool* p)
+	{
+		delete static_cast<TestFixedMemoryPool*>(p);
+	}
+
+	std::size_t getRequiredMemorySize(std::size_t blockSize, std::size_t numBlocks)
+	{
+		return blockSize * numBlocks;
+	}
+};
+
+class TestVariableMemoryPool : public VariableMemoryPool {
+public:
+	std::size_t m_memoryPoolSize;
+	void* m_memoryPoolAddress;
+
+	TestVariableMemoryPool(std::size_t memoryPoolSize, void* memoryPoolAddress)
+	: m_memoryPoolSize(memoryPoolSize), m_memoryPoolAddress(memoryPoolAddress) {}
+	~TestVariableMemoryPool() {}
+
+	void* allocate(std::size_t size)
+	{
+		return mock().actualCall("allocate").withParameter("size", size).returnPointerValueOrDefault(0);
+	}
+	void deallocate(void* p)
+	{
+		mock().actualCall("deallocate").withParameter("p", p);
+	}
+};
+
+class TestVariableMemoryPoolFactory : public VariableMemoryPoolFactory {
+public:
+	int m_count;
+	TestVariableMemoryPool* m_lastPool;
+	VariableMemoryPool* m_lastDestroyed;
+	TestVariableMemoryPoolFactory() : m_count(-1), m_lastPool(0), m_lastDestroyed(0) {}
+	VariableMemoryPool* create(std::size_t memoryPoolSize, void* memoryPoolAddress)
+	{
+		if (m_count == 0) {
+			return 0;
+		}
+		m_count--;
+		m_lastPool = new TestVariableMemoryPool(memoryPoolSize, memoryPoolAddress);
+		return m_lastPool;
+	}
+
+	void destroy(VariableMemoryPool* p)
+	{
+		m_lastDestroyed = p;
+		delete static_cast<TestVariableMemoryPool*>(p);
+	}
+};
+
+TEST_GROUP(SizeClassMemoryPoolTest) {
+	TestFixedMemoryPoolFactory testFixedMemoryPoolFactory;
+	TestVariableMemoryPoolFactory testVariableMemoryPoolFactory;
+	// Size classes of 8, 16 and 32 bytes
+	std::size_t numBlocks[3];
+	double poolBuf[40];
+
+	void setup()
+	{
+		OSWrapper::registerFixedMemoryPoolFactory(&testFixedMemoryPoolFactory);
+		OSWrapper::registerVariableMemoryPoolFactory(&testVariableMemoryPoolFactory);
+		numBlocks[0] = 4;
+		numBlocks[1] = 2;
+		numBlocks[2] = 1;
+	}
+	void teardown()
+	{
+		mock().checkExpectations();
+		mock().clear();
+	}
+
+	bool isIn(void* p, std::size_t begin, std::size_t end)
+	{
+		const char* cp = static_cast<const char*>(p);
+		const char* area = reinterpret_cast<const char*>(poolBuf);
+		return (area + begin <= cp) && (cp < area + end);
+	}
+};
+
+TEST(SizeClassMemoryPoolTest, create_destroy)
+{
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3);
+	CHECK(pool);
+	LONGS_EQUAL(3, pool->getNumberOfSizeClasses());
+	LONGS_EQUAL(8, pool->getBlockSize(0));
+	LONGS_EQUAL(16, pool->getBlockSize(1));
+	LONGS_EQUAL(32, pool->getBlockSize(2));
+	LONGS_EQUAL(0, pool->getBlockSize(3));
+	SizeClassMemoryPool::destroy(pool);
+}
+
+TEST(SizeClassMemoryPoolTest, destroy_by_VariableMemoryPool)
+{
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3, 64);
+	CHECK(pool);
+	VariableMemoryPool* vpool = pool;
+
+	// Only the large memory pool is destroyed by the VariableMemoryPoolFactory
+	VariableMemoryPool* largePool = testVariableMemoryPoolFactory.m_lastPool;
+	CHECK(largePool);
+	VariableMemoryPool::destroy(vpool);
+	POINTERS_EQUAL(largePool, testVariableMemoryPoolFactory.m_lastDestroyed);
+}
+
+TEST(SizeClassMemoryPoolTest, destroy_nullptr)
+{
+	SizeClassMemoryPool::destroy(0);
+}
+
+TEST(SizeClassMemoryPoolTest, getRequiredMemorySize)
+{
+	LONGS_EQUAL(96, SizeClassMemoryPool::getRequiredMemorySize(8, numBlocks, 3));
+	LONGS_EQUAL(196, SizeClassMemoryPool::getRequiredMemorySize(8, numBlocks, 3, 100));
+	LONGS_EQUAL(0, SizeClassMemoryPool::getRequiredMemorySize(0, numBlocks, 3));
+}
+
+TEST(SizeClassMemoryPoolTest, create_invalid_parameter)
+{
+	CHECK(!SizeClassMemoryPool::create(0, numBlocks, 3));
+	CHECK(!SizeClassMemoryPool::create(8, 0, 3));
+	CHECK(!SizeClassMemoryPool::create(8, numBlocks, 0));
+
+	std::size_t manyBlocks[SizeClassMemoryPool::MAX_SIZE_CLASSES + 1];
+	for (std::size_t i = 0; i < SizeClassMemoryPool::MAX_SIZE_CLASSES + 1; i++) {
+		manyBlocks[i] = 1;
+	}
+	CHECK(!SizeClassMemoryPool::create(8, manyBlocks, SizeClassMemoryPool::MAX_SIZE_CLASSES + 1));
+
+	numBlocks[1] = 0;
+	CHECK(!SizeClassMemoryPool::create(8, numBlocks, 3));
+}
+
+TEST(SizeClassMemoryPoolTest, create_failed_objPool)
+{
+	testFixedMemoryPoolFactory.m_count = 0;
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3);
+	CHECK(!pool);
+}
+
+TEST(SizeClassMemoryPoolTest, create_failed_sizeClassPool)
+{
+	testFixedMemoryPoolFactory.m_count = 3;
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3);
+	CHECK(!pool);
+}
+
+TEST(SizeClassMemoryPoolTest, create_failed_largePool)
+{
+	testVariableMemoryPoolFactory.m_count = 0;
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3, 100);
+	CHECK(!pool);
+}
+
+TEST(SizeClassMemoryPoolTest, create_carves_areas_from_memory_pool_area)
+{
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3, 100, poolBuf);
+	CHECK(pool);
+	LONGS_EQUAL(100, testVariableMemoryPoolFactory.m_lastPool->m_memoryPoolSize);
+	POINTERS_EQUAL(reinterpret_cast<char*>(poolBuf) + 96, testVariableMemoryPoolFactory.m_lastPool->m_memoryPoolAddress);
+
+	void* p = pool->allocate(8);
+	CHECK(isIn(p, 0, 32));
+	void* q = pool->allocate(9);
+	CHECK(isIn(q, 32, 64));
+	void* r = pool->allocate(32);
+	CHECK(isIn(r, 64, 96));
+
+	pool->deallocate(r);
+	pool->deallocate(q);
+	pool->deallocate(p);
+	SizeClassMemoryPool::destroy(pool);
+}
+
+TEST(SizeClassMemoryPoolTest, allocate_counts_hits)
+{
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3, 0, poolBuf);
+	CHECK(pool);
+	void* p[4];
+	for (int i = 0; i < 4; i++) {
+		p[i] = pool->allocate(1 + i);
+		CHECK(isIn(p[i], 0, 32));
+	}
+	LONGS_EQUAL(4, pool->getNumberOfHits(0));
+	LONGS_EQUAL(0, pool->getNumberOfMisses(0));
+	LONGS_EQUAL(0, pool->getNumberOfHits(1));
+	LONGS_EQUAL(0, pool->getNumberOfHits(3));
+
+	for (int i = 0; i < 4; i++) {
+		pool->deallocate(p[i]);
+	}
+	SizeClassMemoryPool::destroy(pool);
+}
+
+TEST(SizeClassMemoryPoolTest, allocate_zero)
+{
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3, 0, poolBuf);
+	CHECK(pool);
+	void* p = pool->allocate(0);
+	CHECK(isIn(p, 0, 32));
+	pool->deallocate(p);
+	SizeClassMemoryPool::destroy(pool);
+}
+
+TEST(SizeClassMemoryPoolTest, allocate_miss_without_large_pool)
+{
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3, 0, poolBuf);
+	CHECK(pool);
+	void* p = pool->allocate(32);
+	CHECK(p);
+	void* q = pool->allocate(32);
+	CHECK(q == 0);
+	LONGS_EQUAL(1, pool->getNumberOfHits(2));
+	LONGS_EQUAL(1, pool->getNumberOfMisses(2));
+
+	// The smaller size class is not used for the larger size
+	q = pool->allocate(33);
+	CHECK(q == 0);
+	LONGS_EQUAL(1, pool->getNumberOfLargeRequests());
+
+	pool->deallocate(p);
+	q = pool->allocate(32);
+	POINTERS_EQUAL(p, q);
+	LONGS_EQUAL(2, pool->getNumberOfHits(2));
+	pool->deallocate(q);
+	SizeClassMemoryPool::destroy(pool);
+}
+
+TEST(SizeClassMemoryPoolTest, allocate_miss_falls_back_to_large_pool)
+{
+	double largeBlock[4];
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3, 100, poolBuf);
+	CHECK(pool);
+	void* p = pool->allocate(20);
+	CHECK(isIn(p, 64, 96));
+
+	mock().expectOneCall("allocate").withParameter("size", 20).andReturnValue(static_cast<void*>(largeBlock));
+	void* q = pool->allocate(20);
+	POINTERS_EQUAL(largeBlock, q);
+	LONGS_EQUAL(1, pool->getNumberOfHits(2));
+	LONGS_EQUAL(1, pool->getNumberOfMisses(2));
+
+	mock().expectOneCall("deallocate").withParameter("p", static_cast<void*>(largeBlock));
+	pool->deallocate(q);
+	pool->deallocate(p);
+	SizeClassMemoryPool::destroy(pool);
+}
+
+TEST(SizeClassMemoryPoolTest, allocate_large_request)
+{
+	double largeBlock[8];
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3, 100, poolBuf);
+	CHECK(pool);
+
+	mock().expectOneCall("allocate").withParameter("size", 64).andReturnValue(static_cast<void*>(largeBlock));
+	void* p = pool->allocate(64);
+	POINTERS_EQUAL(largeBlock, p);
+	LONGS_EQUAL(1, pool->getNumberOfLargeRequests());
+	LONGS_EQUAL(0, pool->getNumberOfMisses(2));
+
+	mock().expectOneCall("deallocate").withParameter("p", static_cast<void*>(largeBlock));
+	pool->deallocate(p);
+	SizeClassMemoryPool::destroy(pool);
+}
+
+TEST(SizeClassMemoryPoolTest, deallocate_nullptr)
+{
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(8, numBlocks, 3, 100, poolBuf);
+	CHECK(pool);
+	pool->deallocate(0);
+	SizeClassMemoryPool::destroy(pool);
+}
+
+} // namespace SizeClassMemoryPoolTest
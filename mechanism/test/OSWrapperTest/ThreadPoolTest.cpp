@@ -377,6 +377,7 @@ TEST(ThreadPoolTest, create_destroy)
 {
 	ThreadPool* tp = ThreadPool::create(10);
 	CHECK(tp);
+	LONGS_EQUAL(10, tp->getMaxThreads());
 	ThreadPool::destroy(tp);
 }
 
@@ -392,13 +393,20 @@ TEST(ThreadPoolTest, create_failed_objPool)
 	CHECK(tp == 0);
 }
 
-TEST(ThreadPoolTest, create_failed_MessageQueue)
+TEST(ThreadPoolTest, create_failed_chainMutex)
 {
 	testMutexFactory.m_count = 0;
 	ThreadPool* tp = ThreadPool::create(10);
 	CHECK(tp == 0);
 }
 
+TEST(ThreadPoolTest, create_failed_MessageQueue)
+{
+	testMutexFactory.m_count = 1;
+	ThreadPool* tp = ThreadPool::create(10);
+	CHECK(tp == 0);
+}
+
 TEST(ThreadPoolTest, create_failed_threadMemoryPool)
 {
 	testFixedMemoryPoolFactory.m_count = 2;
@@ -443,5 +451,123 @@ TEST(ThreadPoolTest, create_failed_Thread)
 	}
 }
 
+TEST(ThreadPoolTest, createQueued_destroy)
+{
+	ThreadPool* tp = ThreadPool::createQueued(10, 20, ThreadPool::DISCARD_OLDEST);
+	CHECK(tp);
+	LONGS_EQUAL(10, tp->getMaxThreads());
+	ThreadPool::destroy(tp);
+}
+
+TEST(ThreadPoolTest, createQueued_invalid_parameter)
+{
+	ThreadPool* tp = ThreadPool::createQueued(0, 20);
+	CHECK(tp == 0);
+}
+
+TEST(ThreadPoolTest, createQueued_failed_FixedMemoryPool)
+{
+	// objPool, scheduler, task queue, free entry queue, threadMemoryPool, runnerPool
+	for (int i = 0; i < 6; i++) {
+		testFixedMemoryPoolFactory.m_count = i;
+		ThreadPool* tp = ThreadPool::createQueued(10, 20);
+		CHECK(tp == 0);
+	}
+
+	for (int i = 0; i < 2 + 2 + 1 + 30; i++) {
+		testFixedMemoryPoolFactory.m_count = -1;
+		testFixedMemoryPoolFactory.m_allocateCount = i;
+		ThreadPool* tp = ThreadPool::createQueued(10, 20);
+		CHECK(tp == 0);
+	}
+}
+
+TEST(ThreadPoolTest, createQueued_failed_MessageQueue)
+{
+	// 1 for the chain and 3 for each MessageQueue
+	for (int i = 0; i < 1 + 2 * 3; i++) {
+		testMutexFactory.m_count = i;
+		ThreadPool* tp = ThreadPool::createQueued(10, 20);
+		CHECK(tp == 0);
+	}
+}
+
+TEST(ThreadPoolTest, createQueued_failed_EventFlag)
+{
+	for (int i = 0; i < 2 + 30; i++) {
+		testEventFlagFactory.m_count = i;
+		ThreadPool* tp = ThreadPool::createQueued(10, 20);
+		CHECK(tp == 0);
+	}
+}
+
+TEST(ThreadPoolTest, createQueued_failed_Thread)
+{
+	for (int i = 0; i < 10; i++) {
+		testThreadFactory.m_count = i;
+		ThreadPool* tp = ThreadPool::createQueued(10, 20);
+		CHECK(tp == 0);
+	}
+}
+
+TEST(ThreadPoolTest, createPriorityQueued_destroy)
+{
+	ThreadPool* tp = ThreadPool::createPriorityQueued(10, 20, ThreadPool::DISCARD_OLDEST);
+	CHECK(tp);
+	ThreadPool::destroy(tp);
+}
+
+TEST(ThreadPoolTest, createPriorityQueued_invalid_parameter)
+{
+	ThreadPool* tp = ThreadPool::createPriorityQueued(0, 20);
+	CHECK(tp == 0);
+}
+
+TEST(ThreadPoolTest, createPriorityQueued_failed_FixedMemoryPool)
+{
+	for (int i = 0; i < 6; i++) {
+		testFixedMemoryPoolFactory.m_count = i;
+		ThreadPool* tp = ThreadPool::createPriorityQueued(10, 20);
+		CHECK(tp == 0);
+	}
+}
+
+TEST(ThreadPoolTest, createPriorityQueued_failed_Mutex)
+{
+	// 1 for the chain, 3 for each MessageQueue and 1 for the heap
+	for (int i = 0; i < 1 + 2 * 3 + 1; i++) {
+		testMutexFactory.m_count = i;
+		ThreadPool* tp = ThreadPool::createPriorityQueued(10, 20);
+		CHECK(tp == 0);
+	}
+}
+
+#if (__cplusplus >= 201103L)
+TEST(ThreadPoolTest, createWorkStealing_destroy)
+{
+	ThreadPool* tp = ThreadPool::createWorkStealing(10, 20);
+	CHECK(tp);
+	ThreadPool::destroy(tp);
+}
+
+TEST(ThreadPoolTest, createWorkStealing_failed_FixedMemoryPool)
+{
+	for (int i = 0; i < 4; i++) {
+		testFixedMemoryPoolFactory.m_count = i;
+		ThreadPool* tp = ThreadPool::createWorkStealing(10, 20);
+		CHECK(tp == 0);
+	}
+}
+
+TEST(ThreadPoolTest, createWorkStealing_failed_Thread)
+{
+	for (int i = 0; i < 10; i++) {
+		testThreadFactory.m_count = i;
+		ThreadPool* tp = ThreadPool::createWorkStealing(10, 20);
+		CHECK(tp == 0);
+	}
+}
+#endif
+
 
 } // namespace ThreadPoolTest
@@ -0,0 +1,73 @@
+#include "OSWrapper/Timeout.h"
+#include "CppUTest/TestHarness.h"
+
+namespace TimeoutTest {
+
+using OSWrapper::Timeout;
+
+TEST_GROUP(TimeoutTest) {
+};
+
+TEST(TimeoutTest, milliseconds)
+{
+	Timeout tmout(100);
+	LONGS_EQUAL(100, tmout);
+	LONGS_EQUAL(100, tmout.getWholeMillis());
+	LONGS_EQUAL(0, tmout.getSubMillisNanos());
+}
+
+TEST(TimeoutTest, constants)
+{
+	LONGS_EQUAL(0, Timeout::POLLING);
+	LONGS_EQUAL(-1, Timeout::FOREVER);
+	LONGS_EQUAL(0, Timeout::FOREVER.getSubMillisNanos());
+}
+
+TEST(TimeoutTest, fromMicros)
+{
+	Timeout tmout = Timeout::fromMicros(1500);
+	LONGS_EQUAL(1, tmout.getWholeMillis());
+	LONGS_EQUAL(500000, tmout.getSubMillisNanos());
+	// Rounded up to milliseconds
+	LONGS_EQUAL(2, tmout);
+
+	Timeout copied(tmout);
+	LONGS_EQUAL(1, copied.getWholeMillis());
+	LONGS_EQUAL(500000, copied.getSubMillisNanos());
+}
+
+TEST(TimeoutTest, fromMicros_less_than_one_millisecond)
+{
+	Timeout tmout = Timeout::fromMicros(1);
+	LONGS_EQUAL(0, tmout.getWholeMillis());
+	LONGS_EQUAL(1000, tmout.getSubMillisNanos());
+	// Not POLLING
+	LONGS_EQUAL(1, tmout);
+}
+
+TEST(TimeoutTest, fromMicros_zero_is_POLLING)
+{
+	LONGS_EQUAL(Timeout::POLLING, Timeout::fromMicros(0));
+	LONGS_EQUAL(Timeout::POLLING, Timeout::fromNanos(0));
+}
+
+TEST(TimeoutTest, fromMicros_negative_is_FOREVER)
+{
+	LONGS_EQUAL(Timeout::FOREVER, Timeout::fromMicros(-1));
+	LONGS_EQUAL(Timeout::FOREVER, Timeout::fromMicros(-1000));
+	LONGS_EQUAL(0, Timeout::fromMicros(-1).getSubMillisNanos());
+}
+
+TEST(TimeoutTest, fromNanos)
+{
+	Timeout tmout = Timeout::fromNanos(2000001);
+	LONGS_EQUAL(2, tmout.getWholeMillis());
+	LONGS_EQUAL(1, tmout.getSubMillisNanos());
+	LONGS_EQUAL(3, tmout);
+
+	LONGS_EQUAL(5, Timeout::fromNanos(5000000));
+	LONGS_EQUAL(0, Timeout::fromNanos(5000000).getSubMillisNanos());
+	LONGS_EQUAL(Timeout::FOREVER, Timeout::fromNanos(-1));
+}
+
+} // namespace TimeoutTest
@@ -2,12 +2,14 @@
 #include "ItronThreadFactory.h"
 #include "ItronMutexFactory.h"
 #include "ItronEventFlagFactory.h"
+#include "ItronSemaphoreFactory.h"
 #include "ItronFixedMemoryPoolFactory.h"
 #include "ItronVariableMemoryPoolFactory.h"
 #include "ItronPeriodicTimerFactory.h"
 #include "OSWrapper/Thread.h"
 #include "OSWrapper/Mutex.h"
 #include "OSWrapper/EventFlag.h"
+#include "OSWrapper/Semaphore.h"
 #include "OSWrapper/FixedMemoryPool.h"
 #include "OSWrapper/VariableMemoryPool.h"
 #include "OSWrapper/PeriodicTimer.h"
@@ -19,6 +21,7 @@ void init()
 	static ItronThreadFactory theThreadFactory;
 	static ItronMutexFactory theMutexFactory;
 	static ItronEventFlagFactory theEventFlagFactory;
+	static ItronSemaphoreFactory theSemaphoreFactory;
 	static ItronFixedMemoryPoolFactory theFixedMemoryPoolFactory;
 	static ItronVariableMemoryPoolFactory theVariableMemoryPoolFactory;
 	static ItronPeriodicTimerFactory thePeriodicTimerFactory;
@@ -26,6 +29,7 @@ void init()
 	OSWrapper::registerThreadFactory(&theThreadFactory);
 	OSWrapper::registerMutexFactory(&theMutexFactory);
 	OSWrapper::registerEventFlagFactory(&theEventFlagFactory);
+	OSWrapper::registerSemaphoreFactory(&theSemaphoreFactory);
 	OSWrapper::registerFixedMemoryPoolFactory(&theFixedMemoryPoolFactory);
 	OSWrapper::registerVariableMemoryPoolFactory(&theVariableMemoryPoolFactory);
 	OSWrapper::registerPeriodicTimerFactory(&thePeriodicTimerFactory);
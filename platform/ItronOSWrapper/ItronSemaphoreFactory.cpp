@@ -0,0 +1,281 @@
+#include "ItronSemaphoreFactory.h"
+#include "OSWrapper/Semaphore.h"
+#include "private/ItronLock.h"
+#include <new>
+
+#ifndef MAX_SEMAPHORES
+#define MAX_SEMAPHORES (256U)
+#endif
+
+namespace ItronOSWrapper {
+
+using OSWrapper::Timeout;
+
+/*
+ * The semaphore of uITRON acquires 1 permit at a time.
+ * For n permits, the acquirer takes the permits one by one while it locks m_multiMtxId,
+ * so the acquirers of n permits do not hold some permits each other forever.
+ * If it fails to take all, it releases the permits taken.
+ *
+ * The releasers check the count and signal the permits while they lock m_releaseMtxId,
+ * so release() fails without releasing any permit if the count would exceed the max count.
+ * The acquirer also locks m_releaseMtxId to give back the permits taken.
+ * The acquirer waiting for the permits does not lock m_releaseMtxId, so it does not block the releasers.
+ *
+ * The non-task context can't lock the mutex, so release() signals the permits by isig_sem() without the lock there.
+ * If the count reaches the max count during it, the permits signaled before it are not taken back.
+ */
+class ItronSemaphore : public OSWrapper::Semaphore {
+private:
+	ID m_semId;
+	ID m_multiMtxId;
+	ID m_releaseMtxId;
+	std::size_t m_maxCount;
+
+	static OSWrapper::Error toError(ER err)
+	{
+		switch (err) {
+		case E_OK:
+			return OSWrapper::OK;
+		case E_TMOUT:
+			return OSWrapper::TimedOut;
+		case E_CTX:
+			return OSWrapper::CalledByNonThread;
+		case E_PAR:
+			return OSWrapper::InvalidParameter;
+		default:
+			return OSWrapper::OtherError;
+		}
+	}
+
+	static TMO getRemainingTimeout(Timeout tmout, SYSTIM start)
+	{
+		if ((tmout == Timeout::FOREVER) || (tmout == Timeout::POLLING)) {
+			return static_cast<TMO>(tmout);
+		}
+		SYSTIM now = 0;
+		get_tim(&now);
+		const long elapsed = static_cast<long>(now - start);
+		if (elapsed >= tmout) {
+			return TMO_POL;
+		}
+		return static_cast<TMO>(tmout - elapsed);
+	}
+
+	OSWrapper::Error releaseByNonTask(std::size_t n)
+	{
+		for (std::size_t i = 0U; i < n; i++) {
+			ER err = isig_sem(m_semId);
+			if (err != E_OK) {
+				return OSWrapper::OtherError;
+			}
+		}
+		return OSWrapper::OK;
+	}
+
+public:
+	ItronSemaphore(std::size_t initialCount, std::size_t maxCount)
+	: m_semId(0), m_multiMtxId(0), m_releaseMtxId(0), m_maxCount(maxCount)
+	{
+		T_CMTX cmtx = {0};
+		cmtx.mtxatr = TA_INHERIT;
+		ER_ID mtx = acre_mtx(&cmtx);
+		if (mtx <= 0) {
+			return;
+		}
+		m_multiMtxId = mtx;
+
+		mtx = acre_mtx(&cmtx);
+		if (mtx <= 0) {
+			return;
+		}
+		m_releaseMtxId = mtx;
+
+		T_CSEM csem = {0};
+		csem.sematr = TA_TPRI;
+		csem.isemcnt = static_cast<UINT>(initialCount);
+		csem.maxsem = static_cast<UINT>(maxCount);
+		ER_ID sem = acre_sem(&csem);
+		if (sem <= 0) {
+			return;
+		}
+		m_semId = sem;
+	}
+
+	~ItronSemaphore()
+	{
+		if (m_semId > 0) {
+			del_sem(m_semId);
+		}
+		if (m_releaseMtxId > 0) {
+			del_mtx(m_releaseMtxId);
+		}
+		if (m_multiMtxId > 0) {
+			del_mtx(m_multiMtxId);
+		}
+	}
+
+	bool isCreated() { return (m_semId > 0) && (m_multiMtxId > 0) && (m_releaseMtxId > 0); }
+
+	OSWrapper::Error acquire(std::size_t n)
+	{
+		return timedAcquire(n, Timeout::FOREVER);
+	}
+
+	OSWrapper::Error tryAcquire(std::size_t n)
+	{
+		return timedAcquire(n, Timeout::POLLING);
+	}
+
+	OSWrapper::Error timedAcquire(std::size_t n, Timeout tmout)
+	{
+		if ((n == 0U) || (n > m_maxCount)) {
+			return OSWrapper::InvalidParameter;
+		}
+		if (n == 1U) {
+			return toError(twai_sem(m_semId, static_cast<TMO>(tmout)));
+		}
+
+		SYSTIM start = 0;
+		get_tim(&start);
+		ER err = tloc_mtx(m_multiMtxId, static_cast<TMO>(tmout));
+		if (err != E_OK) {
+			return toError(err);
+		}
+		std::size_t taken = 0U;
+		while (taken < n) {
+			err = twai_sem(m_semId, getRemainingTimeout(tmout, start));
+			if (err != E_OK) {
+				break;
+			}
+			taken++;
+		}
+		if (taken < n) {
+			Lock lk(m_releaseMtxId);
+			for (std::size_t i = 0U; i < taken; i++) {
+				sig_sem(m_semId);
+			}
+		}
+		unl_mtx(m_multiMtxId);
+		return toError(err);
+	}
+
+	OSWrapper::Error release(std::size_t n)
+	{
+		if (n == 0U) {
+			return OSWrapper::InvalidParameter;
+		}
+		if (sns_ctx() != FALSE) {
+			// Non-task context
+			return releaseByNonTask(n);
+		}
+		Lock lk(m_releaseMtxId);
+		// The count does not increase while m_releaseMtxId is locked, so all the signals succeed if this check passes.
+		if (n > m_maxCount - getCount()) {
+			return OSWrapper::OtherError;
+		}
+		for (std::size_t i = 0U; i < n; i++) {
+			ER err = sig_sem(m_semId);
+			if (err != E_OK) {
+				return OSWrapper::OtherError;
+			}
+		}
+		return OSWrapper::OK;
+	}
+
+	std::size_t getCount() const
+	{
+		T_RSEM rsem = {0};
+		ER err = ref_sem(m_semId, &rsem);
+		if (err == E_OK) {
+			return static_cast<std::size_t>(rsem.semcnt);
+		} else {
+			return 0U;
+		}
+	}
+
+	std::size_t getMaxCount() const
+	{
+		return m_maxCount;
+	}
+
+};
+
+
+ItronSemaphoreFactory::ItronSemaphoreFactory()
+: m_mpfId(0), m_mtxId(0)
+{
+	T_CMPF cmpf = {0};
+	cmpf.mpfatr = TA_TFIFO;
+	cmpf.blkcnt = MAX_SEMAPHORES;
+	cmpf.blksz = sizeof(ItronSemaphore);
+	cmpf.mpf = 0;
+
+	ER_ID mpf = acre_mpf(&cmpf);
+	if (mpf <= 0) {
+		return;
+	}
+	m_mpfId = mpf;
+
+	T_CMTX cmtx = {0};
+	cmtx.mtxatr = TA_INHERIT;
+	ER_ID mtxId = acre_mtx(&cmtx);
+	if (mtxId <= 0) {
+		return;
+	}
+	m_mtxId = mtxId;
+}
+
+ItronSemaphoreFactory::~ItronSemaphoreFactory()
+{
+	if (m_mpfId > 0) {
+		del_mpf(m_mpfId);
+	}
+	if (m_mtxId > 0) {
+		del_mtx(m_mtxId);
+	}
+}
+
+OSWrapper::Semaphore* ItronSemaphoreFactory::create(std::size_t initialCount, std::size_t maxCount)
+{
+	if ((maxCount == 0U) || (initialCount > maxCount)) {
+		return 0;
+	}
+#ifdef TMAX_MAXSEM
+	if (maxCount > TMAX_MAXSEM) {
+		return 0;
+	}
+#endif
+
+	Lock lk(m_mtxId);
+	if (m_mpfId <= 0) {
+		return 0;
+	}
+
+	VP p = 0;
+	ER err = pget_mpf(m_mpfId, &p);
+	if (err != E_OK) {
+		return 0;
+	}
+	if (p == 0) {
+		return 0;
+	}
+
+	ItronSemaphore* s = new(p) ItronSemaphore(initialCount, maxCount);
+	if (!s->isCreated()) {
+		s->~ItronSemaphore();
+		rel_mpf(m_mpfId, s);
+		return 0;
+	}
+
+	return s;
+}
+
+void ItronSemaphoreFactory::destroy(OSWrapper::Semaphore* s)
+{
+	Lock lk(m_mtxId);
+	static_cast<ItronSemaphore*>(s)->~ItronSemaphore();
+	rel_mpf(m_mpfId, s);
+}
+
+}
@@ -0,0 +1,27 @@
+#ifndef ITRON_OS_WRAPPER_ITRON_SEMAPHORE_FACTORY_H_INCLUDED
+#define ITRON_OS_WRAPPER_ITRON_SEMAPHORE_FACTORY_H_INCLUDED
+
+#include "OSWrapper/SemaphoreFactory.h"
+#include "kernel.h"
+
+namespace ItronOSWrapper {
+
+class ItronSemaphoreFactory : public OSWrapper::SemaphoreFactory {
+public:
+	ItronSemaphoreFactory();
+	virtual ~ItronSemaphoreFactory();
+
+private:
+	virtual OSWrapper::Semaphore* create(std::size_t initialCount, std::size_t maxCount);
+	virtual void destroy(OSWrapper::Semaphore* s);
+
+	ItronSemaphoreFactory(const ItronSemaphoreFactory&);
+	ItronSemaphoreFactory& operator=(const ItronSemaphoreFactory&);
+
+	ID m_mpfId;
+	ID m_mtxId;
+};
+
+}
+
+#endif // ITRON_OS_WRAPPER_ITRON_SEMAPHORE_FACTORY_H_INCLUDED
@@ -0,0 +1,290 @@
+#include "PosixEventFlagFactory.h"
+
+#if defined(__linux__)
+#include "OSWrapper/EventFlag.h"
+#include "StdCppOSWrapper/StdCppTimeout.h"
+#include "PosixFutex.h"
+#include <mutex>
+#include <new>
+
+namespace PosixOSWrapper {
+
+using OSWrapper::EventFlag;
+using OSWrapper::Timeout;
+
+/*
+ * The pattern is kept in an atomic word, so set() and reset() do not take any lock,
+ * and a waiter whose condition is already satisfied takes the pattern without any lock.
+ * Each waiter that has to sleep waits on its own futex word and is linked to the waiter list in FIFO order.
+ * set() releases only the waiters whose condition is satisfied and wakes up each of them.
+ * If the EventFlag is auto reset, set() releases only the first satisfied waiter, because the pattern is reset by it.
+ * If there are no waiters, set() does not take the lock nor call the system call.
+ */
+class PosixEventFlag : public EventFlag {
+private:
+	struct Waiter {
+		const unsigned int m_bitPattern;
+		const Mode m_waitMode;
+		unsigned int m_releasedPattern;
+		std::atomic<unsigned int> m_state;
+		Waiter* m_prev;
+		Waiter* m_next;
+
+		Waiter(unsigned int bitPattern, Mode waitMode)
+		: m_bitPattern(bitPattern), m_waitMode(waitMode), m_releasedPattern(0U), m_state(WAITING),
+		  m_prev(nullptr), m_next(nullptr)
+		{
+		}
+	};
+
+	// States of Waiter::m_state, that is the futex word of the waiter
+	static const unsigned int WAITING = 0U;
+	static const unsigned int RELEASED = 1U;
+
+	const bool m_autoReset;
+	std::atomic<unsigned int> m_pattern;
+	std::atomic<unsigned int> m_numWaiters;
+
+	std::mutex m_mutex;
+	Waiter* m_head;
+	Waiter* m_tail;
+
+	static bool isSatisfied(unsigned int current, unsigned int bitPattern, Mode waitMode)
+	{
+		if (waitMode == EventFlag::OR) {
+			return (current & bitPattern) != 0U;
+		}
+		return (current & bitPattern) == bitPattern;
+	}
+
+	bool tryTakePattern(unsigned int bitPattern, Mode waitMode, unsigned int* takenPattern)
+	{
+		unsigned int current = m_pattern.load();
+		while (isSatisfied(current, bitPattern, waitMode)) {
+			if (!m_autoReset || m_pattern.compare_exchange_weak(current, 0U)) {
+				*takenPattern = current;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void linkWaiter(Waiter* w)
+	{
+		w->m_prev = m_tail;
+		w->m_next = nullptr;
+		if (m_tail != nullptr) {
+			m_tail->m_next = w;
+		} else {
+			m_head = w;
+		}
+		m_tail = w;
+	}
+
+	void unlinkWaiter(Waiter* w)
+	{
+		if (w->m_prev != nullptr) {
+			w->m_prev->m_next = w->m_next;
+		} else {
+			m_head = w->m_next;
+		}
+		if (w->m_next != nullptr) {
+			w->m_next->m_prev = w->m_prev;
+		} else {
+			m_tail = w->m_prev;
+		}
+		w->m_prev = nullptr;
+		w->m_next = nullptr;
+		m_numWaiters.fetch_sub(1U);
+	}
+
+public:
+	explicit PosixEventFlag(bool autoReset)
+	: m_autoReset(autoReset), m_pattern(0U), m_numWaiters(0U), m_mutex(), m_head(nullptr), m_tail(nullptr)
+	{
+	}
+
+	~PosixEventFlag()
+	{
+	}
+
+	OSWrapper::Error waitAny()
+	{
+		return timedWaitAny(Timeout::FOREVER);
+	}
+
+	OSWrapper::Error waitOne(std::size_t pos)
+	{
+		return timedWaitOne(pos, Timeout::FOREVER);
+	}
+
+	OSWrapper::Error wait(EventFlag::Pattern bitPattern, Mode waitMode, EventFlag::Pattern* releasedPattern)
+	{
+		return timedWait(bitPattern, waitMode, releasedPattern, Timeout::FOREVER);
+	}
+
+	OSWrapper::Error tryWaitAny()
+	{
+		return timedWaitAny(Timeout::POLLING);
+	}
+
+	OSWrapper::Error tryWaitOne(std::size_t pos)
+	{
+		return timedWaitOne(pos, Timeout::POLLING);
+	}
+
+	OSWrapper::Error tryWait(EventFlag::Pattern bitPattern, Mode waitMode, EventFlag::Pattern* releasedPattern)
+	{
+		return timedWait(bitPattern, waitMode, releasedPattern, Timeout::POLLING);
+	}
+
+	OSWrapper::Error timedWaitAny(Timeout tmout)
+	{
+		return timedWait(EventFlag::Pattern().set(), EventFlag::OR, nullptr, tmout);
+	}
+
+	OSWrapper::Error timedWaitOne(std::size_t pos, Timeout tmout)
+	{
+		if (pos >= EventFlag::Pattern().size()) {
+			return OSWrapper::InvalidParameter;
+		}
+		return timedWait(EventFlag::Pattern().set(pos), EventFlag::OR, nullptr, tmout);
+	}
+
+	OSWrapper::Error timedWait(EventFlag::Pattern bitPattern, Mode waitMode, EventFlag::Pattern* releasedPattern, Timeout tmout)
+	{
+		if ((waitMode != EventFlag::OR) && (waitMode != EventFlag::AND)) {
+			return OSWrapper::InvalidParameter;
+		}
+		if (bitPattern.none()) {
+			return OSWrapper::InvalidParameter;
+		}
+
+		const unsigned int bits = bitPattern;
+		unsigned int takenPattern = 0U;
+		if (tryTakePattern(bits, waitMode, &takenPattern)) {
+			if (releasedPattern != nullptr) {
+				*releasedPattern = takenPattern;
+			}
+			return OSWrapper::OK;
+		}
+		if (tmout == Timeout::POLLING) {
+			return OSWrapper::TimedOut;
+		}
+
+		const bool forever = (tmout == Timeout::FOREVER);
+		std::chrono::steady_clock::time_point deadline;
+		if (!forever) {
+			deadline = std::chrono::steady_clock::now() + StdCppOSWrapper::toDuration(tmout);
+		}
+
+		Waiter w(bits, waitMode);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			// set() does not see the waiter list while m_numWaiters is zero, so check the pattern again after counting this waiter
+			m_numWaiters.fetch_add(1U);
+			if (tryTakePattern(bits, waitMode, &takenPattern)) {
+				m_numWaiters.fetch_sub(1U);
+				if (releasedPattern != nullptr) {
+					*releasedPattern = takenPattern;
+				}
+				return OSWrapper::OK;
+			}
+			linkWaiter(&w);
+		}
+
+		while (w.m_state.load() == WAITING) {
+			if (!futexWait(w.m_state, WAITING, FUTEX_BITSET_MATCH_ANY, forever ? nullptr : &deadline)) {
+				break;
+			}
+		}
+
+		// set() releases the waiter with m_mutex locked, so set() does not access w after this lock
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (w.m_state.load() == WAITING) {
+			unlinkWaiter(&w);
+			return OSWrapper::TimedOut;
+		}
+		if (releasedPattern != nullptr) {
+			*releasedPattern = w.m_releasedPattern;
+		}
+		return OSWrapper::OK;
+	}
+
+	OSWrapper::Error setAll()
+	{
+		return set(EventFlag::Pattern().set());
+	}
+
+	OSWrapper::Error setOne(std::size_t pos)
+	{
+		if (pos >= EventFlag::Pattern().size()) {
+			return OSWrapper::InvalidParameter;
+		}
+		return set(EventFlag::Pattern().set(pos));
+	}
+
+	OSWrapper::Error set(EventFlag::Pattern bitPattern)
+	{
+		const unsigned int bits = bitPattern;
+		const unsigned int old = m_pattern.fetch_or(bits);
+		if (((bits & ~old) == 0U) || (m_numWaiters.load() == 0U)) {
+			return OSWrapper::OK;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Waiter* w = m_head;
+		while ((w != nullptr) && (m_pattern.load() != 0U)) {
+			Waiter* next = w->m_next;
+			unsigned int takenPattern = 0U;
+			if (tryTakePattern(w->m_bitPattern, w->m_waitMode, &takenPattern)) {
+				unlinkWaiter(w);
+				w->m_releasedPattern = takenPattern;
+				w->m_state.store(RELEASED);
+				futexWake(w->m_state, 1, FUTEX_BITSET_MATCH_ANY);
+			}
+			w = next;
+		}
+		return OSWrapper::OK;
+	}
+
+	OSWrapper::Error resetAll()
+	{
+		return reset(EventFlag::Pattern().set());
+	}
+
+	OSWrapper::Error resetOne(std::size_t pos)
+	{
+		if (pos >= EventFlag::Pattern().size()) {
+			return OSWrapper::InvalidParameter;
+		}
+		return reset(EventFlag::Pattern().set(pos));
+	}
+
+	OSWrapper::Error reset(EventFlag::Pattern bitPattern)
+	{
+		m_pattern.fetch_and(~static_cast<unsigned int>(bitPattern));
+		return OSWrapper::OK;
+	}
+
+	EventFlag::Pattern getCurrentPattern() const
+	{
+		return m_pattern.load();
+	}
+
+};
+
+
+OSWrapper::EventFlag* PosixEventFlagFactory::create(bool autoReset)
+{
+	return new(std::nothrow) PosixEventFlag(autoReset);
+}
+
+void PosixEventFlagFactory::destroy(OSWrapper::EventFlag* e)
+{
+	delete static_cast<PosixEventFlag*>(e);
+}
+
+}
+
+#endif
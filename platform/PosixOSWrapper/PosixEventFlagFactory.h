@@ -6,6 +6,15 @@
 namespace PosixOSWrapper {
 
 class PosixEventFlagFactory : public StdCppOSWrapper::StdCppEventFlagFactory {
+#if defined(__linux__)
+public:
+	PosixEventFlagFactory() {}
+	virtual ~PosixEventFlagFactory() {}
+
+private:
+	virtual OSWrapper::EventFlag* create(bool autoReset);
+	virtual void destroy(OSWrapper::EventFlag* e);
+#endif
 };
 
 }
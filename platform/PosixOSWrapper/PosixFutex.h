@@ -0,0 +1,74 @@
+#ifndef POSIX_OS_WRAPPER_POSIX_FUTEX_H_INCLUDED
+#define POSIX_OS_WRAPPER_POSIX_FUTEX_H_INCLUDED
+
+#if defined(__linux__)
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <ctime>
+#include <cerrno>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace PosixOSWrapper {
+
+static_assert(sizeof(std::atomic<unsigned int>) == sizeof(unsigned int), "std::atomic<unsigned int> can not be used as futex word");
+
+/*!
+ * @brief Wait while the futex word is the expected value
+ * @param word Futex word
+ * @param expected Expected value of the futex word
+ * @param bitset Bits that this waiter is woken up by futexWake()
+ * @param deadline Time point to stop waiting. If null pointer, waits forever
+ * @retval true Woken up, or the futex word was not the expected value
+ * @retval false Timed out
+ *
+ * It may return spuriously, so the caller must check its condition again.
+ * std::chrono::steady_clock is CLOCK_MONOTONIC on Linux, that is the clock of FUTEX_WAIT_BITSET.
+ */
+inline bool futexWait(std::atomic<unsigned int>& word, unsigned int expected, unsigned int bitset,
+		const std::chrono::steady_clock::time_point* deadline)
+{
+	struct timespec ts = {};
+	struct timespec* tsp = nullptr;
+	if (deadline != nullptr) {
+		const std::chrono::nanoseconds time = deadline->time_since_epoch();
+		const std::chrono::seconds sec = std::chrono::duration_cast<std::chrono::seconds>(time);
+		ts.tv_sec = static_cast<std::time_t>(sec.count());
+		ts.tv_nsec = static_cast<long>((time - sec).count());
+		tsp = &ts;
+	}
+	const long ret = syscall(SYS_futex, reinterpret_cast<unsigned int*>(&word), FUTEX_WAIT_BITSET_PRIVATE,
+			expected, tsp, nullptr, bitset);
+	return !((ret != 0) && (errno == ETIMEDOUT));
+}
+
+/*!
+ * @brief Wake up the waiters of the futex word
+ * @param word Futex word
+ * @param count Maximum number of the waiters to be woken up
+ * @param bitset Only the waiters waiting for any of these bits are woken up
+ */
+inline void futexWake(std::atomic<unsigned int>& word, int count, unsigned int bitset)
+{
+	syscall(SYS_futex, reinterpret_cast<unsigned int*>(&word), FUTEX_WAKE_BITSET_PRIVATE,
+			count, nullptr, nullptr, bitset);
+}
+
+/*!
+ * @brief Hint to the CPU that the current thread is spinning
+ */
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+}
+#endif
+
+#endif // POSIX_OS_WRAPPER_POSIX_FUTEX_H_INCLUDED
@@ -0,0 +1,207 @@
+#include "PosixMutexFactory.h"
+
+#if defined(__linux__)
+#include "OSWrapper/Mutex.h"
+#include "StdCppOSWrapper/StdCppTimeout.h"
+#include "PosixFutex.h"
+#include <thread>
+#include <new>
+
+namespace PosixOSWrapper {
+
+/*
+ * The state of the futex word is UNLOCKED, LOCKED or CONTENDED, that means some threads may sleep on the futex.
+ * A thread that fails to lock spins on the state, and then sleeps setting the state to CONTENDED.
+ * unlock() calls the system call only if the state was CONTENDED.
+ *
+ * The maximum count of spinning is adapted to the counts that were needed to lock, like PTHREAD_MUTEX_ADAPTIVE_NP.
+ * If there is only one CPU, it does not spin.
+ */
+class PosixAdaptiveMutex : public OSWrapper::Mutex {
+private:
+	static const unsigned int UNLOCKED = 0U;
+	static const unsigned int LOCKED = 1U;
+	static const unsigned int CONTENDED = 2U;
+	static const int MAX_SPIN_COUNT = 100;
+
+	const bool m_recursive;
+	const bool m_spins;
+	std::atomic<unsigned int> m_state;
+	std::atomic<int> m_spinCount;
+	std::atomic<std::thread::id> m_owner;
+	std::size_t m_lockingCount;
+
+	bool tryAcquire()
+	{
+		unsigned int expected = UNLOCKED;
+		return m_state.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	bool spinAcquire()
+	{
+		if (!m_spins) {
+			return false;
+		}
+		const int estimate = m_spinCount.load(std::memory_order_relaxed);
+		int maxCount = estimate * 2 + 10;
+		if (maxCount > MAX_SPIN_COUNT) {
+			maxCount = MAX_SPIN_COUNT;
+		}
+		for (int count = 0; count < maxCount; count++) {
+			if ((m_state.load(std::memory_order_relaxed) == UNLOCKED) && tryAcquire()) {
+				m_spinCount.store(estimate + (count - estimate) / 8, std::memory_order_relaxed);
+				return true;
+			}
+			cpuRelax();
+		}
+		m_spinCount.store(estimate + (maxCount - estimate) / 8, std::memory_order_relaxed);
+		return false;
+	}
+
+	bool acquire(OSWrapper::Timeout tmout)
+	{
+		if (tryAcquire()) {
+			return true;
+		}
+		if (tmout == OSWrapper::Timeout::POLLING) {
+			return false;
+		}
+		if (spinAcquire()) {
+			return true;
+		}
+
+		const bool forever = (tmout == OSWrapper::Timeout::FOREVER);
+		std::chrono::steady_clock::time_point deadline;
+		if (!forever) {
+			deadline = std::chrono::steady_clock::now() + StdCppOSWrapper::toDuration(tmout);
+		}
+		while (m_state.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED) {
+			if (!forever && (std::chrono::steady_clock::now() >= deadline)) {
+				return false;
+			}
+			futexWait(m_state, CONTENDED, FUTEX_BITSET_MATCH_ANY, forever ? nullptr : &deadline);
+		}
+		return true;
+	}
+
+	void release()
+	{
+		if (m_state.exchange(UNLOCKED, std::memory_order_release) == CONTENDED) {
+			futexWake(m_state, 1, FUTEX_BITSET_MATCH_ANY);
+		}
+	}
+
+public:
+	explicit PosixAdaptiveMutex(bool recursive)
+	: m_recursive(recursive), m_spins(std::thread::hardware_concurrency() > 1U),
+	  m_state(UNLOCKED), m_spinCount(0), m_owner(std::thread::id()), m_lockingCount(0U)
+	{
+	}
+
+	virtual ~PosixAdaptiveMutex()
+	{
+	}
+
+	OSWrapper::Error lock()
+	{
+		return timedLock(OSWrapper::Timeout::FOREVER);
+	}
+
+	OSWrapper::Error tryLock()
+	{
+		return timedLock(OSWrapper::Timeout::POLLING);
+	}
+
+	OSWrapper::Error timedLock(OSWrapper::Timeout tmout)
+	{
+		if (m_recursive) {
+			// Only the current thread stores its own id to m_owner, so the relaxed load is enough to know it is the owner
+			const std::thread::id self = std::this_thread::get_id();
+			if (m_owner.load(std::memory_order_relaxed) == self) {
+				m_lockingCount++;
+				return OSWrapper::OK;
+			}
+			if (!acquire(tmout)) {
+				return OSWrapper::TimedOut;
+			}
+			m_owner.store(self, std::memory_order_relaxed);
+			m_lockingCount = 1U;
+			return OSWrapper::OK;
+		}
+		if (!acquire(tmout)) {
+			return OSWrapper::TimedOut;
+		}
+		return OSWrapper::OK;
+	}
+
+	OSWrapper::Error unlock()
+	{
+		if (m_recursive) {
+			if (m_owner.load(std::memory_order_relaxed) != std::this_thread::get_id()) {
+				return OSWrapper::NotLocked;
+			}
+			m_lockingCount--;
+			if (m_lockingCount != 0U) {
+				return OSWrapper::OK;
+			}
+			m_owner.store(std::thread::id(), std::memory_order_relaxed);
+		} else if (m_state.load(std::memory_order_relaxed) == UNLOCKED) {
+			return OSWrapper::NotLocked;
+		}
+		release();
+		return OSWrapper::OK;
+	}
+};
+
+
+PosixMutexFactory::PosixMutexFactory(bool adaptive)
+: StdCppOSWrapper::StdCppMutexFactory(), m_adaptive(adaptive)
+{
+}
+
+OSWrapper::Mutex* PosixMutexFactory::create()
+{
+	if (!m_adaptive) {
+		return StdCppOSWrapper::StdCppMutexFactory::create();
+	}
+	return new(std::nothrow) PosixAdaptiveMutex(true);
+}
+
+OSWrapper::Mutex* PosixMutexFactory::create(int priorityCeiling)
+{
+	(void) priorityCeiling;
+	return create();
+}
+
+OSWrapper::Mutex* PosixMutexFactory::createNonRecursive()
+{
+	if (!m_adaptive) {
+		return StdCppOSWrapper::StdCppMutexFactory::createNonRecursive();
+	}
+	return new(std::nothrow) PosixAdaptiveMutex(false);
+}
+
+void PosixMutexFactory::destroy(OSWrapper::Mutex* m)
+{
+	if (!m_adaptive) {
+		StdCppOSWrapper::StdCppMutexFactory::destroy(m);
+		return;
+	}
+	delete static_cast<PosixAdaptiveMutex*>(m);
+}
+
+}
+
+#else
+
+namespace PosixOSWrapper {
+
+PosixMutexFactory::PosixMutexFactory(bool adaptive)
+: StdCppOSWrapper::StdCppMutexFactory()
+{
+	(void) adaptive;
+}
+
+}
+
+#endif
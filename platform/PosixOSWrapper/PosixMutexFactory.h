@@ -6,6 +6,26 @@
 namespace PosixOSWrapper {
 
 class PosixMutexFactory : public StdCppOSWrapper::StdCppMutexFactory {
+public:
+	/*!
+	 * @brief Constructor of PosixMutexFactory
+	 * @param adaptive If true, the mutexes spin for a short time before they sleep on a futex (Linux only)
+	 *
+	 * The adaptive mutexes avoid the system calls for the short critical sections.
+	 * If the platform is not Linux, adaptive is ignored.
+	 */
+	explicit PosixMutexFactory(bool adaptive = false);
+	virtual ~PosixMutexFactory() {}
+
+#if defined(__linux__)
+private:
+	virtual OSWrapper::Mutex* create();
+	virtual OSWrapper::Mutex* create(int priorityCeiling);
+	virtual OSWrapper::Mutex* createNonRecursive();
+	virtual void destroy(OSWrapper::Mutex* m);
+
+	bool m_adaptive;
+#endif
 };
 
 }
@@ -1,14 +1,18 @@
 #include "PosixOSWrapper.h"
 #include "PosixThreadFactory.h"
 #include "PosixMutexFactory.h"
+#include "PosixRWLockFactory.h"
 #include "PosixEventFlagFactory.h"
+#include "PosixSemaphoreFactory.h"
 #include "PosixFixedMemoryPoolFactory.h"
 #include "PosixVariableMemoryPoolFactory.h"
 #include "PosixPeriodicTimerFactory.h"
 #include "PosixOneShotTimerFactory.h"
 #include "OSWrapper/Thread.h"
 #include "OSWrapper/Mutex.h"
+#include "OSWrapper/RWLock.h"
 #include "OSWrapper/EventFlag.h"
+#include "OSWrapper/Semaphore.h"
 #include "OSWrapper/FixedMemoryPool.h"
 #include "OSWrapper/VariableMemoryPool.h"
 #include "OSWrapper/PeriodicTimer.h"
@@ -33,7 +37,9 @@ void init(int lowestPriority, int highestPriority)
 {
 	static PosixThreadFactory theThreadFactory(lowestPriority, highestPriority);
 	static PosixMutexFactory theMutexFactory;
+	static PosixRWLockFactory theRWLockFactory;
 	static PosixEventFlagFactory theEventFlagFactory;
+	static PosixSemaphoreFactory theSemaphoreFactory;
 	static PosixFixedMemoryPoolFactory theFixedMemoryPoolFactory;
 	static PosixVariableMemoryPoolFactory theVariableMemoryPoolFactory;
 	static PosixPeriodicTimerFactory thePeriodicTimerFactory;
@@ -41,7 +47,9 @@ void init(int lowestPriority, int highestPriority)
 
 	OSWrapper::registerThreadFactory(&theThreadFactory);
 	OSWrapper::registerMutexFactory(&theMutexFactory);
+	OSWrapper::registerRWLockFactory(&theRWLockFactory);
 	OSWrapper::registerEventFlagFactory(&theEventFlagFactory);
+	OSWrapper::registerSemaphoreFactory(&theSemaphoreFactory);
 	OSWrapper::registerFixedMemoryPoolFactory(&theFixedMemoryPoolFactory);
 	OSWrapper::registerVariableMemoryPoolFactory(&theVariableMemoryPoolFactory);
 	OSWrapper::registerPeriodicTimerFactory(&thePeriodicTimerFactory);
@@ -0,0 +1,20 @@
+#include "PosixOneShotTimerFactory.h"
+
+#if defined(__linux__)
+#include "PosixTimerService.h"
+
+namespace PosixOSWrapper {
+
+StdCppOSWrapper::StdCppTimerService* PosixOneShotTimerFactory::acquireTimerService()
+{
+	return PosixTimerService::acquire();
+}
+
+void PosixOneShotTimerFactory::releaseTimerService()
+{
+	PosixTimerService::release();
+}
+
+}
+
+#endif
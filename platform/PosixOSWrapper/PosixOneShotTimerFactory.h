@@ -6,6 +6,15 @@
 namespace PosixOSWrapper {
 
 class PosixOneShotTimerFactory : public StdCppOSWrapper::StdCppOneShotTimerFactory {
+#if defined(__linux__)
+public:
+	PosixOneShotTimerFactory() {}
+	virtual ~PosixOneShotTimerFactory() {}
+
+private:
+	virtual StdCppOSWrapper::StdCppTimerService* acquireTimerService();
+	virtual void releaseTimerService();
+#endif
 };
 
 }
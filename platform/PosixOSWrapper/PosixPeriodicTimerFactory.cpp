@@ -0,0 +1,20 @@
+#include "PosixPeriodicTimerFactory.h"
+
+#if defined(__linux__)
+#include "PosixTimerService.h"
+
+namespace PosixOSWrapper {
+
+StdCppOSWrapper::StdCppTimerService* PosixPeriodicTimerFactory::acquireTimerService()
+{
+	return PosixTimerService::acquire();
+}
+
+void PosixPeriodicTimerFactory::releaseTimerService()
+{
+	PosixTimerService::release();
+}
+
+}
+
+#endif
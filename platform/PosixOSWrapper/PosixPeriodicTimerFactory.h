@@ -6,6 +6,15 @@
 namespace PosixOSWrapper {
 
 class PosixPeriodicTimerFactory : public StdCppOSWrapper::StdCppPeriodicTimerFactory {
+#if defined(__linux__)
+public:
+	PosixPeriodicTimerFactory() {}
+	virtual ~PosixPeriodicTimerFactory() {}
+
+private:
+	virtual StdCppOSWrapper::StdCppTimerService* acquireTimerService();
+	virtual void releaseTimerService();
+#endif
 };
 
 }
@@ -0,0 +1,183 @@
+#include "PosixRWLockFactory.h"
+
+#if defined(__GLIBC__)
+#include "OSWrapper/RWLock.h"
+#include <atomic>
+#include <cstddef>
+#include <cerrno>
+#include <ctime>
+#include <new>
+
+namespace PosixOSWrapper {
+
+/*
+ * pthread_rwlock_unlock() does not know whether the current thread locks,
+ * so the numbers of the lockers are counted to return NotLocked.
+ */
+class PosixRWLock : public OSWrapper::RWLock {
+private:
+	pthread_rwlock_t m_rwlock;
+	bool m_isInitialized;
+	std::atomic<std::size_t> m_numReaders;
+	std::atomic<bool> m_isWriting;
+
+	typedef int (*LockFunc)(pthread_rwlock_t*);
+#if __GLIBC_PREREQ(2, 30)
+	typedef int (*TimedLockFunc)(pthread_rwlock_t*, clockid_t, const struct timespec*);
+	static const clockid_t DEADLINE_CLOCK = CLOCK_MONOTONIC;
+#else
+	typedef int (*TimedLockFunc)(pthread_rwlock_t*, const struct timespec*);
+	static const clockid_t DEADLINE_CLOCK = CLOCK_REALTIME;
+#endif
+
+	static void getDeadline(OSWrapper::Timeout tmout, struct timespec* deadline)
+	{
+		clock_gettime(DEADLINE_CLOCK, deadline);
+		const long millis = tmout.getWholeMillis();
+		const long nanos = deadline->tv_nsec + (millis % 1000) * 1000000L + tmout.getSubMillisNanos();
+		deadline->tv_sec += static_cast<time_t>(millis / 1000 + nanos / 1000000000L);
+		deadline->tv_nsec = nanos % 1000000000L;
+	}
+
+	int lock(OSWrapper::Timeout tmout, LockFunc lockFunc, LockFunc tryLockFunc, TimedLockFunc timedLockFunc)
+	{
+		if (tmout == OSWrapper::Timeout::FOREVER) {
+			return lockFunc(&m_rwlock);
+		}
+		if (tmout == OSWrapper::Timeout::POLLING) {
+			return tryLockFunc(&m_rwlock);
+		}
+		struct timespec deadline;
+		getDeadline(tmout, &deadline);
+#if __GLIBC_PREREQ(2, 30)
+		return timedLockFunc(&m_rwlock, DEADLINE_CLOCK, &deadline);
+#else
+		return timedLockFunc(&m_rwlock, &deadline);
+#endif
+	}
+
+	static OSWrapper::Error toError(int ret)
+	{
+		switch (ret) {
+		case 0:
+			return OSWrapper::OK;
+		case EBUSY:
+		case ETIMEDOUT:
+			return OSWrapper::TimedOut;
+		default:
+			return OSWrapper::OtherError;
+		}
+	}
+
+public:
+	explicit PosixRWLock(bool writerPreference)
+	: m_rwlock(), m_isInitialized(false), m_numReaders(0U), m_isWriting(false)
+	{
+		pthread_rwlockattr_t attr;
+		if (pthread_rwlockattr_init(&attr) != 0) {
+			return;
+		}
+		if (writerPreference) {
+			pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+		}
+		m_isInitialized = (pthread_rwlock_init(&m_rwlock, &attr) == 0);
+		pthread_rwlockattr_destroy(&attr);
+	}
+
+	~PosixRWLock()
+	{
+		if (m_isInitialized) {
+			pthread_rwlock_destroy(&m_rwlock);
+		}
+	}
+
+	bool isInitialized() const
+	{
+		return m_isInitialized;
+	}
+
+	OSWrapper::Error readLock()
+	{
+		return timedReadLock(OSWrapper::Timeout::FOREVER);
+	}
+
+	OSWrapper::Error tryReadLock()
+	{
+		return timedReadLock(OSWrapper::Timeout::POLLING);
+	}
+
+	OSWrapper::Error timedReadLock(OSWrapper::Timeout tmout)
+	{
+#if __GLIBC_PREREQ(2, 30)
+		const int ret = lock(tmout, pthread_rwlock_rdlock, pthread_rwlock_tryrdlock, pthread_rwlock_clockrdlock);
+#else
+		const int ret = lock(tmout, pthread_rwlock_rdlock, pthread_rwlock_tryrdlock, pthread_rwlock_timedrdlock);
+#endif
+		if (ret == 0) {
+			m_numReaders.fetch_add(1U, std::memory_order_relaxed);
+		}
+		return toError(ret);
+	}
+
+	OSWrapper::Error readUnlock()
+	{
+		std::size_t n = m_numReaders.load(std::memory_order_relaxed);
+		do {
+			if (n == 0U) {
+				return OSWrapper::NotLocked;
+			}
+		} while (!m_numReaders.compare_exchange_weak(n, n - 1U, std::memory_order_relaxed));
+		return toError(pthread_rwlock_unlock(&m_rwlock));
+	}
+
+	OSWrapper::Error writeLock()
+	{
+		return timedWriteLock(OSWrapper::Timeout::FOREVER);
+	}
+
+	OSWrapper::Error tryWriteLock()
+	{
+		return timedWriteLock(OSWrapper::Timeout::POLLING);
+	}
+
+	OSWrapper::Error timedWriteLock(OSWrapper::Timeout tmout)
+	{
+#if __GLIBC_PREREQ(2, 30)
+		const int ret = lock(tmout, pthread_rwlock_wrlock, pthread_rwlock_trywrlock, pthread_rwlock_clockwrlock);
+#else
+		const int ret = lock(tmout, pthread_rwlock_wrlock, pthread_rwlock_trywrlock, pthread_rwlock_timedwrlock);
+#endif
+		if (ret == 0) {
+			m_isWriting.store(true, std::memory_order_relaxed);
+		}
+		return toError(ret);
+	}
+
+	OSWrapper::Error writeUnlock()
+	{
+		if (!m_isWriting.exchange(false, std::memory_order_relaxed)) {
+			return OSWrapper::NotLocked;
+		}
+		return toError(pthread_rwlock_unlock(&m_rwlock));
+	}
+};
+
+
+OSWrapper::RWLock* PosixRWLockFactory::create(bool writerPreference)
+{
+	PosixRWLock* l = new(std::nothrow) PosixRWLock(writerPreference);
+	if ((l != nullptr) && !l->isInitialized()) {
+		delete l;
+		return nullptr;
+	}
+	return l;
+}
+
+void PosixRWLockFactory::destroy(OSWrapper::RWLock* l)
+{
+	delete static_cast<PosixRWLock*>(l);
+}
+
+}
+
+#endif
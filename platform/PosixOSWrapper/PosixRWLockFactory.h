@@ -0,0 +1,29 @@
+#ifndef POSIX_OS_WRAPPER_POSIX_RW_LOCK_FACTORY_H_INCLUDED
+#define POSIX_OS_WRAPPER_POSIX_RW_LOCK_FACTORY_H_INCLUDED
+
+#include "StdCppOSWrapper/StdCppRWLockFactory.h"
+#include <pthread.h>
+
+namespace PosixOSWrapper {
+
+/*!
+ * @brief RWLockFactory of PosixOSWrapper
+ *
+ * With glibc, the RWLock is pthread_rwlock_t and the writer preference is PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP.
+ * Otherwise, same as StdCppRWLockFactory.
+ */
+class PosixRWLockFactory : public StdCppOSWrapper::StdCppRWLockFactory {
+public:
+	PosixRWLockFactory() {}
+	virtual ~PosixRWLockFactory() {}
+
+#if defined(__GLIBC__)
+private:
+	virtual OSWrapper::RWLock* create(bool writerPreference);
+	virtual void destroy(OSWrapper::RWLock* l);
+#endif
+};
+
+}
+
+#endif // POSIX_OS_WRAPPER_POSIX_RW_LOCK_FACTORY_H_INCLUDED
@@ -0,0 +1,148 @@
+#include "PosixSemaphoreFactory.h"
+
+#if defined(__linux__)
+#include "OSWrapper/Semaphore.h"
+#include "StdCppOSWrapper/StdCppTimeout.h"
+#include "PosixFutex.h"
+#include <climits>
+#include <new>
+
+namespace PosixOSWrapper {
+
+using OSWrapper::Timeout;
+
+/*
+ * The count is the futex word, so the permits are acquired and released by CAS without any lock.
+ * The system call is called only when a thread has to sleep, or release() finds the sleeping threads.
+ * sem_t is not used because it can not acquire n permits at once and has no maximum count.
+ *
+ * If all the waiting threads wait for 1 permit, release(n) wakes up n threads.
+ * Otherwise it wakes up all the waiting threads like StdCppSemaphore.
+ */
+class PosixSemaphore : public OSWrapper::Semaphore {
+private:
+	const unsigned int m_maxCount;
+	std::atomic<unsigned int> m_count;
+	std::atomic<unsigned int> m_numWaiters;
+	std::atomic<unsigned int> m_numMultiWaiters;
+
+	bool tryTake(unsigned int n)
+	{
+		unsigned int current = m_count.load(std::memory_order_relaxed);
+		while (current >= n) {
+			if (m_count.compare_exchange_weak(current, current - n, std::memory_order_acquire, std::memory_order_relaxed)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	PosixSemaphore(unsigned int initialCount, unsigned int maxCount)
+	: m_maxCount(maxCount), m_count(initialCount), m_numWaiters(0U), m_numMultiWaiters(0U)
+	{
+	}
+
+	~PosixSemaphore()
+	{
+	}
+
+	OSWrapper::Error acquire(std::size_t n)
+	{
+		return timedAcquire(n, Timeout::FOREVER);
+	}
+
+	OSWrapper::Error tryAcquire(std::size_t n)
+	{
+		return timedAcquire(n, Timeout::POLLING);
+	}
+
+	OSWrapper::Error timedAcquire(std::size_t n, Timeout tmout)
+	{
+		if ((n == 0U) || (n > m_maxCount)) {
+			return OSWrapper::InvalidParameter;
+		}
+		const unsigned int num = static_cast<unsigned int>(n);
+		if (tryTake(num)) {
+			return OSWrapper::OK;
+		}
+		if (tmout == Timeout::POLLING) {
+			return OSWrapper::TimedOut;
+		}
+
+		const bool forever = (tmout == Timeout::FOREVER);
+		std::chrono::steady_clock::time_point deadline;
+		if (!forever) {
+			deadline = std::chrono::steady_clock::now() + StdCppOSWrapper::toDuration(tmout);
+		}
+		std::atomic<unsigned int>& numWaiters = (num > 1U) ? m_numMultiWaiters : m_numWaiters;
+		for (;;) {
+			if (tryTake(num)) {
+				return OSWrapper::OK;
+			}
+			if (!forever && (std::chrono::steady_clock::now() >= deadline)) {
+				return OSWrapper::TimedOut;
+			}
+			// release() adds the count before it reads the numbers of the waiters,
+			// so it wakes up this thread or this thread reads the added count.
+			numWaiters.fetch_add(1U);
+			const unsigned int current = m_count.load();
+			if (current < num) {
+				futexWait(m_count, current, FUTEX_BITSET_MATCH_ANY, forever ? nullptr : &deadline);
+			}
+			numWaiters.fetch_sub(1U);
+		}
+	}
+
+	OSWrapper::Error release(std::size_t n)
+	{
+		if (n == 0U) {
+			return OSWrapper::InvalidParameter;
+		}
+		if (n > m_maxCount) {
+			return OSWrapper::OtherError;
+		}
+		const unsigned int num = static_cast<unsigned int>(n);
+		unsigned int current = m_count.load(std::memory_order_relaxed);
+		do {
+			if (num > m_maxCount - current) {
+				return OSWrapper::OtherError;
+			}
+		} while (!m_count.compare_exchange_weak(current, current + num));
+
+		if (m_numMultiWaiters.load() != 0U) {
+			futexWake(m_count, INT_MAX, FUTEX_BITSET_MATCH_ANY);
+		} else if (m_numWaiters.load() != 0U) {
+			futexWake(m_count, (num > static_cast<unsigned int>(INT_MAX)) ? INT_MAX : static_cast<int>(num), FUTEX_BITSET_MATCH_ANY);
+		}
+		return OSWrapper::OK;
+	}
+
+	std::size_t getCount() const
+	{
+		return m_count.load();
+	}
+
+	std::size_t getMaxCount() const
+	{
+		return m_maxCount;
+	}
+};
+
+
+OSWrapper::Semaphore* PosixSemaphoreFactory::create(std::size_t initialCount, std::size_t maxCount)
+{
+	if ((maxCount == 0U) || (initialCount > maxCount) || (maxCount > UINT_MAX)) {
+		return nullptr;
+	}
+	return new(std::nothrow) PosixSemaphore(static_cast<unsigned int>(initialCount), static_cast<unsigned int>(maxCount));
+}
+
+void PosixSemaphoreFactory::destroy(OSWrapper::Semaphore* s)
+{
+	delete static_cast<PosixSemaphore*>(s);
+}
+
+}
+
+#endif
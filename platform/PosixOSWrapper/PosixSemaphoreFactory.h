@@ -0,0 +1,22 @@
+#ifndef POSIX_OS_WRAPPER_POSIX_SEMAPHORE_FACTORY_H_INCLUDED
+#define POSIX_OS_WRAPPER_POSIX_SEMAPHORE_FACTORY_H_INCLUDED
+
+#include "StdCppOSWrapper/StdCppSemaphoreFactory.h"
+
+namespace PosixOSWrapper {
+
+class PosixSemaphoreFactory : public StdCppOSWrapper::StdCppSemaphoreFactory {
+#if defined(__linux__)
+public:
+	PosixSemaphoreFactory() {}
+	virtual ~PosixSemaphoreFactory() {}
+
+private:
+	virtual OSWrapper::Semaphore* create(std::size_t initialCount, std::size_t maxCount);
+	virtual void destroy(OSWrapper::Semaphore* s);
+#endif
+};
+
+}
+
+#endif // POSIX_OS_WRAPPER_POSIX_SEMAPHORE_FACTORY_H_INCLUDED
@@ -0,0 +1,146 @@
+#include "PosixTimerService.h"
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <ctime>
+#include <limits>
+
+namespace PosixOSWrapper {
+
+namespace {
+
+std::mutex s_serviceMutex;
+PosixTimerService* s_service = nullptr;
+std::size_t s_refCount = 0U;
+
+const std::uint64_t NOT_ARMED = std::numeric_limits<std::uint64_t>::max();
+
+}
+
+PosixTimerService* PosixTimerService::acquire()
+{
+	std::lock_guard<std::mutex> lock(s_serviceMutex);
+	if (s_service == nullptr) {
+		PosixTimerService* service = new PosixTimerService();
+		if (!service->open() || !service->beginThread()) {
+			delete service;
+			return nullptr;
+		}
+		s_service = service;
+	}
+	++s_refCount;
+	return s_service;
+}
+
+void PosixTimerService::release()
+{
+	std::lock_guard<std::mutex> lock(s_serviceMutex);
+	if (s_refCount == 0U) {
+		return;
+	}
+	--s_refCount;
+	if (s_refCount == 0U) {
+		s_service->endThread();
+		delete s_service;
+		s_service = nullptr;
+	}
+}
+
+PosixTimerService::PosixTimerService()
+: StdCppOSWrapper::StdCppTimerService(), m_epollFd(-1), m_timerFd(-1), m_eventFd(-1), m_armedTick(NOT_ARMED)
+{
+}
+
+PosixTimerService::~PosixTimerService()
+{
+	if (m_eventFd >= 0) {
+		close(m_eventFd);
+	}
+	if (m_timerFd >= 0) {
+		close(m_timerFd);
+	}
+	if (m_epollFd >= 0) {
+		close(m_epollFd);
+	}
+}
+
+bool PosixTimerService::open()
+{
+	m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (m_epollFd < 0) {
+		return false;
+	}
+	// std::chrono::steady_clock is CLOCK_MONOTONIC on Linux, so the time points of the ticks are used as they are
+	m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (m_timerFd < 0) {
+		return false;
+	}
+	m_eventFd = eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_eventFd < 0) {
+		return false;
+	}
+
+	struct epoll_event ev = {};
+	ev.events = EPOLLIN;
+	ev.data.fd = m_timerFd;
+	if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_timerFd, &ev) != 0) {
+		return false;
+	}
+	ev.data.fd = m_eventFd;
+	if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_eventFd, &ev) != 0) {
+		return false;
+	}
+	return true;
+}
+
+void PosixTimerService::waitUntil(std::unique_lock<std::mutex>& lock, std::uint64_t tick)
+{
+	if (tick != m_armedTick) {
+		const std::chrono::nanoseconds time = getTimePoint(tick).time_since_epoch();
+		const std::chrono::seconds sec = std::chrono::duration_cast<std::chrono::seconds>(time);
+		struct itimerspec spec = {};
+		spec.it_value.tv_sec = static_cast<std::time_t>(sec.count());
+		spec.it_value.tv_nsec = static_cast<long>((time - sec).count());
+		if (timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+			// Not to be blocked forever, it polls every millisecond
+			waitForEvents(lock, 1);
+			return;
+		}
+		m_armedTick = tick;
+	}
+	waitForEvents(lock, -1);
+}
+
+void PosixTimerService::waitForWakeUp(std::unique_lock<std::mutex>& lock)
+{
+	waitForEvents(lock, -1);
+}
+
+void PosixTimerService::wakeUp()
+{
+	const std::uint64_t value = 1U;
+	const ssize_t ret = write(m_eventFd, &value, sizeof value);
+	static_cast<void>(ret);
+}
+
+void PosixTimerService::waitForEvents(std::unique_lock<std::mutex>& lock, int timeoutInMillis)
+{
+	struct epoll_event events[2];
+	lock.unlock();
+	const int num = epoll_wait(m_epollFd, events, 2, timeoutInMillis);
+	lock.lock();
+	for (int i = 0; i < num; ++i) {
+		std::uint64_t value = 0U;
+		const ssize_t ret = read(events[i].data.fd, &value, sizeof value);
+		if ((events[i].data.fd == m_timerFd) && (ret == static_cast<ssize_t>(sizeof value))) {
+			// The timerfd is disarmed when it expires
+			m_armedTick = NOT_ARMED;
+		}
+	}
+}
+
+}
+#endif
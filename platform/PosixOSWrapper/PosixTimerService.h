@@ -0,0 +1,44 @@
+#ifndef POSIX_OS_WRAPPER_POSIX_TIMER_SERVICE_H_INCLUDED
+#define POSIX_OS_WRAPPER_POSIX_TIMER_SERVICE_H_INCLUDED
+
+#include "StdCppOSWrapper/StdCppTimerService.h"
+
+#if defined(__linux__)
+namespace PosixOSWrapper {
+
+/*!
+ * @brief Timer service whose dispatcher thread waits by timerfd and epoll
+ *
+ * The timing wheel is the same as StdCppTimerService.
+ * The dispatcher thread arms a timerfd with TFD_TIMER_ABSTIME at the next expiry,
+ * and waits for it and an eventfd for wakeUp() by epoll_wait().
+ * The timerfd is armed again only when the next expiry is changed.
+ */
+class PosixTimerService : public StdCppOSWrapper::StdCppTimerService {
+public:
+	static PosixTimerService* acquire();
+	static void release();
+
+private:
+	int m_epollFd;
+	int m_timerFd;
+	int m_eventFd;
+	std::uint64_t m_armedTick;
+
+	PosixTimerService();
+	virtual ~PosixTimerService();
+	bool open();
+
+	virtual void waitUntil(std::unique_lock<std::mutex>& lock, std::uint64_t tick);
+	virtual void waitForWakeUp(std::unique_lock<std::mutex>& lock);
+	virtual void wakeUp();
+	void waitForEvents(std::unique_lock<std::mutex>& lock, int timeoutInMillis);
+
+	PosixTimerService(const PosixTimerService&);
+	PosixTimerService& operator=(const PosixTimerService&);
+};
+
+}
+#endif
+
+#endif // POSIX_OS_WRAPPER_POSIX_TIMER_SERVICE_H_INCLUDED
@@ -1,5 +1,6 @@
 #include "StdCppEventFlagFactory.h"
 #include "OSWrapper/EventFlag.h"
+#include "StdCppTimeout.h"
 #include <condition_variable>
 #include <chrono>
 
@@ -8,17 +9,84 @@ namespace StdCppOSWrapper {
 using OSWrapper::EventFlag;
 using OSWrapper::Timeout;
 
+/*
+ * Each waiter has its own condition variable and is linked to the waiter list in FIFO order.
+ * set() releases only the waiters whose condition is satisfied and notifies each of them.
+ * If the EventFlag is auto reset, set() releases only the first satisfied waiter, because the pattern is reset by it.
+ */
 class StdCppEventFlag : public EventFlag {
 private:
+	struct Waiter {
+		EventFlag::Pattern m_bitPattern;
+		Mode m_waitMode;
+		bool m_isReleased;
+		EventFlag::Pattern m_releasedPattern;
+		std::condition_variable m_cond;
+		Waiter* m_prev;
+		Waiter* m_next;
+
+		Waiter(EventFlag::Pattern bitPattern, Mode waitMode)
+		: m_bitPattern(bitPattern), m_waitMode(waitMode), m_isReleased(false), m_releasedPattern(), m_cond(),
+		  m_prev(nullptr), m_next(nullptr)
+		{
+		}
+	};
+
 	bool m_autoReset;
 	EventFlag::Pattern m_pattern;
 
 	mutable std::mutex m_mutex;
-	std::condition_variable m_cond;
+	Waiter* m_head;
+	Waiter* m_tail;
+
+	bool isSatisfied(EventFlag::Pattern bitPattern, Mode waitMode) const
+	{
+		if (waitMode == EventFlag::OR) {
+			return EventFlag::Pattern(bitPattern & m_pattern).any();
+		}
+		return (bitPattern & m_pattern) == bitPattern;
+	}
+
+	EventFlag::Pattern takePattern()
+	{
+		EventFlag::Pattern pattern = m_pattern;
+		if (m_autoReset) {
+			m_pattern.reset();
+		}
+		return pattern;
+	}
+
+	void linkWaiter(Waiter* w)
+	{
+		w->m_prev = m_tail;
+		w->m_next = nullptr;
+		if (m_tail != nullptr) {
+			m_tail->m_next = w;
+		} else {
+			m_head = w;
+		}
+		m_tail = w;
+	}
+
+	void unlinkWaiter(Waiter* w)
+	{
+		if (w->m_prev != nullptr) {
+			w->m_prev->m_next = w->m_next;
+		} else {
+			m_head = w->m_next;
+		}
+		if (w->m_next != nullptr) {
+			w->m_next->m_prev = w->m_prev;
+		} else {
+			m_tail = w->m_prev;
+		}
+		w->m_prev = nullptr;
+		w->m_next = nullptr;
+	}
 
 public:
 	explicit StdCppEventFlag(bool autoReset)
-	: m_autoReset(autoReset), m_pattern(), m_mutex(), m_cond()
+	: m_autoReset(autoReset), m_pattern(), m_mutex(), m_head(nullptr), m_tail(nullptr)
 	{
 	}
 
@@ -80,31 +148,30 @@ public:
 
 		std::unique_lock<std::mutex> lock(m_mutex);
 
-		if (tmout == Timeout::FOREVER) {
-			if (waitMode == EventFlag::OR) {
-				m_cond.wait(lock, [&] { return EventFlag::Pattern(bitPattern & m_pattern).any(); });
-			} else {
-				m_cond.wait(lock, [&] { return (bitPattern & m_pattern) == bitPattern; });
+		if (isSatisfied(bitPattern, waitMode)) {
+			const EventFlag::Pattern pattern = takePattern();
+			if (releasedPattern != nullptr) {
+				*releasedPattern = pattern;
 			}
+			return OSWrapper::OK;
+		}
+		if (tmout == Timeout::POLLING) {
+			return OSWrapper::TimedOut;
+		}
+
+		Waiter w(bitPattern, waitMode);
+		linkWaiter(&w);
+		if (tmout == Timeout::FOREVER) {
+			w.m_cond.wait(lock, [&] { return w.m_isReleased; });
 		} else {
-			if (waitMode == EventFlag::OR) {
-				if (!m_cond.wait_for(lock, std::chrono::milliseconds(tmout),
-							[&] { return EventFlag::Pattern(bitPattern & m_pattern).any(); })) {
-					return OSWrapper::TimedOut;
-				}
-			} else {
-				if (!m_cond.wait_for(lock, std::chrono::milliseconds(tmout),
-							[&] { return (bitPattern & m_pattern) == bitPattern; })) {
-					return OSWrapper::TimedOut;
-				}
+			if (!w.m_cond.wait_for(lock, toDuration(tmout), [&] { return w.m_isReleased; })) {
+				unlinkWaiter(&w);
+				return OSWrapper::TimedOut;
 			}
 		}
 
 		if (releasedPattern != nullptr) {
-			*releasedPattern = m_pattern;
-		}
-		if (m_autoReset) {
-			m_pattern.reset();
+			*releasedPattern = w.m_releasedPattern;
 		}
 		return OSWrapper::OK;
 	}
@@ -126,7 +193,17 @@ public:
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
 		m_pattern |= bitPattern;
-		m_cond.notify_all();
+		Waiter* w = m_head;
+		while ((w != nullptr) && m_pattern.any()) {
+			Waiter* next = w->m_next;
+			if (isSatisfied(w->m_bitPattern, w->m_waitMode)) {
+				unlinkWaiter(w);
+				w->m_releasedPattern = takePattern();
+				w->m_isReleased = true;
+				w->m_cond.notify_one();
+			}
+			w = next;
+		}
 		return OSWrapper::OK;
 	}
 
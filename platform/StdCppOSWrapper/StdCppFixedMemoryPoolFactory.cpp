@@ -1,15 +1,16 @@
 #include "StdCppFixedMemoryPoolFactory.h"
 #include "OSWrapper/FixedMemoryPool.h"
-#include "Container/IntrusiveList.h"
+#include "StdCppTimeout.h"
 #include <condition_variable>
 #include <chrono>
+#include <atomic>
+#include <memory>
 #include <vector>
+#include <cstdint>
 #include <cstdlib>
 
 namespace StdCppOSWrapper {
 
-using Container::IntrusiveListNode;
-using Container::IntrusiveList;
 using OSWrapper::Timeout;
 
 namespace {
@@ -19,42 +20,93 @@ inline std::size_t getAlignedSize(std::size_t size)
 	return ((size + (sizeof(double) - 1U)) & (~(sizeof(double) - 1U)));
 }
 
+const std::size_t MAX_BLOCKS = 0xFFFFFFFDU;
+
 };
 
+/*
+ * The free list is a lock-free stack of block indices (Treiber stack).
+ * The head holds the index of the top block and a tag that is changed by every update,
+ * so a pop that read a stale next index fails even if the same block is on the top again (ABA problem).
+ * The mutex and the condition variable are used only when the pool is exhausted.
+ */
 class StdCppFixedMemoryPool : public OSWrapper::FixedMemoryPool {
 private:
+	static const std::uint32_t NIL = 0xFFFFFFFFU;
+	static const std::uint32_t USED = 0xFFFFFFFEU;
+
 	const std::size_t m_blockSize;
 	const std::size_t m_maxBlocks;
+	const std::size_t m_alignedBlockSize;
 
-	struct MemoryNode : public IntrusiveListNode {
-		void* data;
-		MemoryNode(): data() {}
-		~MemoryNode() {}
-	};
-	IntrusiveList<MemoryNode> m_freeList;
-	IntrusiveList<MemoryNode> m_usedList;
-	std::vector<MemoryNode> m_realNodeArray;
+	// The lower 32 bits are the index of the top block, and the upper 32 bits are the tag
+	std::atomic<std::uint64_t> m_head;
+	// The index of the next free block, or USED if the block is allocated
+	std::unique_ptr<std::atomic<std::uint32_t>[]> m_next;
+	std::atomic<std::size_t> m_numFreeBlocks;
 	std::vector<char> m_memoryPoolBuffer;
+	char* m_firstBlock;
 
-	mutable std::mutex m_mutex;
+	std::atomic<std::size_t> m_numWaiters;
+	std::mutex m_mutex;
 	std::condition_variable m_cond;
 
+	static std::uint32_t getIndex(std::uint64_t head)
+	{
+		return static_cast<std::uint32_t>(head);
+	}
+
+	static std::uint64_t makeHead(std::uint32_t index, std::uint64_t oldHead)
+	{
+		return ((oldHead & 0xFFFFFFFF00000000U) + 0x100000000U) | index;
+	}
+
+	bool tryPop(void** memory)
+	{
+		// seq_cst to be ordered after the increment of m_numWaiters in timedAllocateMemory()
+		std::uint64_t head = m_head.load();
+		while (true) {
+			const std::uint32_t index = getIndex(head);
+			if (index == NIL) {
+				return false;
+			}
+			const std::uint32_t next = m_next[index].load(std::memory_order_relaxed);
+			if (m_head.compare_exchange_weak(head, makeHead(next, head))) {
+				m_next[index].store(USED, std::memory_order_relaxed);
+				m_numFreeBlocks.fetch_sub(1U, std::memory_order_relaxed);
+				*memory = m_firstBlock + (index * m_alignedBlockSize);
+				return true;
+			}
+		}
+	}
+
+	void push(std::uint32_t index)
+	{
+		std::uint64_t head = m_head.load(std::memory_order_relaxed);
+		std::uint32_t used = USED;
+		// A block that is already free is ignored
+		if (!m_next[index].compare_exchange_strong(used, getIndex(head), std::memory_order_relaxed)) {
+			return;
+		}
+		m_numFreeBlocks.fetch_add(1U, std::memory_order_relaxed);
+		while (!m_head.compare_exchange_weak(head, makeHead(index, head))) {
+			m_next[index].store(getIndex(head), std::memory_order_relaxed);
+		}
+	}
+
 public:
 	explicit StdCppFixedMemoryPool(std::size_t blockSize, std::size_t maxBlocks, std::size_t memoryPoolSize, void* memoryPoolAddress)
-	: m_blockSize(blockSize), m_maxBlocks(maxBlocks)
-	, m_freeList(), m_usedList(), m_realNodeArray(maxBlocks), m_memoryPoolBuffer()
-	, m_mutex(), m_cond()
+	: m_blockSize(blockSize), m_maxBlocks(maxBlocks), m_alignedBlockSize(getAlignedSize(blockSize))
+	, m_head(0U), m_next(new std::atomic<std::uint32_t>[maxBlocks]), m_numFreeBlocks(maxBlocks)
+	, m_memoryPoolBuffer(), m_firstBlock(static_cast<char*>(memoryPoolAddress))
+	, m_numWaiters(0U), m_mutex(), m_cond()
 	{
-		char* p = static_cast<char*>(memoryPoolAddress);
-		if (p == nullptr) {
+		if (m_firstBlock == nullptr) {
 			m_memoryPoolBuffer.resize(memoryPoolSize);
-			p = &m_memoryPoolBuffer[0];
+			m_firstBlock = &m_memoryPoolBuffer[0];
 		}
-		const std::size_t alignedBlockSize = getAlignedSize(blockSize);
 		for (std::size_t i = 0U; i < maxBlocks; i++) {
-			m_realNodeArray[i].data = p;
-			p += alignedBlockSize;
-			m_freeList.push_back(m_realNodeArray[i]);
+			m_next[i].store((i + 1U < maxBlocks) ? static_cast<std::uint32_t>(i + 1U) : NIL, std::memory_order_relaxed);
 		}
 	}
 
@@ -76,17 +128,17 @@ public:
 		if (p == nullptr) {
 			return;
 		}
-		std::lock_guard<std::mutex> lock(m_mutex);
-		for (auto it = m_usedList.begin(); it != m_usedList.end(); ++it) {
-			if (it->data == p) {
-				// release memory block to free list
-				m_freeList.splice(m_freeList.end(), m_usedList, it);
-				m_cond.notify_all();
-				return;
-			}
+		const char* cp = static_cast<const char*>(p);
+		if ((cp < m_firstBlock) || (cp >= m_firstBlock + (m_maxBlocks * m_alignedBlockSize))) {
+			// If p is not included in the memory pool, p is a pointer that std::malloc() returned
+			std::free(p);
+			return;
+		}
+		push(static_cast<std::uint32_t>(static_cast<std::size_t>(cp - m_firstBlock) / m_alignedBlockSize));
+		if (m_numWaiters.load() != 0U) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_cond.notify_one();
 		}
-		// If p is not included in used list, p is a pointer that std::malloc() returned
-		std::free(p);
 	}
 
 	std::size_t getBlockSize() const
@@ -109,28 +161,30 @@ public:
 		if (memory == nullptr) {
 			return OSWrapper::InvalidParameter;
 		}
+		if (tryPop(memory)) {
+			return OSWrapper::OK;
+		}
+		if (tmout == Timeout::POLLING) {
+			return OSWrapper::TimedOut;
+		}
 
+		// The pool is exhausted. deallocate() notifies only if m_numWaiters is not zero,
+		// so tryPop() is retried after m_numWaiters is incremented.
 		std::unique_lock<std::mutex> lock(m_mutex);
+		m_numWaiters.fetch_add(1U);
+		bool allocated = true;
 		if (tmout == Timeout::FOREVER) {
-			m_cond.wait(lock, [&] { return !m_freeList.empty(); });
+			m_cond.wait(lock, [&] { return tryPop(memory); });
 		} else {
-			if (!m_cond.wait_for(lock, std::chrono::milliseconds(tmout),
-						[&] { return !m_freeList.empty(); })) {
-				return OSWrapper::TimedOut;
-			}
+			allocated = m_cond.wait_for(lock, toDuration(tmout), [&] { return tryPop(memory); });
 		}
-		// get memory block from free list
-		auto it = m_freeList.begin();
-		void* p = it->data;
-		m_usedList.splice(m_usedList.end(), m_freeList, it);
-		*memory = p;
-		return OSWrapper::OK;
+		m_numWaiters.fetch_sub(1U);
+		return allocated ? OSWrapper::OK : OSWrapper::TimedOut;
 	}
 
 	std::size_t getNumberOfAvailableBlocks() const
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
-		return m_freeList.size();
+		return m_numFreeBlocks.load(std::memory_order_relaxed);
 	}
 
 	std::size_t getMaxNumberOfBlocks() const
@@ -152,7 +206,7 @@ OSWrapper::FixedMemoryPool* StdCppFixedMemoryPoolFactory::create(std::size_t blo
 		return nullptr;
 	}
 	const std::size_t maxBlocks = memoryPoolSize / getAlignedSize(blockSize);
-	if (maxBlocks == 0U) {
+	if ((maxBlocks == 0U) || (maxBlocks > MAX_BLOCKS)) {
 		return nullptr;
 	}
 #ifndef CPPELIB_NO_EXCEPTIONS
@@ -1,13 +1,23 @@
 #include "StdCppMutexFactory.h"
 #include "OSWrapper/Mutex.h"
+#include "StdCppTimeout.h"
 #include <chrono>
 #include <cstddef>
 
 namespace StdCppOSWrapper {
 
-class StdCppMutex : public OSWrapper::Mutex {
+class StdCppMutexBase : public OSWrapper::Mutex {
+public:
+	virtual ~StdCppMutexBase() {}
+};
+
+/*
+ * M is std::recursive_timed_mutex for create() and std::timed_mutex for createNonRecursive().
+ */
+template <typename M>
+class StdCppMutex : public StdCppMutexBase {
 private:
-	std::recursive_timed_mutex m_mutex;
+	M m_mutex;
 	std::size_t m_lockingCount;
 
 public:
@@ -62,7 +72,7 @@ public:
 #ifndef CPPELIB_NO_EXCEPTIONS
 		try {
 #endif
-			if (m_mutex.try_lock_for(std::chrono::milliseconds(tmout))) {
+			if (m_mutex.try_lock_for(toDuration(tmout))) {
 				m_lockingCount++;
 				return OSWrapper::OK;
 			}
@@ -107,7 +117,7 @@ OSWrapper::Mutex* StdCppMutexFactory::create()
 	try {
 #endif
 		std::lock_guard<std::mutex> lock(m_mutex);
-		StdCppMutex* m = new StdCppMutex();
+		StdCppMutex<std::recursive_timed_mutex>* m = new StdCppMutex<std::recursive_timed_mutex>();
 		return m;
 #ifndef CPPELIB_NO_EXCEPTIONS
 	}
@@ -123,10 +133,26 @@ OSWrapper::Mutex* StdCppMutexFactory::create(int priorityCeiling)
 	return create();
 }
 
+OSWrapper::Mutex* StdCppMutexFactory::createNonRecursive()
+{
+#ifndef CPPELIB_NO_EXCEPTIONS
+	try {
+#endif
+		std::lock_guard<std::mutex> lock(m_mutex);
+		StdCppMutex<std::timed_mutex>* m = new StdCppMutex<std::timed_mutex>();
+		return m;
+#ifndef CPPELIB_NO_EXCEPTIONS
+	}
+	catch (...) {
+		return nullptr;
+	}
+#endif
+}
+
 void StdCppMutexFactory::destroy(OSWrapper::Mutex* m)
 {
 	std::lock_guard<std::mutex> lock(m_mutex);
-	delete static_cast<StdCppMutex*>(m);
+	delete static_cast<StdCppMutexBase*>(m);
 }
 
 }
@@ -11,11 +11,13 @@ public:
 	StdCppMutexFactory();
 	virtual ~StdCppMutexFactory() {}
 
-private:
+protected:
 	virtual OSWrapper::Mutex* create();
 	virtual OSWrapper::Mutex* create(int priorityCeiling);
+	virtual OSWrapper::Mutex* createNonRecursive();
 	virtual void destroy(OSWrapper::Mutex* m);
 
+private:
 	StdCppMutexFactory(const StdCppMutexFactory&);
 	StdCppMutexFactory& operator=(const StdCppMutexFactory&);
 
@@ -1,14 +1,18 @@
 #include "StdCppOSWrapper.h"
 #include "StdCppThreadFactory.h"
 #include "StdCppMutexFactory.h"
+#include "StdCppRWLockFactory.h"
 #include "StdCppEventFlagFactory.h"
+#include "StdCppSemaphoreFactory.h"
 #include "StdCppFixedMemoryPoolFactory.h"
 #include "StdCppVariableMemoryPoolFactory.h"
 #include "StdCppPeriodicTimerFactory.h"
 #include "StdCppOneShotTimerFactory.h"
 #include "OSWrapper/Thread.h"
 #include "OSWrapper/Mutex.h"
+#include "OSWrapper/RWLock.h"
 #include "OSWrapper/EventFlag.h"
+#include "OSWrapper/Semaphore.h"
 #include "OSWrapper/FixedMemoryPool.h"
 #include "OSWrapper/VariableMemoryPool.h"
 #include "OSWrapper/PeriodicTimer.h"
@@ -31,7 +35,9 @@ void init()
 {
 	static StdCppThreadFactory theThreadFactory;
 	static StdCppMutexFactory theMutexFactory;
+	static StdCppRWLockFactory theRWLockFactory;
 	static StdCppEventFlagFactory theEventFlagFactory;
+	static StdCppSemaphoreFactory theSemaphoreFactory;
 	static StdCppFixedMemoryPoolFactory theFixedMemoryPoolFactory;
 	static StdCppVariableMemoryPoolFactory theVariableMemoryPoolFactory;
 	static StdCppPeriodicTimerFactory thePeriodicTimerFactory;
@@ -39,7 +45,9 @@ void init()
 
 	OSWrapper::registerThreadFactory(&theThreadFactory);
 	OSWrapper::registerMutexFactory(&theMutexFactory);
+	OSWrapper::registerRWLockFactory(&theRWLockFactory);
 	OSWrapper::registerEventFlagFactory(&theEventFlagFactory);
+	OSWrapper::registerSemaphoreFactory(&theSemaphoreFactory);
 	OSWrapper::registerFixedMemoryPoolFactory(&theFixedMemoryPoolFactory);
 	OSWrapper::registerVariableMemoryPoolFactory(&theVariableMemoryPoolFactory);
 	OSWrapper::registerPeriodicTimerFactory(&thePeriodicTimerFactory);
@@ -1,84 +1,33 @@
 #include "StdCppOneShotTimerFactory.h"
 #include "OSWrapper/OneShotTimer.h"
 #include "OSWrapper/Runnable.h"
-#include "OSWrapper/Thread.h"
-#include <memory>
-#include <chrono>
-#include <condition_variable>
+#include "StdCppTimerService.h"
+#include <new>
 
 namespace StdCppOSWrapper {
 
 class StdCppOneShotTimer : public OSWrapper::OneShotTimer {
 private:
-	unsigned long m_timeInMillis;
 	const char* m_name;
 
-	class TimerTask : public OSWrapper::Runnable {
+	class TimerEntry : public StdCppTimerService::Entry {
 	private:
 		StdCppOneShotTimer* m_timer;
 	public:
-		TimerTask() : m_timer(0) {}
-		virtual ~TimerTask() {}
-		virtual void run()
+		explicit TimerEntry(StdCppOneShotTimer* timer) : m_timer(timer) {}
+		virtual ~TimerEntry() {}
+		virtual void expire(unsigned long)
 		{
-			m_timer->threadLoop();
-		}
-		void setTimer(StdCppOneShotTimer* timer)
-		{
-			m_timer = timer;
+			m_timer->timerMain();
 		}
 	};
-	TimerTask m_task;
-	std::unique_ptr<OSWrapper::Thread, decltype(&OSWrapper::Thread::destroy)> m_thread;
+	TimerEntry m_entry;
+	StdCppTimerService* m_service;
 	mutable std::mutex m_mutex;
 
-	std::condition_variable m_condActive;
-	std::condition_variable m_condStarted;
-	std::condition_variable m_condStopped;
-	bool m_isActive;
-	bool m_started;
-	bool m_stopped;
-	bool m_endThreadRequested;
-
-	void threadLoop()
-	{
-		while (true) {
-			{
-				std::unique_lock<std::mutex> lock(m_mutex);
-				m_condActive.wait(lock, [this] { return m_isActive || m_endThreadRequested; });
-				m_started = true;
-				m_condStarted.notify_all();
-				if (m_endThreadRequested) {
-					break;
-				}
-
-				if (m_condActive.wait_for(lock, std::chrono::milliseconds(m_timeInMillis),
-							[this] { return !m_isActive || m_endThreadRequested; })) {
-					m_stopped = true;
-					m_condStopped.notify_all();
-					if (m_endThreadRequested) { // cppcheck-suppress knownConditionTrueFalse // false-positive
-						break;
-					}
-					continue;
-				}
-			}
-			timerMain();
-			{
-				std::lock_guard<std::mutex> lock(m_mutex);
-				m_started = false;
-				m_stopped = true;
-				m_isActive = false;
-			}
-		}
-	}
-
 public:
-	StdCppOneShotTimer(OSWrapper::Runnable* r, const char* name)
-	: OneShotTimer(r), m_timeInMillis(0U), m_name(name), 
-	  m_task(), 
-	  m_thread(OSWrapper::Thread::create(&m_task), &OSWrapper::Thread::destroy), 
-	  m_mutex(), m_condActive(), m_condStarted(), m_condStopped(), 
-	  m_isActive(false), m_started(false), m_stopped(true), m_endThreadRequested(false)
+	StdCppOneShotTimer(OSWrapper::Runnable* r, const char* name, StdCppTimerService* service)
+	: OneShotTimer(r), m_name(name), m_entry(this), m_service(service), m_mutex()
 	{
 	}
 
@@ -86,52 +35,24 @@ public:
 	{
 	}
 
-	void beginThread()
-	{
-		m_task.setTimer(this);
-		m_thread->setPriority(OSWrapper::Thread::getHighestPriority());
-		m_thread->start();
-	}
-
-	void endThread()
+	void cancel()
 	{
-		{
-			std::lock_guard<std::mutex> lock(m_mutex);
-			m_endThreadRequested = true;
-			m_condActive.notify_all();
-		}
-		m_thread->wait();
+		m_service->cancel(&m_entry);
 	}
 
 	void start(unsigned long timeInMillis)
 	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		if (m_isActive) {
-			return;
-		}
-		m_condStopped.wait(lock, [this] { return m_stopped; });
-		m_timeInMillis = timeInMillis;
-		m_stopped = false;
-		m_isActive = true;
-		m_condActive.notify_all();
+		m_service->start(&m_entry, static_cast<std::uint64_t>(timeInMillis) * 1000U, 0U);
 	}
 
 	void stop()
 	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		if (!m_isActive) {
-			return;
-		}
-		m_condStarted.wait(lock, [this] { return m_started; });
-		m_started = false;
-		m_isActive = false;
-		m_condActive.notify_all();
+		m_service->stop(&m_entry);
 	}
 
 	bool isStarted() const
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
-		return m_isActive;
+		return m_service->isStarted(&m_entry);
 	}
 
 	void setName(const char* name)
@@ -160,8 +81,14 @@ OSWrapper::OneShotTimer* StdCppOneShotTimerFactory::create(OSWrapper::Runnable*
 	try {
 #endif
 		std::lock_guard<std::mutex> lock(m_mutex);
-		StdCppOneShotTimer* t = new StdCppOneShotTimer(r, name);
-		t->beginThread();
+		StdCppTimerService* service = acquireTimerService();
+		if (service == nullptr) {
+			return nullptr;
+		}
+		StdCppOneShotTimer* t = new(std::nothrow) StdCppOneShotTimer(r, name, service);
+		if (t == nullptr) {
+			releaseTimerService();
+		}
 		return t;
 #ifndef CPPELIB_NO_EXCEPTIONS
 	}
@@ -174,9 +101,20 @@ OSWrapper::OneShotTimer* StdCppOneShotTimerFactory::create(OSWrapper::Runnable*
 void StdCppOneShotTimerFactory::destroy(OSWrapper::OneShotTimer* t)
 {
 	StdCppOneShotTimer* timer = static_cast<StdCppOneShotTimer*>(t);
-	timer->endThread();
+	timer->cancel();
 	std::lock_guard<std::mutex> lock(m_mutex);
-	delete static_cast<StdCppOneShotTimer*>(t);
+	delete timer;
+	releaseTimerService();
+}
+
+StdCppTimerService* StdCppOneShotTimerFactory::acquireTimerService()
+{
+	return StdCppTimerService::acquire();
+}
+
+void StdCppOneShotTimerFactory::releaseTimerService()
+{
+	StdCppTimerService::release();
 }
 
 }
@@ -6,6 +6,8 @@
 
 namespace StdCppOSWrapper {
 
+class StdCppTimerService;
+
 class StdCppOneShotTimerFactory : public OSWrapper::OneShotTimerFactory {
 public:
 	StdCppOneShotTimerFactory();
@@ -14,6 +16,8 @@ public:
 private:
 	virtual OSWrapper::OneShotTimer* create(OSWrapper::Runnable* r, const char* name);
 	virtual void destroy(OSWrapper::OneShotTimer* t);
+	virtual StdCppTimerService* acquireTimerService();
+	virtual void releaseTimerService();
 
 	StdCppOneShotTimerFactory(const StdCppOneShotTimerFactory&);
 	StdCppOneShotTimerFactory& operator=(const StdCppOneShotTimerFactory&);
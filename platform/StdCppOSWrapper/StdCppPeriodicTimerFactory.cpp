@@ -1,82 +1,35 @@
 #include "StdCppPeriodicTimerFactory.h"
 #include "OSWrapper/PeriodicTimer.h"
 #include "OSWrapper/Runnable.h"
-#include "OSWrapper/Thread.h"
-#include <memory>
-#include <chrono>
-#include <condition_variable>
+#include "StdCppTimerService.h"
+#include <new>
 
 namespace StdCppOSWrapper {
 
 class StdCppPeriodicTimer : public OSWrapper::PeriodicTimer {
 private:
-	unsigned long m_periodInMillis;
+	std::uint64_t m_periodInMicros;
 	const char* m_name;
 
-	class TimerTask : public OSWrapper::Runnable {
+	class TimerEntry : public StdCppTimerService::Entry {
 	private:
 		StdCppPeriodicTimer* m_timer;
 	public:
-		TimerTask() : m_timer(0) {}
-		virtual ~TimerTask() {}
-		virtual void run()
+		explicit TimerEntry(StdCppPeriodicTimer* timer) : m_timer(timer) {}
+		virtual ~TimerEntry() {}
+		virtual void expire(unsigned long missedPeriods)
 		{
-			m_timer->threadLoop();
-		}
-		void setTimer(StdCppPeriodicTimer* timer)
-		{
-			m_timer = timer;
+			m_timer->reportOverrun(missedPeriods);
+			m_timer->timerMain();
 		}
 	};
-	TimerTask m_task;
-	std::unique_ptr<OSWrapper::Thread, decltype(&OSWrapper::Thread::destroy)> m_thread;
+	TimerEntry m_entry;
+	StdCppTimerService* m_service;
 	mutable std::mutex m_mutex;
 
-	std::condition_variable m_condActive;
-	std::condition_variable m_condStarted;
-	std::condition_variable m_condStopped;
-	bool m_isActive;
-	bool m_started;
-	bool m_stopped;
-	bool m_endThreadRequested;
-
-	void threadLoop()
-	{
-		while (true) {
-			{
-				std::unique_lock<std::mutex> lock(m_mutex);
-				m_condActive.wait(lock, [this] { return m_isActive || m_endThreadRequested; });
-				m_started = true;
-				m_condStarted.notify_all();
-				if (m_endThreadRequested) {
-					break;
-				}
-			}
-			while (true) {
-				{
-					std::unique_lock<std::mutex> lock(m_mutex);
-					if (m_condActive.wait_for(lock, std::chrono::milliseconds(m_periodInMillis),
-								[this] { return !m_isActive || m_endThreadRequested; })) {
-						m_stopped = true;
-						m_condStopped.notify_all();
-						if (m_endThreadRequested) {
-							return;
-						}
-						break;
-					}
-				}
-				timerMain();
-			}
-		}
-	}
-
 public:
-	StdCppPeriodicTimer(OSWrapper::Runnable* r, unsigned long periodInMillis, const char* name)
-	: PeriodicTimer(r), m_periodInMillis(periodInMillis), m_name(name), 
-	  m_task(), 
-	  m_thread(OSWrapper::Thread::create(&m_task), &OSWrapper::Thread::destroy), 
-	  m_mutex(), m_condActive(), m_condStarted(), m_condStopped(), 
-	  m_isActive(false), m_started(false), m_stopped(true), m_endThreadRequested(false)
+	StdCppPeriodicTimer(OSWrapper::Runnable* r, std::uint64_t periodInMicros, const char* name, StdCppTimerService* service)
+	: PeriodicTimer(r), m_periodInMicros(periodInMicros), m_name(name), m_entry(this), m_service(service), m_mutex()
 	{
 	}
 
@@ -84,56 +37,87 @@ public:
 	{
 	}
 
-	void beginThread()
+	void cancel()
 	{
-		m_task.setTimer(this);
-		m_thread->setPriority(OSWrapper::Thread::getHighestPriority());
-		m_thread->start();
-	}
-
-	void endThread()
-	{
-		{
-			std::lock_guard<std::mutex> lock(m_mutex);
-			m_endThreadRequested = true;
-			m_condActive.notify_all();
-		}
-		m_thread->wait();
+		m_service->cancel(&m_entry);
 	}
 
 	void start()
 	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		if (m_isActive) {
-			return;
-		}
-		m_condStopped.wait(lock, [this] { return m_stopped; });
-		m_stopped = false;
-		m_isActive = true;
-		m_condActive.notify_all();
+		m_service->start(&m_entry, m_periodInMicros, m_periodInMicros);
 	}
 
 	void stop()
 	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		if (!m_isActive) {
-			return;
-		}
-		m_condStarted.wait(lock, [this] { return m_started; });
-		m_started = false;
-		m_isActive = false;
-		m_condActive.notify_all();
+		m_service->stop(&m_entry);
 	}
 
 	bool isStarted() const
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
-		return m_isActive;
+		return m_service->isStarted(&m_entry);
 	}
 
 	unsigned long getPeriodInMillis() const
 	{
-		return m_periodInMillis;
+		return static_cast<unsigned long>((m_periodInMicros + 999U) / 1000U);
+	}
+
+	unsigned long getPeriodInMicros() const
+	{
+		return static_cast<unsigned long>(m_periodInMicros);
+	}
+
+	OSWrapper::Error setScheduleMode(ScheduleMode mode, OverrunPolicy policy)
+	{
+		StdCppTimerService::Schedule schedule = StdCppTimerService::RELATIVE_SCHEDULE;
+		if (mode == ABSOLUTE_SCHEDULE) {
+			switch (policy) {
+			case SKIP:
+				schedule = StdCppTimerService::SKIP_MISSED;
+				break;
+			case CATCH_UP:
+				schedule = StdCppTimerService::CATCH_UP_MISSED;
+				break;
+			case REPORT:
+				schedule = StdCppTimerService::REPORT_MISSED;
+				break;
+			default:
+				return OSWrapper::InvalidParameter;
+			}
+		} else if (mode != RELATIVE_SCHEDULE) {
+			return OSWrapper::InvalidParameter;
+		}
+		m_service->setSchedule(&m_entry, schedule);
+		return OSWrapper::OK;
+	}
+
+	unsigned long getNumberOfExpirations() const
+	{
+		return m_service->getStatistics(&m_entry).m_numExpirations;
+	}
+
+	unsigned long getNumberOfOverruns() const
+	{
+		return m_service->getStatistics(&m_entry).m_numOverruns;
+	}
+
+	unsigned long getMaxJitterInMicros() const
+	{
+		return static_cast<unsigned long>(m_service->getStatistics(&m_entry).m_maxLatenessInNanos / 1000U);
+	}
+
+	unsigned long getAverageJitterInMicros() const
+	{
+		const StdCppTimerService::Statistics stats = m_service->getStatistics(&m_entry);
+		if (stats.m_numExpirations == 0U) {
+			return 0UL;
+		}
+		return static_cast<unsigned long>(stats.m_totalLatenessInNanos / stats.m_numExpirations / 1000U);
+	}
+
+	void resetStatistics()
+	{
+		m_service->resetStatistics(&m_entry);
 	}
 
 	void setName(const char* name)
@@ -157,13 +141,29 @@ StdCppPeriodicTimerFactory::StdCppPeriodicTimerFactory()
 }
 
 OSWrapper::PeriodicTimer* StdCppPeriodicTimerFactory::create(OSWrapper::Runnable* r, unsigned long periodInMillis, const char* name)
+{
+	return createTimer(r, static_cast<std::uint64_t>(periodInMillis) * 1000U, name);
+}
+
+OSWrapper::PeriodicTimer* StdCppPeriodicTimerFactory::createInMicros(OSWrapper::Runnable* r, unsigned long periodInMicros, const char* name)
+{
+	return createTimer(r, periodInMicros, name);
+}
+
+OSWrapper::PeriodicTimer* StdCppPeriodicTimerFactory::createTimer(OSWrapper::Runnable* r, std::uint64_t periodInMicros, const char* name)
 {
 #ifndef CPPELIB_NO_EXCEPTIONS
 	try {
 #endif
 		std::lock_guard<std::mutex> lock(m_mutex);
-		StdCppPeriodicTimer* t = new StdCppPeriodicTimer(r, periodInMillis, name);
-		t->beginThread();
+		StdCppTimerService* service = acquireTimerService();
+		if (service == nullptr) {
+			return nullptr;
+		}
+		StdCppPeriodicTimer* t = new(std::nothrow) StdCppPeriodicTimer(r, periodInMicros, name, service);
+		if (t == nullptr) {
+			releaseTimerService();
+		}
 		return t;
 #ifndef CPPELIB_NO_EXCEPTIONS
 	}
@@ -176,9 +176,20 @@ OSWrapper::PeriodicTimer* StdCppPeriodicTimerFactory::create(OSWrapper::Runnable
 void StdCppPeriodicTimerFactory::destroy(OSWrapper::PeriodicTimer* t)
 {
 	StdCppPeriodicTimer* timer = static_cast<StdCppPeriodicTimer*>(t);
-	timer->endThread();
+	timer->cancel();
 	std::lock_guard<std::mutex> lock(m_mutex);
-	delete static_cast<StdCppPeriodicTimer*>(t);
+	delete timer;
+	releaseTimerService();
+}
+
+StdCppTimerService* StdCppPeriodicTimerFactory::acquireTimerService()
+{
+	return StdCppTimerService::acquire();
+}
+
+void StdCppPeriodicTimerFactory::releaseTimerService()
+{
+	StdCppTimerService::release();
 }
 
 }
@@ -3,9 +3,12 @@
 
 #include "OSWrapper/PeriodicTimerFactory.h"
 #include <mutex>
+#include <cstdint>
 
 namespace StdCppOSWrapper {
 
+class StdCppTimerService;
+
 class StdCppPeriodicTimerFactory : public OSWrapper::PeriodicTimerFactory {
 public:
 	StdCppPeriodicTimerFactory();
@@ -13,7 +16,11 @@ public:
 
 private:
 	virtual OSWrapper::PeriodicTimer* create(OSWrapper::Runnable* r, unsigned long periodInMillis, const char* name);
+	virtual OSWrapper::PeriodicTimer* createInMicros(OSWrapper::Runnable* r, unsigned long periodInMicros, const char* name);
 	virtual void destroy(OSWrapper::PeriodicTimer* t);
+	virtual StdCppTimerService* acquireTimerService();
+	virtual void releaseTimerService();
+	OSWrapper::PeriodicTimer* createTimer(OSWrapper::Runnable* r, std::uint64_t periodInMicros, const char* name);
 
 	StdCppPeriodicTimerFactory(const StdCppPeriodicTimerFactory&);
 	StdCppPeriodicTimerFactory& operator=(const StdCppPeriodicTimerFactory&);
@@ -0,0 +1,202 @@
+#include "StdCppRWLockFactory.h"
+#include "OSWrapper/RWLock.h"
+#include "StdCppTimeout.h"
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+
+namespace StdCppOSWrapper {
+
+/*
+ * std::shared_timed_mutex is C++14 and does not choose the preference,
+ * so the lock state is kept under a std::mutex.
+ * The readers wait on m_condRead and the writers wait on m_condWrite.
+ */
+class StdCppRWLock : public OSWrapper::RWLock {
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_condRead;
+	std::condition_variable m_condWrite;
+	const bool m_writerPreference;
+	std::size_t m_numReaders;
+	std::size_t m_numWaitingWriters;
+	bool m_isWriting;
+
+	bool canRead() const
+	{
+		if (m_isWriting) {
+			return false;
+		}
+		return !m_writerPreference || (m_numWaitingWriters == 0U);
+	}
+
+	bool canWrite() const
+	{
+		return !m_isWriting && (m_numReaders == 0U);
+	}
+
+public:
+	explicit StdCppRWLock(bool writerPreference)
+	: m_mutex(), m_condRead(), m_condWrite(), m_writerPreference(writerPreference)
+	, m_numReaders(0U), m_numWaitingWriters(0U), m_isWriting(false)
+	{
+	}
+
+	~StdCppRWLock()
+	{
+	}
+
+	OSWrapper::Error readLock()
+	{
+		return timedReadLock(OSWrapper::Timeout::FOREVER);
+	}
+
+	OSWrapper::Error tryReadLock()
+	{
+		return timedReadLock(OSWrapper::Timeout::POLLING);
+	}
+
+	OSWrapper::Error timedReadLock(OSWrapper::Timeout tmout)
+	{
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (tmout == OSWrapper::Timeout::FOREVER) {
+				m_condRead.wait(lock, [this] { return canRead(); });
+			} else if (!m_condRead.wait_for(lock, toDuration(tmout), [this] { return canRead(); })) {
+				return OSWrapper::TimedOut;
+			}
+			m_numReaders++;
+			return OSWrapper::OK;
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (...) {
+			return OSWrapper::OtherError;
+		}
+#endif
+	}
+
+	OSWrapper::Error readUnlock()
+	{
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_numReaders == 0U) {
+				return OSWrapper::NotLocked;
+			}
+			m_numReaders--;
+			if ((m_numReaders == 0U) && (m_numWaitingWriters != 0U)) {
+				m_condWrite.notify_one();
+			}
+			return OSWrapper::OK;
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (...) {
+			return OSWrapper::OtherError;
+		}
+#endif
+	}
+
+	OSWrapper::Error writeLock()
+	{
+		return timedWriteLock(OSWrapper::Timeout::FOREVER);
+	}
+
+	OSWrapper::Error tryWriteLock()
+	{
+		return timedWriteLock(OSWrapper::Timeout::POLLING);
+	}
+
+	OSWrapper::Error timedWriteLock(OSWrapper::Timeout tmout)
+	{
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (!canWrite()) {
+				if (tmout == OSWrapper::Timeout::POLLING) {
+					return OSWrapper::TimedOut;
+				}
+				// While this writer is waiting, the new readers wait if the lock prefers writers
+				m_numWaitingWriters++;
+				bool locked = true;
+				if (tmout == OSWrapper::Timeout::FOREVER) {
+					m_condWrite.wait(lock, [this] { return canWrite(); });
+				} else {
+					locked = m_condWrite.wait_for(lock, toDuration(tmout), [this] { return canWrite(); });
+				}
+				m_numWaitingWriters--;
+				if (!locked) {
+					if (canRead()) {
+						m_condRead.notify_all();
+					}
+					return OSWrapper::TimedOut;
+				}
+			}
+			m_isWriting = true;
+			return OSWrapper::OK;
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (...) {
+			return OSWrapper::OtherError;
+		}
+#endif
+	}
+
+	OSWrapper::Error writeUnlock()
+	{
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_isWriting) {
+				return OSWrapper::NotLocked;
+			}
+			m_isWriting = false;
+			if (m_numWaitingWriters != 0U) {
+				m_condWrite.notify_one();
+			}
+			if (canRead()) {
+				m_condRead.notify_all();
+			}
+			return OSWrapper::OK;
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (...) {
+			return OSWrapper::OtherError;
+		}
+#endif
+	}
+};
+
+
+StdCppRWLockFactory::StdCppRWLockFactory()
+: m_mutex()
+{
+}
+
+OSWrapper::RWLock* StdCppRWLockFactory::create(bool writerPreference)
+{
+#ifndef CPPELIB_NO_EXCEPTIONS
+	try {
+#endif
+		std::lock_guard<std::mutex> lock(m_mutex);
+		StdCppRWLock* l = new StdCppRWLock(writerPreference);
+		return l;
+#ifndef CPPELIB_NO_EXCEPTIONS
+	}
+	catch (...) {
+		return nullptr;
+	}
+#endif
+}
+
+void StdCppRWLockFactory::destroy(OSWrapper::RWLock* l)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	delete static_cast<StdCppRWLock*>(l);
+}
+
+}
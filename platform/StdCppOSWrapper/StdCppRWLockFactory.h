@@ -0,0 +1,27 @@
+#ifndef STDCPP_OS_WRAPPER_STDCPP_RW_LOCK_FACTORY_H_INCLUDED
+#define STDCPP_OS_WRAPPER_STDCPP_RW_LOCK_FACTORY_H_INCLUDED
+
+#include "OSWrapper/RWLockFactory.h"
+#include <mutex>
+
+namespace StdCppOSWrapper {
+
+class StdCppRWLockFactory : public OSWrapper::RWLockFactory {
+public:
+	StdCppRWLockFactory();
+	virtual ~StdCppRWLockFactory() {}
+
+protected:
+	virtual OSWrapper::RWLock* create(bool writerPreference);
+	virtual void destroy(OSWrapper::RWLock* l);
+
+private:
+	StdCppRWLockFactory(const StdCppRWLockFactory&);
+	StdCppRWLockFactory& operator=(const StdCppRWLockFactory&);
+
+	std::mutex m_mutex;
+};
+
+}
+
+#endif // STDCPP_OS_WRAPPER_STDCPP_RW_LOCK_FACTORY_H_INCLUDED
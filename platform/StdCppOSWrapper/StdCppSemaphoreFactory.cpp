@@ -0,0 +1,160 @@
+#include "StdCppSemaphoreFactory.h"
+#include "OSWrapper/Semaphore.h"
+#include "StdCppTimeout.h"
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+
+namespace StdCppOSWrapper {
+
+/*
+ * If all the waiting threads wait for 1 permit, release(n) wakes up n threads.
+ * Otherwise it wakes up all the waiting threads,
+ * because the thread woken up may wait for more permits than released and another thread may be able to acquire.
+ */
+class StdCppSemaphore : public OSWrapper::Semaphore {
+private:
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cond;
+	const std::size_t m_maxCount;
+	std::size_t m_count;
+	std::size_t m_numWaiters;
+	std::size_t m_numMultiWaiters;
+
+public:
+	StdCppSemaphore(std::size_t initialCount, std::size_t maxCount)
+	: m_mutex(), m_cond(), m_maxCount(maxCount), m_count(initialCount), m_numWaiters(0U), m_numMultiWaiters(0U)
+	{
+	}
+
+	~StdCppSemaphore()
+	{
+	}
+
+	OSWrapper::Error acquire(std::size_t n)
+	{
+		return timedAcquire(n, OSWrapper::Timeout::FOREVER);
+	}
+
+	OSWrapper::Error tryAcquire(std::size_t n)
+	{
+		return timedAcquire(n, OSWrapper::Timeout::POLLING);
+	}
+
+	OSWrapper::Error timedAcquire(std::size_t n, OSWrapper::Timeout tmout)
+	{
+		if ((n == 0U) || (n > m_maxCount)) {
+			return OSWrapper::InvalidParameter;
+		}
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (m_count < n) {
+				if (tmout == OSWrapper::Timeout::POLLING) {
+					return OSWrapper::TimedOut;
+				}
+				m_numWaiters++;
+				if (n > 1U) {
+					m_numMultiWaiters++;
+				}
+				bool acquired = true;
+				if (tmout == OSWrapper::Timeout::FOREVER) {
+					m_cond.wait(lock, [this, n] { return m_count >= n; });
+				} else {
+					acquired = m_cond.wait_for(lock, toDuration(tmout), [this, n] { return m_count >= n; });
+				}
+				m_numWaiters--;
+				if (n > 1U) {
+					m_numMultiWaiters--;
+				}
+				if (!acquired) {
+					return OSWrapper::TimedOut;
+				}
+			}
+			m_count -= n;
+			return OSWrapper::OK;
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (...) {
+			return OSWrapper::OtherError;
+		}
+#endif
+	}
+
+	OSWrapper::Error release(std::size_t n)
+	{
+		if (n == 0U) {
+			return OSWrapper::InvalidParameter;
+		}
+#ifndef CPPELIB_NO_EXCEPTIONS
+		try {
+#endif
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (n > m_maxCount - m_count) {
+				return OSWrapper::OtherError;
+			}
+			m_count += n;
+			if (m_numWaiters == 0U) {
+				return OSWrapper::OK;
+			}
+			if ((m_numMultiWaiters != 0U) || (n >= m_numWaiters)) {
+				m_cond.notify_all();
+			} else {
+				for (std::size_t i = 0U; i < n; i++) {
+					m_cond.notify_one();
+				}
+			}
+			return OSWrapper::OK;
+#ifndef CPPELIB_NO_EXCEPTIONS
+		}
+		catch (...) {
+			return OSWrapper::OtherError;
+		}
+#endif
+	}
+
+	std::size_t getCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_count;
+	}
+
+	std::size_t getMaxCount() const
+	{
+		return m_maxCount;
+	}
+};
+
+
+StdCppSemaphoreFactory::StdCppSemaphoreFactory()
+: m_mutex()
+{
+}
+
+OSWrapper::Semaphore* StdCppSemaphoreFactory::create(std::size_t initialCount, std::size_t maxCount)
+{
+	if ((maxCount == 0U) || (initialCount > maxCount)) {
+		return nullptr;
+	}
+#ifndef CPPELIB_NO_EXCEPTIONS
+	try {
+#endif
+		std::lock_guard<std::mutex> lock(m_mutex);
+		StdCppSemaphore* s = new StdCppSemaphore(initialCount, maxCount);
+		return s;
+#ifndef CPPELIB_NO_EXCEPTIONS
+	}
+	catch (...) {
+		return nullptr;
+	}
+#endif
+}
+
+void StdCppSemaphoreFactory::destroy(OSWrapper::Semaphore* s)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	delete static_cast<StdCppSemaphore*>(s);
+}
+
+}
@@ -0,0 +1,27 @@
+#ifndef STDCPP_OS_WRAPPER_STDCPP_SEMAPHORE_FACTORY_H_INCLUDED
+#define STDCPP_OS_WRAPPER_STDCPP_SEMAPHORE_FACTORY_H_INCLUDED
+
+#include "OSWrapper/SemaphoreFactory.h"
+#include <mutex>
+
+namespace StdCppOSWrapper {
+
+class StdCppSemaphoreFactory : public OSWrapper::SemaphoreFactory {
+public:
+	StdCppSemaphoreFactory();
+	virtual ~StdCppSemaphoreFactory() {}
+
+protected:
+	virtual OSWrapper::Semaphore* create(std::size_t initialCount, std::size_t maxCount);
+	virtual void destroy(OSWrapper::Semaphore* s);
+
+private:
+	StdCppSemaphoreFactory(const StdCppSemaphoreFactory&);
+	StdCppSemaphoreFactory& operator=(const StdCppSemaphoreFactory&);
+
+	std::mutex m_mutex;
+};
+
+}
+
+#endif // STDCPP_OS_WRAPPER_STDCPP_SEMAPHORE_FACTORY_H_INCLUDED
@@ -1,13 +1,17 @@
 #include "StdCppThreadFactory.h"
 #include "OSWrapper/Runnable.h"
+#include "StdCppTimeout.h"
 #include "Assertion/Assertion.h"
 #include <chrono>
 
 namespace StdCppOSWrapper {
 
+thread_local StdCppThreadFactory::StdCppThread* StdCppThreadFactory::StdCppThread::s_currentThread = nullptr;
+
 void StdCppThreadFactory::StdCppThread::threadEntry(StdCppThread* t)
 {
 	if (t != nullptr) {
+		s_currentThread = t;
 		t->threadLoop();
 	}
 }
@@ -86,7 +90,7 @@ OSWrapper::Error StdCppThreadFactory::StdCppThread::timedWait(OSWrapper::Timeout
 	if (tmout == OSWrapper::Timeout::FOREVER) {
 		m_condFinished.wait(lock, [this] { return !m_isActive; });
 	} else {
-		if (!m_condFinished.wait_for(lock, std::chrono::milliseconds(tmout),
+		if (!m_condFinished.wait_for(lock, toDuration(tmout),
 					[this] { return !m_isActive; })) {
 			return OSWrapper::TimedOut;
 		}
@@ -161,7 +165,7 @@ void* StdCppThreadFactory::StdCppThread::getNativeHandle()
 
 
 StdCppThreadFactory::StdCppThreadFactory()
-: m_threadIdMap(), m_mutex()
+: m_mutex()
 {
 }
 
@@ -181,6 +185,7 @@ OSWrapper::Thread* StdCppThreadFactory::create(OSWrapper::Runnable* r, int prior
 		std::lock_guard<std::recursive_mutex> lock(m_mutex);
 		t = createStdCppThread(r, priority, stackSize, name);
 		t->beginThread();
+		return t;
 	}
 #ifndef CPPELIB_NO_EXCEPTIONS
 	catch (const Assertion::Failure&) {
@@ -191,20 +196,6 @@ OSWrapper::Thread* StdCppThreadFactory::create(OSWrapper::Runnable* r, int prior
 		delete t;
 		return nullptr;
 	}
-	try
-#endif
-	{
-		std::lock_guard<std::recursive_mutex> lock(m_mutex);
-		m_threadIdMap.insert(std::make_pair(t->getId(), t));
-		return t;
-	}
-#ifndef CPPELIB_NO_EXCEPTIONS
-	catch (...) {
-		t->endThread();
-		std::lock_guard<std::recursive_mutex> lock(m_mutex);
-		delete t;
-		return nullptr;
-	}
 #endif
 }
 
@@ -213,7 +204,6 @@ void StdCppThreadFactory::destroy(OSWrapper::Thread* t)
 	StdCppThread* stdThread = static_cast<StdCppThread*>(t);
 	stdThread->endThread();
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
-	m_threadIdMap.erase(stdThread->getId());
 	delete stdThread;
 }
 
@@ -229,12 +219,7 @@ void StdCppThreadFactory::yield()
 
 OSWrapper::Thread* StdCppThreadFactory::getCurrentThread()
 {
-	std::lock_guard<std::recursive_mutex> lock(m_mutex);
-	auto iter = m_threadIdMap.find(std::this_thread::get_id());
-	if (iter == m_threadIdMap.end()) {
-		return nullptr;
-	}
-	return iter->second;
+	return StdCppThread::getCurrentThread();
 }
 
 int StdCppThreadFactory::getMaxPriority() const
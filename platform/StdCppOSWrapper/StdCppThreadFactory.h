@@ -28,6 +28,9 @@ protected:
 		bool m_endThreadRequested;
 		std::thread::id m_threadId;
 
+		// Set by the thread itself, so getCurrentThread() takes no lock
+		static thread_local StdCppThread* s_currentThread;
+
 		static void threadEntry(StdCppThread* t);
 		void threadLoop();
 
@@ -52,6 +55,7 @@ protected:
 		virtual void* getNativeHandle();
 
 		std::thread::id getId() const { return m_threadId; }
+		static StdCppThread* getCurrentThread() { return s_currentThread; }
 	};
 
 public:
@@ -74,7 +78,6 @@ private:
 
 	virtual StdCppThread* createStdCppThread(OSWrapper::Runnable* r, int priority, std::size_t stackSize, const char* name);
 
-	std::unordered_map<std::thread::id, OSWrapper::Thread*> m_threadIdMap;
 	std::recursive_mutex m_mutex;
 };
 
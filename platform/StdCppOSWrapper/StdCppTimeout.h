@@ -0,0 +1,19 @@
+#ifndef STDCPP_OS_WRAPPER_STDCPP_TIMEOUT_H_INCLUDED
+#define STDCPP_OS_WRAPPER_STDCPP_TIMEOUT_H_INCLUDED
+
+#include "OSWrapper/Timeout.h"
+#include <chrono>
+
+namespace StdCppOSWrapper {
+
+/*!
+ * @brief Convert the Timeout to std::chrono::duration without losing the fraction of a millisecond
+ */
+inline std::chrono::nanoseconds toDuration(OSWrapper::Timeout tmout)
+{
+	return std::chrono::milliseconds(tmout.getWholeMillis()) + std::chrono::nanoseconds(tmout.getSubMillisNanos());
+}
+
+}
+
+#endif // STDCPP_OS_WRAPPER_STDCPP_TIMEOUT_H_INCLUDED
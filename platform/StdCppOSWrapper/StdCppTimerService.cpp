@@ -0,0 +1,439 @@
+#include "StdCppTimerService.h"
+#include "OSWrapper/Thread.h"
+#include <limits>
+
+namespace StdCppOSWrapper {
+
+namespace {
+
+std::mutex s_serviceMutex;
+StdCppTimerService* s_service = nullptr;
+std::size_t s_refCount = 0U;
+
+const std::uint64_t MAX_TICK = std::numeric_limits<std::uint64_t>::max();
+
+// Value of m_waitingTick while the dispatcher thread is not waiting.
+// The dispatcher thread finds the next expiry again before it waits, so it is not woken up.
+const std::uint64_t NOT_WAITING = 0U;
+
+// Limit of the timer time not to overflow the tick counter
+const std::uint64_t MAX_TIME_IN_MICROS = static_cast<std::uint64_t>(1U) << 62;
+
+// Limit of one wait of the dispatcher thread not to overflow std::chrono::steady_clock
+const std::uint64_t MAX_WAIT_IN_MICROS = static_cast<std::uint64_t>(24U * 60U * 60U) * 1000000U;
+
+unsigned int findFirstSet(std::uint64_t bits)
+{
+#if defined(__GNUC__)
+	return static_cast<unsigned int>(__builtin_ctzll(bits));
+#else
+	unsigned int n = 0U;
+	while ((bits & 1U) == 0U) {
+		bits >>= 1;
+		++n;
+	}
+	return n;
+#endif
+}
+
+unsigned int findLastSet(std::uint64_t bits)
+{
+#if defined(__GNUC__)
+	return 63U - static_cast<unsigned int>(__builtin_clzll(bits));
+#else
+	unsigned int n = 0U;
+	while ((bits >>= 1) != 0U) {
+		++n;
+	}
+	return n;
+#endif
+}
+
+}
+
+StdCppTimerService* StdCppTimerService::acquire()
+{
+	std::lock_guard<std::mutex> lock(s_serviceMutex);
+	if (s_service == nullptr) {
+		StdCppTimerService* service = new StdCppTimerService();
+		if (!service->beginThread()) {
+			delete service;
+			return nullptr;
+		}
+		s_service = service;
+	}
+	++s_refCount;
+	return s_service;
+}
+
+void StdCppTimerService::release()
+{
+	std::lock_guard<std::mutex> lock(s_serviceMutex);
+	if (s_refCount == 0U) {
+		return;
+	}
+	--s_refCount;
+	if (s_refCount == 0U) {
+		s_service->endThread();
+		delete s_service;
+		s_service = nullptr;
+	}
+}
+
+StdCppTimerService::StdCppTimerService()
+: m_task(this), m_thread(nullptr), m_dispatcherId(),
+  m_mutex(), m_condWakeup(), m_condExpired(), m_endThreadRequested(false),
+  m_epoch(std::chrono::steady_clock::now()), m_currentTick(0U), m_waitingTick(NOT_WAITING), m_numTimers(0U),
+  m_bitmaps(), m_slots(), m_expired(nullptr)
+{
+}
+
+StdCppTimerService::~StdCppTimerService()
+{
+}
+
+bool StdCppTimerService::beginThread()
+{
+	m_thread = OSWrapper::Thread::create(&m_task, OSWrapper::Thread::INHERIT_PRIORITY, 0U, nullptr, "StdCppTimerService");
+	if (m_thread == nullptr) {
+		return false;
+	}
+	m_thread->setPriority(OSWrapper::Thread::getHighestPriority());
+	m_thread->start();
+	return true;
+}
+
+void StdCppTimerService::endThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_endThreadRequested = true;
+		wakeUp();
+	}
+	m_thread->wait();
+	OSWrapper::Thread::destroy(m_thread);
+	m_thread = nullptr;
+}
+
+void StdCppTimerService::dispatcherLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_dispatcherId = std::this_thread::get_id();
+	while (!m_endThreadRequested) {
+		if (m_numTimers == 0U) {
+			m_waitingTick = MAX_TICK;
+			waitForWakeUp(lock);
+			m_waitingTick = NOT_WAITING;
+			continue;
+		}
+		const std::uint64_t nextTick = getNextEventTick();
+		const std::uint64_t nowTick = getCurrentTick();
+		if (nowTick < nextTick) {
+			std::uint64_t waitTick = nextTick;
+			if (waitTick - nowTick > MAX_WAIT_IN_MICROS) {
+				waitTick = nowTick + MAX_WAIT_IN_MICROS;
+			}
+			m_waitingTick = nextTick;
+			waitUntil(lock, waitTick);
+			m_waitingTick = NOT_WAITING;
+			continue;
+		}
+		advanceTo(nextTick);
+		fireExpired(lock);
+	}
+}
+
+void StdCppTimerService::start(Entry* e, std::uint64_t timeInMicros, std::uint64_t periodInMicros)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (e->m_isActive) {
+		return;
+	}
+	e->m_isActive = true;
+	e->m_periodInMicros = periodInMicros;
+	e->m_missedPeriods = 0U;
+	e->m_countedDeadline = 0U;
+	const std::uint64_t expiry = getTickAfter(timeInMicros);
+	if (m_numTimers == 0U) {
+		// The wheel is empty, so it can skip the idle ticks at once
+		const std::uint64_t nowTick = getCurrentTick();
+		if (m_currentTick < nowTick) {
+			m_currentTick = nowTick;
+		}
+	}
+	e->m_deadline = expiry;
+	schedule(e, expiry);
+}
+
+void StdCppTimerService::stop(Entry* e)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!e->m_isActive) {
+		return;
+	}
+	unlink(e);
+	e->m_isActive = false;
+}
+
+void StdCppTimerService::cancel(Entry* e)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	unlink(e);
+	e->m_isActive = false;
+	if (std::this_thread::get_id() != m_dispatcherId) {
+		m_condExpired.wait(lock, [e] { return !e->m_isRunning; });
+	}
+}
+
+bool StdCppTimerService::isStarted(const Entry* e) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return e->m_isActive;
+}
+
+void StdCppTimerService::setSchedule(Entry* e, Schedule schedule)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	e->m_schedule = schedule;
+}
+
+StdCppTimerService::Statistics StdCppTimerService::getStatistics(const Entry* e) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return e->m_statistics;
+}
+
+void StdCppTimerService::resetStatistics(Entry* e)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	e->m_statistics = Statistics();
+}
+
+void StdCppTimerService::waitUntil(std::unique_lock<std::mutex>& lock, std::uint64_t tick)
+{
+	m_condWakeup.wait_until(lock, getTimePoint(tick));
+}
+
+void StdCppTimerService::waitForWakeUp(std::unique_lock<std::mutex>& lock)
+{
+	m_condWakeup.wait(lock);
+}
+
+void StdCppTimerService::wakeUp()
+{
+	m_condWakeup.notify_all();
+}
+
+/*
+ * The tick N is the time of N microseconds after the epoch.
+ */
+std::chrono::steady_clock::time_point StdCppTimerService::getTimePoint(std::uint64_t tick) const
+{
+	return m_epoch + std::chrono::microseconds(tick);
+}
+
+std::uint64_t StdCppTimerService::getElapsedNanos() const
+{
+	return static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count());
+}
+
+std::uint64_t StdCppTimerService::getCurrentTick() const
+{
+	return getElapsedNanos() / 1000U;
+}
+
+/*
+ * Return the first tick that is timeInMicros or more after now.
+ */
+std::uint64_t StdCppTimerService::getTickAfter(std::uint64_t timeInMicros) const
+{
+	const std::uint64_t elapsed = getElapsedNanos();
+	std::uint64_t time = timeInMicros;
+	if (time > MAX_TIME_IN_MICROS) {
+		time = MAX_TIME_IN_MICROS;
+	}
+	return (elapsed + 999U) / 1000U + time;
+}
+
+/*
+ * The level of the entry is the position of the highest bit group that differs between the expiry and the current tick.
+ * So the entries of a level are cascaded to the lower levels when the current tick reaches their slot.
+ */
+void StdCppTimerService::schedule(Entry* e, std::uint64_t expiry)
+{
+	if (expiry <= m_currentTick) {
+		expiry = m_currentTick + 1U;
+	}
+	e->m_expiry = expiry;
+	const unsigned int level = findLastSet(expiry ^ m_currentTick) / SLOT_BITS;
+	const unsigned int slot = static_cast<unsigned int>(expiry >> (level * SLOT_BITS)) & (NUM_SLOTS - 1U);
+	link(e, level, slot);
+	if (expiry < m_waitingTick) {
+		wakeUp();
+	}
+}
+
+/*
+ * The deadline of the next period is the deadline of the expired period + the period,
+ * except the relative schedule that starts the period now.
+ * The deadlines that have already passed are overruns, and each of them is counted only once.
+ */
+void StdCppTimerService::scheduleNextPeriod(Entry* e)
+{
+	const std::uint64_t period = e->m_periodInMicros;
+	if (e->m_schedule == RELATIVE_SCHEDULE) {
+		e->m_deadline = getTickAfter(e->m_periodInMicros);
+		schedule(e, e->m_deadline);
+		return;
+	}
+	std::uint64_t next = e->m_deadline + period;
+	const std::uint64_t nowTick = getCurrentTick();
+	if (next <= nowTick) {
+		const std::uint64_t missed = (nowTick - next) / period + 1U;
+		const std::uint64_t lastPassed = next + (missed - 1U) * period;
+		std::uint64_t firstUncounted = next;
+		if (e->m_countedDeadline >= next) {
+			firstUncounted = e->m_countedDeadline + period;
+		}
+		if (firstUncounted <= lastPassed) {
+			e->m_statistics.m_numOverruns += static_cast<unsigned long>((lastPassed - firstUncounted) / period + 1U);
+			e->m_countedDeadline = lastPassed;
+		}
+		if (e->m_schedule != CATCH_UP_MISSED) {
+			next += missed * period;
+			if (e->m_schedule == REPORT_MISSED) {
+				e->m_missedPeriods = static_cast<unsigned long>(missed);
+			}
+		}
+	}
+	e->m_deadline = next;
+	schedule(e, next);
+}
+
+void StdCppTimerService::link(Entry* e, unsigned int level, unsigned int slot)
+{
+	Entry** head = &m_expired;
+	if (level != EXPIRED_LEVEL) {
+		head = &m_slots[level][slot];
+		m_bitmaps[level] |= static_cast<std::uint64_t>(1U) << slot;
+		++m_numTimers;
+	}
+	e->m_level = level;
+	e->m_prev = nullptr;
+	e->m_next = *head;
+	if (*head != nullptr) {
+		(*head)->m_prev = e;
+	}
+	*head = e;
+}
+
+void StdCppTimerService::unlink(Entry* e)
+{
+	if (e->m_level == NOT_LINKED) {
+		return;
+	}
+	Entry** head = &m_expired;
+	unsigned int slot = 0U;
+	if (e->m_level != EXPIRED_LEVEL) {
+		slot = static_cast<unsigned int>(e->m_expiry >> (e->m_level * SLOT_BITS)) & (NUM_SLOTS - 1U);
+		head = &m_slots[e->m_level][slot];
+		--m_numTimers;
+	}
+	if (e->m_prev != nullptr) {
+		e->m_prev->m_next = e->m_next;
+	} else {
+		*head = e->m_next;
+	}
+	if (e->m_next != nullptr) {
+		e->m_next->m_prev = e->m_prev;
+	}
+	if ((e->m_level != EXPIRED_LEVEL) && (*head == nullptr)) {
+		m_bitmaps[e->m_level] &= ~(static_cast<std::uint64_t>(1U) << slot);
+	}
+	e->m_prev = nullptr;
+	e->m_next = nullptr;
+	e->m_level = NOT_LINKED;
+}
+
+/*
+ * Return the tick when the first non-empty slot is reached.
+ * All the non-empty slots of a level are after the slot of the current tick.
+ */
+std::uint64_t StdCppTimerService::getNextEventTick() const
+{
+	std::uint64_t nextTick = MAX_TICK;
+	for (unsigned int level = 0U; level < NUM_LEVELS; ++level) {
+		if (m_bitmaps[level] == 0U) {
+			continue;
+		}
+		const unsigned int shift = level * SLOT_BITS;
+		const unsigned int upperShift = shift + SLOT_BITS;
+		std::uint64_t tick = 0U;
+		if (upperShift < 64U) {
+			tick = (m_currentTick >> upperShift) << upperShift;
+		}
+		tick += static_cast<std::uint64_t>(findFirstSet(m_bitmaps[level])) << shift;
+		if (tick < nextTick) {
+			nextTick = tick;
+		}
+	}
+	return nextTick;
+}
+
+void StdCppTimerService::advanceTo(std::uint64_t tick)
+{
+	m_currentTick = tick;
+	for (unsigned int level = NUM_LEVELS; level > 0U; ) {
+		--level;
+		const unsigned int shift = level * SLOT_BITS;
+		if ((level != 0U) && ((tick & ((static_cast<std::uint64_t>(1U) << shift) - 1U)) != 0U)) {
+			continue;
+		}
+		const unsigned int slot = static_cast<unsigned int>(tick >> shift) & (NUM_SLOTS - 1U);
+		while (m_slots[level][slot] != nullptr) {
+			Entry* e = m_slots[level][slot];
+			unlink(e);
+			if (e->m_expiry <= tick) {
+				link(e, EXPIRED_LEVEL, 0U);
+			} else {
+				schedule(e, e->m_expiry);
+			}
+		}
+	}
+}
+
+void StdCppTimerService::fireExpired(std::unique_lock<std::mutex>& lock)
+{
+	while (m_expired != nullptr) {
+		Entry* e = m_expired;
+		unlink(e);
+		const std::uint64_t elapsed = getElapsedNanos();
+		const std::uint64_t deadline = e->m_deadline * 1000U;
+		const std::uint64_t lateness = (elapsed > deadline) ? (elapsed - deadline) : 0U;
+		Statistics& stats = e->m_statistics;
+		++stats.m_numExpirations;
+		stats.m_totalLatenessInNanos += lateness;
+		if (stats.m_maxLatenessInNanos < lateness) {
+			stats.m_maxLatenessInNanos = lateness;
+		}
+		const unsigned long missedPeriods = e->m_missedPeriods;
+		e->m_missedPeriods = 0U;
+		e->m_isRunning = true;
+		lock.unlock();
+		e->expire(missedPeriods);
+		lock.lock();
+		e->m_isRunning = false;
+		// If the timer was restarted in expire(), it is already linked
+		if (e->m_level == NOT_LINKED) {
+			if (e->m_periodInMicros == 0U) {
+				e->m_isActive = false;
+			} else if (e->m_isActive) {
+				scheduleNextPeriod(e);
+			}
+		}
+		m_condExpired.notify_all();
+	}
+}
+
+}
@@ -0,0 +1,187 @@
+#ifndef STDCPP_OS_WRAPPER_STDCPP_TIMER_SERVICE_H_INCLUDED
+#define STDCPP_OS_WRAPPER_STDCPP_TIMER_SERVICE_H_INCLUDED
+
+#include "OSWrapper/Runnable.h"
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+
+namespace OSWrapper {
+class Thread;
+}
+
+namespace StdCppOSWrapper {
+
+/*!
+ * @brief Timer service that drives all the timers by one dispatcher thread
+ *
+ * The timers are kept in a hierarchical timing wheel of 1 us ticks.
+ * Each level has 64 slots and a bitmap of the non-empty slots, so start and stop are O(1)
+ * and the dispatcher thread finds the next expiry without scanning the timers.
+ * The expired timers are called one by one on the dispatcher thread.
+ *
+ * The service is shared by StdCppOneShotTimerFactory and StdCppPeriodicTimerFactory.
+ * The dispatcher thread is created when the first timer is created and ended when the last timer is destroyed.
+ *
+ * The dispatcher thread waits for the next expiry by a condition variable.
+ * A derived class can wait by another way by overriding waitUntil(), waitForWakeUp() and wakeUp().
+ */
+class StdCppTimerService {
+public:
+	/*!
+	 * @brief How a periodic timer schedules the next period
+	 */
+	enum Schedule {
+		RELATIVE_SCHEDULE, //!< The next period starts when the timer returns from expire()
+		SKIP_MISSED,       //!< The periods are on the time grid and the missed periods are skipped
+		CATCH_UP_MISSED,   //!< The periods are on the time grid and the missed periods expire back to back
+		REPORT_MISSED      //!< Same as SKIP_MISSED, and expire() takes the number of the skipped periods
+	};
+
+	/*!
+	 * @brief Statistics of a timer
+	 */
+	struct Statistics {
+		unsigned long m_numExpirations;
+		unsigned long m_numOverruns;
+		std::uint64_t m_maxLatenessInNanos;
+		std::uint64_t m_totalLatenessInNanos;
+	};
+
+	/*!
+	 * @brief Timer entry linked into the timing wheel
+	 */
+	class Entry {
+	public:
+		Entry()
+		: m_prev(nullptr), m_next(nullptr), m_level(NOT_LINKED), m_expiry(0U), m_deadline(0U), m_countedDeadline(0U)
+		, m_periodInMicros(0U), m_schedule(RELATIVE_SCHEDULE), m_missedPeriods(0U), m_isActive(false), m_isRunning(false)
+		, m_statistics()
+		{
+		}
+		virtual ~Entry() {}
+
+		/*!
+		 * @brief Called on the dispatcher thread when the timer expires
+		 * @param missedPeriods Number of the periods skipped before this expiration if the schedule is REPORT_MISSED, else 0
+		 */
+		virtual void expire(unsigned long missedPeriods) = 0;
+
+	private:
+		friend class StdCppTimerService;
+		Entry* m_prev;
+		Entry* m_next;
+		unsigned int m_level;
+		std::uint64_t m_expiry;
+		std::uint64_t m_deadline;
+		std::uint64_t m_countedDeadline;
+		std::uint64_t m_periodInMicros;
+		Schedule m_schedule;
+		unsigned long m_missedPeriods;
+		bool m_isActive;
+		bool m_isRunning;
+		Statistics m_statistics;
+
+		Entry(const Entry&);
+		Entry& operator=(const Entry&);
+	};
+
+	static StdCppTimerService* acquire();
+	static void release();
+
+	void start(Entry* e, std::uint64_t timeInMicros, std::uint64_t periodInMicros);
+	void stop(Entry* e);
+	void cancel(Entry* e);
+	bool isStarted(const Entry* e) const;
+	void setSchedule(Entry* e, Schedule schedule);
+	Statistics getStatistics(const Entry* e) const;
+	void resetStatistics(Entry* e);
+
+protected:
+	StdCppTimerService();
+	virtual ~StdCppTimerService();
+	bool beginThread();
+	void endThread();
+	std::chrono::steady_clock::time_point getTimePoint(std::uint64_t tick) const;
+
+	/*!
+	 * @brief Wait until the tick or wakeUp() is called
+	 * @param lock Lock of the service. It is locked when called and when returned.
+	 * @param tick Tick to wake up
+	 *
+	 * It may return earlier than the tick.
+	 */
+	virtual void waitUntil(std::unique_lock<std::mutex>& lock, std::uint64_t tick);
+
+	/*!
+	 * @brief Wait until wakeUp() is called
+	 * @param lock Lock of the service. It is locked when called and when returned.
+	 *
+	 * It may return without wakeUp().
+	 */
+	virtual void waitForWakeUp(std::unique_lock<std::mutex>& lock);
+
+	/*!
+	 * @brief Wake up the dispatcher thread waiting in waitUntil() or waitForWakeUp()
+	 *
+	 * It is called with the lock of the service.
+	 */
+	virtual void wakeUp();
+
+private:
+	static const unsigned int SLOT_BITS = 6U;
+	static const unsigned int NUM_SLOTS = 1U << SLOT_BITS;
+	static const unsigned int NUM_LEVELS = (64U + SLOT_BITS - 1U) / SLOT_BITS;
+	static const unsigned int EXPIRED_LEVEL = NUM_LEVELS;
+	static const unsigned int NOT_LINKED = NUM_LEVELS + 1U;
+
+	class DispatcherTask : public OSWrapper::Runnable {
+	private:
+		StdCppTimerService* m_service;
+	public:
+		explicit DispatcherTask(StdCppTimerService* service) : m_service(service) {}
+		virtual ~DispatcherTask() {}
+		virtual void run()
+		{
+			m_service->dispatcherLoop();
+		}
+	};
+
+	DispatcherTask m_task;
+	OSWrapper::Thread* m_thread;
+	std::thread::id m_dispatcherId;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condWakeup;
+	std::condition_variable m_condExpired;
+	bool m_endThreadRequested;
+
+	const std::chrono::steady_clock::time_point m_epoch;
+	std::uint64_t m_currentTick;
+	std::uint64_t m_waitingTick;
+	std::size_t m_numTimers;
+	std::uint64_t m_bitmaps[NUM_LEVELS];
+	Entry* m_slots[NUM_LEVELS][NUM_SLOTS];
+	Entry* m_expired;
+
+	void dispatcherLoop();
+
+	std::uint64_t getElapsedNanos() const;
+	std::uint64_t getCurrentTick() const;
+	std::uint64_t getTickAfter(std::uint64_t timeInMicros) const;
+	void schedule(Entry* e, std::uint64_t expiry);
+	void scheduleNextPeriod(Entry* e);
+	void link(Entry* e, unsigned int level, unsigned int slot);
+	void unlink(Entry* e);
+	std::uint64_t getNextEventTick() const;
+	void advanceTo(std::uint64_t tick);
+	void fireExpired(std::unique_lock<std::mutex>& lock);
+
+	StdCppTimerService(const StdCppTimerService&);
+	StdCppTimerService& operator=(const StdCppTimerService&);
+};
+
+}
+
+#endif // STDCPP_OS_WRAPPER_STDCPP_TIMER_SERVICE_H_INCLUDED
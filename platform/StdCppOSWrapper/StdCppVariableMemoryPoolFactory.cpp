@@ -1,25 +1,299 @@
 #include "StdCppVariableMemoryPoolFactory.h"
 #include "OSWrapper/VariableMemoryPool.h"
-#include <cstdlib>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 namespace StdCppOSWrapper {
 
+namespace {
+
+const std::size_t ALIGNMENT = alignof(std::max_align_t);
+
+inline std::size_t alignUp(std::size_t size)
+{
+	return ((size + (ALIGNMENT - 1U)) & (~(ALIGNMENT - 1U)));
+}
+
+inline std::size_t alignDown(std::size_t size)
+{
+	return (size & (~(ALIGNMENT - 1U)));
+}
+
+// Index of the most significant set bit. x must not be zero.
+inline unsigned int findLastSet(std::size_t x)
+{
+	unsigned int bit = 0U;
+	for (unsigned int shift = sizeof(std::size_t) * 4U; shift > 0U; shift /= 2U) {
+		if ((x >> shift) != 0U) {
+			x >>= shift;
+			bit += shift;
+		}
+	}
+	return bit;
+}
+
+// Index of the least significant set bit. x must not be zero.
+inline unsigned int findFirstSet(std::uint32_t x)
+{
+	return findLastSet(x & (~x + 1U));
+}
+
+};
+
+/*
+ * TLSF (Two-Level Segregated Fit) allocator in the memory pool area.
+ *
+ * The free blocks are classified by the size into the free lists.
+ * The first level is the power of two of the size, and the second level divides it linearly into SL_COUNT ranges.
+ * The bitmaps of non-empty free lists find a free block large enough in constant time.
+ * Each block has a header that has the size and the pointer of the previous block in physical order,
+ * so a released block is merged with the adjacent free blocks in constant time.
+ * The area is terminated by a used sentinel block of size zero.
+ */
 class StdCppVariableMemoryPool : public OSWrapper::VariableMemoryPool {
 public:
-	StdCppVariableMemoryPool() {}
+	struct Block {
+		Block* m_prevPhys;
+		// The lower bit is FREE_BIT
+		std::size_t m_size;
+	};
+
+private:
+	// Only free blocks have these links at the head of the user area
+	struct FreeLinks {
+		Block* m_nextFree;
+		Block* m_prevFree;
+	};
+
+	static const std::size_t FREE_BIT = 1U;
+	static const unsigned int SL_LOG2 = 4U;
+	static const unsigned int SL_COUNT = 1U << SL_LOG2;
+	static const unsigned int FL_SHIFT = SL_LOG2 + 4U;
+	static const std::size_t SMALL_BLOCK_SIZE = static_cast<std::size_t>(1U) << FL_SHIFT;
+	static const unsigned int FL_INDEX_MAX = (sizeof(std::size_t) >= 8U) ? 38U : 30U;
+	static const unsigned int FL_COUNT = FL_INDEX_MAX - FL_SHIFT + 2U;
+
+	std::vector<char> m_memoryPoolBuffer;
+	std::mutex m_mutex;
+	char* m_begin;
+	char* m_end;
+	std::uint32_t m_flBitmap;
+	std::uint32_t m_slBitmap[FL_COUNT];
+	Block* m_freeLists[FL_COUNT][SL_COUNT];
+
+	static std::size_t getSize(const Block* b)
+	{
+		return b->m_size & (~FREE_BIT);
+	}
+
+	static bool isFree(const Block* b)
+	{
+		return (b->m_size & FREE_BIT) != 0U;
+	}
+
+	static char* getUserArea(Block* b)
+	{
+		return reinterpret_cast<char*>(b) + HEADER_SIZE;
+	}
+
+	static FreeLinks* getLinks(Block* b)
+	{
+		return reinterpret_cast<FreeLinks*>(getUserArea(b));
+	}
+
+	static Block* getNextPhys(Block* b)
+	{
+		return reinterpret_cast<Block*>(getUserArea(b) + getSize(b));
+	}
+
+	static void mapping(std::size_t size, unsigned int* fl, unsigned int* sl)
+	{
+		if (size < SMALL_BLOCK_SIZE) {
+			*fl = 0U;
+			*sl = static_cast<unsigned int>(size / (SMALL_BLOCK_SIZE / SL_COUNT));
+		} else {
+			const unsigned int bit = findLastSet(size);
+			*sl = static_cast<unsigned int>(size >> (bit - SL_LOG2)) ^ SL_COUNT;
+			*fl = bit - FL_SHIFT + 1U;
+		}
+	}
+
+	void insertFreeBlock(Block* b)
+	{
+		unsigned int fl = 0U;
+		unsigned int sl = 0U;
+		mapping(getSize(b), &fl, &sl);
+		Block* head = m_freeLists[fl][sl];
+		getLinks(b)->m_nextFree = head;
+		getLinks(b)->m_prevFree = nullptr;
+		if (head != nullptr) {
+			getLinks(head)->m_prevFree = b;
+		}
+		m_freeLists[fl][sl] = b;
+		m_flBitmap |= (1U << fl);
+		m_slBitmap[fl] |= (1U << sl);
+	}
+
+	void removeFreeBlock(Block* b)
+	{
+		unsigned int fl = 0U;
+		unsigned int sl = 0U;
+		mapping(getSize(b), &fl, &sl);
+		Block* next = getLinks(b)->m_nextFree;
+		Block* prev = getLinks(b)->m_prevFree;
+		if (next != nullptr) {
+			getLinks(next)->m_prevFree = prev;
+		}
+		if (prev != nullptr) {
+			getLinks(prev)->m_nextFree = next;
+		} else {
+			m_freeLists[fl][sl] = next;
+			if (next == nullptr) {
+				m_slBitmap[fl] &= ~(1U << sl);
+				if (m_slBitmap[fl] == 0U) {
+					m_flBitmap &= ~(1U << fl);
+				}
+			}
+		}
+	}
+
+	// Find a free block whose size is size or more.
+	// The size is rounded up to the next list, so any block in the found list is large enough.
+	// If there is no such list, the first block of the list that size belongs to is also checked.
+	Block* findFreeBlock(std::size_t size)
+	{
+		std::size_t roundedSize = size;
+		if (size >= SMALL_BLOCK_SIZE) {
+			roundedSize += (static_cast<std::size_t>(1U) << (findLastSet(size) - SL_LOG2)) - 1U;
+		}
+		unsigned int fl = 0U;
+		unsigned int sl = 0U;
+		mapping(roundedSize, &fl, &sl);
+		std::uint32_t slMap = (fl < FL_COUNT) ? (m_slBitmap[fl] & (~0U << sl)) : 0U;
+		if (slMap == 0U) {
+			const std::uint32_t flMap = (fl + 1U < FL_COUNT) ? (m_flBitmap & (~0U << (fl + 1U))) : 0U;
+			if (flMap == 0U) {
+				return findFirstFitBlock(size);
+			}
+			fl = findFirstSet(flMap);
+			slMap = m_slBitmap[fl];
+		}
+		sl = findFirstSet(slMap);
+		Block* b = m_freeLists[fl][sl];
+		removeFreeBlock(b);
+		return b;
+	}
+
+	Block* findFirstFitBlock(std::size_t size)
+	{
+		unsigned int fl = 0U;
+		unsigned int sl = 0U;
+		mapping(size, &fl, &sl);
+		Block* b = m_freeLists[fl][sl];
+		if ((b == nullptr) || (getSize(b) < size)) {
+			return nullptr;
+		}
+		removeFreeBlock(b);
+		return b;
+	}
+
+	// Split the remainder of b into a new free block if it is large enough
+	void split(Block* b, std::size_t size)
+	{
+		const std::size_t blockSize = getSize(b);
+		if (blockSize < size + HEADER_SIZE + MIN_BLOCK_SIZE) {
+			return;
+		}
+		b->m_size = size | (b->m_size & FREE_BIT);
+		Block* rest = getNextPhys(b);
+		rest->m_prevPhys = b;
+		rest->m_size = (blockSize - size - HEADER_SIZE) | FREE_BIT;
+		getNextPhys(rest)->m_prevPhys = rest;
+		insertFreeBlock(rest);
+	}
+
+	// Merge b with next, which follows b in physical order
+	static void merge(Block* b, Block* next)
+	{
+		b->m_size += HEADER_SIZE + getSize(next);
+		getNextPhys(b)->m_prevPhys = b;
+	}
+
+public:
+	static const std::size_t HEADER_SIZE = (sizeof(Block) + (ALIGNMENT - 1U)) & (~(ALIGNMENT - 1U));
+	static const std::size_t MIN_BLOCK_SIZE = (sizeof(FreeLinks) + (ALIGNMENT - 1U)) & (~(ALIGNMENT - 1U));
+	static const std::size_t MAX_BLOCK_SIZE = static_cast<std::size_t>(1U) << FL_INDEX_MAX;
+
+	// The area must be aligned and have a block of MIN_BLOCK_SIZE and the sentinel at least
+	StdCppVariableMemoryPool(std::size_t memoryPoolSize, void* memoryPoolAddress)
+	: m_memoryPoolBuffer(), m_mutex(), m_begin(static_cast<char*>(memoryPoolAddress)), m_end(nullptr)
+	, m_flBitmap(0U), m_slBitmap(), m_freeLists()
+	{
+		if (m_begin == nullptr) {
+			m_memoryPoolBuffer.resize(memoryPoolSize + (ALIGNMENT - 1U));
+			const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(&m_memoryPoolBuffer[0]);
+			m_begin = &m_memoryPoolBuffer[alignUp(addr) - addr];
+		}
+		m_end = m_begin + memoryPoolSize;
+
+		Block* first = reinterpret_cast<Block*>(m_begin);
+		first->m_prevPhys = nullptr;
+		first->m_size = (memoryPoolSize - (HEADER_SIZE * 2U)) | FREE_BIT;
+		Block* sentinel = getNextPhys(first);
+		sentinel->m_prevPhys = first;
+		sentinel->m_size = 0U;
+		insertFreeBlock(first);
+	}
+
 	~StdCppVariableMemoryPool() {}
 
 	void* allocate(std::size_t size)
 	{
-		return std::malloc(size);
+		if (size > MAX_BLOCK_SIZE) {
+			return nullptr;
+		}
+		size = (size < MIN_BLOCK_SIZE) ? MIN_BLOCK_SIZE : alignUp(size);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Block* b = findFreeBlock(size);
+		if (b == nullptr) {
+			return nullptr;
+		}
+		b->m_size &= ~FREE_BIT;
+		split(b, size);
+		return getUserArea(b);
 	}
 
 	void deallocate(void* p)
 	{
-		std::free(p);
+		char* cp = static_cast<char*>(p);
+		if ((cp < m_begin + HEADER_SIZE) || (cp >= m_end)) {
+			return;
+		}
+		Block* b = reinterpret_cast<Block*>(cp - HEADER_SIZE);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (isFree(b)) {
+			return;
+		}
+		b->m_size |= FREE_BIT;
+		Block* next = getNextPhys(b);
+		if (isFree(next)) {
+			removeFreeBlock(next);
+			merge(b, next);
+		}
+		Block* prev = b->m_prevPhys;
+		if ((prev != nullptr) && isFree(prev)) {
+			removeFreeBlock(prev);
+			merge(prev, b);
+			b = prev;
+		}
+		insertFreeBlock(b);
 	}
 };
 
+
 StdCppVariableMemoryPoolFactory::StdCppVariableMemoryPoolFactory()
 : m_mutex()
 {
@@ -27,15 +301,26 @@ StdCppVariableMemoryPoolFactory::StdCppVariableMemoryPoolFactory()
 
 OSWrapper::VariableMemoryPool* StdCppVariableMemoryPoolFactory::create(std::size_t memoryPoolSize, void* memoryPoolAddress)
 {
-	(void) memoryPoolAddress;
-	if (memoryPoolSize == 0U) {
+	if (memoryPoolAddress != nullptr) {
+		// Use the aligned part of the given area
+		const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(memoryPoolAddress);
+		const std::size_t padding = alignUp(addr) - addr;
+		if (memoryPoolSize <= padding) {
+			return nullptr;
+		}
+		memoryPoolAddress = static_cast<char*>(memoryPoolAddress) + padding;
+		memoryPoolSize -= padding;
+	}
+	memoryPoolSize = alignDown(memoryPoolSize);
+	if ((memoryPoolSize < (StdCppVariableMemoryPool::HEADER_SIZE * 2U) + StdCppVariableMemoryPool::MIN_BLOCK_SIZE)
+			|| (memoryPoolSize > StdCppVariableMemoryPool::MAX_BLOCK_SIZE)) {
 		return nullptr;
 	}
 #ifndef CPPELIB_NO_EXCEPTIONS
 	try {
 #endif
 		std::lock_guard<std::mutex> lock(m_mutex);
-		StdCppVariableMemoryPool* p = new StdCppVariableMemoryPool();
+		StdCppVariableMemoryPool* p = new StdCppVariableMemoryPool(memoryPoolSize, memoryPoolAddress);
 		return p;
 #ifndef CPPELIB_NO_EXCEPTIONS
 	}
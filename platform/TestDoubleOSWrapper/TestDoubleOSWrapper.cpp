@@ -1,14 +1,18 @@
 #include "TestDoubleOSWrapper.h"
 #include "TestDoubleThreadFactory.h"
 #include "TestDoubleMutexFactory.h"
+#include "TestDoubleRWLockFactory.h"
 #include "TestDoubleEventFlagFactory.h"
+#include "TestDoubleSemaphoreFactory.h"
 #include "TestDoubleFixedMemoryPoolFactory.h"
 #include "TestDoubleVariableMemoryPoolFactory.h"
 #include "TestDoublePeriodicTimerFactory.h"
 #include "TestDoubleOneShotTimerFactory.h"
 #include "OSWrapper/Thread.h"
 #include "OSWrapper/Mutex.h"
+#include "OSWrapper/RWLock.h"
 #include "OSWrapper/EventFlag.h"
+#include "OSWrapper/Semaphore.h"
 #include "OSWrapper/FixedMemoryPool.h"
 #include "OSWrapper/VariableMemoryPool.h"
 #include "OSWrapper/PeriodicTimer.h"
@@ -36,7 +40,9 @@ void init()
 {
 	static TestDoubleThreadFactory<> theThreadFactory;
 	static TestDoubleMutexFactory<> theMutexFactory;
+	static TestDoubleRWLockFactory<> theRWLockFactory;
 	static TestDoubleEventFlagFactory<> theEventFlagFactory;
+	static TestDoubleSemaphoreFactory<> theSemaphoreFactory;
 	static TestDoubleFixedMemoryPoolFactory<> theFixedMemoryPoolFactory;
 	static TestDoubleVariableMemoryPoolFactory<> theVariableMemoryPoolFactory;
 	static TestDoublePeriodicTimerFactory<> thePeriodicTimerFactory;
@@ -44,7 +50,9 @@ void init()
 
 	OSWrapper::registerThreadFactory(&theThreadFactory);
 	OSWrapper::registerMutexFactory(&theMutexFactory);
+	OSWrapper::registerRWLockFactory(&theRWLockFactory);
 	OSWrapper::registerEventFlagFactory(&theEventFlagFactory);
+	OSWrapper::registerSemaphoreFactory(&theSemaphoreFactory);
 	OSWrapper::registerFixedMemoryPoolFactory(&theFixedMemoryPoolFactory);
 	OSWrapper::registerVariableMemoryPoolFactory(&theVariableMemoryPoolFactory);
 	OSWrapper::registerPeriodicTimerFactory(&thePeriodicTimerFactory);
@@ -0,0 +1,96 @@
+#ifndef TEST_DOUBLE_OS_WRAPPER_TEST_DOUBLE_RW_LOCK_FACTORY_H_INCLUDED
+#define TEST_DOUBLE_OS_WRAPPER_TEST_DOUBLE_RW_LOCK_FACTORY_H_INCLUDED
+
+#include "OSWrapper/RWLock.h"
+#include "OSWrapper/RWLockFactory.h"
+
+namespace TestDoubleOSWrapper {
+
+class TestDoubleRWLock : public OSWrapper::RWLock {
+protected:
+	bool m_writerPreference;
+
+public:
+	TestDoubleRWLock()
+	: m_writerPreference(false)
+	{
+	}
+
+	void setCreateArgs(bool writerPreference)
+	{
+		m_writerPreference = writerPreference;
+	}
+
+	virtual ~TestDoubleRWLock()
+	{
+	}
+
+	virtual OSWrapper::Error readLock()
+	{
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error tryReadLock()
+	{
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error timedReadLock(OSWrapper::Timeout tmout)
+	{
+		(void) tmout;
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error readUnlock()
+	{
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error writeLock()
+	{
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error tryWriteLock()
+	{
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error timedWriteLock(OSWrapper::Timeout tmout)
+	{
+		(void) tmout;
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error writeUnlock()
+	{
+		return OSWrapper::OK;
+	}
+};
+
+template <typename T = TestDoubleRWLock>
+class TestDoubleRWLockFactory : public OSWrapper::RWLockFactory {
+public:
+	TestDoubleRWLockFactory() {}
+	virtual ~TestDoubleRWLockFactory() {}
+
+	virtual OSWrapper::RWLock* create(bool writerPreference)
+	{
+		T* obj = new T();
+		obj->setCreateArgs(writerPreference);
+		return obj;
+	}
+
+	virtual void destroy(OSWrapper::RWLock* l)
+	{
+		delete static_cast<T*>(l);
+	}
+
+private:
+	TestDoubleRWLockFactory(const TestDoubleRWLockFactory&);
+	TestDoubleRWLockFactory& operator=(const TestDoubleRWLockFactory&);
+};
+
+}
+
+#endif // TEST_DOUBLE_OS_WRAPPER_TEST_DOUBLE_RW_LOCK_FACTORY_H_INCLUDED
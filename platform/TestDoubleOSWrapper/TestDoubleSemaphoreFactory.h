@@ -0,0 +1,91 @@
+#ifndef TEST_DOUBLE_OS_WRAPPER_TEST_DOUBLE_SEMAPHORE_FACTORY_H_INCLUDED
+#define TEST_DOUBLE_OS_WRAPPER_TEST_DOUBLE_SEMAPHORE_FACTORY_H_INCLUDED
+
+#include "OSWrapper/Semaphore.h"
+#include "OSWrapper/SemaphoreFactory.h"
+
+namespace TestDoubleOSWrapper {
+
+class TestDoubleSemaphore : public OSWrapper::Semaphore {
+protected:
+	std::size_t m_initialCount;
+	std::size_t m_maxCount;
+
+public:
+	TestDoubleSemaphore()
+	: m_initialCount(0U), m_maxCount(0U)
+	{
+	}
+
+	void setCreateArgs(std::size_t initialCount, std::size_t maxCount)
+	{
+		m_initialCount = initialCount;
+		m_maxCount = maxCount;
+	}
+
+	virtual ~TestDoubleSemaphore()
+	{
+	}
+
+	virtual OSWrapper::Error acquire(std::size_t n)
+	{
+		(void) n;
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error tryAcquire(std::size_t n)
+	{
+		(void) n;
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error timedAcquire(std::size_t n, OSWrapper::Timeout tmout)
+	{
+		(void) n;
+		(void) tmout;
+		return OSWrapper::OK;
+	}
+
+	virtual OSWrapper::Error release(std::size_t n)
+	{
+		(void) n;
+		return OSWrapper::OK;
+	}
+
+	virtual std::size_t getCount() const
+	{
+		return 0U;
+	}
+
+	virtual std::size_t getMaxCount() const
+	{
+		return m_maxCount;
+	}
+};
+
+template <typename T = TestDoubleSemaphore>
+class TestDoubleSemaphoreFactory : public OSWrapper::SemaphoreFactory {
+public:
+	TestDoubleSemaphoreFactory() {}
+	virtual ~TestDoubleSemaphoreFactory() {}
+
+	virtual OSWrapper::Semaphore* create(std::size_t initialCount, std::size_t maxCount)
+	{
+		T* obj = new T();
+		obj->setCreateArgs(initialCount, maxCount);
+		return obj;
+	}
+
+	virtual void destroy(OSWrapper::Semaphore* s)
+	{
+		delete static_cast<T*>(s);
+	}
+
+private:
+	TestDoubleSemaphoreFactory(const TestDoubleSemaphoreFactory&);
+	TestDoubleSemaphoreFactory& operator=(const TestDoubleSemaphoreFactory&);
+};
+
+}
+
+#endif // TEST_DOUBLE_OS_WRAPPER_TEST_DOUBLE_SEMAPHORE_FACTORY_H_INCLUDED
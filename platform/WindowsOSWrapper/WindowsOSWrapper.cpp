@@ -1,14 +1,18 @@
 #include "WindowsOSWrapper.h"
 #include "WindowsThreadFactory.h"
 #include "WindowsMutexFactory.h"
+#include "WindowsRWLockFactory.h"
 #include "WindowsEventFlagFactory.h"
+#include "WindowsSemaphoreFactory.h"
 #include "WindowsFixedMemoryPoolFactory.h"
 #include "WindowsVariableMemoryPoolFactory.h"
 #include "WindowsPeriodicTimerFactory.h"
 #include "WindowsOneShotTimerFactory.h"
 #include "OSWrapper/Thread.h"
 #include "OSWrapper/Mutex.h"
+#include "OSWrapper/RWLock.h"
 #include "OSWrapper/EventFlag.h"
+#include "OSWrapper/Semaphore.h"
 #include "OSWrapper/FixedMemoryPool.h"
 #include "OSWrapper/VariableMemoryPool.h"
 #include "OSWrapper/PeriodicTimer.h"
@@ -33,7 +37,9 @@ void init(int lowestPriority, int highestPriority)
 {
 	static WindowsThreadFactory theThreadFactory(lowestPriority, highestPriority);
 	static WindowsMutexFactory theMutexFactory;
+	static WindowsRWLockFactory theRWLockFactory;
 	static WindowsEventFlagFactory theEventFlagFactory;
+	static WindowsSemaphoreFactory theSemaphoreFactory;
 	static WindowsFixedMemoryPoolFactory theFixedMemoryPoolFactory;
 	static WindowsVariableMemoryPoolFactory theVariableMemoryPoolFactory;
 	static WindowsPeriodicTimerFactory thePeriodicTimerFactory;
@@ -41,7 +47,9 @@ void init(int lowestPriority, int highestPriority)
 
 	OSWrapper::registerThreadFactory(&theThreadFactory);
 	OSWrapper::registerMutexFactory(&theMutexFactory);
+	OSWrapper::registerRWLockFactory(&theRWLockFactory);
 	OSWrapper::registerEventFlagFactory(&theEventFlagFactory);
+	OSWrapper::registerSemaphoreFactory(&theSemaphoreFactory);
 	OSWrapper::registerFixedMemoryPoolFactory(&theFixedMemoryPoolFactory);
 	OSWrapper::registerVariableMemoryPoolFactory(&theVariableMemoryPoolFactory);
 	OSWrapper::registerPeriodicTimerFactory(&thePeriodicTimerFactory);
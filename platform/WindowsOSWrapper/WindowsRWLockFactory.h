@@ -0,0 +1,13 @@
+#ifndef WINDOWS_OS_WRAPPER_WINDOWS_RW_LOCK_FACTORY_H_INCLUDED
+#define WINDOWS_OS_WRAPPER_WINDOWS_RW_LOCK_FACTORY_H_INCLUDED
+
+#include "StdCppOSWrapper/StdCppRWLockFactory.h"
+
+namespace WindowsOSWrapper {
+
+class WindowsRWLockFactory : public StdCppOSWrapper::StdCppRWLockFactory {
+};
+
+}
+
+#endif // WINDOWS_OS_WRAPPER_WINDOWS_RW_LOCK_FACTORY_H_INCLUDED
@@ -0,0 +1,13 @@
+#ifndef WINDOWS_OS_WRAPPER_WINDOWS_SEMAPHORE_FACTORY_H_INCLUDED
+#define WINDOWS_OS_WRAPPER_WINDOWS_SEMAPHORE_FACTORY_H_INCLUDED
+
+#include "StdCppOSWrapper/StdCppSemaphoreFactory.h"
+
+namespace WindowsOSWrapper {
+
+class WindowsSemaphoreFactory : public StdCppOSWrapper::StdCppSemaphoreFactory {
+};
+
+}
+
+#endif // WINDOWS_OS_WRAPPER_WINDOWS_SEMAPHORE_FACTORY_H_INCLUDED
@@ -0,0 +1,132 @@
+#include "OSWrapper/FixedMemoryPool.h"
+#include "OSWrapper/FixedMemoryPoolCache.h"
+#include "OSWrapper/Runnable.h"
+#include "OSWrapper/Thread.h"
+#include <cstdio>
+#include <vector>
+
+#include "../PlatformOSWrapperTest/PlatformOSWrapperTestHelper.h"
+
+#include "CppUTest/TestHarness.h"
+
+namespace FixedMemoryPoolBenchmark {
+
+using OSWrapper::FixedMemoryPool;
+using OSWrapper::FixedMemoryPoolCache;
+using OSWrapper::Runnable;
+using OSWrapper::Thread;
+
+TEST_GROUP(FixedMemoryPoolBenchmark) {
+	static const std::size_t BLOCK_SIZE = 64;
+	static const std::size_t NUM_OPS = 2000000;
+	static const std::size_t MAX_BLOCKS = 16384;
+	static const int MAX_THREADS = 8;
+
+	class AllocFree : public Runnable {
+	private:
+		FixedMemoryPool* m_pool;
+		std::size_t m_num;
+	public:
+		AllocFree() : m_pool(0), m_num(0) {}
+		void init(FixedMemoryPool* pool, std::size_t num)
+		{
+			m_pool = pool;
+			m_num = num;
+		}
+		virtual void run()
+		{
+			for (std::size_t i = 0; i < m_num; i++) {
+				void* p = 0;
+				m_pool->allocateMemory(&p);
+				m_pool->deallocate(p);
+			}
+		}
+	};
+
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+	}
+	void teardown()
+	{
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+		std::printf("\n\n");
+	}
+
+	// Allocate all the blocks, then deallocate them from the most recently allocated one, and repeat until NUM_OPS pairs
+	unsigned long allocateDeallocate(std::size_t numBlocks)
+	{
+		FixedMemoryPool* pool = FixedMemoryPool::create(BLOCK_SIZE, FixedMemoryPool::getRequiredMemorySize(BLOCK_SIZE, numBlocks));
+		CHECK(pool);
+		LONGS_EQUAL(numBlocks, pool->getNumberOfAvailableBlocks());
+		std::vector<void*> blocks(numBlocks);
+
+		const unsigned long t = PlatformOSWrapperTestHelper::getCurrentTime();
+		for (std::size_t done = 0; done < NUM_OPS; done += numBlocks) {
+			for (std::size_t i = 0; i < numBlocks; i++) {
+				pool->tryAllocateMemory(&blocks[i]);
+			}
+			for (std::size_t i = numBlocks; i > 0; i--) {
+				pool->deallocate(blocks[i - 1]);
+			}
+		}
+		const unsigned long elapsed = PlatformOSWrapperTestHelper::getCurrentTime() - t;
+
+		LONGS_EQUAL(numBlocks, pool->getNumberOfAvailableBlocks());
+		FixedMemoryPool::destroy(pool);
+		return elapsed;
+	}
+
+	// NUM_OPS allocate/deallocate pairs are divided among the threads. The pool has a block for each thread.
+	// If usesCache is true, the threads allocate through a FixedMemoryPoolCache in front of the pool.
+	unsigned long allocateDeallocateByThreads(int numThreads, bool usesCache)
+	{
+		FixedMemoryPool* pool = FixedMemoryPool::create(BLOCK_SIZE, FixedMemoryPool::getRequiredMemorySize(BLOCK_SIZE, numThreads));
+		CHECK(pool);
+		FixedMemoryPoolCache<2> cache(pool);
+		AllocFree runnables[MAX_THREADS];
+		Thread* threads[MAX_THREADS];
+		for (int i = 0; i < numThreads; i++) {
+			runnables[i].init(usesCache ? static_cast<FixedMemoryPool*>(&cache) : pool, NUM_OPS / numThreads);
+			threads[i] = Thread::create(&runnables[i], Thread::getNormalPriority());
+			CHECK(threads[i]);
+		}
+
+		const unsigned long t = PlatformOSWrapperTestHelper::getCurrentTime();
+		for (int i = 0; i < numThreads; i++) {
+			threads[i]->start();
+		}
+		for (int i = 0; i < numThreads; i++) {
+			threads[i]->wait();
+		}
+		const unsigned long elapsed = PlatformOSWrapperTestHelper::getCurrentTime() - t;
+
+		LONGS_EQUAL(numThreads, cache.getNumberOfAvailableBlocks());
+		for (int i = 0; i < numThreads; i++) {
+			Thread::destroy(threads[i]);
+		}
+		cache.flush();
+		FixedMemoryPool::destroy(pool);
+		return elapsed;
+	}
+};
+
+TEST(FixedMemoryPoolBenchmark, blocks_16_to_16384)
+{
+	for (std::size_t numBlocks = 16; numBlocks <= MAX_BLOCKS; numBlocks *= 4) {
+		std::printf("FixedMemoryPool, %lu blocks, %lu allocate/deallocate, %lu ms\n",
+				static_cast<unsigned long>(numBlocks), static_cast<unsigned long>(NUM_OPS), allocateDeallocate(numBlocks));
+	}
+}
+
+TEST(FixedMemoryPoolBenchmark, threads_1_to_8)
+{
+	for (int numThreads = 1; numThreads <= MAX_THREADS; numThreads *= 2) {
+		std::printf("FixedMemoryPool, %d threads, %lu allocate/deallocate, %lu ms\n",
+				numThreads, static_cast<unsigned long>(NUM_OPS), allocateDeallocateByThreads(numThreads, false));
+		std::printf("FixedMemoryPoolCache, %d threads, %lu allocate/deallocate, %lu ms\n",
+				numThreads, static_cast<unsigned long>(NUM_OPS), allocateDeallocateByThreads(numThreads, true));
+	}
+}
+
+} // namespace FixedMemoryPoolBenchmark
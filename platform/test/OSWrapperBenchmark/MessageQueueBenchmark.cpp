@@ -0,0 +1,119 @@
+#include "OSWrapper/Runnable.h"
+#include "OSWrapper/Thread.h"
+#include "OSWrapper/MessageQueue.h"
+#include "OSWrapper/MPMCMessageQueue.h"
+#include <cstdio>
+
+#include "../PlatformOSWrapperTest/PlatformOSWrapperTestHelper.h"
+
+#include "CppUTest/TestHarness.h"
+
+namespace MessageQueueBenchmark {
+
+using OSWrapper::Runnable;
+using OSWrapper::Thread;
+using OSWrapper::MessageQueue;
+using OSWrapper::MPMCMessageQueue;
+
+TEST_GROUP(MessageQueueBenchmark) {
+	static const std::size_t QUEUE_SIZE = 64;
+	static const int NUM_MSGS = 400000;
+	static const int MAX_PRODUCERS = 16;
+
+	template <class MQ>
+	class Producer : public Runnable {
+	private:
+		MQ* m_mq;
+		int m_num;
+	public:
+		Producer() : m_mq(0), m_num(0) {}
+		void init(MQ* mq, int num)
+		{
+			m_mq = mq;
+			m_num = num;
+		}
+		virtual void run()
+		{
+			for (int i = 0; i < m_num; i++) {
+				m_mq->send(i);
+			}
+		}
+	};
+
+	template <class MQ>
+	class Consumer : public Runnable {
+	private:
+		MQ* m_mq;
+		int m_num;
+	public:
+		Consumer(MQ* mq, int num) : m_mq(mq), m_num(num) {}
+		virtual void run()
+		{
+			for (int i = 0; i < m_num; i++) {
+				int data = 0;
+				m_mq->receive(&data);
+			}
+		}
+	};
+
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+	}
+	void teardown()
+	{
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+		std::printf("\n\n");
+	}
+
+	// NUM_MSGS messages are divided among the producers and one consumer receives all of them
+	template <class MQ>
+	unsigned long sendReceive(int numProducers)
+	{
+		MQ* mq = MQ::create(QUEUE_SIZE);
+		CHECK(mq);
+		const int numPerProducer = NUM_MSGS / numProducers;
+		Producer<MQ> producers[MAX_PRODUCERS];
+		Thread* producerThreads[MAX_PRODUCERS];
+		for (int i = 0; i < numProducers; i++) {
+			producers[i].init(mq, numPerProducer);
+			producerThreads[i] = Thread::create(&producers[i], Thread::getNormalPriority());
+			CHECK(producerThreads[i]);
+		}
+		Consumer<MQ> consumer(mq, numPerProducer * numProducers);
+		Thread* consumerThread = Thread::create(&consumer, Thread::getNormalPriority());
+		CHECK(consumerThread);
+
+		const unsigned long t = PlatformOSWrapperTestHelper::getCurrentTime();
+		consumerThread->start();
+		for (int i = 0; i < numProducers; i++) {
+			producerThreads[i]->start();
+		}
+		for (int i = 0; i < numProducers; i++) {
+			producerThreads[i]->wait();
+		}
+		consumerThread->wait();
+		const unsigned long elapsed = PlatformOSWrapperTestHelper::getCurrentTime() - t;
+
+		LONGS_EQUAL(0, mq->getSize());
+
+		Thread::destroy(consumerThread);
+		for (int i = 0; i < numProducers; i++) {
+			Thread::destroy(producerThreads[i]);
+		}
+		MQ::destroy(mq);
+		return elapsed;
+	}
+};
+
+TEST(MessageQueueBenchmark, producers_1_to_16)
+{
+	for (int numProducers = 1; numProducers <= MAX_PRODUCERS; numProducers *= 2) {
+		std::printf("MessageQueue, %d producers, %d msgs, %lu ms\n",
+				numProducers, NUM_MSGS, sendReceive<MessageQueue<int> >(numProducers));
+		std::printf("MPMCMessageQueue, %d producers, %d msgs, %lu ms\n",
+				numProducers, NUM_MSGS, sendReceive<MPMCMessageQueue<int> >(numProducers));
+	}
+}
+
+} // namespace MessageQueueBenchmark
@@ -0,0 +1,69 @@
+#include "OSWrapper/VariableMemoryPool.h"
+#include <cstdio>
+#include <vector>
+
+#include "../PlatformOSWrapperTest/PlatformOSWrapperTestHelper.h"
+
+#include "CppUTest/TestHarness.h"
+
+namespace VariableMemoryPoolBenchmark {
+
+using OSWrapper::VariableMemoryPool;
+
+TEST_GROUP(VariableMemoryPoolBenchmark) {
+	static const std::size_t POOL_SIZE = 1024 * 1024;
+	static const std::size_t NUM_OPS = 2000000;
+	static const std::size_t NUM_SLOTS = 256;
+
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+	}
+	void teardown()
+	{
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+		std::printf("\n\n");
+	}
+
+	// Each operation releases the block in a pseudo-random slot and allocates a block of a pseudo-random size up to maxSize
+	unsigned long allocateDeallocate(std::size_t maxSize)
+	{
+		VariableMemoryPool* pool = VariableMemoryPool::create(POOL_SIZE);
+		CHECK(pool);
+		std::vector<void*> blocks(NUM_SLOTS);
+		unsigned long seed = 1;
+		unsigned long numFailed = 0;
+
+		const unsigned long t = PlatformOSWrapperTestHelper::getCurrentTime();
+		for (std::size_t i = 0; i < NUM_OPS; i++) {
+			seed = seed * 1103515245UL + 12345UL;
+			const std::size_t slot = (seed >> 8) % NUM_SLOTS;
+			const std::size_t size = ((seed >> 16) % maxSize) + 1;
+			pool->deallocate(blocks[slot]);
+			blocks[slot] = pool->allocate(size);
+			if (blocks[slot] == 0) {
+				numFailed++;
+			}
+		}
+		const unsigned long elapsed = PlatformOSWrapperTestHelper::getCurrentTime() - t;
+
+		for (std::size_t i = 0; i < NUM_SLOTS; i++) {
+			pool->deallocate(blocks[i]);
+		}
+		VariableMemoryPool::destroy(pool);
+		if (numFailed != 0) {
+			std::printf("VariableMemoryPool, %lu allocations failed\n", numFailed);
+		}
+		return elapsed;
+	}
+};
+
+TEST(VariableMemoryPoolBenchmark, sizes_64_to_4096)
+{
+	for (std::size_t maxSize = 64; maxSize <= 4096; maxSize *= 4) {
+		std::printf("VariableMemoryPool, max %lu bytes, %lu allocate/deallocate, %lu ms\n",
+				static_cast<unsigned long>(maxSize), static_cast<unsigned long>(NUM_OPS), allocateDeallocate(maxSize));
+	}
+}
+
+} // namespace VariableMemoryPoolBenchmark
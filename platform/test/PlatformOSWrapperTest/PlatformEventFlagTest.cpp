@@ -569,4 +569,204 @@ TEST(PlatformEventFlagTest, waitPattern_InvalidParameter)
 	testTwoThreadsSharingOneEventFlag<WaitFailedInvalidMode, WaitFailedInvalidPattern>(true);
 }
 
+TEST(PlatformEventFlagTest, waiters_of_different_bits)
+{
+	class WaitOneBit : public BaseRunnable {
+	private:
+		std::size_t m_pos;
+	public:
+		WaitOneBit() : BaseRunnable(0), m_pos(0) {}
+		void init(EventFlag* e, std::size_t pos)
+		{
+			m_ef = e;
+			m_pos = pos;
+		}
+		virtual void run()
+		{
+			OSWrapper::Error err = m_ef->waitOne(m_pos);
+			{
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+			}
+			// Notify that this thread is woken up
+			m_ef->setOne(m_pos + 8);
+		}
+	};
+
+	EventFlag* ef = EventFlag::create(false);
+	CHECK(ef);
+	const std::size_t numThreads = 4;
+	WaitOneBit r[numThreads];
+	Thread* t[numThreads];
+	for (std::size_t i = 0; i < numThreads; i++) {
+		r[i].init(ef, i);
+		t[i] = Thread::create(&r[i], Thread::getNormalPriority());
+		CHECK(t[i]);
+		t[i]->start();
+	}
+	Thread::sleep(10);
+
+	for (std::size_t i = numThreads; i > 0; ) {
+		--i;
+		LONGS_EQUAL(OSWrapper::OK, ef->setOne(i));
+		LONGS_EQUAL(OSWrapper::OK, ef->timedWaitOne(i + 8, Timeout(1000)));
+		t[i]->wait();
+		// The threads waiting for the other bits are still waiting
+		for (std::size_t j = 0; j < i; j++) {
+			CHECK_FALSE(ef->getCurrentPattern().test(j + 8));
+		}
+	}
+
+	for (std::size_t i = 0; i < numThreads; i++) {
+		Thread::destroy(t[i]);
+	}
+	EventFlag::destroy(ef);
+}
+
+TEST(PlatformEventFlagTest, timedWait_TimedOut_then_set)
+{
+	EventFlag* ef = EventFlag::create(false);
+	CHECK(ef);
+
+	LONGS_EQUAL(OSWrapper::OK, ef->set(EventFlag::Pattern(0x01)));
+	LONGS_EQUAL(OSWrapper::TimedOut, ef->timedWait(EventFlag::Pattern(0x03), EventFlag::AND, 0, Timeout(10)));
+
+	// The timed out waiter is not released by set()
+	LONGS_EQUAL(OSWrapper::OK, ef->set(EventFlag::Pattern(0x02)));
+	EventFlag::Pattern ptn;
+	LONGS_EQUAL(OSWrapper::OK, ef->tryWait(EventFlag::Pattern(0x03), EventFlag::AND, &ptn));
+	LONGS_EQUAL(0x03, ptn);
+
+	EventFlag::destroy(ef);
+}
+
+TEST(PlatformEventFlagTest, autoReset_each_set_releases_one_waiter)
+{
+	class WaitAnyAutoReset : public Runnable {
+	private:
+		EventFlag* m_ef;
+		EventFlag* m_done;
+	public:
+		WaitAnyAutoReset() : m_ef(0), m_done(0) {}
+		void init(EventFlag* e, EventFlag* done)
+		{
+			m_ef = e;
+			m_done = done;
+		}
+		virtual void run()
+		{
+			OSWrapper::Error err = m_ef->waitAny();
+			{
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+			}
+			m_done->setOne(0);
+		}
+	};
+
+	EventFlag* ef = EventFlag::create(true);
+	CHECK(ef);
+	EventFlag* done = EventFlag::create(true);
+	CHECK(done);
+	const std::size_t numThreads = 4;
+	WaitAnyAutoReset r[numThreads];
+	Thread* t[numThreads];
+	for (std::size_t i = 0; i < numThreads; i++) {
+		r[i].init(ef, done);
+		t[i] = Thread::create(&r[i], Thread::getNormalPriority());
+		CHECK(t[i]);
+		t[i]->start();
+	}
+	Thread::sleep(10);
+
+	for (std::size_t i = 0; i < numThreads; i++) {
+		LONGS_EQUAL(OSWrapper::OK, ef->setOne(i));
+		LONGS_EQUAL(OSWrapper::OK, done->timedWaitAny(Timeout(1000)));
+		// Only one waiter is released by one set
+		LONGS_EQUAL(OSWrapper::TimedOut, done->timedWaitAny(Timeout(10)));
+	}
+
+	for (std::size_t i = 0; i < numThreads; i++) {
+		t[i]->wait();
+		Thread::destroy(t[i]);
+	}
+	EventFlag::destroy(done);
+	EventFlag::destroy(ef);
+}
+
+TEST(PlatformEventFlagTest, AND_waiter_not_released_by_part_of_bits)
+{
+	class WaitAND : public Runnable {
+	private:
+		EventFlag* m_ef;
+		EventFlag* m_done;
+		EventFlag::Pattern m_releasedPattern;
+	public:
+		WaitAND(EventFlag* e, EventFlag* done) : m_ef(e), m_done(done), m_releasedPattern() {}
+		virtual void run()
+		{
+			OSWrapper::Error err = m_ef->wait(EventFlag::Pattern(0x03), EventFlag::AND, &m_releasedPattern);
+			{
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+			}
+			m_done->setOne(0);
+		}
+		EventFlag::Pattern getReleasedPattern() const
+		{
+			return m_releasedPattern;
+		}
+	};
+
+	EventFlag* ef = EventFlag::create(true);
+	CHECK(ef);
+	EventFlag* done = EventFlag::create(true);
+	CHECK(done);
+	WaitAND r(ef, done);
+	Thread* t = Thread::create(&r, Thread::getNormalPriority());
+	CHECK(t);
+	t->start();
+	Thread::sleep(10);
+
+	LONGS_EQUAL(OSWrapper::OK, ef->setOne(0));
+	LONGS_EQUAL(OSWrapper::TimedOut, done->timedWaitAny(Timeout(10)));
+	LONGS_EQUAL(0x01, ef->getCurrentPattern());
+
+	LONGS_EQUAL(OSWrapper::OK, ef->setOne(1));
+	LONGS_EQUAL(OSWrapper::OK, done->timedWaitAny(Timeout(1000)));
+	t->wait();
+	LONGS_EQUAL(0x03, r.getReleasedPattern());
+	// The pattern is reset by the released waiter
+	LONGS_EQUAL(0x00, ef->getCurrentPattern());
+
+	Thread::destroy(t);
+	EventFlag::destroy(done);
+	EventFlag::destroy(ef);
+}
+
+#if defined(PLATFORM_OS_STDCPP) || defined(PLATFORM_OS_POSIX)
+TEST(PlatformEventFlagTest, timedWaitAny_TimedOut_Timeout_fromMicros)
+{
+	EventFlag* ef = EventFlag::create(true);
+	CHECK(ef);
+
+	// If the timeout were rounded up to 1 ms, the waits would take 20 ms or more.
+	// The shortest of some trials is checked not to be affected by the other processes.
+	unsigned long shortest = 20;
+	for (int trial = 0; trial < 5; trial++) {
+		unsigned long start = PlatformOSWrapperTestHelper::getCurrentTime();
+		for (int i = 0; i < 20; i++) {
+			LONGS_EQUAL(OSWrapper::TimedOut, ef->timedWaitAny(Timeout::fromMicros(200)));
+		}
+		unsigned long elapsed = PlatformOSWrapperTestHelper::getCurrentTime() - start;
+		if (elapsed < shortest) {
+			shortest = elapsed;
+		}
+	}
+	CHECK(shortest < 20);
+
+	EventFlag::destroy(ef);
+}
+#endif
+
 } // namespace PlatformEventFlagTest
@@ -1,4 +1,5 @@
 #include "OSWrapper/FixedMemoryPool.h"
+#include "OSWrapper/FixedMemoryPoolCache.h"
 #include "OSWrapper/Runnable.h"
 #include "OSWrapper/Thread.h"
 #include "OSWrapper/EventFlag.h"
@@ -20,6 +21,7 @@ namespace PlatformFixedMemoryPoolTest {
 
 using OSWrapper::FixedMemoryPool;
 using OSWrapper::FixedMemoryPoolFactory;
+using OSWrapper::FixedMemoryPoolCache;
 using OSWrapper::Timeout;
 using OSWrapper::Runnable;
 using OSWrapper::Thread;
@@ -408,6 +410,83 @@ TEST(PlatformFixedMemoryPoolTest, allocateMemory_allocate_by_multi_threads)
 	FixedMemoryPool::destroy(pool);
 }
 
+TEST(PlatformFixedMemoryPoolTest, allocateMemory_deallocate_by_multi_threads)
+{
+	// Each thread owns the blocks it allocated, so the pattern written by the thread must not be changed
+	class AllocFreeRunnable : public Runnable {
+	private:
+		FixedMemoryPool* m_pool;
+		const unsigned char m_pattern;
+		bool m_ok;
+	public:
+		AllocFreeRunnable(FixedMemoryPool* pool, unsigned char pattern)
+			: m_pool(pool), m_pattern(pattern), m_ok(true)
+		{}
+		bool isOk() const { return m_ok; }
+		void run()
+		{
+			const std::size_t blockSize = m_pool->getBlockSize();
+			for (int i = 0; i < 10000; i++) {
+				void* p[2] = {0, 0};
+				for (int j = 0; j < 2; j++) {
+					if (m_pool->allocateMemory(&p[j]) != OSWrapper::OK) {
+						m_ok = false;
+						return;
+					}
+					std::memset(p[j], m_pattern, blockSize);
+				}
+				for (int j = 0; j < 2; j++) {
+					const unsigned char* c = static_cast<const unsigned char*>(p[j]);
+					if ((c[0] != m_pattern) || (c[blockSize - 1] != m_pattern)) {
+						m_ok = false;
+					}
+					m_pool->deallocate(p[j]);
+				}
+			}
+		}
+	};
+
+	const std::size_t blockSize = 16;
+	const std::size_t maxBlocks = 7;
+	FixedMemoryPool* pool = FixedMemoryPool::create(blockSize, FixedMemoryPool::getRequiredMemorySize(blockSize, maxBlocks));
+	CHECK(pool);
+
+	// 4 threads need up to 8 blocks, so some of them wait for the blocks deallocated by the others
+	AllocFreeRunnable runnable1(pool, 0x11);
+	AllocFreeRunnable runnable2(pool, 0x22);
+	AllocFreeRunnable runnable3(pool, 0x33);
+	AllocFreeRunnable runnable4(pool, 0x44);
+	Thread* thread1 = Thread::create(&runnable1);
+	Thread* thread2 = Thread::create(&runnable2);
+	Thread* thread3 = Thread::create(&runnable3);
+	Thread* thread4 = Thread::create(&runnable4);
+	CHECK(thread1);
+	CHECK(thread2);
+	CHECK(thread3);
+	CHECK(thread4);
+
+	thread1->start();
+	thread2->start();
+	thread3->start();
+	thread4->start();
+	thread1->wait();
+	thread2->wait();
+	thread3->wait();
+	thread4->wait();
+
+	CHECK(runnable1.isOk());
+	CHECK(runnable2.isOk());
+	CHECK(runnable3.isOk());
+	CHECK(runnable4.isOk());
+	LONGS_EQUAL(maxBlocks, pool->getNumberOfAvailableBlocks());
+
+	Thread::destroy(thread1);
+	Thread::destroy(thread2);
+	Thread::destroy(thread3);
+	Thread::destroy(thread4);
+	FixedMemoryPool::destroy(pool);
+}
+
 TEST(PlatformFixedMemoryPoolTest, tryAllocateMemory)
 {
 	double poolBuf[100];
@@ -559,6 +638,45 @@ TEST(PlatformFixedMemoryPoolTest, tryAllocateMemory_timeout_by_use_max)
 	FixedMemoryPool::destroy(pool);
 }
 
+TEST(PlatformFixedMemoryPoolTest, tryAllocateMemory_deallocate_in_any_order)
+{
+	const std::size_t blockSize = 16;
+	const std::size_t maxBlocks = 100;
+	FixedMemoryPool* pool = FixedMemoryPool::create(blockSize, FixedMemoryPool::getRequiredMemorySize(blockSize, maxBlocks));
+	CHECK(pool);
+
+	std::vector<void*> blocks(maxBlocks);
+	for (std::size_t i = 0; i < maxBlocks; i++) {
+		LONGS_EQUAL(OSWrapper::OK, pool->tryAllocateMemory(&blocks[i]));
+	}
+
+	// Odd blocks from the last, then even blocks from the first
+	for (std::size_t i = maxBlocks - 1; i < maxBlocks; i -= 2) {
+		pool->deallocate(blocks[i]);
+	}
+	LONGS_EQUAL(maxBlocks / 2, pool->getNumberOfAvailableBlocks());
+	for (std::size_t i = 0; i < maxBlocks; i += 2) {
+		pool->deallocate(blocks[i]);
+	}
+	LONGS_EQUAL(maxBlocks, pool->getNumberOfAvailableBlocks());
+
+	// All the blocks can be allocated again and they are different
+	for (std::size_t i = 0; i < maxBlocks; i++) {
+		LONGS_EQUAL(OSWrapper::OK, pool->tryAllocateMemory(&blocks[i]));
+		std::memset(blocks[i], static_cast<int>(i), blockSize);
+	}
+	for (std::size_t i = 0; i < maxBlocks; i++) {
+		LONGS_EQUAL(static_cast<unsigned char>(i), *static_cast<unsigned char*>(blocks[i]));
+	}
+	void* q = 0;
+	LONGS_EQUAL(OSWrapper::TimedOut, pool->tryAllocateMemory(&q));
+
+	for (std::size_t i = 0; i < maxBlocks; i++) {
+		pool->deallocate(blocks[i]);
+	}
+	FixedMemoryPool::destroy(pool);
+}
+
 TEST(PlatformFixedMemoryPoolTest, timedAllocateMemory)
 {
 	double poolBuf[100];
@@ -741,4 +859,79 @@ TEST(PlatformFixedMemoryPoolTest, timedAllocateMemory_timeout_by_use_max)
 	FixedMemoryPool::destroy(pool);
 }
 
+TEST(PlatformFixedMemoryPoolTest, FixedMemoryPoolCache_blocks_deallocated_by_consumer)
+{
+	class SendRunnable : public Runnable {
+	private:
+		FixedMemoryPool* m_pool;
+		MessageQueue<void*>* m_mq;
+		const std::size_t m_num;
+	public:
+		SendRunnable(FixedMemoryPool* pool, MessageQueue<void*>* mq, std::size_t num)
+			: m_pool(pool), m_mq(mq), m_num(num)
+		{}
+		void run()
+		{
+			for (std::size_t i = 0; i < m_num; i++) {
+				void* p = 0;
+				OSWrapper::Error err = m_pool->timedAllocateMemory(&p, Timeout(1000));
+				LONGS_EQUAL(OSWrapper::OK, err);
+				err = m_mq->send(p);
+				LONGS_EQUAL(OSWrapper::OK, err);
+			}
+		}
+	};
+	class RecvRunnable : public Runnable {
+	private:
+		FixedMemoryPool* m_pool;
+		MessageQueue<void*>* m_mq;
+		const std::size_t m_num;
+	public:
+		RecvRunnable(FixedMemoryPool* pool, MessageQueue<void*>* mq, std::size_t num)
+			: m_pool(pool), m_mq(mq), m_num(num)
+		{}
+		void run()
+		{
+			for (std::size_t i = 0; i < m_num; i++) {
+				void* p = 0;
+				OSWrapper::Error err = m_mq->timedReceive(&p, Timeout(1000));
+				LONGS_EQUAL(OSWrapper::OK, err);
+				m_pool->deallocate(p);
+			}
+		}
+	};
+
+	// The caches can keep more blocks than the pool has, so the consumer's cache may keep all of them
+	const std::size_t blockSize = 16;
+	const std::size_t maxBlocks = 4;
+	const std::size_t numMessages = 1000;
+	FixedMemoryPool* pool = FixedMemoryPool::create(blockSize, FixedMemoryPool::getRequiredMemorySize(blockSize, maxBlocks));
+	CHECK(pool);
+	MessageQueue<void*>* mq = MessageQueue<void*>::create(maxBlocks);
+	CHECK(mq);
+	{
+		FixedMemoryPoolCache<8> cache(pool);
+		SendRunnable sender(&cache, mq, numMessages);
+		RecvRunnable receiver(&cache, mq, numMessages);
+		Thread* sendThread = Thread::create(&sender);
+		Thread* recvThread = Thread::create(&receiver);
+		CHECK(sendThread);
+		CHECK(recvThread);
+
+		sendThread->start();
+		recvThread->start();
+		sendThread->wait();
+		recvThread->wait();
+
+		LONGS_EQUAL(maxBlocks, cache.getNumberOfAvailableBlocks());
+
+		Thread::destroy(recvThread);
+		Thread::destroy(sendThread);
+	}
+	LONGS_EQUAL(maxBlocks, pool->getNumberOfAvailableBlocks());
+
+	MessageQueue<void*>::destroy(mq);
+	FixedMemoryPool::destroy(pool);
+}
+
 } // namespace PlatformFixedMemoryPoolTest
@@ -0,0 +1,287 @@
+#include "OSWrapper/Runnable.h"
+#include "OSWrapper/Thread.h"
+#include "OSWrapper/EventFlag.h"
+#include "OSWrapper/ThreadPool.h"
+#include "OSWrapper/Future.h"
+#include <stdexcept>
+
+#include "PlatformOSWrapperTestHelper.h"
+
+#include "CppUTest/TestHarness.h"
+
+namespace PlatformFutureTest {
+
+using OSWrapper::Thread;
+using OSWrapper::EventFlag;
+using OSWrapper::ThreadPool;
+using OSWrapper::Callable;
+using OSWrapper::Continuation;
+using OSWrapper::FutureBase;
+using OSWrapper::Future;
+
+class NullExceptionHandler : public Thread::UncaughtExceptionHandler {
+public:
+	void handle(Thread*, const char*) {}
+};
+
+TEST_GROUP(PlatformFutureTest) {
+	ThreadPool* pool;
+	NullExceptionHandler handler;
+
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+		pool = ThreadPool::createQueued(2, 8, ThreadPool::BLOCK, 4096);
+		CHECK(pool);
+		pool->setUncaughtExceptionHandler(&handler);
+	}
+	void teardown()
+	{
+		ThreadPool::destroy(pool);
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+	}
+};
+
+class SquareCallable : public Callable<int> {
+	int m_input;
+	EventFlag* m_ev;
+public:
+	explicit SquareCallable(int input, EventFlag* ev = 0) : m_input(input), m_ev(ev) {}
+protected:
+	int call()
+	{
+		if (m_ev != 0) {
+			m_ev->waitAny();
+		}
+		return m_input * m_input;
+	}
+};
+
+class PlusContinuation : public Continuation<int, int> {
+	int m_addend;
+public:
+	explicit PlusContinuation(int addend) : m_addend(addend) {}
+protected:
+	int continueWith(const int& input)
+	{
+		return input + m_addend;
+	}
+};
+
+class HalfContinuation : public Continuation<int, double> {
+protected:
+	double continueWith(const int& input)
+	{
+		return input / 2.0;
+	}
+};
+
+TEST(PlatformFutureTest, async_get)
+{
+	SquareCallable task(3);
+	Future<int> future;
+	CHECK(!future.isValid());
+	LONGS_EQUAL(OSWrapper::OK, OSWrapper::async(pool, &task, &future));
+	CHECK(future.isValid());
+
+	int value = 0;
+	LONGS_EQUAL(OSWrapper::OK, future.get(&value));
+	LONGS_EQUAL(9, value);
+
+	// The result can be got again
+	value = 0;
+	LONGS_EQUAL(OSWrapper::OK, future.get(&value));
+	LONGS_EQUAL(9, value);
+
+	future.release();
+	CHECK(!future.isValid());
+}
+
+TEST(PlatformFutureTest, async_invalid_parameter)
+{
+	SquareCallable task(3);
+	Future<int> future;
+	int value = 0;
+	LONGS_EQUAL(OSWrapper::InvalidParameter, future.get(&value));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::async(static_cast<ThreadPool*>(0), &task, &future));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::async(pool, static_cast<Callable<int>*>(0), &future));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::async(pool, &task, static_cast<Future<int>*>(0)));
+
+	LONGS_EQUAL(OSWrapper::OK, OSWrapper::async(pool, &task, &future));
+	// future is already valid
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::async(pool, &task, &future));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, future.get(static_cast<int*>(0)));
+}
+
+TEST(PlatformFutureTest, then_chain)
+{
+	EventFlag* ev = EventFlag::create(false);
+	CHECK(ev);
+	SquareCallable task(4, ev);
+	PlusContinuation plus(1);
+	HalfContinuation half;
+	{
+		Future<int> future1;
+		Future<int> future2;
+		Future<double> future3;
+		LONGS_EQUAL(OSWrapper::OK, OSWrapper::async(pool, &task, &future1));
+		LONGS_EQUAL(OSWrapper::OK, OSWrapper::then(pool, &future1, &plus, &future2));
+		LONGS_EQUAL(OSWrapper::OK, OSWrapper::then(pool, &future2, &half, &future3));
+		LONGS_EQUAL(OSWrapper::TimedOut, future3.tryWait());
+
+		ev->setAll();
+		double value = 0.0;
+		LONGS_EQUAL(OSWrapper::OK, future3.get(&value));
+		DOUBLES_EQUAL(8.5, value, 0.0);
+		int value2 = 0;
+		LONGS_EQUAL(OSWrapper::OK, future2.get(&value2));
+		LONGS_EQUAL(17, value2);
+	}
+	EventFlag::destroy(ev);
+}
+
+TEST(PlatformFutureTest, then_after_finished)
+{
+	SquareCallable task(5);
+	PlusContinuation plus(2);
+	Future<int> future1;
+	Future<int> future2;
+	LONGS_EQUAL(OSWrapper::OK, OSWrapper::async(pool, &task, &future1));
+	LONGS_EQUAL(OSWrapper::OK, future1.wait());
+	LONGS_EQUAL(OSWrapper::OK, OSWrapper::then(pool, &future1, &plus, &future2));
+
+	int value = 0;
+	LONGS_EQUAL(OSWrapper::OK, future2.get(&value));
+	LONGS_EQUAL(27, value);
+}
+
+class SumCallable : public Callable<int> {
+	Future<int>* m_a;
+	Future<int>* m_b;
+public:
+	SumCallable(Future<int>* a, Future<int>* b) : m_a(a), m_b(b) {}
+protected:
+	int call()
+	{
+		int a = 0;
+		int b = 0;
+		m_a->get(&a);
+		m_b->get(&b);
+		return a + b;
+	}
+};
+
+TEST(PlatformFutureTest, whenAll)
+{
+	EventFlag* ev = EventFlag::create(false);
+	CHECK(ev);
+	SquareCallable task1(2, ev);
+	SquareCallable task2(3, ev);
+	{
+		Future<int> future1;
+		Future<int> future2;
+		Future<int> future3;
+		SumCallable sum(&future1, &future2);
+		LONGS_EQUAL(OSWrapper::OK, OSWrapper::async(pool, &task1, &future1));
+		LONGS_EQUAL(OSWrapper::OK, OSWrapper::async(pool, &task2, &future2));
+		FutureBase* inputs[] = {&future1, &future2};
+		LONGS_EQUAL(OSWrapper::OK, OSWrapper::whenAll(pool, inputs, 2, &sum, &future3));
+		LONGS_EQUAL(OSWrapper::TimedOut, future3.tryWait());
+
+		ev->setAll();
+		int value = 0;
+		LONGS_EQUAL(OSWrapper::OK, future3.get(&value));
+		LONGS_EQUAL(13, value);
+	}
+	EventFlag::destroy(ev);
+}
+
+class FirstCallable : public Callable<int> {
+	Future<int>* m_a;
+	Future<int>* m_b;
+public:
+	FirstCallable(Future<int>* a, Future<int>* b) : m_a(a), m_b(b) {}
+protected:
+	int call()
+	{
+		int value = 0;
+		if (m_a->tryWait() == OSWrapper::OK) {
+			m_a->get(&value);
+		} else {
+			m_b->get(&value);
+		}
+		return value;
+	}
+};
+
+TEST(PlatformFutureTest, whenAny)
+{
+	EventFlag* ev1 = EventFlag::create(false);
+	CHECK(ev1);
+	EventFlag* ev2 = EventFlag::create(false);
+	CHECK(ev2);
+	SquareCallable task1(2, ev1);
+	SquareCallable task2(3, ev2);
+	{
+		Future<int> future1;
+		Future<int> future2;
+		Future<int> future3;
+		FirstCallable first(&future1, &future2);
+		LONGS_EQUAL(OSWrapper::OK, OSWrapper::async(pool, &task1, &future1));
+		LONGS_EQUAL(OSWrapper::OK, OSWrapper::async(pool, &task2, &future2));
+		FutureBase* inputs[] = {&future1, &future2};
+		LONGS_EQUAL(OSWrapper::OK, OSWrapper::whenAny(pool, inputs, 2, &first, &future3));
+
+		ev2->setAll();
+		int value = 0;
+		LONGS_EQUAL(OSWrapper::OK, future3.get(&value));
+		LONGS_EQUAL(9, value);
+		ev1->setAll();
+	}
+	EventFlag::destroy(ev2);
+	EventFlag::destroy(ev1);
+}
+
+TEST(PlatformFutureTest, whenAll_invalid_parameter)
+{
+	SquareCallable task(2);
+	Future<int> future1;
+	Future<int> future2;
+	FutureBase* inputs[FutureBase::MAX_INPUTS + 1U] = {0};
+	for (std::size_t i = 0U; i < FutureBase::MAX_INPUTS + 1U; i++) {
+		inputs[i] = &future1;
+	}
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::whenAll(pool, inputs, 0, &task, &future2));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::whenAll(pool, inputs, FutureBase::MAX_INPUTS + 1U, &task, &future2));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::whenAny(pool, static_cast<FutureBase* const*>(0), 1, &task, &future2));
+	inputs[0] = 0;
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::whenAny(pool, inputs, 1, &task, &future2));
+	CHECK(!future2.isValid());
+}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+class ThrowingCallable : public Callable<int> {
+protected:
+	int call()
+	{
+		throw std::runtime_error("error");
+	}
+};
+
+TEST(PlatformFutureTest, exception_no_result)
+{
+	ThrowingCallable task;
+	PlusContinuation plus(1);
+	Future<int> future1;
+	Future<int> future2;
+	LONGS_EQUAL(OSWrapper::OK, OSWrapper::async(pool, &task, &future1));
+	LONGS_EQUAL(OSWrapper::OK, OSWrapper::then(pool, &future1, &plus, &future2));
+
+	int value = 0;
+	LONGS_EQUAL(OSWrapper::OtherError, future2.get(&value));
+	LONGS_EQUAL(OSWrapper::OtherError, future1.get(&value));
+	LONGS_EQUAL(0, value);
+}
+#endif
+
+} // namespace PlatformFutureTest
@@ -6,6 +6,9 @@
 #include "OSWrapper/FixedMemoryPool.h"
 #include "Assertion/Assertion.h"
 #include <exception>
+#if (__cplusplus >= 201103L)
+#include <memory>
+#endif
 
 #include "PlatformOSWrapperTestHelper.h"
 
@@ -334,6 +337,376 @@ TEST(PlatformMessageQueueTest, send_receive_many_threads)
 	LONGS_EQUAL(num * SIZE, recv_count);
 }
 
+TEST(PlatformMessageQueueTest, sendN_receiveN_InvalidParameter)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	int data[SIZE] = {0};
+	std::size_t num = 100;
+	LONGS_EQUAL(OSWrapper::InvalidParameter, mq->trySendN(0, SIZE, &num));
+	LONGS_EQUAL(0, num);
+	LONGS_EQUAL(OSWrapper::InvalidParameter, mq->trySendN(data, 0, &num));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, mq->tryReceiveN(0, SIZE, &num));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, mq->tryReceiveN(data, 0, &num));
+	LONGS_EQUAL(0, num);
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformMessageQueueTest, trySendN_tryReceiveN)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	int sendData[SIZE + 3];
+	for (std::size_t i = 0; i < SIZE + 3; i++) {
+		sendData[i] = int(i);
+	}
+	std::size_t num = 0;
+
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->tryReceiveN(sendData, SIZE, &num));
+	LONGS_EQUAL(0, num);
+
+	LONGS_EQUAL(OSWrapper::OK, mq->trySendN(sendData, 4, &num));
+	LONGS_EQUAL(4, num);
+	LONGS_EQUAL(4, mq->getSize());
+
+	LONGS_EQUAL(OSWrapper::OK, mq->trySendN(&sendData[4], SIZE, &num));
+	LONGS_EQUAL(SIZE - 4, num);
+	LONGS_EQUAL(SIZE, mq->getSize());
+
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->trySendN(sendData, 1, &num));
+	LONGS_EQUAL(0, num);
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->timedSendN(sendData, 1, 0, Timeout(10)));
+
+	int recvData[SIZE + 3] = {0};
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceiveN(recvData, 3, &num));
+	LONGS_EQUAL(3, num);
+	LONGS_EQUAL(SIZE - 3, mq->getSize());
+
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceiveN(&recvData[3], SIZE + 3, 0));
+	LONGS_EQUAL(0, mq->getSize());
+	for (std::size_t i = 0; i < SIZE; i++) {
+		LONGS_EQUAL(i, recvData[i]);
+	}
+	LONGS_EQUAL(0, recvData[SIZE]);
+
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->timedReceiveN(recvData, 1, &num, Timeout(10)));
+	LONGS_EQUAL(0, num);
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformMessageQueueTest, sendN_receiveN_many_msgs)
+{
+	static const int num = SIZE + 1000;
+	class Sender : public BaseRunnable {
+	public:
+		Sender(IntMQ* mq) : BaseRunnable(mq) {}
+		virtual void run()
+		{
+			int data[7];
+			int i = 0;
+			while (i < num) {
+				std::size_t n = 0;
+				for (; (n < 7) && (i + int(n) < num); n++) {
+					data[n] = i + int(n);
+				}
+				std::size_t sent = 0;
+				OSWrapper::Error err = m_mq->sendN(data, n, &sent);
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+				CHECK((0 < sent) && (sent <= n));
+				i += int(sent);
+			}
+		}
+	};
+
+	class Receiver : public BaseRunnable {
+	public:
+		Receiver(IntMQ* mq) : BaseRunnable(mq) {}
+		virtual void run()
+		{
+			int data[5];
+			int i = 0;
+			while (i < num) {
+				std::size_t received = 0;
+				OSWrapper::Error err = m_mq->receiveN(data, 5, &received);
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+				CHECK((0 < received) && (received <= 5));
+				for (std::size_t n = 0; n < received; n++) {
+					LONGS_EQUAL(i, data[n]);
+					i++;
+				}
+			}
+		}
+	};
+	testTwoThreadsSharingOneMQ<Sender, Receiver, IntMQ>();
+}
+
+TEST(PlatformMessageQueueTest, reserveSend_peekReceive_InvalidParameter)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(OSWrapper::InvalidParameter, mq->tryReserveSend(0));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, mq->tryPeekReceive(0));
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformMessageQueueTest, commitSend_cancelSend_releaseReceive_NotLocked)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(OSWrapper::NotLocked, mq->commitSend());
+	LONGS_EQUAL(OSWrapper::NotLocked, mq->cancelSend());
+	LONGS_EQUAL(OSWrapper::NotLocked, mq->releaseReceive());
+	LONGS_EQUAL(0, mq->getSize());
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformMessageQueueTest, tryReserveSend_commitSend_tryPeekReceive_releaseReceive)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	int* msg = 0;
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->tryPeekReceive(&msg));
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->timedPeekReceive(&msg, Timeout(10)));
+
+	for (std::size_t i = 0; i < SIZE; i++) {
+		int* slot = 0;
+		LONGS_EQUAL(OSWrapper::OK, mq->tryReserveSend(&slot));
+		CHECK(slot);
+		LONGS_EQUAL(i, mq->getSize());
+		new(slot) int(int(i));
+		LONGS_EQUAL(OSWrapper::OK, mq->commitSend());
+		LONGS_EQUAL(i + 1, mq->getSize());
+	}
+	int* slot = 0;
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->tryReserveSend(&slot));
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->timedReserveSend(&slot, Timeout(10)));
+	LONGS_EQUAL(OSWrapper::NotLocked, mq->commitSend());
+
+	for (std::size_t i = 0; i < SIZE; i++) {
+		LONGS_EQUAL(OSWrapper::OK, mq->tryPeekReceive(&msg));
+		LONGS_EQUAL(i, *msg);
+		LONGS_EQUAL(SIZE - i, mq->getSize());
+		LONGS_EQUAL(OSWrapper::OK, mq->releaseReceive());
+		LONGS_EQUAL(SIZE - i - 1, mq->getSize());
+	}
+	LONGS_EQUAL(OSWrapper::NotLocked, mq->releaseReceive());
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformMessageQueueTest, tryReserveSend_cancelSend)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	int* slot = 0;
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReserveSend(&slot));
+	LONGS_EQUAL(OSWrapper::OK, mq->cancelSend());
+	LONGS_EQUAL(0, mq->getSize());
+
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend(100));
+	LONGS_EQUAL(1, mq->getSize());
+	int data = 0;
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(&data));
+	LONGS_EQUAL(100, data);
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformMessageQueueTest, send_receive_OtherError_while_reserved_or_peeked)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	int data[2] = {1, 2};
+	std::size_t num = 0;
+	int* slot = 0;
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReserveSend(&slot));
+	LONGS_EQUAL(OSWrapper::OtherError, mq->trySend(100));
+	LONGS_EQUAL(OSWrapper::OtherError, mq->trySendN(data, 2, &num));
+	LONGS_EQUAL(OSWrapper::OtherError, mq->tryReserveSend(&slot));
+	LONGS_EQUAL(0, mq->getSize());
+	new(slot) int(100);
+	LONGS_EQUAL(OSWrapper::OK, mq->commitSend());
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend(200));
+	LONGS_EQUAL(2, mq->getSize());
+
+	int* msg = 0;
+	LONGS_EQUAL(OSWrapper::OK, mq->tryPeekReceive(&msg));
+	LONGS_EQUAL(100, *msg);
+	LONGS_EQUAL(OSWrapper::OtherError, mq->tryReceive(&data[0]));
+	LONGS_EQUAL(OSWrapper::OtherError, mq->tryReceiveN(data, 2, &num));
+	LONGS_EQUAL(OSWrapper::OtherError, mq->tryPeekReceive(&msg));
+	LONGS_EQUAL(2, mq->getSize());
+	LONGS_EQUAL(OSWrapper::OK, mq->releaseReceive());
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(&data[0]));
+	LONGS_EQUAL(200, data[0]);
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformMessageQueueTest, commitSend_releaseReceive_NotLocked_by_another_thread)
+{
+	class Releaser : public BaseRunnable {
+	public:
+		OSWrapper::Error m_commitErr;
+		OSWrapper::Error m_cancelErr;
+		OSWrapper::Error m_releaseErr;
+		Releaser(IntMQ* mq) : BaseRunnable(mq), m_commitErr(OSWrapper::OK), m_cancelErr(OSWrapper::OK), m_releaseErr(OSWrapper::OK) {}
+		virtual void run()
+		{
+			m_commitErr = m_mq->commitSend();
+			m_cancelErr = m_mq->cancelSend();
+			m_releaseErr = m_mq->releaseReceive();
+		}
+	};
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	Releaser releaser(mq);
+	Thread* thread = Thread::create(&releaser, Thread::getNormalPriority());
+	CHECK(thread);
+
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend(100));
+	int* slot = 0;
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReserveSend(&slot));
+	int* msg = 0;
+	LONGS_EQUAL(OSWrapper::OK, mq->tryPeekReceive(&msg));
+	thread->start();
+	thread->wait();
+	LONGS_EQUAL(OSWrapper::NotLocked, releaser.m_commitErr);
+	LONGS_EQUAL(OSWrapper::NotLocked, releaser.m_cancelErr);
+	LONGS_EQUAL(OSWrapper::NotLocked, releaser.m_releaseErr);
+	LONGS_EQUAL(1, mq->getSize());
+
+	new(slot) int(200);
+	LONGS_EQUAL(OSWrapper::OK, mq->commitSend());
+	LONGS_EQUAL(OSWrapper::OK, mq->releaseReceive());
+	LONGS_EQUAL(1, mq->getSize());
+	int data = 0;
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(&data));
+	LONGS_EQUAL(200, data);
+
+	Thread::destroy(thread);
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformMessageQueueTest, reserveSend_peekReceive_many_msgs)
+{
+	struct Record {
+		int seq;
+		unsigned char payload[4096];
+	};
+	typedef MessageQueue<Record> RecordMQ;
+	static const int num = SIZE + 1000;
+
+	class Sender : public Runnable {
+	private:
+		RecordMQ* m_mq;
+	public:
+		Sender(RecordMQ* mq) : m_mq(mq) {}
+		virtual void run()
+		{
+			for (int i = 0; i < num; i++) {
+				Record* slot = 0;
+				OSWrapper::Error err = m_mq->reserveSend(&slot);
+				{
+					LockGuard lock(s_mutex);
+					LONGS_EQUAL(OSWrapper::OK, err);
+				}
+				Record* rec = new(slot) Record();
+				rec->seq = i;
+				rec->payload[sizeof rec->payload - 1] = static_cast<unsigned char>(i);
+				err = m_mq->commitSend();
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+			}
+		}
+	};
+
+	class Receiver : public Runnable {
+	private:
+		RecordMQ* m_mq;
+	public:
+		Receiver(RecordMQ* mq) : m_mq(mq) {}
+		virtual void run()
+		{
+			for (int i = 0; i < num; i++) {
+				Record* rec = 0;
+				OSWrapper::Error err = m_mq->peekReceive(&rec);
+				{
+					LockGuard lock(s_mutex);
+					LONGS_EQUAL(OSWrapper::OK, err);
+					LONGS_EQUAL(i, rec->seq);
+					LONGS_EQUAL(static_cast<unsigned char>(i), rec->payload[sizeof rec->payload - 1]);
+				}
+				err = m_mq->releaseReceive();
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+			}
+		}
+	};
+	testTwoThreadsSharingOneMQ<Sender, Receiver, RecordMQ>();
+}
+
+#if (__cplusplus >= 201103L)
+TEST(PlatformMessageQueueTest, send_receive_unique_ptr)
+{
+	typedef MessageQueue<std::unique_ptr<int> > PtrMQ;
+	PtrMQ* mq = PtrMQ::create(3);
+	CHECK(mq);
+
+	std::unique_ptr<int> p(new int(1));
+	LONGS_EQUAL(OSWrapper::OK, mq->send(std::move(p)));
+	CHECK(p == nullptr);
+	LONGS_EQUAL(OSWrapper::OK, mq->emplaceSend(new int(2)));
+	LONGS_EQUAL(OSWrapper::OK, mq->tryEmplaceSend(new int(3)));
+	LONGS_EQUAL(3, mq->getSize());
+
+	p.reset(new int(4));
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->trySend(std::move(p)));
+	LONGS_EQUAL(OSWrapper::TimedOut, mq->timedSend(std::move(p), Timeout(10)));
+	CHECK(p != nullptr);
+	LONGS_EQUAL(4, *p);
+
+	for (int i = 1; i <= 3; i++) {
+		std::unique_ptr<int> q;
+		LONGS_EQUAL(OSWrapper::OK, mq->receive(&q));
+		CHECK(q != nullptr);
+		LONGS_EQUAL(i, *q);
+	}
+	LONGS_EQUAL(0, mq->getSize());
+	PtrMQ::destroy(mq);
+}
+
+struct Msg {
+	static int copied;
+	int data;
+	explicit Msg(int d = 0) : data(d) {}
+	Msg(const Msg& x) : data(x.data) { copied++; }
+	Msg(Msg&& x) noexcept : data(x.data) { x.data = -1; }
+	Msg& operator=(const Msg& x) { data = x.data; copied++; return *this; }
+	Msg& operator=(Msg&& x) noexcept { data = x.data; x.data = -1; return *this; }
+};
+int Msg::copied = 0;
+
+TEST(PlatformMessageQueueTest, send_receive_without_copy)
+{
+	Msg::copied = 0;
+
+	MessageQueue<Msg>* mq = MessageQueue<Msg>::create(SIZE);
+	CHECK(mq);
+	Msg a(10);
+	LONGS_EQUAL(OSWrapper::OK, mq->trySend(std::move(a)));
+	LONGS_EQUAL(-1, a.data);
+	LONGS_EQUAL(OSWrapper::OK, mq->timedEmplaceSend(Timeout(10), 20));
+
+	Msg b;
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(&b));
+	LONGS_EQUAL(10, b.data);
+	LONGS_EQUAL(OSWrapper::OK, mq->tryReceive(&b));
+	LONGS_EQUAL(20, b.data);
+	LONGS_EQUAL(0, Msg::copied);
+	MessageQueue<Msg>::destroy(mq);
+}
+#endif
+
 #ifndef CPPELIB_NO_EXCEPTIONS
 struct Elem {
 	unsigned int data;
@@ -388,6 +761,30 @@ TEST(PlatformMessageQueueTest, send_receive_std_exception)
 	MessageQueue<Elem>::destroy(mq);
 }
 
+TEST(PlatformMessageQueueTest, sendN_receiveN_std_exception)
+{
+	MessageQueue<Elem>* mq = MessageQueue<Elem>::create(SIZE);
+	CHECK(mq);
+	Elem a[3];
+	a[2].data = Elem::STD_EXCEPTION_DATA;
+
+	std::size_t num = 0;
+	OSWrapper::Error err;
+	err = mq->sendN(a, 3, &num);
+	LONGS_EQUAL(OSWrapper::OtherError, err);
+	LONGS_EQUAL(2, num);
+	LONGS_EQUAL(2, mq->getSize());
+
+	Elem b[3];
+	b[1].data = Elem::STD_EXCEPTION_DATA;
+	err = mq->receiveN(b, 3, &num);
+	LONGS_EQUAL(OSWrapper::OtherError, err);
+	LONGS_EQUAL(1, num);
+	LONGS_EQUAL(1, mq->getSize());
+
+	MessageQueue<Elem>::destroy(mq);
+}
+
 TEST(PlatformMessageQueueTest, send_receive_assertion_failure)
 {
 	MessageQueue<Elem>* mq = MessageQueue<Elem>::create(SIZE);
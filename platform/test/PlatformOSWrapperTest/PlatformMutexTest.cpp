@@ -3,6 +3,9 @@
 #include "OSWrapper/Mutex.h"
 
 #include "PlatformOSWrapperTestHelper.h"
+#if defined(PLATFORM_OS_POSIX)
+#include "PosixOSWrapper/PosixMutexFactory.h"
+#endif
 
 #include "CppUTest/TestHarness.h"
 #include "CppUTestExt/MockSupport.h"
@@ -285,4 +288,188 @@ TEST(PlatformMutexTest, LockGuard_ADOPT_LOCK)
 	}
 }
 
+class CountUpTestRunnable : public Runnable {
+public:
+	static Mutex* mutex;
+	static int count;
+	static const int NUM_LOOPS = 10000;
+
+	void run()
+	{
+		for (int i = 0; i < NUM_LOOPS; i++) {
+			LockGuard lock(mutex);
+			count++;
+		}
+	}
+
+	static void test(Mutex* m)
+	{
+		mutex = m;
+		count = 0;
+		const int num = 4;
+		CountUpTestRunnable runnable[num];
+		Thread* t[num];
+		for (int i = 0; i < num; i++) {
+			t[i] = Thread::create(&runnable[i], Thread::getNormalPriority());
+			CHECK(t[i]);
+		}
+		for (int i = 0; i < num; i++) {
+			t[i]->start();
+		}
+		for (int i = 0; i < num; i++) {
+			t[i]->wait();
+			Thread::destroy(t[i]);
+		}
+		LONGS_EQUAL(num * NUM_LOOPS, count);
+	}
+};
+Mutex* CountUpTestRunnable::mutex;
+int CountUpTestRunnable::count;
+
+TEST(PlatformMutexTest, shared_data_lock_count_up)
+{
+	CountUpTestRunnable::test(s_mutex);
+}
+
+TEST(PlatformMutexTest, createNonRecursive)
+{
+	Mutex* mutex = Mutex::createNonRecursive();
+	CHECK(mutex);
+
+	LONGS_EQUAL(OSWrapper::OK, mutex->lock());
+	LONGS_EQUAL(OSWrapper::OK, mutex->unlock());
+	LONGS_EQUAL(OSWrapper::OK, mutex->tryLock());
+	LONGS_EQUAL(OSWrapper::OK, mutex->unlock());
+	LONGS_EQUAL(OSWrapper::OK, mutex->timedLock(Timeout(10)));
+	LONGS_EQUAL(OSWrapper::OK, mutex->unlock());
+	LONGS_EQUAL(OSWrapper::NotLocked, mutex->unlock());
+
+	CountUpTestRunnable::test(mutex);
+
+	Mutex::destroy(mutex);
+}
+
+#if defined(PLATFORM_OS_POSIX)
+TEST_GROUP(PlatformAdaptiveMutexTest) {
+	PosixOSWrapper::PosixMutexFactory* adaptiveFactory;
+
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+		adaptiveFactory = new PosixOSWrapper::PosixMutexFactory(true);
+		OSWrapper::registerMutexFactory(adaptiveFactory);
+		s_mutex = Mutex::create();
+		CHECK(s_mutex);
+	}
+	void teardown()
+	{
+		OSWrapper::Error err = s_mutex->unlock();
+		LONGS_EQUAL(OSWrapper::NotLocked, err);
+
+		Mutex::destroy(s_mutex);
+		delete adaptiveFactory;
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+
+		mock().checkExpectations();
+		mock().clear();
+	}
+};
+
+TEST(PlatformAdaptiveMutexTest, lock_unlock_recursive)
+{
+	OSWrapper::Error err;
+	err = s_mutex->lock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_mutex->tryLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_mutex->timedLock(Timeout(10));
+	LONGS_EQUAL(OSWrapper::OK, err);
+
+	err = s_mutex->unlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_mutex->unlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_mutex->unlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+}
+
+TEST(PlatformAdaptiveMutexTest, shared_data_lock)
+{
+	FibonacciTestRunnable::init();
+	const int num = 10;
+	FibonacciTestRunnable runnable[num];
+
+	Thread* t[num];
+	for (int i = 0; i < num; i++) {
+		t[i] = Thread::create(&runnable[i], Thread::getNormalPriority());
+		CHECK(t[i]);
+	}
+	for (int i = 0; i < num; i++) {
+		t[i]->start();
+	}
+	for (int i = 0; i < num; i++) {
+		t[i]->wait();
+		Thread::destroy(t[i]);
+	}
+
+	LONGS_EQUAL(34, FibonacciTestRunnable::data);
+}
+
+TEST(PlatformAdaptiveMutexTest, shared_data_lock_count_up)
+{
+	CountUpTestRunnable::test(s_mutex);
+}
+
+TEST(PlatformAdaptiveMutexTest, tryLock_timedLock_by_other_thread)
+{
+	LONGS_EQUAL(OSWrapper::OK, s_mutex->lock());
+
+	TryLockFailedTestRunnable runnable1;
+	TimedLockFailedTestRunnable runnable2(Timeout(10));
+	Thread* t1 = Thread::create(&runnable1, Thread::getNormalPriority());
+	CHECK(t1);
+	Thread* t2 = Thread::create(&runnable2, Thread::getNormalPriority());
+	CHECK(t2);
+	t1->start();
+	t2->start();
+	t1->wait();
+	t2->wait();
+	Thread::destroy(t1);
+	Thread::destroy(t2);
+
+	// The other thread can not unlock
+	class UnlockFailedTestRunnable : public Runnable {
+	public:
+		void run()
+		{
+			LONGS_EQUAL(OSWrapper::NotLocked, s_mutex->unlock());
+		}
+	} runnable3;
+	Thread* t3 = Thread::create(&runnable3, Thread::getNormalPriority());
+	CHECK(t3);
+	t3->start();
+	t3->wait();
+	Thread::destroy(t3);
+
+	LONGS_EQUAL(OSWrapper::OK, s_mutex->unlock());
+}
+
+TEST(PlatformAdaptiveMutexTest, createNonRecursive)
+{
+	Mutex* mutex = Mutex::createNonRecursive();
+	CHECK(mutex);
+
+	LONGS_EQUAL(OSWrapper::OK, mutex->lock());
+	// Not locked recursively
+	LONGS_EQUAL(OSWrapper::TimedOut, mutex->tryLock());
+	LONGS_EQUAL(OSWrapper::TimedOut, mutex->timedLock(Timeout(10)));
+	LONGS_EQUAL(OSWrapper::OK, mutex->unlock());
+	LONGS_EQUAL(OSWrapper::NotLocked, mutex->unlock());
+
+	CountUpTestRunnable::test(mutex);
+
+	Mutex::destroy(mutex);
+}
+#endif
+
 } // namespace PlatformMutexTest
@@ -1,7 +1,9 @@
 #include "PlatformOSWrapperTestHelper.h"
 #include "OSWrapper/Thread.h"
 #include "OSWrapper/Mutex.h"
+#include "OSWrapper/RWLock.h"
 #include "OSWrapper/EventFlag.h"
+#include "OSWrapper/Semaphore.h"
 #include "OSWrapper/FixedMemoryPool.h"
 #include "OSWrapper/VariableMemoryPool.h"
 #include "OSWrapper/PeriodicTimer.h"
@@ -14,7 +16,9 @@ namespace PlatformOSWrapperTestHelper {
 static TestHelper* s_helper;
 static OSWrapper::ThreadFactory* s_threadFactory;
 static OSWrapper::MutexFactory* s_mutexFactory;
+static OSWrapper::RWLockFactory* s_rwLockFactory;
 static OSWrapper::EventFlagFactory* s_eventFlagFactory;
+static OSWrapper::SemaphoreFactory* s_semaphoreFactory;
 static OSWrapper::FixedMemoryPoolFactory* s_fixedMemoryPoolFactory;
 static OSWrapper::VariableMemoryPoolFactory* s_variableMemoryPoolFactory;
 static OSWrapper::PeriodicTimerFactory* s_periodicTimerFactory;
@@ -30,7 +34,9 @@ void createAndRegisterOSWrapperFactories()
 	CHECK(s_helper);
 	s_threadFactory = s_helper->createThreadFactory();
 	s_mutexFactory = s_helper->createMutexFactory();
+	s_rwLockFactory = s_helper->createRWLockFactory();
 	s_eventFlagFactory = s_helper->createEventFlagFactory();
+	s_semaphoreFactory = s_helper->createSemaphoreFactory();
 	s_fixedMemoryPoolFactory = s_helper->createFixedMemoryPoolFactory();
 	s_variableMemoryPoolFactory = s_helper->createVariableMemoryPoolFactory();
 	s_periodicTimerFactory = s_helper->createPeriodicTimerFactory();
@@ -38,7 +44,9 @@ void createAndRegisterOSWrapperFactories()
 
 	CHECK(s_threadFactory);
 	CHECK(s_mutexFactory);
+	CHECK(s_rwLockFactory);
 	CHECK(s_eventFlagFactory);
+	CHECK(s_semaphoreFactory);
 	CHECK(s_fixedMemoryPoolFactory);
 	CHECK(s_variableMemoryPoolFactory);
 	CHECK(s_periodicTimerFactory);
@@ -46,7 +54,9 @@ void createAndRegisterOSWrapperFactories()
 
 	OSWrapper::registerThreadFactory(s_threadFactory);
 	OSWrapper::registerMutexFactory(s_mutexFactory);
+	OSWrapper::registerRWLockFactory(s_rwLockFactory);
 	OSWrapper::registerEventFlagFactory(s_eventFlagFactory);
+	OSWrapper::registerSemaphoreFactory(s_semaphoreFactory);
 	OSWrapper::registerFixedMemoryPoolFactory(s_fixedMemoryPoolFactory);
 	OSWrapper::registerVariableMemoryPoolFactory(s_variableMemoryPoolFactory);
 	OSWrapper::registerPeriodicTimerFactory(s_periodicTimerFactory);
@@ -58,7 +68,9 @@ void destroyOSWrapperFactories()
 	CHECK(s_helper);
 	s_helper->destroyThreadFactory(s_threadFactory);
 	s_helper->destroyMutexFactory(s_mutexFactory);
+	s_helper->destroyRWLockFactory(s_rwLockFactory);
 	s_helper->destroyEventFlagFactory(s_eventFlagFactory);
+	s_helper->destroySemaphoreFactory(s_semaphoreFactory);
 	s_helper->destroyFixedMemoryPoolFactory(s_fixedMemoryPoolFactory);
 	s_helper->destroyVariableMemoryPoolFactory(s_variableMemoryPoolFactory);
 	s_helper->destroyPeriodicTimerFactory(s_periodicTimerFactory);
@@ -66,7 +78,9 @@ void destroyOSWrapperFactories()
 
 	s_threadFactory = 0;
 	s_mutexFactory = 0;
+	s_rwLockFactory = 0;
 	s_eventFlagFactory = 0;
+	s_semaphoreFactory = 0;
 	s_fixedMemoryPoolFactory = 0;
 	s_variableMemoryPoolFactory = 0;
 	s_periodicTimerFactory = 0;
@@ -74,7 +88,9 @@ void destroyOSWrapperFactories()
 
 	OSWrapper::registerThreadFactory(0);
 	OSWrapper::registerMutexFactory(0);
+	OSWrapper::registerRWLockFactory(0);
 	OSWrapper::registerEventFlagFactory(0);
+	OSWrapper::registerSemaphoreFactory(0);
 	OSWrapper::registerFixedMemoryPoolFactory(0);
 	OSWrapper::registerVariableMemoryPoolFactory(0);
 	OSWrapper::registerPeriodicTimerFactory(0);
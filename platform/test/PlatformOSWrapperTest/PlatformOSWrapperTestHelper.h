@@ -3,7 +3,9 @@
 
 #include "OSWrapper/ThreadFactory.h"
 #include "OSWrapper/MutexFactory.h"
+#include "OSWrapper/RWLockFactory.h"
 #include "OSWrapper/EventFlagFactory.h"
+#include "OSWrapper/SemaphoreFactory.h"
 #include "OSWrapper/FixedMemoryPoolFactory.h"
 #include "OSWrapper/VariableMemoryPoolFactory.h"
 #include "OSWrapper/PeriodicTimerFactory.h"
@@ -23,7 +25,9 @@ public:
 
 	virtual OSWrapper::ThreadFactory* createThreadFactory() = 0;
 	virtual OSWrapper::MutexFactory* createMutexFactory() = 0;
+	virtual OSWrapper::RWLockFactory* createRWLockFactory() = 0;
 	virtual OSWrapper::EventFlagFactory* createEventFlagFactory() = 0;
+	virtual OSWrapper::SemaphoreFactory* createSemaphoreFactory() = 0;
 	virtual OSWrapper::FixedMemoryPoolFactory* createFixedMemoryPoolFactory() = 0;
 	virtual OSWrapper::VariableMemoryPoolFactory* createVariableMemoryPoolFactory() = 0;
 	virtual OSWrapper::PeriodicTimerFactory* createPeriodicTimerFactory() = 0;
@@ -31,7 +35,9 @@ public:
 
 	virtual void destroyThreadFactory(OSWrapper::ThreadFactory* factory) = 0;
 	virtual void destroyMutexFactory(OSWrapper::MutexFactory* factory) = 0;
+	virtual void destroyRWLockFactory(OSWrapper::RWLockFactory* factory) = 0;
 	virtual void destroyEventFlagFactory(OSWrapper::EventFlagFactory* factory) = 0;
+	virtual void destroySemaphoreFactory(OSWrapper::SemaphoreFactory* factory) = 0;
 	virtual void destroyFixedMemoryPoolFactory(OSWrapper::FixedMemoryPoolFactory* factory) = 0;
 	virtual void destroyVariableMemoryPoolFactory(OSWrapper::VariableMemoryPoolFactory* factory) = 0;
 	virtual void destroyPeriodicTimerFactory(OSWrapper::PeriodicTimerFactory* factory) = 0;
@@ -213,6 +213,41 @@ TEST(PlatformOneShotTimerTest, multiple_timers)
 	OneShotTimer::destroy(timer3);
 }
 
+TEST(PlatformOneShotTimerTest, many_timers)
+{
+	const int NUM_TIMERS = 200;
+	TimerRunnable runnables[NUM_TIMERS];
+	OneShotTimer* timers[NUM_TIMERS];
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		timers[i] = OneShotTimer::create(&runnables[i], "TestOneShotTimer");
+		CHECK(timers[i]);
+	}
+
+	TimerRunnable longRunnable;
+	OneShotTimer* longTimer = OneShotTimer::create(&longRunnable, "TestOneShotTimer");
+	CHECK(longTimer);
+	longTimer->start(100000);
+
+	// Times across the boundaries of the timer wheel slots
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		const unsigned long time = 50 + (i % 50) * 2;
+		mock().expectOneCall("run").onObject(&runnables[i]);
+		runnables[i].setStartTime(time);
+		timers[i]->start(time);
+	}
+
+	unsigned long tolerance = PlatformOSWrapperTestHelper::getTimeTolerance();
+	Thread::sleep(150 + tolerance);
+
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		CHECK(!timers[i]->isStarted());
+		OneShotTimer::destroy(timers[i]);
+	}
+	CHECK(longTimer->isStarted());
+	longTimer->stop();
+	OneShotTimer::destroy(longTimer);
+}
+
 TEST(PlatformOneShotTimerTest, start_stop_continuously_at_once)
 {
 	TimerRunnable runnable;
@@ -0,0 +1,351 @@
+#include "OSWrapper/Runnable.h"
+#include "OSWrapper/Thread.h"
+#include "OSWrapper/Mutex.h"
+#include "OSWrapper/EventFlag.h"
+#include "OSWrapper/ThreadPool.h"
+#include "OSWrapper/ParallelFor.h"
+#include "Container/Array.h"
+#include <stdexcept>
+
+#include "PlatformOSWrapperTestHelper.h"
+
+#include "CppUTest/TestHarness.h"
+
+namespace PlatformParallelForTest {
+
+using OSWrapper::Runnable;
+using OSWrapper::Thread;
+using OSWrapper::Mutex;
+using OSWrapper::LockGuard;
+using OSWrapper::EventFlag;
+using OSWrapper::ThreadPool;
+
+TEST_GROUP(PlatformParallelForTest) {
+	ThreadPool* pool;
+
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+		pool = ThreadPool::create(4, 4096);
+		CHECK(pool);
+	}
+	void teardown()
+	{
+		ThreadPool::destroy(pool);
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+	}
+};
+
+static const std::size_t SIZE = 10000U;
+
+class CountBody {
+public:
+	explicit CountBody(Container::Array<int, SIZE>* counts) : m_counts(counts) {}
+	void operator()(std::size_t begin, std::size_t end) const
+	{
+		for (std::size_t i = begin; i < end; i++) {
+			(*m_counts)[i]++;
+		}
+	}
+private:
+	Container::Array<int, SIZE>* m_counts;
+};
+
+class ChunkCheckBody {
+public:
+	ChunkCheckBody(Mutex* mtx, std::size_t end, std::size_t grainSize)
+	: m_mtx(mtx), m_end(end), m_grainSize(grainSize), m_numChunks(0), m_numSmallChunks(0) {}
+	void operator()(std::size_t begin, std::size_t end) const
+	{
+		LockGuard lock(m_mtx);
+		m_numChunks++;
+		if ((end - begin < m_grainSize) && (end != m_end)) {
+			m_numSmallChunks++;
+		}
+	}
+	int getNumChunks() const { return m_numChunks; }
+	int getNumSmallChunks() const { return m_numSmallChunks; }
+private:
+	Mutex* m_mtx;
+	std::size_t m_end;
+	std::size_t m_grainSize;
+	mutable int m_numChunks;
+	mutable int m_numSmallChunks;
+};
+
+class SumBody {
+public:
+	unsigned long operator()(std::size_t begin, std::size_t end, unsigned long partial) const
+	{
+		for (std::size_t i = begin; i < end; i++) {
+			partial += i;
+		}
+		return partial;
+	}
+};
+
+class Plus {
+public:
+	unsigned long operator()(unsigned long a, unsigned long b) const
+	{
+		return a + b;
+	}
+};
+
+class MaxBody {
+public:
+	explicit MaxBody(const Container::Array<int, SIZE>* values) : m_values(values) {}
+	int operator()(std::size_t begin, std::size_t end, int partial) const
+	{
+		for (std::size_t i = begin; i < end; i++) {
+			if ((*m_values)[i] > partial) {
+				partial = (*m_values)[i];
+			}
+		}
+		return partial;
+	}
+private:
+	const Container::Array<int, SIZE>* m_values;
+};
+
+class Max {
+public:
+	int operator()(int a, int b) const
+	{
+		return (a > b) ? a : b;
+	}
+};
+
+class BlockingRunnable : public Runnable {
+	EventFlag* m_ev;
+public:
+	explicit BlockingRunnable(EventFlag* ev) : m_ev(ev) {}
+	void run()
+	{
+		m_ev->waitAny();
+	}
+};
+
+TEST(PlatformParallelForTest, parallelFor_each_index_once)
+{
+	Container::Array<int, SIZE> counts = {{0}};
+	OSWrapper::Error err = OSWrapper::parallelFor(pool, 0U, SIZE, 0U, CountBody(&counts));
+	LONGS_EQUAL(OSWrapper::OK, err);
+	for (std::size_t i = 0U; i < SIZE; i++) {
+		LONGS_EQUAL(1, counts[i]);
+	}
+}
+
+TEST(PlatformParallelForTest, parallelFor_sub_range)
+{
+	Container::Array<int, SIZE> counts = {{0}};
+	OSWrapper::Error err = OSWrapper::parallelFor(pool, 100U, 200U, 7U, CountBody(&counts));
+	LONGS_EQUAL(OSWrapper::OK, err);
+	for (std::size_t i = 0U; i < SIZE; i++) {
+		LONGS_EQUAL(((100U <= i) && (i < 200U)) ? 1 : 0, counts[i]);
+	}
+}
+
+TEST(PlatformParallelForTest, parallelFor_empty_range)
+{
+	Container::Array<int, SIZE> counts = {{0}};
+	LONGS_EQUAL(OSWrapper::OK, OSWrapper::parallelFor(pool, 10U, 10U, 1U, CountBody(&counts)));
+	LONGS_EQUAL(OSWrapper::OK, OSWrapper::parallelFor(pool, 10U, 5U, 1U, CountBody(&counts)));
+	for (std::size_t i = 0U; i < SIZE; i++) {
+		LONGS_EQUAL(0, counts[i]);
+	}
+}
+
+TEST(PlatformParallelForTest, parallelFor_grainSize)
+{
+	Mutex* mtx = Mutex::create();
+	CHECK(mtx);
+	ChunkCheckBody body(mtx, SIZE, 1000U);
+	OSWrapper::Error err = OSWrapper::parallelFor(pool, 0U, SIZE, 1000U, body);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	CHECK(body.getNumChunks() <= 10);
+	LONGS_EQUAL(0, body.getNumSmallChunks());
+	Mutex::destroy(mtx);
+}
+
+TEST(PlatformParallelForTest, parallelFor_busy_pool)
+{
+	EventFlag* ev = EventFlag::create(false);
+	CHECK(ev);
+	BlockingRunnable blocking(ev);
+	ThreadPool::WaitGuard waiter[4];
+	for (int i = 0; i < 4; i++) {
+		LONGS_EQUAL(OSWrapper::OK, pool->start(&blocking, &waiter[i]));
+	}
+
+	// All the chunks are processed by the current thread
+	Container::Array<int, SIZE> counts = {{0}};
+	OSWrapper::Error err = OSWrapper::parallelFor(pool, 0U, SIZE, 0U, CountBody(&counts));
+	LONGS_EQUAL(OSWrapper::OK, err);
+	for (std::size_t i = 0U; i < SIZE; i++) {
+		LONGS_EQUAL(1, counts[i]);
+	}
+
+	ev->setAll();
+	for (int i = 0; i < 4; i++) {
+		waiter[i].release();
+	}
+	EventFlag::destroy(ev);
+}
+
+TEST(PlatformParallelForTest, parallelFor_queued_pool)
+{
+	ThreadPool* queued = ThreadPool::createQueued(4, 4);
+	CHECK(queued);
+	Container::Array<int, SIZE> counts = {{0}};
+	OSWrapper::Error err = OSWrapper::parallelFor(queued, 0U, SIZE, 0U, CountBody(&counts));
+	LONGS_EQUAL(OSWrapper::OK, err);
+	for (std::size_t i = 0U; i < SIZE; i++) {
+		LONGS_EQUAL(1, counts[i]);
+	}
+	ThreadPool::destroy(queued);
+}
+
+TEST(PlatformParallelForTest, parallelFor_does_not_discard_queued_task)
+{
+	ThreadPool* queued = ThreadPool::createQueued(1, 1, ThreadPool::DISCARD_OLDEST);
+	CHECK(queued);
+	EventFlag* ev = EventFlag::create(false);
+	CHECK(ev);
+	BlockingRunnable blocking(ev);
+	class QueuedTask : public Runnable {
+	public:
+		bool m_ran;
+		QueuedTask() : m_ran(false) {}
+		void run()
+		{
+			m_ran = true;
+		}
+	} queuedTask;
+	ThreadPool::WaitGuard blockingWaiter;
+	ThreadPool::WaitGuard queuedWaiter;
+	LONGS_EQUAL(OSWrapper::OK, queued->start(&blocking, &blockingWaiter));
+	LONGS_EQUAL(OSWrapper::OK, queued->start(&queuedTask, &queuedWaiter));
+
+	// The thread is busy, so all the chunks are processed by the current thread
+	Container::Array<int, SIZE> counts = {{0}};
+	OSWrapper::Error err = OSWrapper::parallelFor(queued, 0U, SIZE, 0U, CountBody(&counts));
+	LONGS_EQUAL(OSWrapper::OK, err);
+	for (std::size_t i = 0U; i < SIZE; i++) {
+		LONGS_EQUAL(1, counts[i]);
+	}
+
+	ev->setAll();
+	LONGS_EQUAL(OSWrapper::OK, blockingWaiter.wait());
+	LONGS_EQUAL(OSWrapper::OK, queuedWaiter.wait());
+	CHECK(queuedTask.m_ran);
+	blockingWaiter.release();
+	queuedWaiter.release();
+	EventFlag::destroy(ev);
+	ThreadPool::destroy(queued);
+}
+
+TEST(PlatformParallelForTest, parallelFor_pool_nullptr)
+{
+	Container::Array<int, SIZE> counts = {{0}};
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::parallelFor(0, 0U, SIZE, 0U, CountBody(&counts)));
+}
+
+TEST(PlatformParallelForTest, parallelReduce_sum)
+{
+	unsigned long result = 0;
+	OSWrapper::Error err = OSWrapper::parallelReduce(pool, 0U, SIZE, 0U, 0UL, SumBody(), Plus(), &result);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	LONGS_EQUAL(SIZE * (SIZE - 1U) / 2U, result);
+}
+
+TEST(PlatformParallelForTest, parallelReduce_max)
+{
+	Container::Array<int, SIZE> values;
+	for (std::size_t i = 0U; i < SIZE; i++) {
+		values[i] = static_cast<int>((i * 7919U) % SIZE);
+	}
+	values[1234] = 20000;
+
+	int result = 0;
+	OSWrapper::Error err = OSWrapper::parallelReduce(pool, 0U, SIZE, 16U, -1, MaxBody(&values), Max(), &result);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	LONGS_EQUAL(20000, result);
+}
+
+TEST(PlatformParallelForTest, parallelReduce_empty_range)
+{
+	unsigned long result = 1;
+	OSWrapper::Error err = OSWrapper::parallelReduce(pool, 5U, 5U, 0U, 0UL, SumBody(), Plus(), &result);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	LONGS_EQUAL(0, result);
+}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+// The chunks of the tasks throw, and the chunks of the caller wait for it, so a task surely takes a chunk.
+class ThrowInTaskBody {
+public:
+	explicit ThrowInTaskBody(EventFlag* thrown) : m_thrown(thrown) {}
+	unsigned long operator()(std::size_t begin, std::size_t end, unsigned long partial) const
+	{
+		if (Thread::getCurrentThread() != 0) {
+			m_thrown->setAll();
+			throw std::runtime_error("ThrowInTaskBody");
+		}
+		m_thrown->timedWaitAny(OSWrapper::Timeout(1000));
+		return SumBody()(begin, end, partial);
+	}
+	void operator()(std::size_t begin, std::size_t end) const
+	{
+		(void) operator()(begin, end, 0UL);
+	}
+private:
+	EventFlag* m_thrown;
+};
+
+class ExpectedExceptionHandler : public Thread::UncaughtExceptionHandler {
+public:
+	virtual void handle(Thread*, const char* msg)
+	{
+		STRCMP_CONTAINS("ThrowInTaskBody", msg);
+	}
+};
+
+TEST(PlatformParallelForTest, parallelFor_exception_in_task)
+{
+	ExpectedExceptionHandler handler;
+	pool->setUncaughtExceptionHandler(&handler);
+	EventFlag* thrown = EventFlag::create(false);
+	CHECK(thrown);
+
+	OSWrapper::Error err = OSWrapper::parallelFor(pool, 0U, SIZE, 0U, ThrowInTaskBody(thrown));
+	LONGS_EQUAL(OSWrapper::OtherError, err);
+
+	EventFlag::destroy(thrown);
+}
+
+TEST(PlatformParallelForTest, parallelReduce_exception_in_task)
+{
+	ExpectedExceptionHandler handler;
+	pool->setUncaughtExceptionHandler(&handler);
+	EventFlag* thrown = EventFlag::create(false);
+	CHECK(thrown);
+
+	unsigned long result = 1;
+	OSWrapper::Error err = OSWrapper::parallelReduce(pool, 0U, SIZE, 0U, 0UL, ThrowInTaskBody(thrown), Plus(), &result);
+	LONGS_EQUAL(OSWrapper::OtherError, err);
+	LONGS_EQUAL(1, result);
+
+	EventFlag::destroy(thrown);
+}
+#endif
+
+TEST(PlatformParallelForTest, parallelReduce_invalid_parameter)
+{
+	unsigned long result = 1;
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::parallelReduce(0, 0U, SIZE, 0U, 0UL, SumBody(), Plus(), &result));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, OSWrapper::parallelReduce<unsigned long>(pool, 0U, SIZE, 0U, 0UL, SumBody(), Plus(), 0));
+	LONGS_EQUAL(1, result);
+}
+
+} // namespace PlatformParallelForTest
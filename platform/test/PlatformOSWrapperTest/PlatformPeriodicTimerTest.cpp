@@ -206,6 +206,34 @@ TEST(PlatformPeriodicTimerTest, multiple_timers)
 	PeriodicTimer::destroy(timer3);
 }
 
+TEST(PlatformPeriodicTimerTest, many_timers)
+{
+	const int NUM_TIMERS = 100;
+	TimerRunnable* runnables[NUM_TIMERS];
+	PeriodicTimer* timers[NUM_TIMERS];
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		runnables[i] = new TimerRunnable(100);
+		timers[i] = PeriodicTimer::create(runnables[i], runnables[i]->getPeriod(), "TestPeriodicTimer");
+		CHECK(timers[i]);
+	}
+
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		runnables[i]->setStartTime();
+		timers[i]->start();
+	}
+	unsigned long tolerance = PlatformOSWrapperTestHelper::getTimeTolerance();
+	Thread::sleep(200 + tolerance);
+
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		timers[i]->stop();
+	}
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		LONGS_EQUAL(2, runnables[i]->getRunCount());
+		PeriodicTimer::destroy(timers[i]);
+		delete runnables[i];
+	}
+}
+
 TEST(PlatformPeriodicTimerTest, start_stop_continuously_at_once)
 {
 	TimerRunnable runnable(100);
@@ -276,6 +304,240 @@ TEST(PlatformPeriodicTimerTest, name)
 	PeriodicTimer::destroy(timer);
 }
 
+#if defined(PLATFORM_OS_STDCPP) || defined(PLATFORM_OS_POSIX)
+class SlowRunnable : public Runnable {
+	unsigned long m_sleepTime;
+	unsigned long m_numSlowRuns;
+	std::size_t m_runCount;
+public:
+	SlowRunnable(unsigned long sleepTime, unsigned long numSlowRuns)
+	: m_sleepTime(sleepTime), m_numSlowRuns(numSlowRuns), m_runCount(0) {}
+	void run()
+	{
+		bool slow;
+		{
+			LockGuard lock(s_mutex);
+			slow = (m_runCount < m_numSlowRuns);
+			m_runCount++;
+		}
+		if (slow) {
+			Thread::sleep(m_sleepTime);
+		}
+	}
+	std::size_t getRunCount() const
+	{
+		LockGuard lock(s_mutex);
+		return m_runCount;
+	}
+};
+
+class GridRunnable : public Runnable {
+public:
+	static const std::size_t MAX_RUNS = 32;
+private:
+	unsigned long m_sleepTime;
+	unsigned long m_startTime;
+	unsigned long m_runTimes[MAX_RUNS];
+	std::size_t m_runCount;
+public:
+	explicit GridRunnable(unsigned long sleepTime)
+	: m_sleepTime(sleepTime), m_startTime(0), m_runTimes(), m_runCount(0) {}
+	void setStartTime()
+	{
+		m_startTime = PlatformOSWrapperTestHelper::getCurrentTime();
+	}
+	void run()
+	{
+		{
+			LockGuard lock(s_mutex);
+			if (m_runCount < MAX_RUNS) {
+				m_runTimes[m_runCount] = PlatformOSWrapperTestHelper::getCurrentTime() - m_startTime;
+			}
+			m_runCount++;
+		}
+		Thread::sleep(m_sleepTime);
+	}
+	std::size_t getRunCount() const
+	{
+		LockGuard lock(s_mutex);
+		return m_runCount;
+	}
+	// Time of the run from setStartTime() in milliseconds
+	unsigned long getRunTime(std::size_t index) const
+	{
+		LockGuard lock(s_mutex);
+		return m_runTimes[index];
+	}
+};
+
+class MyOverrunHandler : public PeriodicTimer::OverrunHandler {
+public:
+	virtual void handle(PeriodicTimer* t, unsigned long missedPeriods)
+	{
+		LockGuard lock(s_mutex);
+		mock().actualCall("handle").withParameter("t", t).withParameter("missedPeriods", missedPeriods).onObject(this);
+	}
+};
+
+TEST(PlatformPeriodicTimerTest, setScheduleMode_invalid_parameter)
+{
+	TimerRunnable runnable(100);
+	PeriodicTimer* timer = PeriodicTimer::create(&runnable, runnable.getPeriod(), "TestPeriodicTimer");
+	CHECK(timer);
+
+	LONGS_EQUAL(OSWrapper::OK, timer->setScheduleMode(PeriodicTimer::ABSOLUTE_SCHEDULE, PeriodicTimer::CATCH_UP));
+	LONGS_EQUAL(OSWrapper::OK, timer->setScheduleMode(PeriodicTimer::RELATIVE_SCHEDULE));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, timer->setScheduleMode(static_cast<PeriodicTimer::ScheduleMode>(-1)));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, timer->setScheduleMode(PeriodicTimer::ABSOLUTE_SCHEDULE, static_cast<PeriodicTimer::OverrunPolicy>(-1)));
+
+	PeriodicTimer::destroy(timer);
+}
+
+TEST(PlatformPeriodicTimerTest, absolute_schedule_does_not_drift)
+{
+	// run() takes 10 ms of the period 20 ms
+	GridRunnable runnable(10);
+	PeriodicTimer* timer = PeriodicTimer::create(&runnable, 20, "TestPeriodicTimer");
+	CHECK(timer);
+	// CATCH_UP keeps the n-th run on the n-th deadline even if the system is busy
+	LONGS_EQUAL(OSWrapper::OK, timer->setScheduleMode(PeriodicTimer::ABSOLUTE_SCHEDULE, PeriodicTimer::CATCH_UP));
+
+	runnable.setStartTime();
+	timer->start();
+	Thread::sleep(400 + 10);
+	timer->stop();
+
+	// The relative schedule calls run() every 30 ms, so the 15th run would be at 440 ms
+	const std::size_t numChecked = 15;
+	CHECK(runnable.getRunCount() >= numChecked);
+	CHECK(runnable.getRunCount() <= 20);
+	for (std::size_t i = 0; i < numChecked; i++) {
+		const unsigned long deadline = (i + 1) * 20;
+		const unsigned long runTime = runnable.getRunTime(i);
+		// getCurrentTime() is in milliseconds, so the run may look 1 ms early
+		CHECK(runTime + 1 >= deadline);
+		CHECK(runTime <= deadline + PlatformOSWrapperTestHelper::getTimeTolerance());
+	}
+	LONGS_EQUAL(runnable.getRunCount(), timer->getNumberOfExpirations());
+
+	PeriodicTimer::destroy(timer);
+}
+
+TEST(PlatformPeriodicTimerTest, absolute_schedule_skip)
+{
+	// The first run() takes 50 ms of the period 20 ms, so the periods at 40 ms and 60 ms are skipped
+	SlowRunnable runnable(50, 1);
+	PeriodicTimer* timer = PeriodicTimer::create(&runnable, 20, "TestPeriodicTimer");
+	CHECK(timer);
+	LONGS_EQUAL(OSWrapper::OK, timer->setScheduleMode(PeriodicTimer::ABSOLUTE_SCHEDULE, PeriodicTimer::SKIP));
+
+	timer->start();
+	Thread::sleep(200 + 10);
+	timer->stop();
+
+	CHECK(runnable.getRunCount() >= 8);
+	CHECK(runnable.getRunCount() <= 9);
+	LONGS_EQUAL(2, timer->getNumberOfOverruns());
+
+	PeriodicTimer::destroy(timer);
+}
+
+TEST(PlatformPeriodicTimerTest, absolute_schedule_catch_up)
+{
+	// The first run() takes 50 ms of the period 20 ms, so the periods at 40 ms and 60 ms are run late
+	SlowRunnable runnable(50, 1);
+	PeriodicTimer* timer = PeriodicTimer::create(&runnable, 20, "TestPeriodicTimer");
+	CHECK(timer);
+	LONGS_EQUAL(OSWrapper::OK, timer->setScheduleMode(PeriodicTimer::ABSOLUTE_SCHEDULE, PeriodicTimer::CATCH_UP));
+
+	timer->start();
+	Thread::sleep(200 + 10);
+	timer->stop();
+
+	CHECK(runnable.getRunCount() >= 10);
+	CHECK(runnable.getRunCount() <= 11);
+	LONGS_EQUAL(2, timer->getNumberOfOverruns());
+	CHECK(timer->getMaxJitterInMicros() >= 10000);
+
+	PeriodicTimer::destroy(timer);
+}
+
+TEST(PlatformPeriodicTimerTest, absolute_schedule_report)
+{
+	SlowRunnable runnable(50, 1);
+	PeriodicTimer* timer = PeriodicTimer::create(&runnable, 20, "TestPeriodicTimer");
+	CHECK(timer);
+	LONGS_EQUAL(OSWrapper::OK, timer->setScheduleMode(PeriodicTimer::ABSOLUTE_SCHEDULE, PeriodicTimer::REPORT));
+	MyOverrunHandler handler;
+	timer->setOverrunHandler(&handler);
+	POINTERS_EQUAL(&handler, timer->getOverrunHandler());
+	mock().expectOneCall("handle").withParameter("t", timer).withParameter("missedPeriods", 2UL).onObject(&handler);
+
+	timer->start();
+	Thread::sleep(100 + 10);
+	timer->stop();
+
+	LONGS_EQUAL(2, timer->getNumberOfOverruns());
+
+	PeriodicTimer::destroy(timer);
+}
+
+TEST(PlatformPeriodicTimerTest, createInMicros)
+{
+	SlowRunnable runnable(0, 0);
+	PeriodicTimer* timer = PeriodicTimer::createInMicros(&runnable, 500, "TestPeriodicTimer");
+	CHECK(timer);
+	LONGS_EQUAL(500, timer->getPeriodInMicros());
+	LONGS_EQUAL(1, timer->getPeriodInMillis());
+	LONGS_EQUAL(OSWrapper::OK, timer->setScheduleMode(PeriodicTimer::ABSOLUTE_SCHEDULE, PeriodicTimer::CATCH_UP));
+
+	unsigned long start = PlatformOSWrapperTestHelper::getCurrentTime();
+	timer->start();
+	Thread::sleep(100);
+	timer->stop();
+	unsigned long elapsed = PlatformOSWrapperTestHelper::getCurrentTime() - start;
+
+	// Two periods per millisecond
+	CHECK(runnable.getRunCount() + 4 >= elapsed * 2);
+	CHECK(runnable.getRunCount() <= elapsed * 2 + 4);
+
+	PeriodicTimer::destroy(timer);
+}
+
+TEST(PlatformPeriodicTimerTest, createInMicros_failed)
+{
+	SlowRunnable runnable(0, 0);
+	CHECK_FALSE(PeriodicTimer::createInMicros(0, 500));
+	CHECK_FALSE(PeriodicTimer::createInMicros(&runnable, 0));
+}
+
+TEST(PlatformPeriodicTimerTest, statistics)
+{
+	TimerRunnable runnable(20);
+	PeriodicTimer* timer = PeriodicTimer::create(&runnable, runnable.getPeriod(), "TestPeriodicTimer");
+	CHECK(timer);
+	LONGS_EQUAL(0, timer->getNumberOfExpirations());
+	LONGS_EQUAL(0, timer->getAverageJitterInMicros());
+
+	runnable.setStartTime();
+	timer->start();
+	Thread::sleep(100 + 10);
+	timer->stop();
+
+	LONGS_EQUAL(runnable.getRunCount(), timer->getNumberOfExpirations());
+	CHECK(timer->getAverageJitterInMicros() <= timer->getMaxJitterInMicros());
+	CHECK(timer->getMaxJitterInMicros() <= PlatformOSWrapperTestHelper::getTimeTolerance() * 1000);
+
+	timer->resetStatistics();
+	LONGS_EQUAL(0, timer->getNumberOfExpirations());
+	LONGS_EQUAL(0, timer->getNumberOfOverruns());
+	LONGS_EQUAL(0, timer->getMaxJitterInMicros());
+	LONGS_EQUAL(0, timer->getAverageJitterInMicros());
+
+	PeriodicTimer::destroy(timer);
+}
+#endif
+
 #ifndef CPPELIB_NO_EXCEPTIONS
 class ThrowExceptionRunnable : public Runnable {
 public:
@@ -0,0 +1,379 @@
+#include "OSWrapper/Runnable.h"
+#include "OSWrapper/Thread.h"
+#include "OSWrapper/RWLock.h"
+
+#include "PlatformOSWrapperTestHelper.h"
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+namespace PlatformRWLockTest {
+
+using OSWrapper::Runnable;
+using OSWrapper::Thread;
+using OSWrapper::RWLock;
+using OSWrapper::Timeout;
+using OSWrapper::ReadLockGuard;
+using OSWrapper::WriteLockGuard;
+
+static RWLock* s_rwlock;
+
+TEST_GROUP(PlatformRWLockTest) {
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+		s_rwlock = RWLock::create();
+		CHECK(s_rwlock);
+	}
+	void teardown()
+	{
+		LONGS_EQUAL(OSWrapper::NotLocked, s_rwlock->readUnlock());
+		LONGS_EQUAL(OSWrapper::NotLocked, s_rwlock->writeUnlock());
+
+		RWLock::destroy(s_rwlock);
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+
+		mock().checkExpectations();
+		mock().clear();
+	}
+
+	void runThread(Runnable* r)
+	{
+		Thread* t = Thread::create(r, Thread::getNormalPriority());
+		CHECK(t);
+		t->start();
+		t->wait();
+		Thread::destroy(t);
+	}
+};
+
+class TryReadLockTestRunnable : public Runnable {
+	OSWrapper::Error m_expected;
+public:
+	explicit TryReadLockTestRunnable(OSWrapper::Error expected) : m_expected(expected) {}
+	void run()
+	{
+		OSWrapper::Error err = s_rwlock->tryReadLock();
+		LONGS_EQUAL(m_expected, err);
+		if (err == OSWrapper::OK) {
+			LONGS_EQUAL(OSWrapper::OK, s_rwlock->readUnlock());
+		}
+	}
+};
+
+class TryWriteLockTestRunnable : public Runnable {
+	OSWrapper::Error m_expected;
+public:
+	explicit TryWriteLockTestRunnable(OSWrapper::Error expected) : m_expected(expected) {}
+	void run()
+	{
+		OSWrapper::Error err = s_rwlock->tryWriteLock();
+		LONGS_EQUAL(m_expected, err);
+		if (err == OSWrapper::OK) {
+			LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeUnlock());
+		}
+	}
+};
+
+class TimedLockFailedTestRunnable : public Runnable {
+	Timeout m_timeout;
+public:
+	TimedLockFailedTestRunnable(Timeout tmout) : m_timeout(tmout) {}
+	void run()
+	{
+		LONGS_EQUAL(OSWrapper::TimedOut, s_rwlock->timedReadLock(m_timeout));
+		LONGS_EQUAL(OSWrapper::TimedOut, s_rwlock->timedWriteLock(m_timeout));
+	}
+};
+
+TEST(PlatformRWLockTest, create_destroy)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	RWLock::destroy(rwlock);
+
+	rwlock = RWLock::create(true);
+	CHECK(rwlock);
+	RWLock::destroy(rwlock);
+}
+
+TEST(PlatformRWLockTest, readLock_readUnlock)
+{
+	OSWrapper::Error err;
+	err = s_rwlock->readLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_rwlock->readUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+
+	err = s_rwlock->tryReadLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_rwlock->readUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+
+	err = s_rwlock->timedReadLock(Timeout(10));
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_rwlock->readUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+}
+
+TEST(PlatformRWLockTest, writeLock_writeUnlock)
+{
+	OSWrapper::Error err;
+	err = s_rwlock->writeLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_rwlock->writeUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+
+	err = s_rwlock->tryWriteLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_rwlock->writeUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+
+	err = s_rwlock->timedWriteLock(Timeout(10));
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = s_rwlock->writeUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+}
+
+TEST(PlatformRWLockTest, unlock_not_locked)
+{
+	LONGS_EQUAL(OSWrapper::NotLocked, s_rwlock->readUnlock());
+	LONGS_EQUAL(OSWrapper::NotLocked, s_rwlock->writeUnlock());
+
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->readLock());
+	LONGS_EQUAL(OSWrapper::NotLocked, s_rwlock->writeUnlock());
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->readUnlock());
+
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeLock());
+	LONGS_EQUAL(OSWrapper::NotLocked, s_rwlock->readUnlock());
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeUnlock());
+}
+
+TEST(PlatformRWLockTest, readers_share_the_lock)
+{
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->readLock());
+
+	TryReadLockTestRunnable reader(OSWrapper::OK);
+	runThread(&reader);
+	TryWriteLockTestRunnable writer(OSWrapper::TimedOut);
+	runThread(&writer);
+
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->readUnlock());
+
+	TryWriteLockTestRunnable writer2(OSWrapper::OK);
+	runThread(&writer2);
+}
+
+TEST(PlatformRWLockTest, writer_excludes_others)
+{
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeLock());
+
+	TryReadLockTestRunnable reader(OSWrapper::TimedOut);
+	runThread(&reader);
+	TryWriteLockTestRunnable writer(OSWrapper::TimedOut);
+	runThread(&writer);
+
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeUnlock());
+
+	TryReadLockTestRunnable reader2(OSWrapper::OK);
+	runThread(&reader2);
+}
+
+TEST(PlatformRWLockTest, timedLock_TimedOut)
+{
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeLock());
+
+	TimedLockFailedTestRunnable runnable(Timeout(10));
+	runThread(&runnable);
+
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeUnlock());
+}
+
+TEST(PlatformRWLockTest, timedLock_POLLING)
+{
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->timedWriteLock(Timeout::FOREVER));
+
+	TimedLockFailedTestRunnable runnable(Timeout::POLLING);
+	runThread(&runnable);
+
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeUnlock());
+}
+
+class WaitingWriterTestRunnable : public Runnable {
+public:
+	void run()
+	{
+		LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeLock());
+		LONGS_EQUAL(OSWrapper::OK, s_rwlock->writeUnlock());
+	}
+};
+
+static void testNewReaderWhileWriterIsWaiting(OSWrapper::Error expected)
+{
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->readLock());
+
+	WaitingWriterTestRunnable writerRunnable;
+	Thread* writer = Thread::create(&writerRunnable, Thread::getNormalPriority());
+	CHECK(writer);
+	writer->start();
+	Thread::sleep(50);
+	CHECK_FALSE(writer->isFinished());
+
+	TryReadLockTestRunnable readerRunnable(expected);
+	Thread* reader = Thread::create(&readerRunnable, Thread::getNormalPriority());
+	CHECK(reader);
+	reader->start();
+	reader->wait();
+	Thread::destroy(reader);
+
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->readUnlock());
+	writer->wait();
+	Thread::destroy(writer);
+}
+
+TEST(PlatformRWLockTest, readerPreference_new_reader_while_writer_is_waiting)
+{
+	testNewReaderWhileWriterIsWaiting(OSWrapper::OK);
+}
+
+TEST(PlatformRWLockTest, writerPreference_new_reader_while_writer_is_waiting)
+{
+	RWLock::destroy(s_rwlock);
+	s_rwlock = RWLock::create(true);
+	CHECK(s_rwlock);
+
+	testNewReaderWhileWriterIsWaiting(OSWrapper::TimedOut);
+}
+
+class TimedWriteLockFailedTestRunnable : public Runnable {
+public:
+	void run()
+	{
+		LONGS_EQUAL(OSWrapper::TimedOut, s_rwlock->timedWriteLock(Timeout(20)));
+	}
+};
+
+TEST(PlatformRWLockTest, writerPreference_readers_after_writer_TimedOut)
+{
+	RWLock::destroy(s_rwlock);
+	s_rwlock = RWLock::create(true);
+	CHECK(s_rwlock);
+
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->readLock());
+
+	TimedWriteLockFailedTestRunnable writer;
+	runThread(&writer);
+
+	// The writer gave up, so the new readers can lock
+	TryReadLockTestRunnable reader(OSWrapper::OK);
+	runThread(&reader);
+
+	LONGS_EQUAL(OSWrapper::OK, s_rwlock->readUnlock());
+}
+
+TEST(PlatformRWLockTest, ReadLockGuard_WriteLockGuard)
+{
+	{
+		ReadLockGuard lock(s_rwlock);
+		TryReadLockTestRunnable reader(OSWrapper::OK);
+		runThread(&reader);
+	}
+	{
+		WriteLockGuard lock(s_rwlock);
+		TryReadLockTestRunnable reader(OSWrapper::TimedOut);
+		runThread(&reader);
+	}
+}
+
+TEST(PlatformRWLockTest, LockGuard_ADOPT_LOCK)
+{
+	{
+		LONGS_EQUAL(OSWrapper::OK, s_rwlock->tryReadLock());
+		ReadLockGuard lock(s_rwlock, ReadLockGuard::ADOPT_LOCK);
+	}
+	{
+		LONGS_EQUAL(OSWrapper::OK, s_rwlock->tryWriteLock());
+		WriteLockGuard lock(s_rwlock, WriteLockGuard::ADOPT_LOCK);
+	}
+}
+
+/*
+ * The writers keep the two counters equal and the readers check that they are equal.
+ */
+class SharedDataTestRunnable : public Runnable {
+public:
+	static int count1;
+	static int count2;
+	static const int NUM_LOOPS = 2000;
+
+	explicit SharedDataTestRunnable(bool isWriter) : m_isWriter(isWriter), m_numMismatches(0) {}
+
+	void run()
+	{
+		for (int i = 0; i < NUM_LOOPS; i++) {
+			if (m_isWriter) {
+				WriteLockGuard lock(s_rwlock);
+				count1++;
+				if ((i % 100) == 0) {
+					Thread::yield();
+				}
+				count2++;
+			} else {
+				ReadLockGuard lock(s_rwlock);
+				if (count1 != count2) {
+					m_numMismatches++;
+				}
+			}
+		}
+	}
+
+	static void test()
+	{
+		count1 = 0;
+		count2 = 0;
+		const int num = 6;
+		SharedDataTestRunnable runnable[num] = {
+			SharedDataTestRunnable(true), SharedDataTestRunnable(false), SharedDataTestRunnable(false),
+			SharedDataTestRunnable(true), SharedDataTestRunnable(false), SharedDataTestRunnable(false),
+		};
+		Thread* t[num];
+		for (int i = 0; i < num; i++) {
+			t[i] = Thread::create(&runnable[i], Thread::getNormalPriority());
+			CHECK(t[i]);
+		}
+		for (int i = 0; i < num; i++) {
+			t[i]->start();
+		}
+		int numMismatches = 0;
+		for (int i = 0; i < num; i++) {
+			t[i]->wait();
+			Thread::destroy(t[i]);
+			numMismatches += runnable[i].m_numMismatches;
+		}
+		LONGS_EQUAL(2 * NUM_LOOPS, count1);
+		LONGS_EQUAL(2 * NUM_LOOPS, count2);
+		LONGS_EQUAL(0, numMismatches);
+	}
+
+private:
+	bool m_isWriter;
+	int m_numMismatches;
+};
+int SharedDataTestRunnable::count1;
+int SharedDataTestRunnable::count2;
+
+TEST(PlatformRWLockTest, shared_data)
+{
+	SharedDataTestRunnable::test();
+}
+
+TEST(PlatformRWLockTest, shared_data_writerPreference)
+{
+	RWLock::destroy(s_rwlock);
+	s_rwlock = RWLock::create(true);
+	CHECK(s_rwlock);
+
+	SharedDataTestRunnable::test();
+}
+
+} // namespace PlatformRWLockTest
@@ -0,0 +1,318 @@
+#include "OSWrapper/Runnable.h"
+#include "OSWrapper/Thread.h"
+#include "OSWrapper/Mutex.h"
+#include "OSWrapper/SPSCMessageQueue.h"
+#include "Assertion/Assertion.h"
+#include <exception>
+
+#include "PlatformOSWrapperTestHelper.h"
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+namespace PlatformSPSCMessageQueueTest {
+
+using OSWrapper::Runnable;
+using OSWrapper::Thread;
+using OSWrapper::Mutex;
+using OSWrapper::SPSCMessageQueue;
+using OSWrapper::Timeout;
+using OSWrapper::LockGuard;
+
+static Mutex* s_mutex;
+
+TEST_GROUP(PlatformSPSCMessageQueueTest) {
+	static const std::size_t SIZE = 10;
+	typedef SPSCMessageQueue<int> IntMQ;
+
+	class BaseRunnable : public Runnable {
+	protected:
+		IntMQ* m_mq;
+	public:
+		BaseRunnable(IntMQ* mq) : m_mq(mq) {}
+		virtual void run() = 0;
+	};
+
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+		s_mutex = Mutex::create();
+		CHECK(s_mutex);
+	}
+	void teardown()
+	{
+		Mutex::destroy(s_mutex);
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+
+		mock().checkExpectations();
+		mock().clear();
+	}
+
+	template<class Run1, class Run2, class MQ>
+	void testTwoThreadsSharingOneMQ()
+	{
+		MQ* mq = MQ::create(SIZE);
+		CHECK(mq);
+		Run1 r1(mq);
+		Thread* thread1 = Thread::create(&r1, Thread::getNormalPriority());
+		CHECK(thread1);
+		Run2 r2(mq);
+		Thread* thread2 = Thread::create(&r2, Thread::getNormalPriority());
+		CHECK(thread2);
+
+		thread1->start();
+		thread2->start();
+
+		thread1->wait();
+		thread2->wait();
+
+		Thread::destroy(thread1);
+		Thread::destroy(thread2);
+
+		MQ::destroy(mq);
+	}
+};
+
+TEST(PlatformSPSCMessageQueueTest, create_destroy)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformSPSCMessageQueueTest, getMaxSize_getSize)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	LONGS_EQUAL(SIZE, mq->getMaxSize());
+	LONGS_EQUAL(0, mq->getSize());
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformSPSCMessageQueueTest, tryReceive_TimedOut)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	int data = 0;
+	OSWrapper::Error err = mq->tryReceive(&data);
+	LONGS_EQUAL(OSWrapper::TimedOut, err);
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformSPSCMessageQueueTest, timedReceive_Timeout10)
+{
+	IntMQ* mq = IntMQ::create(SIZE);
+	CHECK(mq);
+	int data = 0;
+	OSWrapper::Error err = mq->timedReceive(&data, Timeout(10));
+	LONGS_EQUAL(OSWrapper::TimedOut, err);
+	IntMQ::destroy(mq);
+}
+
+TEST(PlatformSPSCMessageQueueTest, send_receive)
+{
+	class Sender : public BaseRunnable {
+	public:
+		Sender(IntMQ* mq) : BaseRunnable(mq) {}
+		virtual void run()
+		{
+			Thread::sleep(10);
+			OSWrapper::Error err = m_mq->send(100);
+			LockGuard lock(s_mutex);
+			LONGS_EQUAL(OSWrapper::OK, err);
+		}
+	};
+
+	class Receiver : public BaseRunnable {
+	public:
+		Receiver(IntMQ* mq) : BaseRunnable(mq) {}
+		virtual void run()
+		{
+			int data = 0;
+			OSWrapper::Error err = m_mq->receive(&data);
+			LockGuard lock(s_mutex);
+			LONGS_EQUAL(OSWrapper::OK, err);
+			LONGS_EQUAL(100, data);
+		}
+	};
+	testTwoThreadsSharingOneMQ<Sender, Receiver, IntMQ>();
+}
+
+TEST(PlatformSPSCMessageQueueTest, trySend_TimedOut_receive)
+{
+	class Sender : public BaseRunnable {
+	public:
+		Sender(IntMQ* mq) : BaseRunnable(mq) {}
+		virtual void run()
+		{
+			for (std::size_t i = 0; i < SIZE; i++) {
+				OSWrapper::Error err = m_mq->trySend(int(i));
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+			}
+			{
+				std::size_t size = m_mq->getSize();
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(SIZE, size);
+			}
+			{
+				OSWrapper::Error err = m_mq->trySend(SIZE);
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::TimedOut, err);
+			}
+			{
+				OSWrapper::Error err = m_mq->send(SIZE);
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+			}
+		}
+	};
+
+	class Receiver : public BaseRunnable {
+	public:
+		Receiver(IntMQ* mq) : BaseRunnable(mq) {}
+		virtual void run()
+		{
+			Thread::sleep(100);
+			for (std::size_t i = 0; i < SIZE + 1; i++) {
+				int data = 0;
+				OSWrapper::Error err = m_mq->receive(&data);
+				LockGuard lock(s_mutex);
+				LONGS_EQUAL(OSWrapper::OK, err);
+				LONGS_EQUAL(i, data);
+			}
+		}
+	};
+	testTwoThreadsSharingOneMQ<Sender, Receiver, IntMQ>();
+}
+
+TEST(PlatformSPSCMessageQueueTest, send_receive_many_msgs)
+{
+	static const int num = SIZE + 100000;
+	class Sender : public BaseRunnable {
+	public:
+		Sender(IntMQ* mq) : BaseRunnable(mq) {}
+		virtual void run()
+		{
+			for (int i = 0; i < num; i++) {
+				OSWrapper::Error err = m_mq->send(i);
+				if (err != OSWrapper::OK) {
+					LockGuard lock(s_mutex);
+					LONGS_EQUAL(OSWrapper::OK, err);
+				}
+			}
+		}
+	};
+
+	class Receiver : public BaseRunnable {
+	public:
+		Receiver(IntMQ* mq) : BaseRunnable(mq) {}
+		virtual void run()
+		{
+			for (int i = 0; i < num; i++) {
+				int data = 0;
+				OSWrapper::Error err = m_mq->receive(&data);
+				if ((err != OSWrapper::OK) || (data != i)) {
+					LockGuard lock(s_mutex);
+					LONGS_EQUAL(OSWrapper::OK, err);
+					LONGS_EQUAL(i, data);
+				}
+			}
+		}
+	};
+	testTwoThreadsSharingOneMQ<Sender, Receiver, IntMQ>();
+}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+struct Elem {
+	unsigned int data;
+
+	static const unsigned int STD_EXCEPTION_DATA = 0;
+	class StdException : public std::exception {};
+
+	static const unsigned int ASSERTION_FAIL_DATA = 1;
+
+	Elem() : data(100) {}
+	Elem(const Elem& x) : data(x.data)
+	{
+		if (x.data == STD_EXCEPTION_DATA) {
+			throw StdException();
+		} else if (x.data == ASSERTION_FAIL_DATA) {
+			CHECK_ASSERT(false);
+		}
+	}
+	Elem& operator=(const Elem&)
+	{
+		if (data == STD_EXCEPTION_DATA) {
+			throw StdException();
+		} else if (data == ASSERTION_FAIL_DATA) {
+			CHECK_ASSERT(false);
+		}
+		return *this;
+	}
+};
+
+TEST(PlatformSPSCMessageQueueTest, send_receive_std_exception)
+{
+	SPSCMessageQueue<Elem>* mq = SPSCMessageQueue<Elem>::create(SIZE);
+	CHECK(mq);
+	Elem a;
+
+	OSWrapper::Error err;
+	err = mq->send(a);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	LONGS_EQUAL(1, mq->getSize());
+
+	a.data = Elem::STD_EXCEPTION_DATA;
+	err = mq->send(a);
+	LONGS_EQUAL(OSWrapper::OtherError, err);
+	LONGS_EQUAL(1, mq->getSize());
+
+	Elem b;
+	b.data = Elem::STD_EXCEPTION_DATA;
+	err = mq->receive(&b);
+	LONGS_EQUAL(OSWrapper::OtherError, err);
+	LONGS_EQUAL(1, mq->getSize());
+
+	SPSCMessageQueue<Elem>::destroy(mq);
+}
+
+TEST(PlatformSPSCMessageQueueTest, send_receive_assertion_failure)
+{
+	SPSCMessageQueue<Elem>* mq = SPSCMessageQueue<Elem>::create(SIZE);
+	CHECK(mq);
+	Elem a;
+
+	OSWrapper::Error err;
+	err = mq->send(a);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	LONGS_EQUAL(1, mq->getSize());
+
+	bool exception_occurred = false;
+	a.data = Elem::ASSERTION_FAIL_DATA;
+	try {
+		err = mq->send(a);
+	}
+	catch (const Assertion::Failure&) {
+		exception_occurred = true;
+	}
+	CHECK(exception_occurred);
+	LONGS_EQUAL(1, mq->getSize());
+
+	exception_occurred = false;
+	Elem b;
+	b.data = Elem::ASSERTION_FAIL_DATA;
+	try {
+		err = mq->receive(&b);
+	}
+	catch (const Assertion::Failure&) {
+		exception_occurred = true;
+	}
+	CHECK(exception_occurred);
+	LONGS_EQUAL(1, mq->getSize());
+
+	SPSCMessageQueue<Elem>::destroy(mq);
+}
+#endif
+
+} // namespace PlatformSPSCMessageQueueTest
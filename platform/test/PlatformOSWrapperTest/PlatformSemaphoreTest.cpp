@@ -0,0 +1,221 @@
+#include "OSWrapper/Runnable.h"
+#include "OSWrapper/Thread.h"
+#include "OSWrapper/Semaphore.h"
+
+#include "PlatformOSWrapperTestHelper.h"
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+namespace PlatformSemaphoreTest {
+
+using OSWrapper::Runnable;
+using OSWrapper::Thread;
+using OSWrapper::Semaphore;
+using OSWrapper::Timeout;
+
+static Semaphore* s_sem;
+
+TEST_GROUP(PlatformSemaphoreTest) {
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+		s_sem = Semaphore::create(0, 5);
+		CHECK(s_sem);
+	}
+	void teardown()
+	{
+		Semaphore::destroy(s_sem);
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+
+		mock().checkExpectations();
+		mock().clear();
+	}
+};
+
+TEST(PlatformSemaphoreTest, create_destroy)
+{
+	Semaphore* sem = Semaphore::create(3, 3);
+	CHECK(sem);
+	LONGS_EQUAL(3, sem->getCount());
+	LONGS_EQUAL(3, sem->getMaxCount());
+	Semaphore::destroy(sem);
+}
+
+TEST(PlatformSemaphoreTest, create_failed)
+{
+	Semaphore* sem = Semaphore::create(0, 0);
+	CHECK_FALSE(sem);
+	sem = Semaphore::create(4, 3);
+	CHECK_FALSE(sem);
+}
+
+TEST(PlatformSemaphoreTest, tryAcquire_release)
+{
+	LONGS_EQUAL(0, s_sem->getCount());
+	LONGS_EQUAL(OSWrapper::TimedOut, s_sem->tryAcquire(1));
+
+	LONGS_EQUAL(OSWrapper::OK, s_sem->release(3));
+	LONGS_EQUAL(3, s_sem->getCount());
+	LONGS_EQUAL(OSWrapper::TimedOut, s_sem->tryAcquire(4));
+	LONGS_EQUAL(3, s_sem->getCount());
+	LONGS_EQUAL(OSWrapper::OK, s_sem->tryAcquire(2));
+	LONGS_EQUAL(1, s_sem->getCount());
+	LONGS_EQUAL(OSWrapper::OK, s_sem->acquire(1));
+	LONGS_EQUAL(0, s_sem->getCount());
+}
+
+TEST(PlatformSemaphoreTest, release_over_maxCount)
+{
+	LONGS_EQUAL(OSWrapper::OK, s_sem->release(4));
+	LONGS_EQUAL(OSWrapper::OtherError, s_sem->release(2));
+	LONGS_EQUAL(4, s_sem->getCount());
+	LONGS_EQUAL(OSWrapper::OK, s_sem->release(1));
+	LONGS_EQUAL(5, s_sem->getCount());
+	LONGS_EQUAL(OSWrapper::OtherError, s_sem->release(1));
+	LONGS_EQUAL(5, s_sem->getCount());
+}
+
+TEST(PlatformSemaphoreTest, invalid_parameter)
+{
+	LONGS_EQUAL(OSWrapper::InvalidParameter, s_sem->acquire(0));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, s_sem->tryAcquire(6));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, s_sem->timedAcquire(6, Timeout(10)));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, s_sem->release(0));
+}
+
+TEST(PlatformSemaphoreTest, timedAcquire_TimedOut)
+{
+	LONGS_EQUAL(OSWrapper::OK, s_sem->release(1));
+
+	unsigned long t1 = PlatformOSWrapperTestHelper::getCurrentTime();
+	LONGS_EQUAL(OSWrapper::TimedOut, s_sem->timedAcquire(2, Timeout(50)));
+	unsigned long t2 = PlatformOSWrapperTestHelper::getCurrentTime();
+	CHECK(t2 - t1 + PlatformOSWrapperTestHelper::getTimeTolerance() >= 50);
+
+	// No permit is acquired if timedAcquire() fails
+	LONGS_EQUAL(1, s_sem->getCount());
+	LONGS_EQUAL(OSWrapper::OK, s_sem->timedAcquire(1, Timeout(50)));
+}
+
+class AcquireTestRunnable : public Runnable {
+	std::size_t m_num;
+public:
+	explicit AcquireTestRunnable(std::size_t n) : m_num(n) {}
+	void run()
+	{
+		LONGS_EQUAL(OSWrapper::OK, s_sem->acquire(m_num));
+	}
+};
+
+TEST(PlatformSemaphoreTest, release_wakes_up_waiting_thread)
+{
+	AcquireTestRunnable runnable(1);
+	Thread* t = Thread::create(&runnable, Thread::getNormalPriority());
+	CHECK(t);
+	t->start();
+	Thread::sleep(20);
+	CHECK_FALSE(t->isFinished());
+
+	LONGS_EQUAL(OSWrapper::OK, s_sem->release(1));
+	t->wait();
+	CHECK(t->isFinished());
+	LONGS_EQUAL(0, s_sem->getCount());
+
+	Thread::destroy(t);
+}
+
+TEST(PlatformSemaphoreTest, waiters_of_different_numbers)
+{
+	AcquireTestRunnable runnable3(3);
+	AcquireTestRunnable runnable1(1);
+	Thread* t3 = Thread::create(&runnable3, Thread::getNormalPriority());
+	Thread* t1 = Thread::create(&runnable1, Thread::getNormalPriority());
+	CHECK(t3);
+	CHECK(t1);
+	t3->start();
+	t1->start();
+	Thread::sleep(20);
+
+	// The waiter of 1 permit acquires even though the waiter of 3 permits waits
+	LONGS_EQUAL(OSWrapper::OK, s_sem->release(1));
+	t1->wait();
+	Thread::sleep(20);
+	CHECK_FALSE(t3->isFinished());
+
+	LONGS_EQUAL(OSWrapper::OK, s_sem->release(3));
+	t3->wait();
+	LONGS_EQUAL(0, s_sem->getCount());
+
+	Thread::destroy(t1);
+	Thread::destroy(t3);
+}
+
+/*
+ * Bounded buffer by two semaphores: the producers acquire the empty slots and the consumers acquire the filled slots.
+ */
+class BoundedBufferTestRunnable : public Runnable {
+public:
+	static Semaphore* emptySlots;
+	static Semaphore* filledSlots;
+	static const int NUM_LOOPS = 2000;
+
+	explicit BoundedBufferTestRunnable(bool isProducer) : m_isProducer(isProducer), m_count(0) {}
+
+	void run()
+	{
+		for (int i = 0; i < NUM_LOOPS; i++) {
+			if (m_isProducer) {
+				LONGS_EQUAL(OSWrapper::OK, emptySlots->acquire(1));
+				LONGS_EQUAL(OSWrapper::OK, filledSlots->release(1));
+			} else {
+				LONGS_EQUAL(OSWrapper::OK, filledSlots->acquire(1));
+				LONGS_EQUAL(OSWrapper::OK, emptySlots->release(1));
+			}
+			m_count++;
+		}
+	}
+
+	int getCount() const { return m_count; }
+
+private:
+	bool m_isProducer;
+	int m_count;
+};
+Semaphore* BoundedBufferTestRunnable::emptySlots;
+Semaphore* BoundedBufferTestRunnable::filledSlots;
+
+TEST(PlatformSemaphoreTest, bounded_buffer)
+{
+	const std::size_t numSlots = 4;
+	BoundedBufferTestRunnable::emptySlots = Semaphore::create(numSlots, numSlots);
+	BoundedBufferTestRunnable::filledSlots = Semaphore::create(0, numSlots);
+	CHECK(BoundedBufferTestRunnable::emptySlots);
+	CHECK(BoundedBufferTestRunnable::filledSlots);
+
+	const int num = 6;
+	BoundedBufferTestRunnable runnable[num] = {
+		BoundedBufferTestRunnable(true), BoundedBufferTestRunnable(false), BoundedBufferTestRunnable(true),
+		BoundedBufferTestRunnable(false), BoundedBufferTestRunnable(true), BoundedBufferTestRunnable(false),
+	};
+	Thread* t[num];
+	for (int i = 0; i < num; i++) {
+		t[i] = Thread::create(&runnable[i], Thread::getNormalPriority());
+		CHECK(t[i]);
+	}
+	for (int i = 0; i < num; i++) {
+		t[i]->start();
+	}
+	for (int i = 0; i < num; i++) {
+		t[i]->wait();
+		Thread::destroy(t[i]);
+		LONGS_EQUAL(BoundedBufferTestRunnable::NUM_LOOPS, runnable[i].getCount());
+	}
+	LONGS_EQUAL(numSlots, BoundedBufferTestRunnable::emptySlots->getCount());
+	LONGS_EQUAL(0, BoundedBufferTestRunnable::filledSlots->getCount());
+
+	Semaphore::destroy(BoundedBufferTestRunnable::emptySlots);
+	Semaphore::destroy(BoundedBufferTestRunnable::filledSlots);
+}
+
+} // namespace PlatformSemaphoreTest
@@ -0,0 +1,145 @@
+#include "OSWrapper/SizeClassMemoryPool.h"
+#include "OSWrapper/Runnable.h"
+#include "OSWrapper/Thread.h"
+#include <cstring>
+
+#include "PlatformOSWrapperTestHelper.h"
+
+#include "CppUTest/TestHarness.h"
+
+namespace PlatformSizeClassMemoryPoolTest {
+
+using OSWrapper::SizeClassMemoryPool;
+using OSWrapper::Runnable;
+using OSWrapper::Thread;
+
+TEST_GROUP(PlatformSizeClassMemoryPoolTest) {
+	// Size classes of 16, 32, 64 and 128 bytes
+	std::size_t numBlocks[4];
+
+	void setup()
+	{
+		PlatformOSWrapperTestHelper::createAndRegisterOSWrapperFactories();
+		numBlocks[0] = 64;
+		numBlocks[1] = 32;
+		numBlocks[2] = 16;
+		numBlocks[3] = 8;
+	}
+	void teardown()
+	{
+		PlatformOSWrapperTestHelper::destroyOSWrapperFactories();
+	}
+};
+
+TEST(PlatformSizeClassMemoryPoolTest, allocate_deallocate)
+{
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(16, numBlocks, 4, 4096);
+	CHECK(pool);
+
+	void* p[5];
+	const std::size_t sizes[5] = {1, 17, 64, 100, 1000};
+	for (int i = 0; i < 5; i++) {
+		p[i] = pool->allocate(sizes[i]);
+		CHECK(p[i]);
+		std::memset(p[i], i, sizes[i]);
+	}
+	LONGS_EQUAL(1, pool->getNumberOfHits(0));
+	LONGS_EQUAL(1, pool->getNumberOfHits(1));
+	LONGS_EQUAL(1, pool->getNumberOfHits(2));
+	LONGS_EQUAL(1, pool->getNumberOfHits(3));
+	LONGS_EQUAL(1, pool->getNumberOfLargeRequests());
+
+	for (int i = 0; i < 5; i++) {
+		pool->deallocate(p[i]);
+	}
+	SizeClassMemoryPool::destroy(pool);
+}
+
+TEST(PlatformSizeClassMemoryPoolTest, allocate_miss_falls_back_to_large_pool)
+{
+	double poolBuf[1024];
+	CHECK(SizeClassMemoryPool::getRequiredMemorySize(16, numBlocks, 4, 2048) <= sizeof poolBuf);
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(16, numBlocks, 4, 2048, poolBuf);
+	CHECK(pool);
+
+	void* p[9];
+	for (int i = 0; i < 9; i++) {
+		p[i] = pool->allocate(128);
+		CHECK(p[i]);
+	}
+	LONGS_EQUAL(8, pool->getNumberOfHits(3));
+	LONGS_EQUAL(1, pool->getNumberOfMisses(3));
+
+	for (int i = 0; i < 9; i++) {
+		pool->deallocate(p[i]);
+	}
+	SizeClassMemoryPool::destroy(pool);
+}
+
+TEST(PlatformSizeClassMemoryPoolTest, allocate_deallocate_by_multi_threads)
+{
+	class AllocFreeRunnable : public Runnable {
+	private:
+		SizeClassMemoryPool* m_pool;
+		const unsigned char m_pattern;
+		bool m_ok;
+	public:
+		AllocFreeRunnable(SizeClassMemoryPool* pool, unsigned char pattern)
+			: m_pool(pool), m_pattern(pattern), m_ok(true)
+		{}
+		bool isOk() const { return m_ok; }
+		void run()
+		{
+			for (std::size_t i = 0; i < 4000; i++) {
+				const std::size_t size = (i % 128) + 1;
+				unsigned char* p = static_cast<unsigned char*>(m_pool->allocate(size));
+				if (p == 0) {
+					m_ok = false;
+					return;
+				}
+				std::memset(p, m_pattern, size);
+				Thread::yield();
+				for (std::size_t j = 0; j < size; j++) {
+					if (p[j] != m_pattern) {
+						m_ok = false;
+					}
+				}
+				m_pool->deallocate(p);
+			}
+		}
+	};
+
+	SizeClassMemoryPool* pool = SizeClassMemoryPool::create(16, numBlocks, 4);
+	CHECK(pool);
+	AllocFreeRunnable r1(pool, 0x11);
+	AllocFreeRunnable r2(pool, 0x22);
+	AllocFreeRunnable r3(pool, 0x33);
+	Thread* t1 = Thread::create(&r1);
+	Thread* t2 = Thread::create(&r2);
+	Thread* t3 = Thread::create(&r3);
+	CHECK(t1);
+	CHECK(t2);
+	CHECK(t3);
+	t1->start();
+	t2->start();
+	t3->start();
+	t1->wait();
+	t2->wait();
+	t3->wait();
+	CHECK(r1.isOk());
+	CHECK(r2.isOk());
+	CHECK(r3.isOk());
+
+	unsigned long hits = 0;
+	for (std::size_t i = 0; i < pool->getNumberOfSizeClasses(); i++) {
+		hits += pool->getNumberOfHits(i);
+	}
+	LONGS_EQUAL(12000, hits);
+
+	Thread::destroy(t3);
+	Thread::destroy(t2);
+	Thread::destroy(t1);
+	SizeClassMemoryPool::destroy(pool);
+}
+
+} // namespace PlatformSizeClassMemoryPoolTest
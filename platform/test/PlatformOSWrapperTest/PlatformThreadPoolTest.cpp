@@ -6,6 +6,9 @@
 #include "OSWrapper/ThreadPool.h"
 #include "Assertion/Assertion.h"
 #include <stdexcept>
+#if (__cplusplus >= 201103L)
+#include <atomic>
+#endif
 
 #include "PlatformOSWrapperTestHelper.h"
 #if defined(PLATFORM_OS_WINDOWS)
@@ -348,6 +351,726 @@ TEST(PlatformThreadPoolTest, check_priority_stackSize_threadName)
 	ThreadPool::destroy(threadPool);
 }
 
+class BlockingRunnable : public Runnable {
+	OSWrapper::EventFlag* m_ev;
+	OSWrapper::EventFlag* m_started;
+	int m_count;
+public:
+	explicit BlockingRunnable(OSWrapper::EventFlag* ev, OSWrapper::EventFlag* started = 0)
+	: m_ev(ev), m_started(started), m_count(0) {}
+	int getCount() const { return m_count; }
+	void run()
+	{
+		if (m_started != 0) {
+			m_started->setAll();
+		}
+		m_ev->waitAny();
+		m_count++;
+	}
+};
+
+TEST(PlatformThreadPoolTest, createQueued_destroy)
+{
+	ThreadPool* threadPool = ThreadPool::createQueued(4, 16, ThreadPool::BLOCK, 4096);
+	CHECK(threadPool);
+	ThreadPool::destroy(threadPool);
+}
+
+TEST(PlatformThreadPoolTest, createQueued_invalid_parameter)
+{
+	CHECK(ThreadPool::createQueued(0, 16) == 0);
+}
+
+TEST(PlatformThreadPoolTest, queued_start_without_free_thread)
+{
+	OSWrapper::EventFlag* ev = OSWrapper::EventFlag::create(false);
+	CHECK(ev);
+	ThreadPool* threadPool = ThreadPool::createQueued(1, 2, ThreadPool::BLOCK, 4096);
+	CHECK(threadPool);
+
+	BlockingRunnable runnable1(ev);
+	BlockingRunnable runnable2(ev);
+	BlockingRunnable runnable3(ev);
+	BlockingRunnable runnable4(ev);
+	{
+		ThreadPool::WaitGuard waiter1;
+		ThreadPool::WaitGuard waiter2;
+		ThreadPool::WaitGuard waiter3;
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable1, &waiter1));
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable2, &waiter2));
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable3, &waiter3));
+		LONGS_EQUAL(OSWrapper::TimedOut, threadPool->tryStart(&runnable4));
+		LONGS_EQUAL(OSWrapper::TimedOut, threadPool->timedStart(&runnable4, Timeout(10)));
+
+		ev->setAll();
+	}
+	LONGS_EQUAL(1, runnable1.getCount());
+	LONGS_EQUAL(1, runnable2.getCount());
+	LONGS_EQUAL(1, runnable3.getCount());
+	LONGS_EQUAL(0, runnable4.getCount());
+
+	ThreadPool::destroy(threadPool);
+	OSWrapper::EventFlag::destroy(ev);
+}
+
+TEST(PlatformThreadPoolTest, queued_start_nowaiter)
+{
+	TestRunnable runnable[100];
+	{
+		ThreadPool* threadPool = ThreadPool::createQueued(4, 8, ThreadPool::BLOCK, 4096);
+		CHECK(threadPool);
+
+		for (int i = 0; i < 100; i++) {
+			OSWrapper::Error err = threadPool->start(&runnable[i]);
+			LONGS_EQUAL(OSWrapper::OK, err);
+		}
+
+		ThreadPool::destroy(threadPool);
+	}
+	for (int i = 0; i < 100; i++) {
+		LONGS_EQUAL(100, runnable[i].getResult());
+	}
+}
+
+TEST(PlatformThreadPoolTest, queued_REJECT)
+{
+	OSWrapper::EventFlag* ev = OSWrapper::EventFlag::create(false);
+	CHECK(ev);
+	ThreadPool* threadPool = ThreadPool::createQueued(1, 1, ThreadPool::REJECT, 4096);
+	CHECK(threadPool);
+
+	BlockingRunnable runnable1(ev);
+	BlockingRunnable runnable2(ev);
+	TestRunnable runnable3(3);
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable1));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable2));
+	LONGS_EQUAL(OSWrapper::TimedOut, threadPool->start(&runnable3));
+
+	ev->setAll();
+	ThreadPool::destroy(threadPool);
+	OSWrapper::EventFlag::destroy(ev);
+
+	LONGS_EQUAL(1, runnable1.getCount());
+	LONGS_EQUAL(1, runnable2.getCount());
+	LONGS_EQUAL(3, runnable3.getResult());
+}
+
+TEST(PlatformThreadPoolTest, queued_CALLER_RUNS)
+{
+	OSWrapper::EventFlag* ev = OSWrapper::EventFlag::create(false);
+	CHECK(ev);
+	ThreadPool* threadPool = ThreadPool::createQueued(1, 1, ThreadPool::CALLER_RUNS, 4096);
+	CHECK(threadPool);
+
+	BlockingRunnable runnable1(ev);
+	BlockingRunnable runnable2(ev);
+	TestRunnable runnable3(3);
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable1));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable2));
+	{
+		ThreadPool::WaitGuard waiter;
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable3, &waiter));
+		LONGS_EQUAL(103, runnable3.getResult());
+		CHECK_FALSE(waiter.isValid());
+	}
+
+	ev->setAll();
+	ThreadPool::destroy(threadPool);
+	OSWrapper::EventFlag::destroy(ev);
+
+	LONGS_EQUAL(1, runnable1.getCount());
+	LONGS_EQUAL(1, runnable2.getCount());
+}
+
+TEST(PlatformThreadPoolTest, queued_DISCARD_OLDEST)
+{
+	OSWrapper::EventFlag* ev = OSWrapper::EventFlag::create(false);
+	CHECK(ev);
+	OSWrapper::EventFlag* started = OSWrapper::EventFlag::create(false);
+	CHECK(started);
+	ThreadPool* threadPool = ThreadPool::createQueued(1, 2, ThreadPool::DISCARD_OLDEST, 4096);
+	CHECK(threadPool);
+
+	BlockingRunnable runnable1(ev, started);
+	BlockingRunnable runnable2(ev);
+	BlockingRunnable runnable3(ev);
+	BlockingRunnable runnable4(ev);
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable1));
+	started->waitAny();
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable2));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable3));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable4));
+
+	ev->setAll();
+	ThreadPool::destroy(threadPool);
+	OSWrapper::EventFlag::destroy(started);
+	OSWrapper::EventFlag::destroy(ev);
+
+	LONGS_EQUAL(1, runnable1.getCount());
+	LONGS_EQUAL(0, runnable2.getCount());
+	LONGS_EQUAL(1, runnable3.getCount());
+	LONGS_EQUAL(1, runnable4.getCount());
+}
+
+TEST(PlatformThreadPoolTest, queued_DISCARD_OLDEST_waiter)
+{
+	OSWrapper::EventFlag* ev = OSWrapper::EventFlag::create(false);
+	CHECK(ev);
+	OSWrapper::EventFlag* started = OSWrapper::EventFlag::create(false);
+	CHECK(started);
+	ThreadPool* threadPool = ThreadPool::createQueued(1, 2, ThreadPool::DISCARD_OLDEST, 4096);
+	CHECK(threadPool);
+
+	BlockingRunnable runnable1(ev, started);
+	BlockingRunnable runnable2(ev);
+	BlockingRunnable runnable3(ev);
+	BlockingRunnable runnable4(ev);
+	{
+		ThreadPool::WaitGuard waiter1;
+		ThreadPool::WaitGuard waiter2;
+		ThreadPool::WaitGuard waiter4;
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable1, &waiter1));
+		started->waitAny();
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable2, &waiter2));
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable3));
+		// runnable2 keeps its entry until waiter2 is released, so runnable3 is also discarded
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable4, &waiter4));
+
+		LONGS_EQUAL(OSWrapper::OtherError, waiter2.wait());
+		waiter2.release();
+
+		ev->setAll();
+		LONGS_EQUAL(OSWrapper::OK, waiter1.wait());
+		LONGS_EQUAL(OSWrapper::OK, waiter4.wait());
+	}
+
+	ThreadPool::destroy(threadPool);
+	OSWrapper::EventFlag::destroy(started);
+	OSWrapper::EventFlag::destroy(ev);
+
+	LONGS_EQUAL(1, runnable1.getCount());
+	LONGS_EQUAL(0, runnable2.getCount());
+	LONGS_EQUAL(0, runnable3.getCount());
+	LONGS_EQUAL(1, runnable4.getCount());
+}
+
+TEST(PlatformThreadPoolTest, queued_check_priority_stackSize_threadName)
+{
+	class CheckPriorityStackSizeRunnable : public Runnable {
+	public:
+		Thread* m_thread;
+		void run()
+		{
+			m_thread = Thread::getCurrentThread();
+			LONGS_EQUAL(4096, m_thread->getStackSize());
+			LONGS_EQUAL(Thread::getPriorityHigherThan(Thread::getNormalPriority(), 1),
+					m_thread->getPriority());
+			STRCMP_EQUAL("ThreadPool", m_thread->getName());
+		}
+	};
+	ThreadPool* threadPool = ThreadPool::createQueued(2, 4, ThreadPool::BLOCK, 4096, Thread::getHighestPriority(), "ThreadPool");
+	CHECK(threadPool);
+	STRCMP_EQUAL("ThreadPool", threadPool->getThreadName());
+
+	CheckPriorityStackSizeRunnable runnable;
+	{
+		ThreadPool::WaitGuard waiter;
+		OSWrapper::Error err = threadPool->start(&runnable, &waiter,
+				Thread::getPriorityHigherThan(Thread::getNormalPriority(), 1));
+		LONGS_EQUAL(OSWrapper::OK, err);
+	}
+	LONGS_EQUAL(Thread::getHighestPriority(), runnable.m_thread->getPriority());
+
+	ThreadPool::destroy(threadPool);
+}
+
+class OrderRunnable : public Runnable {
+	int* m_counter;
+	int m_order;
+public:
+	explicit OrderRunnable(int* counter) : m_counter(counter), m_order(-1) {}
+	int getOrder() const { return m_order; }
+	void run()
+	{
+		m_order = (*m_counter)++;
+	}
+};
+
+TEST(PlatformThreadPoolTest, createPriorityQueued_destroy)
+{
+	ThreadPool* threadPool = ThreadPool::createPriorityQueued(4, 16, ThreadPool::BLOCK, 4096);
+	CHECK(threadPool);
+	ThreadPool::destroy(threadPool);
+}
+
+TEST(PlatformThreadPoolTest, createPriorityQueued_invalid_parameter)
+{
+	CHECK(ThreadPool::createPriorityQueued(0, 16) == 0);
+}
+
+// StdCppOSWrapper has only one priority
+#if !defined(PLATFORM_OS_STDCPP)
+TEST(PlatformThreadPoolTest, priorityQueued_order)
+{
+	OSWrapper::EventFlag* ev = OSWrapper::EventFlag::create(false);
+	CHECK(ev);
+	OSWrapper::EventFlag* started = OSWrapper::EventFlag::create(false);
+	CHECK(started);
+	ThreadPool* threadPool = ThreadPool::createPriorityQueued(1, 5, ThreadPool::BLOCK, 4096);
+	CHECK(threadPool);
+
+	const int normal = Thread::getNormalPriority();
+	const int high = Thread::getPriorityHigherThan(normal, 1);
+	const int low = Thread::getPriorityHigherThan(normal, -1);
+	int counter = 0;
+	BlockingRunnable blocking(ev, started);
+	OrderRunnable low1(&counter);
+	OrderRunnable normal1(&counter);
+	OrderRunnable high1(&counter);
+	OrderRunnable inherit1(&counter);
+	OrderRunnable high2(&counter);
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&blocking));
+	started->waitAny();
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&low1, 0, low));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&normal1, 0, normal));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&high1, 0, high));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&inherit1));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&high2, 0, high));
+
+	ev->setAll();
+	ThreadPool::destroy(threadPool);
+	OSWrapper::EventFlag::destroy(started);
+	OSWrapper::EventFlag::destroy(ev);
+
+	LONGS_EQUAL(0, high1.getOrder());
+	LONGS_EQUAL(1, high2.getOrder());
+	LONGS_EQUAL(2, normal1.getOrder());
+	LONGS_EQUAL(3, inherit1.getOrder());
+	LONGS_EQUAL(4, low1.getOrder());
+}
+
+TEST(PlatformThreadPoolTest, priorityQueued_DISCARD_OLDEST)
+{
+	OSWrapper::EventFlag* ev = OSWrapper::EventFlag::create(false);
+	CHECK(ev);
+	OSWrapper::EventFlag* started = OSWrapper::EventFlag::create(false);
+	CHECK(started);
+	ThreadPool* threadPool = ThreadPool::createPriorityQueued(1, 3, ThreadPool::DISCARD_OLDEST, 4096);
+	CHECK(threadPool);
+
+	const int normal = Thread::getNormalPriority();
+	const int high = Thread::getPriorityHigherThan(normal, 1);
+	const int low = Thread::getPriorityHigherThan(normal, -1);
+	int counter = 0;
+	BlockingRunnable blocking(ev, started);
+	OrderRunnable high1(&counter);
+	OrderRunnable low1(&counter);
+	OrderRunnable low2(&counter);
+	OrderRunnable normal1(&counter);
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&blocking));
+	started->waitAny();
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&high1, 0, high));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&low1, 0, low));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&low2, 0, low));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->start(&normal1, 0, normal));
+
+	ev->setAll();
+	ThreadPool::destroy(threadPool);
+	OSWrapper::EventFlag::destroy(started);
+	OSWrapper::EventFlag::destroy(ev);
+
+	LONGS_EQUAL(0, high1.getOrder());
+	LONGS_EQUAL(1, normal1.getOrder());
+	LONGS_EQUAL(-1, low1.getOrder());
+	LONGS_EQUAL(2, low2.getOrder());
+}
+
+#endif
+
+TEST(PlatformThreadPoolTest, priorityQueued_start_waiter_multi)
+{
+	ThreadPool* threadPool = ThreadPool::createPriorityQueued(2, 4, ThreadPool::BLOCK, 4096);
+	CHECK(threadPool);
+
+	TestRunnable runnable[10];
+	{
+		ThreadPool::WaitGuard waiter[10];
+		for (int i = 0; i < 10; i++) {
+			OSWrapper::Error err = threadPool->start(&runnable[i], &waiter[i],
+					Thread::getPriorityHigherThan(Thread::getNormalPriority(), i % 3));
+			LONGS_EQUAL(OSWrapper::OK, err);
+			if (i % 2 == 1) {
+				waiter[i - 1].release();
+				waiter[i].release();
+			}
+		}
+	}
+	for (int i = 0; i < 10; i++) {
+		LONGS_EQUAL(100, runnable[i].getResult());
+	}
+
+	ThreadPool::destroy(threadPool);
+}
+
+#if (__cplusplus >= 201103L)
+class CountRunnable : public Runnable {
+	std::atomic<int>* m_count;
+public:
+	CountRunnable() : m_count(0) {}
+	void init(std::atomic<int>* count) { m_count = count; }
+	void run()
+	{
+		m_count->fetch_add(1);
+	}
+};
+
+TEST(PlatformThreadPoolTest, createWorkStealing_destroy)
+{
+	ThreadPool* threadPool = ThreadPool::createWorkStealing(4, 16, 4096);
+	CHECK(threadPool);
+	ThreadPool::destroy(threadPool);
+}
+
+TEST(PlatformThreadPoolTest, createWorkStealing_invalid_parameter)
+{
+	CHECK(ThreadPool::createWorkStealing(0, 16) == 0);
+	CHECK(ThreadPool::createWorkStealing(4, 0) == 0);
+}
+
+TEST(PlatformThreadPoolTest, workStealing_start_nowaiter)
+{
+	static const int num = 1000;
+	std::atomic<int> count(0);
+	CountRunnable runnable[num];
+	{
+		ThreadPool* threadPool = ThreadPool::createWorkStealing(4, 16, 4096);
+		CHECK(threadPool);
+
+		for (int i = 0; i < num; i++) {
+			runnable[i].init(&count);
+			OSWrapper::Error err = threadPool->start(&runnable[i]);
+			LONGS_EQUAL(OSWrapper::OK, err);
+		}
+
+		ThreadPool::destroy(threadPool);
+	}
+	LONGS_EQUAL(num, count.load());
+}
+
+TEST(PlatformThreadPoolTest, workStealing_start_waiter_multi)
+{
+	ThreadPool* threadPool = ThreadPool::createWorkStealing(2, 16, 4096);
+	CHECK(threadPool);
+
+	TestRunnable runnable1(1);
+	TestRunnable runnable2(2);
+	TestRunnable runnable3(3);
+	{
+		OSWrapper::Error err;
+		ThreadPool::WaitGuard waiter1;
+		err = threadPool->start(&runnable1, &waiter1);
+		LONGS_EQUAL(OSWrapper::OK, err);
+
+		ThreadPool::WaitGuard waiter2;
+		err = threadPool->start(&runnable2, &waiter2);
+		LONGS_EQUAL(OSWrapper::OK, err);
+
+		ThreadPool::WaitGuard waiter3;
+		err = threadPool->start(&runnable3, &waiter3);
+		LONGS_EQUAL(OSWrapper::OK, err);
+
+		waiter1.wait();
+		LONGS_EQUAL(101, runnable1.getResult());
+
+		waiter2.wait();
+		LONGS_EQUAL(102, runnable2.getResult());
+
+		waiter3.wait();
+		LONGS_EQUAL(103, runnable3.getResult());
+	}
+
+	ThreadPool::destroy(threadPool);
+}
+
+TEST(PlatformThreadPoolTest, workStealing_tryStart_TimedOut)
+{
+	OSWrapper::EventFlag* ev = OSWrapper::EventFlag::create(false);
+	CHECK(ev);
+	ThreadPool* threadPool = ThreadPool::createWorkStealing(1, 2, 4096);
+	CHECK(threadPool);
+
+	BlockingRunnable runnable(ev);
+	LONGS_EQUAL(OSWrapper::OK, threadPool->tryStart(&runnable));
+	LONGS_EQUAL(OSWrapper::OK, threadPool->tryStart(&runnable));
+	LONGS_EQUAL(OSWrapper::TimedOut, threadPool->tryStart(&runnable));
+	LONGS_EQUAL(OSWrapper::TimedOut, threadPool->timedStart(&runnable, Timeout(10)));
+
+	ev->setAll();
+	ThreadPool::destroy(threadPool);
+	OSWrapper::EventFlag::destroy(ev);
+}
+
+TEST(PlatformThreadPoolTest, workStealing_start_in_task)
+{
+	static const int numParents = 8;
+	static const int numChildren = 100;
+	class ParentRunnable : public Runnable {
+		ThreadPool* m_tp;
+		CountRunnable m_children[numChildren];
+	public:
+		ParentRunnable() : m_tp(0), m_children() {}
+		void init(ThreadPool* tp, std::atomic<int>* count)
+		{
+			m_tp = tp;
+			for (int i = 0; i < numChildren; i++) {
+				m_children[i].init(count);
+			}
+		}
+		void run()
+		{
+			for (int i = 0; i < numChildren; i++) {
+				m_tp->start(&m_children[i]);
+			}
+		}
+	};
+	std::atomic<int> count(0);
+	ParentRunnable parents[numParents];
+	{
+		ThreadPool* threadPool = ThreadPool::createWorkStealing(4, (numParents + 1) * numChildren, 4096);
+		CHECK(threadPool);
+
+		for (int i = 0; i < numParents; i++) {
+			parents[i].init(threadPool, &count);
+			OSWrapper::Error err = threadPool->start(&parents[i]);
+			LONGS_EQUAL(OSWrapper::OK, err);
+		}
+
+		ThreadPool::destroy(threadPool);
+	}
+	LONGS_EQUAL(numParents * numChildren, count.load());
+}
+
+TEST(PlatformThreadPoolTest, workStealing_check_priority_stackSize_threadName)
+{
+	class CheckPriorityStackSizeRunnable : public Runnable {
+	public:
+		Thread* m_thread;
+		void run()
+		{
+			m_thread = Thread::getCurrentThread();
+			LONGS_EQUAL(4096, m_thread->getStackSize());
+			LONGS_EQUAL(Thread::getPriorityHigherThan(Thread::getNormalPriority(), 1),
+					m_thread->getPriority());
+			STRCMP_EQUAL("ThreadPool", m_thread->getName());
+		}
+	};
+	ThreadPool* threadPool = ThreadPool::createWorkStealing(2, 4, 4096, Thread::getHighestPriority(), "ThreadPool");
+	CHECK(threadPool);
+	STRCMP_EQUAL("ThreadPool", threadPool->getThreadName());
+
+	CheckPriorityStackSizeRunnable runnable;
+	{
+		ThreadPool::WaitGuard waiter;
+		OSWrapper::Error err = threadPool->start(&runnable, &waiter,
+				Thread::getPriorityHigherThan(Thread::getNormalPriority(), 1));
+		LONGS_EQUAL(OSWrapper::OK, err);
+	}
+	LONGS_EQUAL(Thread::getHighestPriority(), runnable.m_thread->getPriority());
+
+	ThreadPool::destroy(threadPool);
+}
+
+#ifndef CPPELIB_NO_EXCEPTIONS
+TEST(PlatformThreadPoolTest, workStealing_exception)
+{
+	class ThrowRunnable : public Runnable {
+		void run()
+		{
+			throw std::runtime_error("Exception Test");
+		}
+	};
+	ThreadPool* threadPool = ThreadPool::createWorkStealing(1, 4, 4096);
+	CHECK(threadPool);
+	MyExceptionHandler handler("Exception Test");
+	threadPool->setUncaughtExceptionHandler(&handler);
+	mock().expectOneCall("handle").onObject(&handler);
+
+	ThrowRunnable throwRunnable;
+	TestRunnable runnable(1);
+	{
+		ThreadPool::WaitGuard waiter1;
+		OSWrapper::Error err = threadPool->start(&throwRunnable, &waiter1);
+		LONGS_EQUAL(OSWrapper::OK, err);
+		waiter1.wait();
+
+		// The thread keeps running after the exception
+		ThreadPool::WaitGuard waiter2;
+		err = threadPool->start(&runnable, &waiter2);
+		LONGS_EQUAL(OSWrapper::OK, err);
+	}
+	LONGS_EQUAL(101, runnable.getResult());
+
+	ThreadPool::destroy(threadPool);
+}
+#endif
+#endif
+
+class AppendRunnable : public Runnable {
+	OSWrapper::Mutex* m_mtx;
+	char* m_buf;
+	std::size_t* m_len;
+	char m_c;
+public:
+	AppendRunnable(OSWrapper::Mutex* mtx, char* buf, std::size_t* len, char c)
+	: m_mtx(mtx), m_buf(buf), m_len(len), m_c(c) {}
+	void run()
+	{
+		OSWrapper::LockGuard lock(m_mtx);
+		m_buf[*m_len] = m_c;
+		(*m_len)++;
+	}
+};
+
+static void checkStartAfterAll(ThreadPool* threadPool)
+{
+	OSWrapper::EventFlag* ev = OSWrapper::EventFlag::create(false);
+	CHECK(ev);
+	OSWrapper::Mutex* mtx = OSWrapper::Mutex::create();
+	CHECK(mtx);
+	char buf[8] = {0};
+	std::size_t len = 0U;
+
+	BlockingRunnable runnable1(ev);
+	BlockingRunnable runnable2(ev);
+	AppendRunnable runnable3(mtx, buf, &len, 'c');
+	AppendRunnable runnable4(mtx, buf, &len, 'd');
+	{
+		ThreadPool::WaitGuard waiter1;
+		ThreadPool::WaitGuard waiter2;
+		ThreadPool::WaitGuard waiter3;
+		ThreadPool::WaitGuard waiter4;
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable1, &waiter1));
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable2, &waiter2));
+		ThreadPool::WaitGuard* antecedents3[] = {&waiter1, &waiter2};
+		LONGS_EQUAL(OSWrapper::OK, threadPool->startAfterAll(antecedents3, 2, &runnable3, &waiter3));
+		ThreadPool::WaitGuard* antecedents4[] = {&waiter3};
+		LONGS_EQUAL(OSWrapper::OK, threadPool->startAfterAll(antecedents4, 1, &runnable4, &waiter4));
+
+		// An antecedent has at most one following task while it is running
+		LONGS_EQUAL(OSWrapper::InvalidParameter, threadPool->startAfterAll(antecedents4, 1, &runnable4));
+
+		LONGS_EQUAL(OSWrapper::TimedOut, waiter3.tryWait());
+		ev->setAll();
+		LONGS_EQUAL(OSWrapper::OK, waiter4.wait());
+		LONGS_EQUAL(OSWrapper::OK, waiter3.tryWait());
+	}
+	LONGS_EQUAL(1, runnable1.getCount());
+	LONGS_EQUAL(1, runnable2.getCount());
+	STRCMP_EQUAL("cd", buf);
+
+	OSWrapper::Mutex::destroy(mtx);
+	OSWrapper::EventFlag::destroy(ev);
+}
+
+TEST(PlatformThreadPoolTest, startAfterAll)
+{
+	ThreadPool* threadPool = ThreadPool::create(4, 4096);
+	CHECK(threadPool);
+	checkStartAfterAll(threadPool);
+	ThreadPool::destroy(threadPool);
+}
+
+TEST(PlatformThreadPoolTest, queued_startAfterAll)
+{
+	ThreadPool* threadPool = ThreadPool::createQueued(2, 4, ThreadPool::BLOCK, 4096);
+	CHECK(threadPool);
+	checkStartAfterAll(threadPool);
+	ThreadPool::destroy(threadPool);
+}
+
+TEST(PlatformThreadPoolTest, startAfterAll_finished_antecedent)
+{
+	ThreadPool* threadPool = ThreadPool::create(2, 4096);
+	CHECK(threadPool);
+
+	TestRunnable runnable1;
+	TestRunnable runnable2(1);
+	{
+		ThreadPool::WaitGuard waiter1;
+		ThreadPool::WaitGuard waiter2;
+		ThreadPool::WaitGuard invalidWaiter;
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable1, &waiter1));
+		LONGS_EQUAL(OSWrapper::OK, waiter1.wait());
+		ThreadPool::WaitGuard* antecedents[] = {&waiter1, &invalidWaiter};
+		LONGS_EQUAL(OSWrapper::OK, threadPool->timedStartAfterAll(antecedents, 2, &runnable2, Timeout(1000), &waiter2));
+		LONGS_EQUAL(OSWrapper::OK, waiter2.wait());
+	}
+	LONGS_EQUAL(100, runnable1.getResult());
+	LONGS_EQUAL(101, runnable2.getResult());
+
+	ThreadPool::destroy(threadPool);
+}
+
+TEST(PlatformThreadPoolTest, startAfterAny)
+{
+	OSWrapper::EventFlag* ev1 = OSWrapper::EventFlag::create(false);
+	CHECK(ev1);
+	OSWrapper::EventFlag* ev2 = OSWrapper::EventFlag::create(false);
+	CHECK(ev2);
+	ThreadPool* threadPool = ThreadPool::createQueued(2, 2, ThreadPool::BLOCK, 4096);
+	CHECK(threadPool);
+
+	BlockingRunnable runnable1(ev1);
+	BlockingRunnable runnable2(ev2);
+	TestRunnable runnable3;
+	{
+		ThreadPool::WaitGuard waiter1;
+		ThreadPool::WaitGuard waiter2;
+		ThreadPool::WaitGuard waiter3;
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable1, &waiter1));
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable2, &waiter2));
+		ThreadPool::WaitGuard* antecedents[] = {&waiter1, &waiter2};
+		LONGS_EQUAL(OSWrapper::OK, threadPool->startAfterAny(antecedents, 2, &runnable3, &waiter3));
+
+		LONGS_EQUAL(OSWrapper::TimedOut, waiter3.timedWait(Timeout(10)));
+		ev2->setAll();
+		LONGS_EQUAL(OSWrapper::OK, waiter3.wait());
+		LONGS_EQUAL(100, runnable3.getResult());
+		LONGS_EQUAL(OSWrapper::TimedOut, waiter1.tryWait());
+
+		// The entry of runnable3 can be reused while runnable1 is still linked to it
+		waiter3.release();
+		LONGS_EQUAL(OSWrapper::OK, threadPool->start(&runnable3, &waiter3));
+		LONGS_EQUAL(OSWrapper::OK, waiter3.wait());
+		LONGS_EQUAL(200, runnable3.getResult());
+		ev1->setAll();
+	}
+	LONGS_EQUAL(1, runnable1.getCount());
+	LONGS_EQUAL(1, runnable2.getCount());
+	LONGS_EQUAL(200, runnable3.getResult());
+
+	ThreadPool::destroy(threadPool);
+	OSWrapper::EventFlag::destroy(ev2);
+	OSWrapper::EventFlag::destroy(ev1);
+}
+
+TEST(PlatformThreadPoolTest, startAfterAll_invalid_parameter)
+{
+	ThreadPool* threadPool = ThreadPool::create(2, 4096);
+	CHECK(threadPool);
+
+	TestRunnable runnable;
+	ThreadPool::WaitGuard waiter;
+	ThreadPool::WaitGuard* antecedents[] = {&waiter};
+	ThreadPool::WaitGuard* nullAntecedents[] = {0};
+	LONGS_EQUAL(OSWrapper::InvalidParameter, threadPool->startAfterAll(0, 1, &runnable));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, threadPool->startAfterAll(antecedents, 0, &runnable));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, threadPool->startAfterAll(antecedents, 1, 0));
+	LONGS_EQUAL(OSWrapper::InvalidParameter, threadPool->startAfterAny(nullAntecedents, 1, &runnable));
+
+	ThreadPool::destroy(threadPool);
+}
+
 TEST(PlatformThreadPoolTest, invalid_waiter)
 {
 	ThreadPool::WaitGuard waiter;
@@ -1,4 +1,5 @@
 #include "OSWrapper/VariableMemoryPool.h"
+#include <cstring>
 
 #include "PlatformOSWrapperTestHelper.h"
 
@@ -88,6 +89,121 @@ TEST(PlatformVariableMemoryPoolTest, allocate_failed)
 }
 #endif
 
+#if defined(PLATFORM_OS_STDCPP) || defined(PLATFORM_OS_POSIX) || defined(PLATFORM_OS_WINDOWS)
+TEST(PlatformVariableMemoryPoolTest, create_failed_too_small)
+{
+	double poolBuf[2];
+	VariableMemoryPool* pool = VariableMemoryPool::create(sizeof poolBuf, poolBuf);
+	CHECK(!pool);
+}
+
+TEST(PlatformVariableMemoryPoolTest, allocate_within_pool_area)
+{
+	double poolBuf[128];
+	VariableMemoryPool* pool = VariableMemoryPool::create(sizeof poolBuf, poolBuf);
+	CHECK(pool);
+	const char* begin = reinterpret_cast<const char*>(poolBuf);
+	const char* end = begin + sizeof poolBuf;
+
+	void* p[3];
+	for (int i = 0; i < 3; i++) {
+		p[i] = pool->allocate(100);
+		CHECK(p[i]);
+		CHECK(static_cast<char*>(p[i]) >= begin);
+		CHECK(static_cast<char*>(p[i]) + 100 <= end);
+		LONGS_EQUAL(0, reinterpret_cast<std::size_t>(p[i]) % sizeof(double));
+		std::memset(p[i], i, 100);
+	}
+	CHECK(static_cast<char*>(p[0]) + 100 <= static_cast<char*>(p[1]));
+	CHECK(static_cast<char*>(p[1]) + 100 <= static_cast<char*>(p[2]));
+
+	for (int i = 0; i < 3; i++) {
+		pool->deallocate(p[i]);
+	}
+	VariableMemoryPool::destroy(pool);
+}
+
+TEST(PlatformVariableMemoryPoolTest, allocate_failed_exhausted)
+{
+	double poolBuf[128];
+	VariableMemoryPool* pool = VariableMemoryPool::create(sizeof poolBuf, poolBuf);
+	CHECK(pool);
+
+	CHECK(pool->allocate(sizeof poolBuf) == 0);
+
+	void* p = pool->allocate(sizeof poolBuf / 2);
+	CHECK(p);
+	void* q = pool->allocate(sizeof poolBuf / 2);
+	CHECK(q == 0);
+
+	pool->deallocate(p);
+	q = pool->allocate(sizeof poolBuf / 2);
+	POINTERS_EQUAL(p, q);
+	pool->deallocate(q);
+
+	VariableMemoryPool::destroy(pool);
+}
+
+TEST(PlatformVariableMemoryPoolTest, deallocate_coalesces_free_blocks)
+{
+	double poolBuf[128];
+	VariableMemoryPool* pool = VariableMemoryPool::create(sizeof poolBuf, poolBuf);
+	CHECK(pool);
+
+	void* large = pool->allocate(sizeof poolBuf / 2);
+	CHECK(large);
+	pool->deallocate(large);
+
+	void* p[4];
+	for (int i = 0; i < 4; i++) {
+		p[i] = pool->allocate(200);
+		CHECK(p[i]);
+	}
+	CHECK(pool->allocate(sizeof poolBuf / 2) == 0);
+
+	// Release in the order that merges with the previous block, the next block, and both of them
+	pool->deallocate(p[1]);
+	pool->deallocate(p[0]);
+	pool->deallocate(p[3]);
+	pool->deallocate(p[2]);
+
+	// The whole area is one free block again
+	void* q = pool->allocate(sizeof poolBuf - 64);
+	POINTERS_EQUAL(large, q);
+	pool->deallocate(q);
+
+	VariableMemoryPool::destroy(pool);
+}
+
+TEST(PlatformVariableMemoryPoolTest, allocate_many_sizes)
+{
+	VariableMemoryPool* pool = VariableMemoryPool::create(64 * 1024);
+	CHECK(pool);
+
+	void* p[64];
+	for (int round = 0; round < 2; round++) {
+		for (int i = 0; i < 64; i++) {
+			const std::size_t size = static_cast<std::size_t>((i * 37) % 500) + 1;
+			p[i] = pool->allocate(size);
+			CHECK(p[i]);
+			std::memset(p[i], 0xA5, size);
+		}
+		// Release every other block first to fragment the free area
+		for (int i = 0; i < 64; i += 2) {
+			pool->deallocate(p[i]);
+		}
+		for (int i = 1; i < 64; i += 2) {
+			pool->deallocate(p[i]);
+		}
+	}
+	void* q = pool->allocate(60 * 1024);
+	CHECK(q);
+	pool->deallocate(q);
+
+	VariableMemoryPool::destroy(pool);
+}
+#endif
+
 TEST(PlatformVariableMemoryPoolTest, deallocate_nullptr)
 {
 	double poolBuf[100];
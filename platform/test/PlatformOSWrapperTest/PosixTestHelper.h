@@ -4,7 +4,9 @@
 #include "PlatformOSWrapperTestHelper.h"
 #include "PosixOSWrapper/PosixThreadFactory.h"
 #include "PosixOSWrapper/PosixMutexFactory.h"
+#include "PosixOSWrapper/PosixRWLockFactory.h"
 #include "PosixOSWrapper/PosixEventFlagFactory.h"
+#include "PosixOSWrapper/PosixSemaphoreFactory.h"
 #include "PosixOSWrapper/PosixFixedMemoryPoolFactory.h"
 #include "PosixOSWrapper/PosixVariableMemoryPoolFactory.h"
 #include "PosixOSWrapper/PosixPeriodicTimerFactory.h"
@@ -23,11 +25,21 @@ public:
 		return new PosixOSWrapper::PosixMutexFactory();
 	}
 
+	OSWrapper::RWLockFactory* createRWLockFactory()
+	{
+		return new PosixOSWrapper::PosixRWLockFactory();
+	}
+
 	OSWrapper::EventFlagFactory* createEventFlagFactory()
 	{
 		return new PosixOSWrapper::PosixEventFlagFactory();
 	}
 
+	OSWrapper::SemaphoreFactory* createSemaphoreFactory()
+	{
+		return new PosixOSWrapper::PosixSemaphoreFactory();
+	}
+
 	OSWrapper::FixedMemoryPoolFactory* createFixedMemoryPoolFactory()
 	{
 		return new PosixOSWrapper::PosixFixedMemoryPoolFactory();
@@ -58,11 +70,21 @@ public:
 		delete factory;
 	}
 
+	void destroyRWLockFactory(OSWrapper::RWLockFactory* factory)
+	{
+		delete factory;
+	}
+
 	void destroyEventFlagFactory(OSWrapper::EventFlagFactory* factory)
 	{
 		delete factory;
 	}
 
+	void destroySemaphoreFactory(OSWrapper::SemaphoreFactory* factory)
+	{
+		delete factory;
+	}
+
 	void destroyFixedMemoryPoolFactory(OSWrapper::FixedMemoryPoolFactory* factory)
 	{
 		delete factory;
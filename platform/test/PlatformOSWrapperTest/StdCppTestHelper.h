@@ -4,7 +4,9 @@
 #include "PlatformOSWrapperTestHelper.h"
 #include "StdCppOSWrapper/StdCppThreadFactory.h"
 #include "StdCppOSWrapper/StdCppMutexFactory.h"
+#include "StdCppOSWrapper/StdCppRWLockFactory.h"
 #include "StdCppOSWrapper/StdCppEventFlagFactory.h"
+#include "StdCppOSWrapper/StdCppSemaphoreFactory.h"
 #include "StdCppOSWrapper/StdCppFixedMemoryPoolFactory.h"
 #include "StdCppOSWrapper/StdCppVariableMemoryPoolFactory.h"
 #include "StdCppOSWrapper/StdCppPeriodicTimerFactory.h"
@@ -23,11 +25,21 @@ public:
 		return new StdCppOSWrapper::StdCppMutexFactory();
 	}
 
+	OSWrapper::RWLockFactory* createRWLockFactory()
+	{
+		return new StdCppOSWrapper::StdCppRWLockFactory();
+	}
+
 	OSWrapper::EventFlagFactory* createEventFlagFactory()
 	{
 		return new StdCppOSWrapper::StdCppEventFlagFactory();
 	}
 
+	OSWrapper::SemaphoreFactory* createSemaphoreFactory()
+	{
+		return new StdCppOSWrapper::StdCppSemaphoreFactory();
+	}
+
 	OSWrapper::FixedMemoryPoolFactory* createFixedMemoryPoolFactory()
 	{
 		return new StdCppOSWrapper::StdCppFixedMemoryPoolFactory();
@@ -58,11 +70,21 @@ public:
 		delete factory;
 	}
 
+	void destroyRWLockFactory(OSWrapper::RWLockFactory* factory)
+	{
+		delete factory;
+	}
+
 	void destroyEventFlagFactory(OSWrapper::EventFlagFactory* factory)
 	{
 		delete factory;
 	}
 
+	void destroySemaphoreFactory(OSWrapper::SemaphoreFactory* factory)
+	{
+		delete factory;
+	}
+
 	void destroyFixedMemoryPoolFactory(OSWrapper::FixedMemoryPoolFactory* factory)
 	{
 		delete factory;
@@ -4,7 +4,9 @@
 #include "PlatformOSWrapperTestHelper.h"
 #include "WindowsOSWrapper/WindowsThreadFactory.h"
 #include "WindowsOSWrapper/WindowsMutexFactory.h"
+#include "WindowsOSWrapper/WindowsRWLockFactory.h"
 #include "WindowsOSWrapper/WindowsEventFlagFactory.h"
+#include "WindowsOSWrapper/WindowsSemaphoreFactory.h"
 #include "WindowsOSWrapper/WindowsFixedMemoryPoolFactory.h"
 #include "WindowsOSWrapper/WindowsVariableMemoryPoolFactory.h"
 #include "WindowsOSWrapper/WindowsPeriodicTimerFactory.h"
@@ -23,11 +25,21 @@ public:
 		return new WindowsOSWrapper::WindowsMutexFactory();
 	}
 
+	OSWrapper::RWLockFactory* createRWLockFactory()
+	{
+		return new WindowsOSWrapper::WindowsRWLockFactory();
+	}
+
 	OSWrapper::EventFlagFactory* createEventFlagFactory()
 	{
 		return new WindowsOSWrapper::WindowsEventFlagFactory();
 	}
 
+	OSWrapper::SemaphoreFactory* createSemaphoreFactory()
+	{
+		return new WindowsOSWrapper::WindowsSemaphoreFactory();
+	}
+
 	OSWrapper::FixedMemoryPoolFactory* createFixedMemoryPoolFactory()
 	{
 		return new WindowsOSWrapper::WindowsFixedMemoryPoolFactory();
@@ -58,11 +70,21 @@ public:
 		delete factory;
 	}
 
+	void destroyRWLockFactory(OSWrapper::RWLockFactory* factory)
+	{
+		delete factory;
+	}
+
 	void destroyEventFlagFactory(OSWrapper::EventFlagFactory* factory)
 	{
 		delete factory;
 	}
 
+	void destroySemaphoreFactory(OSWrapper::SemaphoreFactory* factory)
+	{
+		delete factory;
+	}
+
 	void destroyFixedMemoryPoolFactory(OSWrapper::FixedMemoryPoolFactory* factory)
 	{
 		delete factory;
@@ -2,7 +2,9 @@
 #include "OSWrapper/Runnable.h"
 #include "OSWrapper/Thread.h"
 #include "OSWrapper/Mutex.h"
+#include "OSWrapper/RWLock.h"
 #include "OSWrapper/EventFlag.h"
+#include "OSWrapper/Semaphore.h"
 #include "OSWrapper/FixedMemoryPool.h"
 #include "OSWrapper/VariableMemoryPool.h"
 #include "OSWrapper/PeriodicTimer.h"
@@ -15,7 +17,11 @@ namespace td = TestDoubleOSWrapper;
 using OSWrapper::Thread;
 using OSWrapper::Mutex;
 using OSWrapper::LockGuard;
+using OSWrapper::RWLock;
+using OSWrapper::ReadLockGuard;
+using OSWrapper::WriteLockGuard;
 using OSWrapper::EventFlag;
+using OSWrapper::Semaphore;
 using OSWrapper::FixedMemoryPool;
 using OSWrapper::VariableMemoryPool;
 using OSWrapper::PeriodicTimer;
@@ -102,6 +108,39 @@ TEST(TestDoubleOSWrapperTest, test_mutex)
 	Mutex::destroy(mutex);
 }
 
+TEST(TestDoubleOSWrapperTest, test_rwlock)
+{
+	RWLock* rwlock = RWLock::create();
+	CHECK(rwlock);
+	{
+		ReadLockGuard lock(rwlock);
+	}
+	{
+		WriteLockGuard lock(rwlock);
+	}
+	OSWrapper::Error err;
+	err = rwlock->readLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = rwlock->tryReadLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = rwlock->timedReadLock(Timeout::POLLING);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = rwlock->readUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = rwlock->writeLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = rwlock->tryWriteLock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = rwlock->timedWriteLock(Timeout::POLLING);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = rwlock->writeUnlock();
+	LONGS_EQUAL(OSWrapper::OK, err);
+	RWLock::destroy(rwlock);
+
+	rwlock = RWLock::create(true);
+	RWLock::destroy(rwlock);
+}
+
 TEST(TestDoubleOSWrapperTest, test_event_flag)
 {
 	EventFlag* ef = EventFlag::create(true);
@@ -148,6 +187,26 @@ TEST(TestDoubleOSWrapperTest, test_event_flag)
 	EventFlag::destroy(ef);
 }
 
+TEST(TestDoubleOSWrapperTest, test_semaphore)
+{
+	Semaphore* sem = Semaphore::create(0, 10);
+	CHECK(sem);
+
+	OSWrapper::Error err;
+	err = sem->acquire(1);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = sem->tryAcquire(2);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = sem->timedAcquire(3, Timeout::POLLING);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	err = sem->release(4);
+	LONGS_EQUAL(OSWrapper::OK, err);
+	LONGS_EQUAL(0, sem->getCount());
+	LONGS_EQUAL(10, sem->getMaxCount());
+
+	Semaphore::destroy(sem);
+}
+
 TEST(TestDoubleOSWrapperTest, test_fixed_memory_pool)
 {
 	double poolBuf[100];